@@ -29,6 +29,8 @@ class IndexType(Enum):
     Secondary = 5
     EMVB = 6
     BMP = 7
+    IVFPQ = 8
+    DiskAnn = 9
 
     def to_ttype(self):
         match self:
@@ -46,6 +48,10 @@ class IndexType(Enum):
                 return ttypes.IndexType.EMVB
             case IndexType.BMP:
                 return ttypes.IndexType.BMP
+            case IndexType.IVFPQ:
+                return ttypes.IndexType.IVFPQ
+            case IndexType.DiskAnn:
+                return ttypes.IndexType.DiskAnn
             case _:
                 raise InfinityException(3060, "Unknown index type")
 
@@ -65,6 +71,10 @@ class IndexType(Enum):
                 return LocalIndexType.kEMVB
             case IndexType.BMP:
                 return LocalIndexType.kBMP
+            case IndexType.IVFPQ:
+                return LocalIndexType.kIVFPQ
+            case IndexType.DiskAnn:
+                return LocalIndexType.kDiskAnn
             case _:
                 raise InfinityException(3060, "Unknown index type")
 
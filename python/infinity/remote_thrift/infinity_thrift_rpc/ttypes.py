@@ -303,6 +303,8 @@ class IndexType(object):
     BMP = 4
     Secondary = 5
     EMVB = 6
+    IVFPQ = 7
+    DiskAnn = 8
 
     _VALUES_TO_NAMES = {
         0: "IVFFlat",
@@ -312,6 +314,8 @@ class IndexType(object):
         4: "BMP",
         5: "Secondary",
         6: "EMVB",
+        7: "IVFPQ",
+        8: "DiskAnn",
     }
 
     _NAMES_TO_VALUES = {
@@ -322,6 +326,8 @@ class IndexType(object):
         "BMP": 4,
         "Secondary": 5,
         "EMVB": 6,
+        "IVFPQ": 7,
+        "DiskAnn": 8,
     }
 
 
@@ -39,93 +39,66 @@ constexpr u64 Str2Int(const char *str, u64 last_value = basis) {
     return (*str != '\0' && *str != '-') ? Str2Int(str + 1, (*str ^ last_value) * prime) : last_value;
 }
 
+template <typename AnalyzerT>
+Tuple<AnalyzerT *, Status> GetPrototype(AnalyzerPool::CacheType &cache, std::mutex &mutex, const std::string_view &key) {
+    // only taken when a thread creates an analyzer, the prototypes are never removed from the cache
+    std::unique_lock<std::mutex> lock(mutex);
+    Analyzer *prototype = cache[key].get();
+    if (prototype == nullptr) {
+        String path;
+        Config *config = InfinityContext::instance().config();
+        if (config == nullptr) {
+            // InfinityContext has not been initialized.
+            path = "/var/infinity/resource";
+        } else {
+            path = config->ResourcePath();
+        }
+        UniquePtr<AnalyzerT> analyzer = MakeUnique<AnalyzerT>(std::move(path));
+        Status load_status = analyzer->Load();
+        if (!load_status.ok()) {
+            return {nullptr, load_status};
+        }
+        prototype = analyzer.get();
+        cache[key] = std::move(analyzer);
+    }
+    return {static_cast<AnalyzerT *>(prototype), Status::OK()};
+}
+
+CutGrain ParseCutGrain(const std::string_view &name) {
+    // {chinese|tradition}-{coarse|fine}
+    const char *str = name.data();
+    while (*str != '\0' && *str != '-') {
+        str++;
+    }
+    return strcmp(str, "-fine") == 0 ? CutGrain::kFine : CutGrain::kCoarse;
+}
+
 Tuple<UniquePtr<Analyzer>, Status> AnalyzerPool::GetAnalyzer(const std::string_view &name) {
     switch (Str2Int(name.data())) {
         case Str2Int(CHINESE.data()): {
-            // chinese-{coarse|fine}
-            Analyzer *prototype = cache_[CHINESE].get();
-            if (prototype == nullptr) {
-                String path;
-                Config *config = InfinityContext::instance().config();
-                if (config == nullptr) {
-                    // InfinityContext has not been initialized.
-                    path = "/var/infinity/resource";
-                } else {
-                    path = config->ResourcePath();
-                }
-                UniquePtr<ChineseAnalyzer> analyzer = MakeUnique<ChineseAnalyzer>(std::move(path));
-                Status load_status = analyzer->Load();
-                if (!load_status.ok()) {
-                    return {nullptr, load_status};
-                }
-                prototype = analyzer.get();
-                cache_[CHINESE] = std::move(analyzer);
-            }
-            CutGrain cut_grain = CutGrain::kCoarse;
-            const char *str = name.data();
-            while (*str != '\0' && *str != '-') {
-                str++;
-            }
-            if (strcmp(str, "-fine") == 0) {
-                cut_grain = CutGrain::kFine;
+            auto [prototype, status] = GetPrototype<ChineseAnalyzer>(cache_, mutex_, CHINESE);
+            if (!status.ok()) {
+                return {nullptr, status};
             }
-            UniquePtr<ChineseAnalyzer> analyzer = MakeUnique<ChineseAnalyzer>(*reinterpret_cast<ChineseAnalyzer *>(prototype));
-            analyzer->SetCutGrain(cut_grain);
+            UniquePtr<ChineseAnalyzer> analyzer = MakeUnique<ChineseAnalyzer>(*prototype);
+            analyzer->SetCutGrain(ParseCutGrain(name));
             return {std::move(analyzer), Status::OK()};
         }
         case Str2Int(TRADITIONALCHINESE.data()): {
-            // chinese-{coarse|fine}
-            Analyzer *prototype = cache_[TRADITIONALCHINESE].get();
-            if (prototype == nullptr) {
-                String path;
-                Config *config = InfinityContext::instance().config();
-                if (config == nullptr) {
-                    // InfinityContext has not been initialized.
-                    path = "/var/infinity/resource";
-                } else {
-                    path = config->ResourcePath();
-                }
-                UniquePtr<TraditionalChineseAnalyzer> analyzer = MakeUnique<TraditionalChineseAnalyzer>(std::move(path));
-                Status load_status = analyzer->Load();
-                if (!load_status.ok()) {
-                    return {nullptr, load_status};
-                }
-                prototype = analyzer.get();
-                cache_[TRADITIONALCHINESE] = std::move(analyzer);
-            }
-            CutGrain cut_grain = CutGrain::kCoarse;
-            const char *str = name.data();
-            while (*str != '\0' && *str != '-') {
-                str++;
+            auto [prototype, status] = GetPrototype<TraditionalChineseAnalyzer>(cache_, mutex_, TRADITIONALCHINESE);
+            if (!status.ok()) {
+                return {nullptr, status};
             }
-            if (strcmp(str, "-fine") == 0) {
-                cut_grain = CutGrain::kFine;
-            }
-            UniquePtr<TraditionalChineseAnalyzer> analyzer =
-                MakeUnique<TraditionalChineseAnalyzer>(*reinterpret_cast<TraditionalChineseAnalyzer *>(prototype));
-            analyzer->SetCutGrain(cut_grain);
+            UniquePtr<TraditionalChineseAnalyzer> analyzer = MakeUnique<TraditionalChineseAnalyzer>(*prototype);
+            analyzer->SetCutGrain(ParseCutGrain(name));
             return {std::move(analyzer), Status::OK()};
         }
         case Str2Int(JAPANESE.data()): {
-            Analyzer *prototype = cache_[JAPANESE].get();
-            if (prototype == nullptr) {
-                String path;
-                Config *config = InfinityContext::instance().config();
-                if (config == nullptr) {
-                    // InfinityContext has not been initialized.
-                    path = "/var/infinity/resource";
-                } else {
-                    path = config->ResourcePath();
-                }
-                UniquePtr<JapaneseAnalyzer> analyzer = MakeUnique<JapaneseAnalyzer>(std::move(path));
-                Status load_status = analyzer->Load();
-                if (!load_status.ok()) {
-                    return {nullptr, load_status};
-                }
-                prototype = analyzer.get();
-                cache_[JAPANESE] = std::move(analyzer);
+            auto [prototype, status] = GetPrototype<JapaneseAnalyzer>(cache_, mutex_, JAPANESE);
+            if (!status.ok()) {
+                return {nullptr, status};
             }
-            return {MakeUnique<JapaneseAnalyzer>(*reinterpret_cast<JapaneseAnalyzer *>(prototype)), Status::OK()};
+            return {MakeUnique<JapaneseAnalyzer>(*prototype), Status::OK()};
         }
         case Str2Int(STANDARD.data()): {
             return {MakeUnique<StandardAnalyzer>(), Status::OK()};
@@ -154,4 +127,20 @@ Tuple<UniquePtr<Analyzer>, Status> AnalyzerPool::GetAnalyzer(const std::string_v
     }
 }
 
+Tuple<Analyzer *, Status> AnalyzerPool::GetThreadLocalAnalyzer(const std::string_view &name) {
+    // the copies share the dictionaries of the prototypes, the stemmer, tokenizer and buffers are built once per thread
+    thread_local FlatHashMap<String, UniquePtr<Analyzer>> thread_analyzers;
+    String key(name);
+    if (auto iter = thread_analyzers.find(key); iter != thread_analyzers.end()) {
+        return {iter->second.get(), Status::OK()};
+    }
+    auto [analyzer, status] = GetAnalyzer(key);
+    if (!status.ok()) {
+        return {nullptr, status};
+    }
+    Analyzer *result = analyzer.get();
+    thread_analyzers.emplace(std::move(key), std::move(analyzer));
+    return {result, Status::OK()};
+}
+
 } // namespace infinity
\ No newline at end of file
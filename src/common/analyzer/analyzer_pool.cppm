@@ -30,6 +30,10 @@ public:
 
     Tuple<UniquePtr<Analyzer>, Status> GetAnalyzer(const std::string_view &name);
 
+    // The analyzer of the calling thread for `name`, copied from the shared prototype on first use and reused by the later
+    // calls of the thread without any locking. It is owned by the thread and must not be handed to other threads.
+    Tuple<Analyzer *, Status> GetThreadLocalAnalyzer(const std::string_view &name);
+
     void Set(const std::string_view &name);
 
 public:
@@ -40,7 +44,9 @@ public:
     static constexpr std::string_view NGRAM = "ngram";
 
 private:
+    // prototypes holding the dictionaries and models, loaded once and shared by all analyzers copied from them
     CacheType cache_{};
+    std::mutex mutex_{};
 };
 
 } // namespace infinity
\ No newline at end of file
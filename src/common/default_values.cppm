@@ -234,6 +234,8 @@ export {
     constexpr std::string_view SYSTEM_MEMORY_USAGE_VAR_NAME = "system_memory_usage";  // global
     constexpr std::string_view OPEN_FILE_COUNT_VAR_NAME = "open_file_count";  // global
     constexpr std::string_view CPU_USAGE_VAR_NAME = "cpu_usage";  // global
+    constexpr std::string_view WAL_FLUSH_BATCH_SIZE_VAR_NAME = "wal_flush_batch_size";  // global
+    constexpr std::string_view WAL_FLUSH_LATENCY_VAR_NAME = "wal_flush_latency";  // global
 
 }
 
@@ -225,6 +225,9 @@ export namespace std {
     using std::uniform_real_distribution;
 
     using std::exception;
+    using std::exception_ptr;
+    using std::current_exception;
+    using std::rethrow_exception;
     using std::unordered_set;
 
     using std::distance;
@@ -244,6 +247,7 @@ export namespace std {
     using std::is_integral_v;
     using std::is_floating_point_v;
     using std::common_type_t;
+    using std::conditional_t;
     using std::underlying_type_t;
 
     using std::function;
@@ -0,0 +1,99 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module histogram;
+
+import stl;
+import third_party;
+
+namespace infinity {
+
+// Histogram of u64 values with power of two buckets, bucket 0 holds 0 and bucket i holds [2^(i-1), 2^i).
+// One thread records, any thread reads. Each counter is read atomically, but not all counters together.
+export class Log2Histogram {
+public:
+    static constexpr SizeT BUCKET_COUNT = 65;
+
+    void Record(u64 value) {
+        buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    u64 Count() const { return count_.load(std::memory_order_relaxed); }
+
+    u64 Sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    u64 Max() const { return max_.load(std::memory_order_relaxed); }
+
+    u64 BucketCount(SizeT bucket_idx) const { return buckets_[bucket_idx].load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket the percentile falls in, 0 if nothing is recorded.
+    u64 Percentile(f64 percentile) const {
+        u64 count = Count();
+        if (count == 0) {
+            return 0;
+        }
+        u64 rank = std::max(u64(1), static_cast<u64>(percentile * count + 0.5));
+        u64 seen = 0;
+        for (SizeT bucket_idx = 0; bucket_idx < BUCKET_COUNT; ++bucket_idx) {
+            seen += BucketCount(bucket_idx);
+            if (seen >= rank) {
+                return std::min(BucketUpperBound(bucket_idx), Max());
+            }
+        }
+        return Max();
+    }
+
+    String ToString() const {
+        u64 count = Count();
+        f64 avg = count == 0 ? 0 : static_cast<f64>(Sum()) / count;
+        return fmt::format("count: {}, avg: {:.2f}, p50: {}, p90: {}, p99: {}, max: {}",
+                           count,
+                           avg,
+                           Percentile(0.5),
+                           Percentile(0.9),
+                           Percentile(0.99),
+                           Max());
+    }
+
+    static SizeT BucketIndex(u64 value) {
+        SizeT bucket_idx = 0;
+        while (value != 0) {
+            ++bucket_idx;
+            value >>= 1;
+        }
+        return bucket_idx;
+    }
+
+    static u64 BucketUpperBound(SizeT bucket_idx) {
+        if (bucket_idx + 1 >= BUCKET_COUNT) {
+            return std::numeric_limits<u64>::max();
+        }
+        return (u64(1) << bucket_idx) - 1;
+    }
+
+private:
+    Array<Atomic<u64>, BUCKET_COUNT> buckets_{};
+    Atomic<u64> count_{};
+    Atomic<u64> sum_{};
+    Atomic<u64> max_{};
+};
+
+} // namespace infinity
@@ -14,6 +14,9 @@
 
 module;
 
+#include <cctype>
+#include <filesystem>
+#include <string>
 #include <thread>
 
 import stl;
@@ -38,4 +41,20 @@ bool ThreadUtil::pin(Thread &thread, const u16 cpu_id) {
 #endif
 }
 
+u16 ThreadUtil::GetNumaNode(const u16 cpu_id) {
+    // Linux links the node directory into the cpu directory, e.g. /sys/devices/system/cpu/cpu0/node0
+    std::error_code error_code;
+    std::filesystem::directory_iterator iter("/sys/devices/system/cpu/cpu" + std::to_string(cpu_id), error_code);
+    if (error_code) {
+        return 0;
+    }
+    for (const auto &entry : iter) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.starts_with("node") && std::isdigit(name[4])) {
+            return static_cast<u16>(std::stoul(name.substr(4)));
+        }
+    }
+    return 0;
+}
+
 } // namespace infinity
@@ -69,5 +69,45 @@ String FormatTimeInfo(u64 seconds) {
     return fmt::format("{}h", seconds);
 }
 
+void RunParallel(SizeT task_count, SizeT worker_count, const std::function<void(SizeT)> &func) {
+    worker_count = std::min(worker_count, task_count);
+    if (worker_count <= 1) {
+        for (SizeT task_idx = 0; task_idx < task_count; ++task_idx) {
+            func(task_idx);
+        }
+        return;
+    }
+    Atomic<SizeT> next_task{0};
+    // The first exception thrown by a task stops the remaining tasks, it is rethrown once all workers are joined.
+    std::mutex exception_mutex;
+    std::exception_ptr first_exception;
+    auto worker = [&] {
+        for (SizeT task_idx = next_task.fetch_add(1); task_idx < task_count; task_idx = next_task.fetch_add(1)) {
+            try {
+                func(task_idx);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!first_exception) {
+                    first_exception = std::current_exception();
+                }
+                next_task.store(task_count);
+                break;
+            }
+        }
+    };
+    Vector<Thread> threads;
+    threads.reserve(worker_count - 1);
+    for (SizeT worker_idx = 1; worker_idx < worker_count; ++worker_idx) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (first_exception) {
+        std::rethrow_exception(first_exception);
+    }
+}
+
 
 } // namespace infinity
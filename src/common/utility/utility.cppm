@@ -24,4 +24,8 @@ SizeT NextPowerOfTwo(SizeT input);
 String FormatByteSize(u64 byte_size);
 String FormatTimeInfo(u64 seconds);
 
+// Run func(0) ... func(task_count - 1) on at most worker_count threads, the calling thread is one of the workers.
+// If a task throws, the tasks not started yet are skipped and the first exception is rethrown on the calling thread.
+void RunParallel(SizeT task_count, SizeT worker_count, const std::function<void(SizeT)> &func);
+
 }
@@ -0,0 +1,121 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module work_stealing_deque;
+
+import stl;
+
+namespace infinity {
+
+// Chase-Lev work stealing deque of pointers.
+// Only the owner thread may call Push and Pop, which work on the bottom end. Any thread may call Steal, which takes from the top end.
+// Pop and Steal return nullptr when the deque is empty or the race for the last element is lost.
+// The ring buffer grows on demand; replaced rings are kept until the deque is destroyed since a thief may still read them.
+export template <typename T>
+class WorkStealingDeque {
+private:
+    struct Ring {
+        explicit Ring(i64 capacity) : capacity_(capacity), mask_(capacity - 1), slots_(MakeUnique<Atomic<T *>[]>(capacity)) {}
+
+        inline T *Get(i64 idx) const { return slots_[idx & mask_].load(std::memory_order_relaxed); }
+
+        inline void Put(i64 idx, T *value) { slots_[idx & mask_].store(value, std::memory_order_relaxed); }
+
+        i64 capacity_{};
+        i64 mask_{};
+        UniquePtr<Atomic<T *>[]> slots_{};
+    };
+
+public:
+    // `capacity` must be a power of 2.
+    explicit WorkStealingDeque(i64 capacity = 256) {
+        rings_.emplace_back(MakeUnique<Ring>(capacity));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    void Push(T *value) {
+        i64 bottom = bottom_.load(std::memory_order_relaxed);
+        i64 top = top_.load(std::memory_order_acquire);
+        Ring *ring = ring_.load(std::memory_order_relaxed);
+        if (bottom - top >= ring->capacity_) {
+            ring = Grow(ring, top, bottom);
+        }
+        ring->Put(bottom, value);
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    T *Pop() {
+        i64 bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring *ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_seq_cst);
+        i64 top = top_.load(std::memory_order_seq_cst);
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T *value = ring->Get(bottom);
+        if (top == bottom) {
+            // Last element, race with the thieves.
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                value = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    T *Steal() {
+        i64 top = top_.load(std::memory_order_seq_cst);
+        i64 bottom = bottom_.load(std::memory_order_seq_cst);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Ring *ring = ring_.load(std::memory_order_acquire);
+        T *value = ring->Get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return value;
+    }
+
+    // Approximate when other threads are working on the deque.
+    [[nodiscard]] SizeT Size() const {
+        i64 bottom = bottom_.load(std::memory_order_relaxed);
+        i64 top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? bottom - top : 0;
+    }
+
+    [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+private:
+    Ring *Grow(Ring *ring, i64 top, i64 bottom) {
+        auto new_ring = MakeUnique<Ring>(ring->capacity_ * 2);
+        for (i64 idx = top; idx < bottom; ++idx) {
+            new_ring->Put(idx, ring->Get(idx));
+        }
+        rings_.emplace_back(std::move(new_ring));
+        ring_.store(rings_.back().get(), std::memory_order_release);
+        return rings_.back().get();
+    }
+
+    Atomic<i64> top_{0};
+    Atomic<i64> bottom_{0};
+    Atomic<Ring *> ring_{nullptr};
+    // Owned by the owner thread.
+    Vector<UniquePtr<Ring>> rings_{};
+};
+
+} // namespace infinity
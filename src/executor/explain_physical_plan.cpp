@@ -83,6 +83,8 @@ import infinity_exception;
 import base_expression;
 import knn_expression;
 import third_party;
+import join_reference;
+import table_index_entry;
 import select_statement;
 import knn_expr;
 import extra_ddl_info;
@@ -1262,7 +1264,7 @@ void ExplainPhysicalPlan::Explain(const PhysicalShow *show_node, SharedPtr<Vecto
             show_str += "(" + std::to_string(show_node->node_id()) + ")";
             result->emplace_back(MakeShared<String>(show_str));
 
-            String output_columns_str = String(intent_size, ' ') + " - output columns: [path, status, size, buffered_type, type]";
+            String output_columns_str = String(intent_size, ' ') + " - output columns: [path, status, size, buffered_type, type, hits, misses, evictions]";
             result->emplace_back(MakeShared<String>(output_columns_str));
             break;
         }
@@ -1653,22 +1655,160 @@ void ExplainPhysicalPlan::Explain(const PhysicalDummyScan *, SharedPtr<Vector<Sh
     RecoverableError(status);
 }
 
-void ExplainPhysicalPlan::Explain(const PhysicalHashJoin *, SharedPtr<Vector<SharedPtr<String>>> &, i64) {
-    Status status = Status::NotSupport("Not implemented");
-    LOG_ERROR(status.message());
-    RecoverableError(status);
+void ExplainPhysicalPlan::Explain(const PhysicalHashJoin *join_node, SharedPtr<Vector<SharedPtr<String>>> &result, i64 intent_size) {
+    String join_header;
+    if (intent_size != 0) {
+        join_header = String(intent_size - 2, ' ') + "-> HASH JOIN";
+    } else {
+        join_header = "HASH JOIN ";
+    }
+
+    join_header += "(" + std::to_string(join_node->node_id()) + ")";
+    result->emplace_back(MakeShared<String>(join_header));
+
+    // Join type
+    {
+        String join_type_str = String(intent_size, ' ') + " - type: " + JoinReference::ToString(join_node->join_type());
+        result->emplace_back(MakeShared<String>(join_type_str));
+    }
+
+    // Conditions
+    {
+        String condition_str = String(intent_size, ' ') + " - hash keys: [";
+
+        SizeT conditions_count = join_node->conditions().size();
+        if (conditions_count == 0) {
+            String error_message = "HASH JOIN without any condition.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+
+        for (SizeT idx = 0; idx < conditions_count - 1; ++idx) {
+            ExplainLogicalPlan::Explain(join_node->conditions()[idx].get(), condition_str);
+            condition_str += ", ";
+        }
+        ExplainLogicalPlan::Explain(join_node->conditions().back().get(), condition_str);
+        condition_str += "]";
+        result->emplace_back(MakeShared<String>(condition_str));
+    }
+
+    // Output column
+    {
+        String output_columns_str = String(intent_size, ' ') + " - output columns: [";
+        SharedPtr<Vector<String>> output_columns = join_node->GetOutputNames();
+        SizeT column_count = output_columns->size();
+        for (SizeT idx = 0; idx < column_count - 1; ++idx) {
+            output_columns_str += output_columns->at(idx) + ", ";
+        }
+        output_columns_str += output_columns->back() + "]";
+        result->emplace_back(MakeShared<String>(output_columns_str));
+    }
 }
 
-void ExplainPhysicalPlan::Explain(const PhysicalSortMergeJoin *, SharedPtr<Vector<SharedPtr<String>>> &, i64) {
-    Status status = Status::NotSupport("Not implemented");
-    LOG_ERROR(status.message());
-    RecoverableError(status);
+void ExplainPhysicalPlan::Explain(const PhysicalSortMergeJoin *join_node, SharedPtr<Vector<SharedPtr<String>>> &result, i64 intent_size) {
+    String join_header;
+    if (intent_size != 0) {
+        join_header = String(intent_size - 2, ' ') + "-> MERGE JOIN";
+    } else {
+        join_header = "MERGE JOIN ";
+    }
+
+    join_header += "(" + std::to_string(join_node->node_id()) + ")";
+    result->emplace_back(MakeShared<String>(join_header));
+
+    // Join type
+    {
+        String join_type_str = String(intent_size, ' ') + " - type: " + JoinReference::ToString(join_node->join_type());
+        result->emplace_back(MakeShared<String>(join_type_str));
+    }
+
+    // Conditions
+    {
+        String condition_str = String(intent_size, ' ') + " - merge keys: [";
+
+        SizeT conditions_count = join_node->conditions().size();
+        if (conditions_count == 0) {
+            String error_message = "MERGE JOIN without any condition.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+
+        for (SizeT idx = 0; idx < conditions_count - 1; ++idx) {
+            ExplainLogicalPlan::Explain(join_node->conditions()[idx].get(), condition_str);
+            condition_str += ", ";
+        }
+        ExplainLogicalPlan::Explain(join_node->conditions().back().get(), condition_str);
+        condition_str += "]";
+        result->emplace_back(MakeShared<String>(condition_str));
+    }
+
+    // Output column
+    {
+        String output_columns_str = String(intent_size, ' ') + " - output columns: [";
+        SharedPtr<Vector<String>> output_columns = join_node->GetOutputNames();
+        SizeT column_count = output_columns->size();
+        for (SizeT idx = 0; idx < column_count - 1; ++idx) {
+            output_columns_str += output_columns->at(idx) + ", ";
+        }
+        output_columns_str += output_columns->back() + "]";
+        result->emplace_back(MakeShared<String>(output_columns_str));
+    }
 }
 
-void ExplainPhysicalPlan::Explain(const PhysicalIndexJoin *, SharedPtr<Vector<SharedPtr<String>>> &, i64) {
-    Status status = Status::NotSupport("Not implemented");
-    LOG_ERROR(status.message());
-    RecoverableError(status);
+void ExplainPhysicalPlan::Explain(const PhysicalIndexJoin *join_node, SharedPtr<Vector<SharedPtr<String>>> &result, i64 intent_size) {
+    String join_header;
+    if (intent_size != 0) {
+        join_header = String(intent_size - 2, ' ') + "-> INDEX JOIN";
+    } else {
+        join_header = "INDEX JOIN ";
+    }
+
+    join_header += "(" + std::to_string(join_node->node_id()) + ")";
+    result->emplace_back(MakeShared<String>(join_header));
+
+    // Join type
+    {
+        String join_type_str = String(intent_size, ' ') + " - type: " + JoinReference::ToString(join_node->join_type());
+        result->emplace_back(MakeShared<String>(join_type_str));
+    }
+
+    // Conditions
+    {
+        String condition_str = String(intent_size, ' ') + " - index keys: [";
+
+        SizeT conditions_count = join_node->conditions().size();
+        if (conditions_count == 0) {
+            String error_message = "INDEX JOIN without any condition.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+
+        for (SizeT idx = 0; idx < conditions_count - 1; ++idx) {
+            ExplainLogicalPlan::Explain(join_node->conditions()[idx].get(), condition_str);
+            condition_str += ", ";
+        }
+        ExplainLogicalPlan::Explain(join_node->conditions().back().get(), condition_str);
+        condition_str += "]";
+        result->emplace_back(MakeShared<String>(condition_str));
+    }
+
+    // Index
+    {
+        String index_str = String(intent_size, ' ') + " - index: " + *join_node->inner_index_entry()->GetIndexName();
+        result->emplace_back(MakeShared<String>(index_str));
+    }
+
+    // Output column
+    {
+        String output_columns_str = String(intent_size, ' ') + " - output columns: [";
+        SharedPtr<Vector<String>> output_columns = join_node->GetOutputNames();
+        SizeT column_count = output_columns->size();
+        for (SizeT idx = 0; idx < column_count - 1; ++idx) {
+            output_columns_str += output_columns->at(idx) + ", ";
+        }
+        output_columns_str += output_columns->back() + "]";
+        result->emplace_back(MakeShared<String>(output_columns_str));
+    }
 }
 
 void ExplainPhysicalPlan::Explain(const PhysicalDelete *delete_node, SharedPtr<Vector<SharedPtr<String>>> &result, i64 intent_size) {
@@ -27,6 +27,8 @@ import physical_source;
 import physical_explain;
 import physical_knn_scan;
 import physical_fusion;
+import physical_hash_join;
+import physical_sort_merge_join;
 import status;
 import infinity_exception;
 
@@ -259,14 +261,58 @@ void FragmentBuilder::BuildFragments(PhysicalOperator *phys_op, PlanFragment *cu
             }
             return;
         }
+        case PhysicalOperatorType::kJoinHash:
+        case PhysicalOperatorType::kJoinMerge: {
+            if (phys_op->left() == nullptr || phys_op->right() == nullptr) {
+                String error_message = fmt::format("{} needs both left and right input.", phys_op->GetName());
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+            // The join collects both inputs from the child fragments, then builds and probes in one task.
+            current_fragment_ptr->AddOperator(phys_op);
+            current_fragment_ptr->SetSourceNode(query_context_ptr_, SourceType::kLocalQueue, phys_op->GetOutputNames(), phys_op->GetOutputTypes());
+            current_fragment_ptr->SetFragmentType(FragmentType::kSerialMaterialize);
+
+            auto left_plan_fragment = MakeUnique<PlanFragment>(GetFragmentId());
+            left_plan_fragment->SetSinkNode(query_context_ptr_,
+                                            SinkType::kLocalQueue,
+                                            phys_op->left()->GetOutputNames(),
+                                            phys_op->left()->GetOutputTypes());
+            BuildFragments(phys_op->left(), left_plan_fragment.get());
+
+            auto right_plan_fragment = MakeUnique<PlanFragment>(GetFragmentId());
+            right_plan_fragment->SetSinkNode(query_context_ptr_,
+                                             SinkType::kLocalQueue,
+                                             phys_op->right()->GetOutputNames(),
+                                             phys_op->right()->GetOutputTypes());
+            BuildFragments(phys_op->right(), right_plan_fragment.get());
+
+            if (phys_op->operator_type() == PhysicalOperatorType::kJoinHash) {
+                static_cast<PhysicalHashJoin *>(phys_op)->SetInputFragmentIds(left_plan_fragment->FragmentID(), right_plan_fragment->FragmentID());
+            } else {
+                static_cast<PhysicalSortMergeJoin *>(phys_op)->SetInputFragmentIds(left_plan_fragment->FragmentID(), right_plan_fragment->FragmentID());
+            }
+            current_fragment_ptr->AddChild(std::move(left_plan_fragment));
+            current_fragment_ptr->AddChild(std::move(right_plan_fragment));
+            return;
+        }
+        case PhysicalOperatorType::kJoinIndex: {
+            if (phys_op->left() == nullptr) {
+                String error_message = fmt::format("No input node of {}", phys_op->GetName());
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+            // The right table is read by index lookups inside the join, only the left input is a pipeline.
+            current_fragment_ptr->SetFragmentType(FragmentType::kParallelMaterialize);
+            current_fragment_ptr->AddOperator(phys_op);
+            BuildFragments(phys_op->left(), current_fragment_ptr);
+            break;
+        }
         case PhysicalOperatorType::kUnionAll:
         case PhysicalOperatorType::kIntersect:
         case PhysicalOperatorType::kExcept:
         case PhysicalOperatorType::kDummyScan:
-        case PhysicalOperatorType::kJoinHash:
         case PhysicalOperatorType::kJoinNestedLoop:
-        case PhysicalOperatorType::kJoinMerge:
-        case PhysicalOperatorType::kJoinIndex:
         case PhysicalOperatorType::kCrossProduct: {
             String error_message = fmt::format("Not support {}.", phys_op->GetName());
             LOG_CRITICAL(error_message);
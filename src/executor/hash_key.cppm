@@ -0,0 +1,93 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module hash_key;
+
+import stl;
+import logical_type;
+
+namespace infinity {
+
+// Hash helpers of the join and group by hash tables, keys are hashed column by column and combined.
+
+export inline u64 HashMix(u64 h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+export inline u64 HashBytes(const char *data, SizeT len) {
+    u64 h = 0xcbf29ce484222325ULL ^ len;
+    SizeT i = 0;
+    for (; i + sizeof(u64) <= len; i += sizeof(u64)) {
+        u64 word;
+        std::memcpy(&word, data + i, sizeof(u64));
+        h = HashMix(h ^ word);
+    }
+    u64 tail = 0;
+    std::memcpy(&tail, data + i, len - i);
+    return HashMix(h ^ tail);
+}
+
+export inline u64 HashCombine(u64 seed, u64 h) { return seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)); }
+
+// Keys are hashed and compared by their bytes, a float key is normalized so that equal keys have equal bytes:
+// -0.0 becomes 0.0 and every NaN becomes the same quiet NaN, so that all NaN keys fall into one group.
+export template <typename T>
+inline T NormalizeFloatKey(T value) {
+    if (value == 0) {
+        return 0;
+    }
+    if (std::isnan(value)) {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    return value;
+}
+
+export template <typename T>
+inline bool FloatKeyEqual(T left, T right) {
+    return left == right || (std::isnan(left) && std::isnan(right));
+}
+
+template <typename T>
+inline void NormalizeFloatKeyBytes(char *data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    value = NormalizeFloatKey(value);
+    std::memcpy(data, &value, sizeof(T));
+}
+
+// Normalize a key of the given type in place, only float keys are changed.
+export inline void NormalizeKeyBytes(LogicalType type, char *data) {
+    switch (type) {
+        case LogicalType::kFloat: {
+            NormalizeFloatKeyBytes<float>(data);
+            break;
+        }
+        case LogicalType::kDouble: {
+            NormalizeFloatKeyBytes<double>(data);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+} // namespace infinity
@@ -14,111 +14,354 @@
 
 module;
 
-#include <string>
-import stl;
+module hash_table;
 
+import stl;
 import column_vector;
-
+import vector_buffer;
+import fix_heap;
+import value;
+import data_type;
+import logical_type;
+import internal_types;
+import status;
 import infinity_exception;
+import logger;
+import third_party;
+import hash_key;
 
-module hash_table;
-
-#if 0
 namespace infinity {
 
-void HashTable::Init(const Vector<DataType> &types) {
-    types_ = types;
-    SizeT type_count = types.size();
-    for (SizeT idx = 0; idx < type_count; ++idx) {
-        const DataType &data_type = types[idx];
-        switch (data_type.type()) {
-            case kBoolean:
-            case kTinyInt:
-            case kSmallInt:
-            case kInteger:
-            case kBigInt:
-            case kHugeInt:
-            case kFloat:
-            case kDouble:
-            case kDecimal:
-            case kVarchar:
-            case kDate:
-            case kTime:
-            case kDateTime:
-            case kMixed: {
-                break; // All these type can be hashed.
+namespace {
+
+constexpr SizeT HASH_SIZE = sizeof(u64);
+constexpr SizeT VARCHAR_KEY_SIZE = sizeof(u32) + sizeof(const char *);
+constexpr u64 NULL_KEY_HASH = 0x5bd1e9955bd1e995ULL;
+
+inline SizeT AlignUp(SizeT size) { return (size + 7) & ~SizeT(7); }
+
+inline u32 ReadVarcharLength(const char *slot) {
+    u32 length;
+    std::memcpy(&length, slot + 1, sizeof(u32));
+    return length;
+}
+
+inline const char *ReadVarcharPtr(const char *slot) {
+    const char *ptr;
+    std::memcpy(&ptr, slot + 1 + sizeof(u32), sizeof(const char *));
+    return ptr;
+}
+
+inline void WriteVarchar(char *slot, u32 length, const char *ptr) {
+    std::memcpy(slot + 1, &length, sizeof(u32));
+    std::memcpy(slot + 1 + sizeof(u32), &ptr, sizeof(const char *));
+}
+
+} // namespace
+
+AggregateHashTable::AggregateHashTable(Vector<SharedPtr<DataType>> key_types, const Vector<SizeT> &state_sizes) : key_types_(std::move(key_types)) {
+    SizeT offset = HASH_SIZE;
+    key_offsets_.reserve(key_types_.size());
+    for (const auto &key_type : key_types_) {
+        if (!SupportKeyType(*key_type)) {
+            Status status = Status::NotSupport(fmt::format("Attempt to construct hash key for type: {}", key_type->ToString()));
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+        }
+        key_offsets_.emplace_back(offset);
+        switch (key_type->type()) {
+            case LogicalType::kBoolean: {
+                offset += 1 + sizeof(BooleanT);
+                break;
+            }
+            case LogicalType::kVarchar: {
+                has_varchar_key_ = true;
+                offset += 1 + VARCHAR_KEY_SIZE;
+                break;
             }
-            case kTimestamp:
-            case kInterval:
-            case kArray:
-            case kTuple:
-            case kPoint:
-            case kLine:
-            case kLineSeg:
-            case kBox:
-//            case kPath:
-//            case kPolygon:
-            case kCircle:
-//            case kBitmap:
-            case kUuid:
-//            case kBlob:
-            case kEmbedding:
-            case kRowID:
-            case kNull:
-            case kMissing:
-            case kInvalid: {
-                RecoverableError(Status::NotSupport(fmt::format("Attempt to construct hash key for type: {}", data_type.ToString())));
+            default: {
+                offset += 1 + key_type->Size();
+                break;
             }
         }
+    }
+    key_size_ = offset - HASH_SIZE;
 
-        SizeT type_size = data_type.Size();
-        key_size_ += type_size;
+    offset = AlignUp(offset);
+    state_offsets_.reserve(state_sizes.size());
+    for (SizeT state_size : state_sizes) {
+        state_offsets_.emplace_back(offset);
+        offset = AlignUp(offset + state_size);
     }
+    row_size_ = offset;
 
-    // Key layout: col1\0col2\0col3\0.
-    key_size_ += type_count;
+    slots_.resize(1024, 0);
+    slot_mask_ = slots_.size() - 1;
 }
 
-void HashTable::Append(const Vector<SharedPtr<ColumnVector>> &columns, SizeT block_id, SizeT row_count) {
-    UniquePtr<char[]> hash_key = MakeUnique<char[]>(key_size_);
-    SizeT column_count = columns.size();
-    for (SizeT row_id = 0; row_id < row_count; ++row_id) {
-        std::memset(hash_key.get(), 0, key_size_);
-        SizeT offset = 0;
+void AggregateHashTable::FindOrCreateGroups(const Vector<SharedPtr<ColumnVector>> &key_columns,
+                                            SizeT row_count,
+                                            Vector<ptr_t> &group_ptrs,
+                                            Vector<ptr_t> &new_groups) {
+    group_ptrs.resize(row_count);
+    String key_buffer(key_size_, '\0');
+    Vector<String> varchar_buffers(key_types_.size());
+    for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+        u64 hash = NormalizeKey(key_columns, row_idx, key_buffer.data(), varchar_buffers, true);
+        group_ptrs[row_idx] = FindOrCreateGroup(hash, key_buffer.data(), new_groups);
+    }
+}
 
-        for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-            char *target_ptr = hash_key.get() + offset;
-            if (!columns[column_id]->nulls_ptr_->IsTrue(row_id)) {
-                *(target_ptr) = '\0';
-                offset += 2;
-                continue;
+void AggregateHashTable::FindOrCreateGroups(const Vector<SharedPtr<ColumnVector>> &key_columns,
+                                            const u64 *hashes,
+                                            const Vector<u32> &rows,
+                                            Vector<ptr_t> &group_ptrs,
+                                            Vector<ptr_t> &new_groups) {
+    group_ptrs.resize(rows.size());
+    String key_buffer(key_size_, '\0');
+    Vector<String> varchar_buffers(key_types_.size());
+    for (SizeT idx = 0; idx < rows.size(); ++idx) {
+        u32 row_idx = rows[idx];
+        NormalizeKey(key_columns, row_idx, key_buffer.data(), varchar_buffers, false);
+        group_ptrs[idx] = FindOrCreateGroup(hashes[row_idx], key_buffer.data(), new_groups);
+    }
+}
+
+ptr_t AggregateHashTable::FindOrCreateGroup(u64 hash, const char *key_buffer, Vector<ptr_t> &new_groups) {
+    if ((group_count_ + 1) * 2 > slots_.size()) {
+        Grow();
+    }
+    u64 salt = hash & SALT_MASK;
+    for (SizeT slot_idx = hash & slot_mask_;; slot_idx = (slot_idx + 1) & slot_mask_) {
+        u64 slot = slots_[slot_idx];
+        if (slot == 0) {
+            ptr_t group = CreateGroup(hash, key_buffer);
+            slots_[slot_idx] = salt | group_count_;
+            new_groups.emplace_back(group);
+            return group;
+        }
+        if ((slot & SALT_MASK) != salt) {
+            continue;
+        }
+        ptr_t group = GetGroup((slot & GROUP_IDX_MASK) - 1);
+        if (GetHash(group) == hash && KeyEqual(group, key_buffer)) {
+            return group;
+        }
+    }
+}
+
+u64 AggregateHashTable::NormalizeKey(const Vector<SharedPtr<ColumnVector>> &key_columns,
+                                     SizeT row_idx,
+                                     char *key_buffer,
+                                     Vector<String> &varchar_buffers,
+                                     bool with_hash) const {
+    std::memset(key_buffer, 0, key_size_);
+    u64 hash = 0;
+    SizeT key_count = key_types_.size();
+    for (SizeT key_idx = 0; key_idx < key_count; ++key_idx) {
+        const ColumnVector &column = *key_columns[key_idx];
+        SizeT idx = column.vector_type() == ColumnVectorType::kConstant ? 0 : row_idx;
+        char *slot = key_buffer + key_offsets_[key_idx] - HASH_SIZE;
+        if (!column.nulls_ptr_->IsTrue(idx)) {
+            // NULL keys form one group, the slot stays zero.
+            if (with_hash) {
+                hash = HashCombine(hash, NULL_KEY_HASH);
+            }
+            continue;
+        }
+        slot[0] = 1;
+        switch (key_types_[key_idx]->type()) {
+            case LogicalType::kBoolean: {
+                slot[1] = column.buffer_->GetCompactBit(idx) ? 1 : 0;
+                if (with_hash) {
+                    hash = HashCombine(hash, HashMix(slot[1] + 1));
+                }
+                break;
+            }
+            case LogicalType::kVarchar: {
+                const VarcharT &varchar = reinterpret_cast<const VarcharT *>(column.data())[idx];
+                const char *data = nullptr;
+                if (varchar.IsInlined()) {
+                    data = varchar.short_.data_;
+                } else {
+                    String &buffer = varchar_buffers[key_idx];
+                    buffer.resize(varchar.length_);
+                    column.buffer_->fix_heap_mgr_->ReadFromHeap(buffer.data(), varchar.vector_.chunk_id_, varchar.vector_.chunk_offset_, varchar.length_);
+                    data = buffer.data();
+                }
+                WriteVarchar(slot, varchar.length_, data);
+                if (with_hash) {
+                    hash = HashCombine(hash, HashBytes(data, varchar.length_));
+                }
+                break;
             }
+            default: {
+                SizeT type_size = column.data_type_size_;
+                std::memcpy(slot + 1, column.data() + idx * type_size, type_size);
+                NormalizeKeyBytes(key_types_[key_idx]->type(), slot + 1);
+                if (with_hash) {
+                    hash = HashCombine(hash, HashBytes(slot + 1, type_size));
+                }
+                break;
+            }
+        }
+    }
+    return HashMix(hash);
+}
+
+bool AggregateHashTable::KeyEqual(const_ptr_t group, const char *key_buffer) const {
+    const char *group_key = group + HASH_SIZE;
+    if (!has_varchar_key_) {
+        // All keys are fixed width and normalized, compare them at once.
+        return std::memcmp(group_key, key_buffer, key_size_) == 0;
+    }
+    SizeT key_count = key_types_.size();
+    for (SizeT key_idx = 0; key_idx < key_count; ++key_idx) {
+        SizeT offset = key_offsets_[key_idx] - HASH_SIZE;
+        SizeT slot_end = key_idx + 1 < key_count ? key_offsets_[key_idx + 1] - HASH_SIZE : key_size_;
+        const char *left = group_key + offset;
+        const char *right = key_buffer + offset;
+        if (key_types_[key_idx]->type() != LogicalType::kVarchar || left[0] == 0 || right[0] == 0) {
+            if (std::memcmp(left, right, slot_end - offset) != 0) {
+                return false;
+            }
+            continue;
+        }
+        u32 length = ReadVarcharLength(left);
+        if (length != ReadVarcharLength(right) || std::memcmp(ReadVarcharPtr(left), ReadVarcharPtr(right), length) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
 
-            DataType &data_type = types_[column_id];
-            if (data_type.type() == kMixed) {
-                // Only float/boolean/integer/string can be built as hash key. Array/Tuple will be treated as null
-                RecoverableError(Status::NotSupport("Attempt to construct hash key for heterogeneous type"));
+ptr_t AggregateHashTable::CreateGroup(u64 hash, const char *key_buffer) {
+    if (group_count_ == row_pages_.size() * ROWS_PER_PAGE) {
+        row_pages_.emplace_back(MakeUnique<char[]>(ROWS_PER_PAGE * row_size_));
+    }
+    ptr_t group = GetGroup(group_count_);
+    std::memcpy(group, &hash, HASH_SIZE);
+    std::memcpy(group + HASH_SIZE, key_buffer, key_size_);
+    if (has_varchar_key_) {
+        // The key points to the input column, copy it into the arena of the table.
+        for (SizeT key_idx = 0; key_idx < key_types_.size(); ++key_idx) {
+            char *slot = group + key_offsets_[key_idx];
+            if (key_types_[key_idx]->type() != LogicalType::kVarchar || slot[0] == 0) {
+                continue;
             }
+            u32 length = ReadVarcharLength(slot);
+            char *data = AllocateString(length);
+            std::memcpy(data, ReadVarcharPtr(slot), length);
+            WriteVarchar(slot, length, data);
+        }
+    }
+    ++group_count_;
+    return group;
+}
+
+void AggregateHashTable::CopyVarcharState(VarcharT &value, const ColumnVector &input_column) {
+    if (value.IsInlined()) {
+        return;
+    }
+    char *data = AllocateString(value.length_);
+    input_column.buffer_->fix_heap_mgr_->ReadFromHeap(data, value.vector_.chunk_id_, value.vector_.chunk_offset_, value.length_);
+    // the arena pointer takes the place of the chunk id and offset
+    std::memcpy(reinterpret_cast<char *>(&value.vector_) + VARCHAR_PREFIX_LEN, &data, sizeof(data));
+}
 
-            if (data_type.type() == kVarchar) {
-                VarcharT *vchar_ptr = &((VarcharT *)(columns[column_id]->data_ptr_))[row_id];
-                if (vchar_ptr->IsInlined()) {
-                    std::memcpy(target_ptr, vchar_ptr->prefix, vchar_ptr->length);
+std::string_view AggregateHashTable::GetVarcharState(const VarcharT &value) {
+    if (value.IsInlined()) {
+        return {value.short_.data_, static_cast<SizeT>(value.length_)};
+    }
+    const char *data;
+    std::memcpy(&data, reinterpret_cast<const char *>(&value.vector_) + VARCHAR_PREFIX_LEN, sizeof(data));
+    return {data, static_cast<SizeT>(value.length_)};
+}
+
+void AggregateHashTable::Grow() {
+    slots_.assign(slots_.size() * 2, 0);
+    slot_mask_ = slots_.size() - 1;
+    // Hashes are stored in the group rows, no key needs to be hashed again.
+    for (SizeT group_idx = 0; group_idx < group_count_; ++group_idx) {
+        u64 hash = GetHash(GetGroup(group_idx));
+        SizeT slot_idx = hash & slot_mask_;
+        while (slots_[slot_idx] != 0) {
+            slot_idx = (slot_idx + 1) & slot_mask_;
+        }
+        slots_[slot_idx] = (hash & SALT_MASK) | (group_idx + 1);
+    }
+}
+
+char *AggregateHashTable::AllocateString(SizeT length) {
+    if (string_page_offset_ + length > string_page_capacity_) {
+        string_page_capacity_ = std::max(STRING_PAGE_SIZE, length);
+        string_pages_.emplace_back(MakeUnique<char[]>(string_page_capacity_));
+        string_page_offset_ = 0;
+    }
+    char *data = string_pages_.back().get() + string_page_offset_;
+    string_page_offset_ += length;
+    return data;
+}
+
+void AggregateHashTable::AppendKeys(const Vector<ptr_t> &groups, const Vector<SharedPtr<ColumnVector>> &output_columns) const {
+    SizeT key_count = key_types_.size();
+    for (SizeT key_idx = 0; key_idx < key_count; ++key_idx) {
+        ColumnVector &output_column = *output_columns[key_idx];
+        const DataType &key_type = *key_types_[key_idx];
+        String zero_value(key_type.Size(), '\0');
+        for (const_ptr_t group : groups) {
+            const char *slot = group + key_offsets_[key_idx];
+            SizeT output_row = output_column.Size();
+            if (slot[0] == 0) {
+                if (key_type.type() == LogicalType::kVarchar) {
+                    output_column.AppendValue(Value::MakeVarchar(""));
                 } else {
-                    std::memcpy(target_ptr, vchar_ptr->ptr, vchar_ptr->length);
+                    output_column.AppendByPtr(zero_value.data());
+                }
+                output_column.nulls_ptr_->SetFalse(output_row);
+                continue;
+            }
+            switch (key_type.type()) {
+                case LogicalType::kBoolean: {
+                    BooleanT value = slot[1] != 0;
+                    output_column.AppendByPtr(reinterpret_cast<const_ptr_t>(&value));
+                    break;
+                }
+                case LogicalType::kVarchar: {
+                    output_column.AppendValue(Value::MakeVarchar(ReadVarcharPtr(slot), ReadVarcharLength(slot)));
+                    break;
+                }
+                default: {
+                    output_column.AppendByPtr(slot + 1);
+                    break;
                 }
-                offset += (vchar_ptr->length + 1);
-            } else {
-                SizeT type_size = types_[column_id].Size();
-                std::memcpy(target_ptr, columns[column_id]->data_ptr_ + type_size * row_id, type_size);
-                offset += (type_size + 1);
             }
         }
+    }
+}
 
-        String key(hash_key.get(), key_size_);
-        hash_table_[key][block_id].emplace_back(row_id);
+bool AggregateHashTable::SupportKeyType(const DataType &data_type) {
+    switch (data_type.type()) {
+        case LogicalType::kBoolean:
+        case LogicalType::kTinyInt:
+        case LogicalType::kSmallInt:
+        case LogicalType::kInteger:
+        case LogicalType::kBigInt:
+        case LogicalType::kHugeInt:
+        case LogicalType::kFloat:
+        case LogicalType::kDouble:
+        case LogicalType::kDecimal:
+        case LogicalType::kVarchar:
+        case LogicalType::kDate:
+        case LogicalType::kTime:
+        case LogicalType::kDateTime:
+        case LogicalType::kTimestamp: {
+            return true;
+        }
+        default: {
+            return false;
+        }
     }
 }
 
 } // namespace infinity
-#endif
\ No newline at end of file
@@ -23,18 +23,102 @@ import data_type;
 
 namespace infinity {
 
-export class HashTable {
+// Group by hash table with open addressing.
+//
+// Every group is stored as a fixed size row:
+// | hash (8 bytes) | key 0 | key 1 | ... | padding | state 0 | state 1 | ... |
+// A key slot is a valid byte followed by the value bytes. Varchar values are normalized into
+// {u32 length, pointer} which points to the string arena of the table, so that all keys have a fixed width.
+// Aggregate states are kept inline after the keys, aligned to 8 bytes.
+export class AggregateHashTable {
 public:
-    void Init(const Vector<DataType> &types);
+    AggregateHashTable(Vector<SharedPtr<DataType>> key_types, const Vector<SizeT> &state_sizes);
 
-    void Append(const Vector<SharedPtr<ColumnVector>> &columns, SizeT block_id, SizeT row_count);
+    // Find the group of every input row, create the group if it doesn't exist.
+    // group_ptrs[i] is the group row of input row i, the rows of created groups are appended to new_groups.
+    void FindOrCreateGroups(const Vector<SharedPtr<ColumnVector>> &key_columns, SizeT row_count, Vector<ptr_t> &group_ptrs, Vector<ptr_t> &new_groups);
 
-public:
-    Vector<DataType> types_{};
+    // Same as above, but only for the given rows whose hashes are already known, e.g. the groups emitted by another table.
+    // group_ptrs[i] is the group row of input row rows[i].
+    void FindOrCreateGroups(const Vector<SharedPtr<ColumnVector>> &key_columns,
+                            const u64 *hashes,
+                            const Vector<u32> &rows,
+                            Vector<ptr_t> &group_ptrs,
+                            Vector<ptr_t> &new_groups);
+
+    // Append the keys of the given groups to the output columns.
+    void AppendKeys(const Vector<ptr_t> &groups, const Vector<SharedPtr<ColumnVector>> &output_columns) const;
+
+    // Aggregates returning a varchar (FIRST) keep the VarcharT of their result in the state. An outline value references the
+    // heap of the input column, copy its bytes into the arena of the table so that the state outlives the input block.
+    void CopyVarcharState(VarcharT &value, const ColumnVector &input_column);
+
+    // Bytes of a varchar state stored by CopyVarcharState().
+    static std::string_view GetVarcharState(const VarcharT &value);
+
+    [[nodiscard]] inline SizeT GroupCount() const { return group_count_; }
+
+    [[nodiscard]] inline ptr_t GetGroup(SizeT group_idx) const {
+        return row_pages_[group_idx / ROWS_PER_PAGE].get() + (group_idx % ROWS_PER_PAGE) * row_size_;
+    }
+
+    [[nodiscard]] inline ptr_t GetState(ptr_t group, SizeT state_idx) const { return group + state_offsets_[state_idx]; }
+
+    [[nodiscard]] inline static u64 GetHash(const_ptr_t group) { return *reinterpret_cast<const u64 *>(group); }
+
+    // Partition of a group when groups are split into 2^partition_bits partitions by hash.
+    // The bits are taken right below the salt, so the groups of one partition still spread over all slots.
+    [[nodiscard]] inline static SizeT PartitionOf(u64 hash, SizeT partition_bits) {
+        return partition_bits == 0 ? 0 : (hash >> (SALT_SHIFT - partition_bits)) & ((1ULL << partition_bits) - 1);
+    }
+
+    [[nodiscard]] inline SizeT row_size() const { return row_size_; }
+
+    [[nodiscard]] inline SizeT SlotCount() const { return slots_.size(); }
+
+    // Check if values of the given type can be used as a group by key.
+    static bool SupportKeyType(const DataType &data_type);
+
+private:
+    // Normalize the keys of a row into key_buffer and return the hash of the keys, the hash isn't computed if with_hash is false.
+    u64 NormalizeKey(const Vector<SharedPtr<ColumnVector>> &key_columns, SizeT row_idx, char *key_buffer, Vector<String> &varchar_buffers, bool with_hash) const;
+
+    ptr_t FindOrCreateGroup(u64 hash, const char *key_buffer, Vector<ptr_t> &new_groups);
+
+    bool KeyEqual(const_ptr_t group, const char *key_buffer) const;
+
+    ptr_t CreateGroup(u64 hash, const char *key_buffer);
+
+    void Grow();
+
+    char *AllocateString(SizeT length);
+
+    static constexpr SizeT ROWS_PER_PAGE = 4096;
+    static constexpr SizeT STRING_PAGE_SIZE = 64 * 1024;
+    static constexpr SizeT SALT_SHIFT = 48;
+    static constexpr u64 SALT_MASK = 0xFFFF000000000000ULL;
+    static constexpr u64 GROUP_IDX_MASK = ~SALT_MASK;
+
+    Vector<SharedPtr<DataType>> key_types_{};
+    Vector<SizeT> key_offsets_{};
+    Vector<SizeT> state_offsets_{};
     SizeT key_size_{};
+    SizeT row_size_{};
+    bool has_varchar_key_{false};
+
+    // Group rows, pages never move so the group pointers stay valid when the table grows.
+    Vector<UniquePtr<char[]>> row_pages_{};
+    SizeT group_count_{};
+
+    // Open addressing array with linear probing. An empty slot is 0, otherwise the high 16 bits keep the
+    // high bits of the hash and the low 48 bits keep (group index + 1).
+    Vector<u64> slots_{};
+    u64 slot_mask_{};
 
-    // Key -> (block id -> row array)
-    HashMap<String, HashMap<SizeT, Vector<SizeT>>> hash_table_{};
+    // Arena of varchar keys and varchar states.
+    Vector<UniquePtr<char[]>> string_pages_{};
+    SizeT string_page_offset_{};
+    SizeT string_page_capacity_{};
 };
 
 } // namespace infinity
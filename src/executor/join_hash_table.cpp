@@ -0,0 +1,286 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+module join_hash_table;
+
+import stl;
+import data_block;
+import column_vector;
+import vector_buffer;
+import fix_heap;
+import data_type;
+import logical_type;
+import internal_types;
+import utility;
+import infinity_exception;
+import logger;
+import third_party;
+import hash_key;
+
+namespace infinity {
+
+namespace {
+
+// Return the bytes of a varchar, only outline varchar needs to be copied into the scratch buffer.
+inline std::string_view GetVarcharView(const ColumnVector &column, SizeT row_idx, String &scratch) {
+    const VarcharT &varchar = reinterpret_cast<const VarcharT *>(column.data())[row_idx];
+    if (varchar.IsInlined()) {
+        return {varchar.short_.data_, static_cast<SizeT>(varchar.length_)};
+    }
+    scratch.resize(varchar.length_);
+    column.buffer_->fix_heap_mgr_->ReadFromHeap(scratch.data(), varchar.vector_.chunk_id_, varchar.vector_.chunk_offset_, varchar.length_);
+    return {scratch.data(), scratch.size()};
+}
+
+inline SizeT RowIndex(const ColumnVector &column, SizeT row_idx) { return column.vector_type() == ColumnVectorType::kConstant ? 0 : row_idx; }
+
+} // namespace
+
+JoinHashTable::JoinHashTable(const Vector<UniquePtr<DataBlock>> *build_blocks, Vector<SizeT> build_key_ids, SizeT radix_bits)
+    : build_blocks_(build_blocks), build_key_ids_(std::move(build_key_ids)), radix_bits_(radix_bits) {}
+
+void JoinHashTable::Build(SizeT worker_count) {
+    Vector<JoinHashEntry> null_key_rows;
+    Vector<Vector<JoinHashEntry>> partitioned_rows = PartitionRows(*build_blocks_, build_key_ids_, radix_bits_, worker_count, null_key_rows);
+
+    SizeT partition_count = partitioned_rows.size();
+    partitions_.resize(partition_count);
+    row_count_ = 0;
+    for (SizeT partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+        row_count_ += partitioned_rows[partition_idx].size();
+        partitions_[partition_idx].entries_ = std::move(partitioned_rows[partition_idx]);
+    }
+
+    Utility::RunParallel(partition_count, worker_count, [&](SizeT partition_idx) { BuildPartition(partitions_[partition_idx]); });
+}
+
+void JoinHashTable::BuildPartition(JoinHashPartition &partition) {
+    SizeT entry_count = partition.entries_.size();
+    if (entry_count == 0) {
+        return;
+    }
+    // Keep the load factor under 0.5 so that most chains have a single entry.
+    SizeT bucket_count = Utility::NextPowerOfTwo(entry_count * 2);
+    partition.bucket_mask_ = bucket_count - 1;
+    partition.buckets_.assign(bucket_count, 0);
+    partition.next_.resize(entry_count);
+    for (SizeT entry_idx = 0; entry_idx < entry_count; ++entry_idx) {
+        SizeT bucket_idx = partition.entries_[entry_idx].hash_ & partition.bucket_mask_;
+        partition.next_[entry_idx] = partition.buckets_[bucket_idx];
+        partition.buckets_[bucket_idx] = entry_idx + 1;
+    }
+}
+
+SizeT JoinHashTable::ChooseRadixBits(SizeT build_row_count) {
+    SizeT radix_bits = 0;
+    while (radix_bits < JOIN_MAX_RADIX_BITS && (build_row_count >> radix_bits) > JOIN_PARTITION_TARGET_ROWS) {
+        ++radix_bits;
+    }
+    return radix_bits;
+}
+
+void JoinHashTable::HashKeys(const DataBlock *block, const Vector<SizeT> &key_ids, Vector<u64> &hashes, Vector<bool> &null_rows) {
+    SizeT row_count = block->row_count();
+    hashes.assign(row_count, 0);
+    null_rows.assign(row_count, false);
+    String scratch;
+    for (SizeT key_id : key_ids) {
+        const ColumnVector &column = *block->column_vectors[key_id];
+        const DataType &data_type = *column.data_type();
+        const SizeT type_size = column.data_type_size_;
+        for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+            SizeT col_row_idx = RowIndex(column, row_idx);
+            if (!column.nulls_ptr_->IsTrue(col_row_idx)) {
+                null_rows[row_idx] = true;
+                continue;
+            }
+            u64 value_hash = 0;
+            switch (data_type.type()) {
+                case LogicalType::kBoolean: {
+                    value_hash = HashMix(column.buffer_->GetCompactBit(col_row_idx) ? 1 : 2);
+                    break;
+                }
+                case LogicalType::kVarchar: {
+                    std::string_view sv = GetVarcharView(column, col_row_idx, scratch);
+                    value_hash = HashBytes(sv.data(), sv.size());
+                    break;
+                }
+                case LogicalType::kFloat: {
+                    FloatT value = NormalizeFloatKey(reinterpret_cast<const FloatT *>(column.data())[col_row_idx]);
+                    value_hash = HashBytes(reinterpret_cast<const char *>(&value), sizeof(value));
+                    break;
+                }
+                case LogicalType::kDouble: {
+                    DoubleT value = NormalizeFloatKey(reinterpret_cast<const DoubleT *>(column.data())[col_row_idx]);
+                    value_hash = HashBytes(reinterpret_cast<const char *>(&value), sizeof(value));
+                    break;
+                }
+                default: {
+                    value_hash = HashBytes(column.data() + col_row_idx * type_size, type_size);
+                    break;
+                }
+            }
+            hashes[row_idx] = HashCombine(hashes[row_idx], value_hash);
+        }
+    }
+}
+
+bool JoinHashTable::KeysEqual(const DataBlock *left,
+                              SizeT left_row,
+                              const Vector<SizeT> &left_key_ids,
+                              const DataBlock *right,
+                              SizeT right_row,
+                              const Vector<SizeT> &right_key_ids) {
+    SizeT key_count = left_key_ids.size();
+    for (SizeT key_idx = 0; key_idx < key_count; ++key_idx) {
+        const ColumnVector &left_column = *left->column_vectors[left_key_ids[key_idx]];
+        const ColumnVector &right_column = *right->column_vectors[right_key_ids[key_idx]];
+        SizeT left_idx = RowIndex(left_column, left_row);
+        SizeT right_idx = RowIndex(right_column, right_row);
+        switch (left_column.data_type()->type()) {
+            case LogicalType::kBoolean: {
+                if (left_column.buffer_->GetCompactBit(left_idx) != right_column.buffer_->GetCompactBit(right_idx)) {
+                    return false;
+                }
+                break;
+            }
+            case LogicalType::kVarchar: {
+                const VarcharT &left_varchar = reinterpret_cast<const VarcharT *>(left_column.data())[left_idx];
+                const VarcharT &right_varchar = reinterpret_cast<const VarcharT *>(right_column.data())[right_idx];
+                if (left_varchar.length_ != right_varchar.length_) {
+                    return false;
+                }
+                String left_scratch, right_scratch;
+                if (GetVarcharView(left_column, left_idx, left_scratch) != GetVarcharView(right_column, right_idx, right_scratch)) {
+                    return false;
+                }
+                break;
+            }
+            case LogicalType::kFloat: {
+                if (!FloatKeyEqual(reinterpret_cast<const FloatT *>(left_column.data())[left_idx],
+                                   reinterpret_cast<const FloatT *>(right_column.data())[right_idx])) {
+                    return false;
+                }
+                break;
+            }
+            case LogicalType::kDouble: {
+                if (!FloatKeyEqual(reinterpret_cast<const DoubleT *>(left_column.data())[left_idx],
+                                   reinterpret_cast<const DoubleT *>(right_column.data())[right_idx])) {
+                    return false;
+                }
+                break;
+            }
+            default: {
+                SizeT type_size = left_column.data_type_size_;
+                if (std::memcmp(left_column.data() + left_idx * type_size, right_column.data() + right_idx * type_size, type_size) != 0) {
+                    return false;
+                }
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+Vector<Vector<JoinHashEntry>> JoinHashTable::PartitionRows(const Vector<UniquePtr<DataBlock>> &blocks,
+                                                           const Vector<SizeT> &key_ids,
+                                                           SizeT radix_bits,
+                                                           SizeT worker_count,
+                                                           Vector<JoinHashEntry> &null_key_rows) {
+    SizeT partition_count = 1ul << radix_bits;
+    SizeT block_count = blocks.size();
+
+    // Pass 1: hash every block and count rows per (block, partition).
+    Vector<Vector<u64>> block_hashes(block_count);
+    Vector<Vector<bool>> block_null_rows(block_count);
+    Vector<Vector<u32>> histograms(block_count, Vector<u32>(partition_count, 0));
+    Utility::RunParallel(block_count, worker_count, [&](SizeT block_idx) {
+        HashKeys(blocks[block_idx].get(), key_ids, block_hashes[block_idx], block_null_rows[block_idx]);
+        Vector<u32> &histogram = histograms[block_idx];
+        const Vector<u64> &hashes = block_hashes[block_idx];
+        const Vector<bool> &null_rows = block_null_rows[block_idx];
+        for (SizeT row_idx = 0; row_idx < hashes.size(); ++row_idx) {
+            if (!null_rows[row_idx]) {
+                ++histogram[PartitionOf(hashes[row_idx], radix_bits)];
+            }
+        }
+    });
+
+    // Exclusive prefix sum over blocks gives each block a private write range inside every partition.
+    Vector<Vector<JoinHashEntry>> partitions(partition_count);
+    for (SizeT partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+        u32 offset = 0;
+        for (SizeT block_idx = 0; block_idx < block_count; ++block_idx) {
+            u32 count = histograms[block_idx][partition_idx];
+            histograms[block_idx][partition_idx] = offset;
+            offset += count;
+        }
+        partitions[partition_idx].resize(offset);
+    }
+
+    // Pass 2: scatter.
+    Utility::RunParallel(block_count, worker_count, [&](SizeT block_idx) {
+        Vector<u32> &write_offsets = histograms[block_idx];
+        const Vector<u64> &hashes = block_hashes[block_idx];
+        const Vector<bool> &null_rows = block_null_rows[block_idx];
+        for (SizeT row_idx = 0; row_idx < hashes.size(); ++row_idx) {
+            if (null_rows[row_idx]) {
+                continue;
+            }
+            SizeT partition_idx = PartitionOf(hashes[row_idx], radix_bits);
+            partitions[partition_idx][write_offsets[partition_idx]++] =
+                JoinHashEntry{hashes[row_idx], static_cast<u32>(block_idx), static_cast<u32>(row_idx)};
+        }
+    });
+
+    for (SizeT block_idx = 0; block_idx < block_count; ++block_idx) {
+        const Vector<bool> &null_rows = block_null_rows[block_idx];
+        for (SizeT row_idx = 0; row_idx < null_rows.size(); ++row_idx) {
+            if (null_rows[row_idx]) {
+                null_key_rows.push_back(JoinHashEntry{0, static_cast<u32>(block_idx), static_cast<u32>(row_idx)});
+            }
+        }
+    }
+    return partitions;
+}
+
+bool JoinHashTable::SupportKeyType(const DataType &data_type) {
+    switch (data_type.type()) {
+        case LogicalType::kBoolean:
+        case LogicalType::kTinyInt:
+        case LogicalType::kSmallInt:
+        case LogicalType::kInteger:
+        case LogicalType::kBigInt:
+        case LogicalType::kHugeInt:
+        case LogicalType::kDecimal:
+        case LogicalType::kFloat:
+        case LogicalType::kDouble:
+        case LogicalType::kVarchar:
+        case LogicalType::kDate:
+        case LogicalType::kTime:
+        case LogicalType::kDateTime:
+        case LogicalType::kTimestamp:
+        case LogicalType::kUuid:
+        case LogicalType::kRowID: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+} // namespace infinity
@@ -0,0 +1,124 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module join_hash_table;
+
+import stl;
+import data_block;
+import data_type;
+
+namespace infinity {
+
+// Build side rows are spread over 2^radix_bits partitions. A partition should fit in L2 cache,
+// 16K entries * 16 bytes = 256KB.
+export constexpr SizeT JOIN_PARTITION_TARGET_ROWS = 16 * 1024;
+export constexpr SizeT JOIN_MAX_RADIX_BITS = 10;
+
+// A row of the build or probe side together with the hash of its join key.
+export struct JoinHashEntry {
+    u64 hash_{};
+    u32 block_idx_{};
+    u32 row_idx_{};
+};
+
+// Entries of one radix partition are stored contiguously and chained by bucket.
+// buckets_ and next_ keep (entry index + 1), 0 marks the end of a chain.
+export struct JoinHashPartition {
+    Vector<JoinHashEntry> entries_{};
+    Vector<u32> buckets_{};
+    Vector<u32> next_{};
+    u64 bucket_mask_{};
+};
+
+export class JoinHashTable {
+public:
+    JoinHashTable(const Vector<UniquePtr<DataBlock>> *build_blocks, Vector<SizeT> build_key_ids, SizeT radix_bits);
+
+    // Partition the build side and construct the bucket chains of each partition.
+    void Build(SizeT worker_count);
+
+    // Call func(const JoinHashEntry &) for every build row whose key equals the key of the probe row.
+    // func returns false to stop the scan. Returns the number of visited matches.
+    template <typename Func>
+    SizeT ForEachMatch(const JoinHashEntry &probe_entry, const DataBlock *probe_block, const Vector<SizeT> &probe_key_ids, Func &&func) const {
+        const JoinHashPartition &partition = partitions_[PartitionOf(probe_entry.hash_, radix_bits_)];
+        if (partition.entries_.empty()) {
+            return 0;
+        }
+        SizeT match_count = 0;
+        for (u32 cur = partition.buckets_[probe_entry.hash_ & partition.bucket_mask_]; cur != 0; cur = partition.next_[cur - 1]) {
+            const JoinHashEntry &build_entry = partition.entries_[cur - 1];
+            if (build_entry.hash_ != probe_entry.hash_) {
+                continue;
+            }
+            if (!KeysEqual((*build_blocks_)[build_entry.block_idx_].get(),
+                           build_entry.row_idx_,
+                           build_key_ids_,
+                           probe_block,
+                           probe_entry.row_idx_,
+                           probe_key_ids)) {
+                continue;
+            }
+            ++match_count;
+            if (!func(build_entry)) {
+                break;
+            }
+        }
+        return match_count;
+    }
+
+    [[nodiscard]] inline SizeT radix_bits() const { return radix_bits_; }
+
+    [[nodiscard]] inline SizeT PartitionCount() const { return partitions_.size(); }
+
+    [[nodiscard]] inline SizeT RowCount() const { return row_count_; }
+
+    [[nodiscard]] inline const JoinHashPartition &GetPartition(SizeT partition_idx) const { return partitions_[partition_idx]; }
+
+public:
+    static inline SizeT PartitionOf(u64 hash, SizeT radix_bits) { return radix_bits == 0 ? 0 : hash >> (64 - radix_bits); }
+
+    // Pick the number of radix bits so that a build partition holds about JOIN_PARTITION_TARGET_ROWS rows.
+    static SizeT ChooseRadixBits(SizeT build_row_count);
+
+    // Hash the key columns of a data block, rows with any NULL key are marked in null_rows.
+    static void HashKeys(const DataBlock *block, const Vector<SizeT> &key_ids, Vector<u64> &hashes, Vector<bool> &null_rows);
+
+    static bool
+    KeysEqual(const DataBlock *left, SizeT left_row, const Vector<SizeT> &left_key_ids, const DataBlock *right, SizeT right_row, const Vector<SizeT> &right_key_ids);
+
+    // Scatter the rows of blocks into 2^radix_bits partitions by the high bits of their key hash.
+    // Rows with NULL key can never match and are collected into null_key_rows.
+    static Vector<Vector<JoinHashEntry>> PartitionRows(const Vector<UniquePtr<DataBlock>> &blocks,
+                                                       const Vector<SizeT> &key_ids,
+                                                       SizeT radix_bits,
+                                                       SizeT worker_count,
+                                                       Vector<JoinHashEntry> &null_key_rows);
+
+    // Check if values of the given type can be used as a hash join key.
+    static bool SupportKeyType(const DataType &data_type);
+
+private:
+    static void BuildPartition(JoinHashPartition &partition);
+
+    const Vector<UniquePtr<DataBlock>> *build_blocks_{};
+    Vector<SizeT> build_key_ids_{};
+    SizeT radix_bits_{};
+    SizeT row_count_{};
+    Vector<JoinHashPartition> partitions_{};
+};
+
+} // namespace infinity
@@ -0,0 +1,107 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+module join_util;
+
+import stl;
+import base_expression;
+import function_expression;
+import reference_expression;
+import expression_type;
+import data_block;
+import column_vector;
+import data_type;
+import logical_type;
+import value;
+
+namespace infinity {
+
+bool ExtractEquiJoinKeys(const Vector<SharedPtr<BaseExpression>> &conditions,
+                         SizeT left_column_count,
+                         Vector<SizeT> &left_key_ids,
+                         Vector<SizeT> &right_key_ids) {
+    left_key_ids.clear();
+    right_key_ids.clear();
+    for (const auto &condition : conditions) {
+        if (condition->type() != ExpressionType::kFunction) {
+            return false;
+        }
+        auto *function_expr = static_cast<FunctionExpression *>(condition.get());
+        if (function_expr->ScalarFunctionName() != "=" || function_expr->arguments().size() != 2) {
+            return false;
+        }
+        const auto &first = function_expr->arguments()[0];
+        const auto &second = function_expr->arguments()[1];
+        if (first->type() != ExpressionType::kReference || second->type() != ExpressionType::kReference) {
+            return false;
+        }
+        SizeT first_idx = static_cast<ReferenceExpression *>(first.get())->column_index();
+        SizeT second_idx = static_cast<ReferenceExpression *>(second.get())->column_index();
+        if (first_idx < left_column_count && second_idx >= left_column_count) {
+            left_key_ids.emplace_back(first_idx);
+            right_key_ids.emplace_back(second_idx - left_column_count);
+        } else if (second_idx < left_column_count && first_idx >= left_column_count) {
+            left_key_ids.emplace_back(second_idx);
+            right_key_ids.emplace_back(first_idx - left_column_count);
+        } else {
+            return false;
+        }
+    }
+    return !left_key_ids.empty();
+}
+
+void AppendJoinOutputRow(Vector<UniquePtr<DataBlock>> &output_blocks,
+                         const Vector<SharedPtr<DataType>> &output_types,
+                         const DataBlock *left_block,
+                         SizeT left_row,
+                         const DataBlock *right_block,
+                         SizeT right_row) {
+    if (output_blocks.empty() || output_blocks.back()->column_vectors[0]->Size() >= output_blocks.back()->capacity()) {
+        if (!output_blocks.empty()) {
+            output_blocks.back()->Finalize();
+        }
+        auto output_block = DataBlock::MakeUniquePtr();
+        output_block->Init(output_types);
+        output_blocks.emplace_back(std::move(output_block));
+    }
+    DataBlock *output_block = output_blocks.back().get();
+    SizeT left_column_count = left_block->column_count();
+    SizeT output_column_count = output_block->column_count();
+    for (SizeT column_idx = 0; column_idx < output_column_count; ++column_idx) {
+        ColumnVector &output_column = *output_block->column_vectors[column_idx];
+        SizeT output_row = output_column.Size();
+        if (column_idx >= left_column_count && right_block == nullptr) {
+            // The right side is padded with NULL.
+            if (output_column.data_type()->type() == LogicalType::kVarchar) {
+                output_column.AppendValue(Value::MakeVarchar(""));
+            } else {
+                output_column.AppendValue(Value::MakeValue(*output_column.data_type()));
+            }
+            output_column.nulls_ptr_->SetFalse(output_row);
+            continue;
+        }
+        const DataBlock *input_block = column_idx < left_column_count ? left_block : right_block;
+        SizeT input_row = column_idx < left_column_count ? left_row : right_row;
+        const ColumnVector &input_column = *input_block->column_vectors[column_idx < left_column_count ? column_idx : column_idx - left_column_count];
+        SizeT input_idx = input_column.vector_type() == ColumnVectorType::kConstant ? 0 : input_row;
+        output_column.AppendWith(input_column, input_idx, 1);
+        if (!input_column.nulls_ptr_->IsTrue(input_idx)) {
+            output_column.nulls_ptr_->SetFalse(output_row);
+        }
+    }
+}
+
+} // namespace infinity
@@ -0,0 +1,42 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module join_util;
+
+import stl;
+import base_expression;
+import data_block;
+import data_type;
+
+namespace infinity {
+
+// Split the equality conditions of a join into column ids of the left side and the right side.
+// Returns false if any condition isn't an equality between a left column and a right column.
+export bool ExtractEquiJoinKeys(const Vector<SharedPtr<BaseExpression>> &conditions,
+                                SizeT left_column_count,
+                                Vector<SizeT> &left_key_ids,
+                                Vector<SizeT> &right_key_ids);
+
+// Append a joined row to the last output block, a new block is started when it is full.
+// The right side is padded with NULL when right_block is nullptr.
+export void AppendJoinOutputRow(Vector<UniquePtr<DataBlock>> &output_blocks,
+                                const Vector<SharedPtr<DataType>> &output_types,
+                                const DataBlock *left_block,
+                                SizeT left_row,
+                                const DataBlock *right_block,
+                                SizeT right_row);
+
+} // namespace infinity
@@ -31,6 +31,7 @@ import data_block;
 import utility;
 import logger;
 import column_vector;
+import value;
 import third_party;
 import infinity_exception;
 import default_values;
@@ -38,10 +39,14 @@ import default_values;
 import expression_state;
 import expression_evaluator;
 import aggregate_expression;
+import aggregate_function;
+import hash_table;
+import base_expression;
 import status;
 import logical_type;
 import internal_types;
 import column_def;
+import embedding_info;
 
 namespace infinity {
 
@@ -51,11 +56,6 @@ bool PhysicalAggregate::Execute(QueryContext *query_context, OperatorState *oper
     OperatorState *prev_op_state = operator_state->prev_op_state_;
     auto *aggregate_operator_state = static_cast<AggregateOperatorState *>(operator_state);
 
-    // 1. Execute group-by expressions to generate unique key.
-    // ExpressionEvaluator groupby_executor;
-    // groupby_executor.Init(groups_);
-
-    Vector<SharedPtr<ColumnDef>> groupby_columns;
     SizeT group_count = groups_.size();
 
     if (group_count == 0) {
@@ -71,569 +71,170 @@ bool PhysicalAggregate::Execute(QueryContext *query_context, OperatorState *oper
         }
         return result;
     }
-#if 0
-    groupby_columns.reserve(group_count);
-
-    Vector<DataType> types;
-    types.reserve(group_count);
-
-    for(i64 idx = 0; auto& expr: groups_) {
-        SharedPtr<ColumnDef> col_def = MakeShared<ColumnDef>(idx,
-                                                             MakeShared<DataType>(expr->Type()),
-                                                             expr->Name(),
-                                                             std::set<ConstraintType>());
-        groupby_columns.emplace_back(col_def);
-        types.emplace_back(expr->Type());
-        ++ idx;
-    }
-
-    SharedPtr<TableDef> groupby_tabledef = TableDef::Make(MakeShared<String>("default_db"), MakeShared<String>("groupby"), groupby_columns);
-    SharedPtr<DataTable> groupby_table = DataTable::Make(groupby_tabledef, TableType::kIntermediate);
-
-    groupby_executor.Execute(input_table_, groupby_table);
-
-    // 2. Use the unique key to get the row list of the same key.
-    hash_table_.Init(types);
-
-    SizeT block_count = groupby_table->DataBlockCount();
-    for(SizeT block_id = 0; block_id < block_count; ++ block_id) {
-        const SharedPtr<DataBlock>& block_ptr = groupby_table->GetDataBlockById(block_id);
-        hash_table_.Append(block_ptr->column_vectors, block_id, block_ptr->row_count());
-    }
 
-    // 3. forlop each aggregates function on each group by bucket, to calculate the result according to the row list
-    SharedPtr<DataTable> output_groupby_table = DataTable::Make(groupby_tabledef, TableType::kIntermediate);
-    GenerateGroupByResult(groupby_table, output_groupby_table);
-
-
-    // input table after group by, each block belong to one group. This is the prerequisites to execute aggregate function.
-    SharedPtr<DataTable> grouped_input_table;
-    {
-        SizeT column_count = input_table_->ColumnCount();
-        Vector<SharedPtr<ColumnDef>> columns;
-        columns.reserve(column_count);
-        for(SizeT idx = 0; idx < column_count; ++ idx) {
-            SharedPtr<DataType> col_type = input_table_->GetColumnTypeById(idx);
-            String col_name = input_table_->GetColumnNameById(idx);
-
-            SharedPtr<ColumnDef> col_def = MakeShared<ColumnDef>(idx, col_type, col_name, std::set<ConstraintType>());
-            columns.emplace_back(col_def);
-        }
-
-        SharedPtr<TableDef> table_def = TableDef::Make(MakeShared<String>("default_db"), MakeShared<String>("grouped_input"), columns);
-
-        grouped_input_table = DataTable::Make(table_def, TableType::kGroupBy);
+    // Aggregate with group by expression
+    // e.g. SELECT a, count(b) FROM table GROUP BY a;
+    auto result = GroupByExecute(prev_op_state->data_block_array_, aggregate_operator_state, prev_op_state->Complete());
+    prev_op_state->data_block_array_.clear();
+    if (prev_op_state->Complete()) {
+        aggregate_operator_state->SetComplete();
     }
-    GroupByInputTable(input_table_, grouped_input_table);
+    return result;
+}
 
-    // generate output aggregate table
+bool PhysicalAggregate::GroupByExecute(const Vector<UniquePtr<DataBlock>> &input_blocks,
+                                       AggregateOperatorState *aggregate_operator_state,
+                                       bool task_completed) {
+    SizeT group_count = groups_.size();
     SizeT aggregates_count = aggregates_.size();
-    if(aggregates_count > 0) {
-        SharedPtr<DataTable> output_aggregate_table{};
-
-        // Prepare the output table columns
-        Vector<SharedPtr<ColumnDef>> aggregate_columns;
-        aggregate_columns.reserve(aggregates_count);
-
-        // Prepare the expression states
-        Vector<SharedPtr<ExpressionState>> expr_states;
-        expr_states.reserve(aggregates_.size());
 
-        // Prepare the output block
-        Vector<SharedPtr<DataType>> output_types;
-        output_types.reserve(aggregates_count);
-
-        for(i64 idx = 0; auto& expr: aggregates_) {
-            // expression state
-            expr_states.emplace_back(ExpressionState::CreateState(expr));
-            SharedPtr<DataType> data_type = MakeShared<DataType>(expr->Type());
-
-            // column definition
-            SharedPtr<ColumnDef> col_def = MakeShared<ColumnDef>(idx,
-                                                                 data_type,
-                                                                 expr->Name(),
-                                                                 std::set<ConstraintType>());
-            aggregate_columns.emplace_back(col_def);
+    if (aggregate_operator_state->hash_table_.get() == nullptr) {
+        aggregate_operator_state->hash_table_ = CreateHashTable();
+    }
+    AggregateHashTable *hash_table = aggregate_operator_state->hash_table_.get();
 
-            // for output block
-            output_types.emplace_back(data_type);
+    // Prepare the expression states of group by keys and aggregate arguments
+    Vector<SharedPtr<ExpressionState>> group_states;
+    group_states.reserve(group_count);
+    for (auto &group_expr : groups_) {
+        group_states.emplace_back(ExpressionState::CreateState(group_expr));
+    }
+    Vector<SharedPtr<ExpressionState>> argument_states;
+    argument_states.reserve(aggregates_count);
+    for (auto &expr : aggregates_) {
+        argument_states.emplace_back(ExpressionState::CreateState(expr->arguments()[0]));
+    }
 
-            ++ idx;
+    Vector<ptr_t> group_ptrs;
+    Vector<ptr_t> new_groups;
+    Vector<ptr_t> state_ptrs;
+    for (const auto &input_block : input_blocks) {
+        SizeT row_count = input_block->row_count();
+        if (row_count == 0) {
+            continue;
         }
-
-        // output aggregate table definition
-        SharedPtr<TableDef> aggregate_tabledef = TableDef::Make(MakeShared<String>("default_db"),
-                                                                MakeShared<String>("aggregate"),
-                                                                aggregate_columns);
-        output_aggregate_table = DataTable::Make(aggregate_tabledef, TableType::kAggregate);
-
-        // Loop blocks
-        HashMap<u64, SharedPtr<DataBlock>> block_map;
-        SizeT input_data_block_count = grouped_input_table->DataBlockCount();
-        for(SizeT block_idx = 0; block_idx < input_data_block_count; ++ block_idx) {
-            SharedPtr<DataBlock> output_data_block = DataBlock::Make();
-            output_data_block->Init(output_types);
-            Vector<SharedPtr<DataBlock>> input_blocks{grouped_input_table->GetDataBlockById(block_idx)};
-//            block_map[groupby_index_] = block_ptr;
-//            block_map[input_table_index_] = block_ptr;
-            // Loop aggregate expression
-            ExpressionEvaluator evaluator;
-            evaluator.Init(input_blocks);
-            for(SizeT expr_idx = 0; expr_idx < aggregates_count; ++ expr_idx) {
-                Vector<SharedPtr<ColumnVector>> blocks_column;
-                blocks_column.emplace_back(output_data_block->column_vectors[expr_idx]);
-                evaluator.Execute(aggregates_[expr_idx],
-                                  expr_states[expr_idx],
-                                  blocks_column);
-                if(blocks_column[0].get() != output_data_block->column_vectors[expr_idx].get()) {
-                    // column vector in blocks column might be changed to the column vector from column reference.
-                    // This check and assignment is to make sure the right column vector are assign to output_data_block
-                    output_data_block->column_vectors[expr_idx] = blocks_column[0];
-                }
+        ExpressionEvaluator evaluator;
+        evaluator.Init(input_block.get());
+
+        // 1. Evaluate group by keys and find the group of each row.
+        Vector<SharedPtr<ColumnVector>> key_columns(group_count);
+        for (SizeT group_idx = 0; group_idx < group_count; ++group_idx) {
+            key_columns[group_idx] = MakeShared<ColumnVector>(MakeShared<DataType>(groups_[group_idx]->Type()));
+            key_columns[group_idx]->Initialize();
+            evaluator.Execute(groups_[group_idx], group_states[group_idx], key_columns[group_idx]);
+        }
+        new_groups.clear();
+        hash_table->FindOrCreateGroups(key_columns, row_count, group_ptrs, new_groups);
+
+        // 2. Initialize the states of new groups, then update the state of each row's group in place.
+        state_ptrs.resize(row_count);
+        for (SizeT expr_idx = 0; expr_idx < aggregates_count; ++expr_idx) {
+            const AggregateFunction &aggregate_function = static_cast<AggregateExpression *>(aggregates_[expr_idx].get())->aggregate_function_;
+            for (ptr_t group : new_groups) {
+                aggregate_function.init_func_(hash_table->GetState(group, expr_idx));
             }
 
-            output_data_block->Finalize();
-            output_aggregate_table->Append(output_data_block);
+            SharedPtr<BaseExpression> &argument = aggregates_[expr_idx]->arguments()[0];
+            SharedPtr<ColumnVector> argument_column = MakeShared<ColumnVector>(MakeShared<DataType>(argument->Type()));
+            argument_column->Initialize();
+            evaluator.Execute(argument, argument_states[expr_idx], argument_column);
+
+            for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+                state_ptrs[row_idx] = hash_table->GetState(group_ptrs[row_idx], expr_idx);
+            }
+            aggregate_function.scatter_update_func_(state_ptrs.data(), argument_column, row_count);
+            CopyVarcharStates(*hash_table, expr_idx, new_groups, *argument_column);
         }
+    }
 
-        // Union output group by table with aggregate table
-        output_groupby_table->UnionWith(output_aggregate_table);
+    if (!task_completed) {
+        return true;
     }
 
-    // 4. generate the result to output
-    this->output_ = output_groupby_table;
-#endif
+    // 3. Generate output blocks, the partial results of all tasks are merged later if partial output is set.
+    OutputGroups(*hash_table, partial_output_, aggregate_operator_state->data_block_array_);
+    if (aggregate_operator_state->data_block_array_.empty()) {
+        // No group, still output an empty block so the next operator knows this task is done.
+        auto output_block = DataBlock::MakeUniquePtr();
+        output_block->Init(*(partial_output_ ? GetPartialOutputTypes() : GetOutputTypes()));
+        output_block->Finalize();
+        aggregate_operator_state->data_block_array_.emplace_back(std::move(output_block));
+    }
     return true;
 }
 
-void PhysicalAggregate::GroupByInputTable(const SharedPtr<DataTable> &input_table, SharedPtr<DataTable> &grouped_input_table) {
-    SizeT column_count = input_table->ColumnCount();
-
-    // 1. Get output table column types.
-    Vector<SharedPtr<DataType>> types;
-    types.reserve(column_count);
-    for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-        SharedPtr<DataType> input_type = input_table->GetColumnTypeById(column_id);
-        SharedPtr<DataType> output_type = grouped_input_table->GetColumnTypeById(column_id);
-        if (*input_type != *output_type) {
-            Status status = Status::DataTypeMismatch(input_type->ToString(), output_type->ToString());
-            LOG_ERROR(status.message());
-            RecoverableError(status);
-        }
-        types.emplace_back(input_type);
+UniquePtr<AggregateHashTable> PhysicalAggregate::CreateHashTable() const {
+    Vector<SharedPtr<DataType>> key_types;
+    key_types.reserve(groups_.size());
+    for (const auto &group_expr : groups_) {
+        key_types.emplace_back(MakeShared<DataType>(group_expr->Type()));
     }
-
-    // 2. Generate data blocks and append it into output table according to the group by hash table.
-    const Vector<SharedPtr<DataBlock>> &input_datablocks = input_table->data_blocks_;
-    for (const auto &item : hash_table_.hash_table_) {
-
-        // 2.1 Each hash bucket will be insert in to one data block
-        SharedPtr<DataBlock> output_datablock = DataBlock::Make();
-        SizeT datablock_size = 0;
-        for (const auto &vec_pair : item.second) {
-            datablock_size += vec_pair.second.size();
-        }
-        SizeT datablock_capacity = Utility::NextPowerOfTwo(datablock_size);
-        output_datablock->Init(types, datablock_capacity);
-
-        // Loop each block
-        SizeT output_row_idx = 0;
-        for (const auto &vec_pair : item.second) {
-            SizeT input_block_id = vec_pair.first;
-
-            // Loop each row of same block
-            for (const auto input_offset : vec_pair.second) {
-
-                // Forloop each column
-                for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-                    switch (types[column_id]->type()) {
-                        case LogicalType::kBoolean: {
-                            ((BooleanT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((BooleanT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case LogicalType::kTinyInt: {
-                            ((TinyIntT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((TinyIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case LogicalType::kSmallInt: {
-                            ((SmallIntT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((SmallIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case LogicalType::kInteger: {
-                            ((IntegerT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((IntegerT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case LogicalType::kBigInt: {
-                            ((BigIntT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((BigIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case kHugeInt: {
-                            String error_message = "Not implement: HugeInt data shuffle";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                        case kFloat: {
-                            ((FloatT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((FloatT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case kDouble: {
-                            ((DoubleT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((DoubleT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case kDecimal: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                        case kVarchar: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            //                            VarcharT &dst_ref = ((VarcharT
-                            //                            *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx]; VarcharT &src_ref
-                            //                            = ((VarcharT
-                            //                            *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset]; if
-                            //                            (src_ref.IsInlined()) {
-                            //                                std::memcpy((char *)&dst_ref, (char *)&src_ref, sizeof(VarcharT));
-                            //                            } else {
-                            //                                dst_ref.length = src_ref.length;
-                            //                                std::memcpy(dst_ref.prefix, src_ref.prefix, VarcharT::PREFIX_LENGTH);
-                            //
-                            //                                dst_ref.ptr =
-                            //                                output_datablock->column_vectors[column_id]->buffer_->fix_heap_mgr_->Allocate(src_ref.length);
-                            //                                std::memcpy(dst_ref.ptr, src_ref.ptr, src_ref.length);
-                            //                            }
-                            break;
-                        }
-                        case kDate: {
-                            ((DateT *)(output_datablock->column_vectors[column_id]->data()))[output_row_idx] =
-                                ((DateT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                            break;
-                        }
-                        case kTime: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                        case kDateTime: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                        case kTimestamp: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                        case kInterval: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                        case kMixed: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                        default: {
-                            String error_message = "Not implement: data shuffle.";
-                            LOG_CRITICAL(error_message);
-                            UnrecoverableError(error_message);
-                            break;
-                        }
-                    }
-                }
-
-                ++output_row_idx;
-            }
-        }
-
-        if (output_row_idx != datablock_size) {
-            String error_message = fmt::format("Expected block size: {}, but only copied data size: {}", datablock_size, output_row_idx);
-            LOG_CRITICAL(error_message);
-            UnrecoverableError(error_message);
-            break;
-        }
-
-        for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-            output_datablock->column_vectors[column_id]->Finalize(datablock_size);
-        }
-
-        output_datablock->Finalize();
-        grouped_input_table->Append(output_datablock);
+    Vector<SizeT> state_sizes;
+    state_sizes.reserve(aggregates_.size());
+    for (const auto &expr : aggregates_) {
+        state_sizes.emplace_back(static_cast<AggregateExpression *>(expr.get())->aggregate_function_.state_size_);
     }
+    return MakeUnique<AggregateHashTable>(std::move(key_types), state_sizes);
 }
 
-void PhysicalAggregate::GenerateGroupByResult(const SharedPtr<DataTable> &input_table, SharedPtr<DataTable> &output_table) {
-
-    SizeT column_count = input_table->ColumnCount();
-    Vector<SharedPtr<DataType>> types;
-    types.reserve(column_count);
-    for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-        SharedPtr<DataType> input_type = input_table->GetColumnTypeById(column_id);
-        SharedPtr<DataType> output_type = output_table->GetColumnTypeById(column_id);
-        if (*input_type != *output_type) {
-            Status status = Status::DataTypeMismatch(input_type->ToString(), output_type->ToString());
-            LOG_ERROR(status.message());
-            RecoverableError(status);
-        }
-        types.emplace_back(input_type);
+void PhysicalAggregate::CopyVarcharStates(AggregateHashTable &hash_table,
+                                          SizeT expr_idx,
+                                          const Vector<ptr_t> &new_groups,
+                                          const ColumnVector &input_column) const {
+    const AggregateFunction &aggregate_function = static_cast<AggregateExpression *>(aggregates_[expr_idx].get())->aggregate_function_;
+    if (aggregate_function.return_type_.type() != LogicalType::kVarchar) {
+        return;
     }
-
-    SharedPtr<DataBlock> output_datablock = nullptr;
-    const Vector<SharedPtr<DataBlock>> &input_datablocks = input_table->data_blocks_;
-//    SizeT row_count = hash_table_.hash_table_.size();
-#if 1
-    for (SizeT block_row_idx = 0; const auto &item : hash_table_.hash_table_) {
-        // Each hash bucket will generate one data block.
-        output_datablock = DataBlock::Make();
-        output_datablock->Init(types);
-
-        // Only get the first row(block id and row offset of the block) of the bucket
-        SizeT input_block_id = item.second.begin()->first;
-        SizeT input_offset = item.second.begin()->second.front();
-
-        // Only the first position of the column vector has value.
-        for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-            switch (types[column_id]->type()) {
-                case LogicalType::kBoolean: {
-                    ((BooleanT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((BooleanT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kTinyInt: {
-                    ((TinyIntT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((TinyIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kSmallInt: {
-                    ((SmallIntT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((SmallIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kInteger: {
-                    ((IntegerT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((IntegerT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kBigInt: {
-                    ((BigIntT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((BigIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case kHugeInt: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-                case kFloat: {
-                    ((FloatT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((FloatT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case kDouble: {
-                    ((DoubleT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((DoubleT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case kDecimal: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-                case kVarchar: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                    //                    VarcharT &dst_ref = ((VarcharT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx];
-                    //                    VarcharT &src_ref = ((VarcharT
-                    //                    *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset]; if
-                    //                    (src_ref.IsInlined()) {
-                    //                        std::memcpy((char *)&dst_ref, (char *)&src_ref, sizeof(VarcharT));
-                    //                    } else {
-                    //                        dst_ref.length = src_ref.length;
-                    //                        std::memcpy(dst_ref.prefix, src_ref.prefix, VarcharT::PREFIX_LENGTH);
-                    //
-                    //                        dst_ref.ptr =
-                    //                        output_datablock->column_vectors[column_id]->buffer_->fix_heap_mgr_->Allocate(src_ref.length);
-                    //                        std::memcpy(dst_ref.ptr, src_ref.ptr, src_ref.length);
-                    //                    }
-                }
-                case kDate: {
-                    ((DateT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((DateT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case kTime: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-                case kDateTime: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-                case kTimestamp: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-                case kInterval: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-                case kMixed: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-                default: {
-                    String error_message = "Not implement: data shuffle.";
-                    LOG_CRITICAL(error_message);
-                    UnrecoverableError(error_message);
-                    break;
-                }
-            }
-
-            output_datablock->column_vectors[column_id]->Finalize(block_row_idx + 1);
-        }
-
-        output_datablock->Finalize();
-        output_table->Append(output_datablock);
+    // the varchar result of a group is set by the first row of the group, which is in the block creating the group
+    for (ptr_t group : new_groups) {
+        auto *value = reinterpret_cast<VarcharT *>(aggregate_function.finalize_func_(hash_table.GetState(group, expr_idx)));
+        hash_table.CopyVarcharState(*value, input_column);
     }
-#else
-    for (SizeT row_id = 0, block_row_idx = 0; const auto &item : hash_table_.hash_table_) {
-        // DEFAULT VECTOR SIZE buckets will generate one data block.
-        if (row_id % DEFAULT_VECTOR_SIZE == 0) {
-            if (output_datablock.get() != nullptr) {
-                for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-                    output_datablock->column_vectors[column_id]->tail_index_ = block_row_idx;
-                }
-
-                output_datablock->Finalize();
-                output_table->Append(output_datablock);
-                block_row_idx = 0;
-            }
+}
 
-            output_datablock = DataBlock::Make();
-            output_datablock->Init(types);
+void PhysicalAggregate::OutputGroups(const AggregateHashTable &hash_table, bool partial, Vector<UniquePtr<DataBlock>> &output_blocks) const {
+    SizeT group_count = groups_.size();
+    SizeT aggregates_count = aggregates_.size();
+    SharedPtr<Vector<SharedPtr<DataType>>> output_types = partial ? GetPartialOutputTypes() : GetOutputTypes();
+    SizeT total_group_count = hash_table.GroupCount();
+    Vector<ptr_t> groups;
+    for (SizeT group_start = 0; group_start < total_group_count; group_start += DEFAULT_BLOCK_CAPACITY) {
+        SizeT group_end = std::min(group_start + DEFAULT_BLOCK_CAPACITY, total_group_count);
+        groups.clear();
+        for (SizeT group_idx = group_start; group_idx < group_end; ++group_idx) {
+            groups.emplace_back(hash_table.GetGroup(group_idx));
         }
 
-        SizeT input_block_id = item.second.begin()->first;
-        SizeT input_offset = item.second.begin()->second.front();
-
-        for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-            switch (types[column_id].type()) {
-                case LogicalType::kBoolean: {
-                    ((BooleanT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((BooleanT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kTinyInt: {
-                    ((TinyIntT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((TinyIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kSmallInt: {
-                    ((SmallIntT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((SmallIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kInteger: {
-                    ((IntegerT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((IntegerT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case LogicalType::kBigInt: {
-                    ((BigIntT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((BigIntT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case kHugeInt: {
-                    NotImplementError("HugeInt data shuffle isn't implemented.")
-                }
-                case kFloat: {
-                    ((FloatT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((FloatT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case kDouble: {
-                    ((DoubleT *)(output_datablock->column_vectors[column_id]->data()))[block_row_idx] =
-                        ((DoubleT *)(input_datablocks[input_block_id]->column_vectors[column_id]->data()))[input_offset];
-                    break;
-                }
-                case kDecimal: {
-                    NotImplementError("Decimal data shuffle isn't implemented.")
-                }
-                case kVarchar: {
-                    NotImplementError("Varchar data shuffle isn't implemented.")
-                }
-                case kDate: {
-                    NotImplementError("Date data shuffle isn't implemented.")
-                }
-                case kTime: {
-                    NotImplementError("Time data shuffle isn't implemented.")
-                }
-                case kDateTime: {
-                    NotImplementError("Datetime data shuffle isn't implemented.")
-                }
-                case kTimestamp: {
-                    NotImplementError("Timestamp data shuffle isn't implemented.")
-                }
-                case kTimestampTZ: {
-                    NotImplementError("TimestampTZ data shuffle isn't implemented.")
-                }
-                case kInterval: {
-                    NotImplementError("Interval data shuffle isn't implemented.")
-                }
-                case kMixed: {
-                    NotImplementError("Heterogeneous data shuffle isn't implemented.")
-                }
-                default: {
-                    ExecutorError("Unexpected data type")
-                }
+        // Group by keys, followed by the aggregate results, or by the aggregate states and the hashes of the groups.
+        auto output_block = DataBlock::MakeUniquePtr();
+        output_block->Init(*output_types);
+        hash_table.AppendKeys(groups, output_block->column_vectors);
+        for (SizeT expr_idx = 0; expr_idx < aggregates_count; ++expr_idx) {
+            const AggregateFunction &aggregate_function = static_cast<AggregateExpression *>(aggregates_[expr_idx].get())->aggregate_function_;
+            ColumnVector &output_column = *output_block->column_vectors[group_count + expr_idx];
+            if (aggregate_function.return_type_.type() == LogicalType::kVarchar) {
+                // the result is also the partial state, the arena of the table doesn't outlive the task
+                for (ptr_t group : groups) {
+                    const auto *value = reinterpret_cast<const VarcharT *>(aggregate_function.finalize_func_(hash_table.GetState(group, expr_idx)));
+                    output_column.AppendValue(Value::MakeVarchar(AggregateHashTable::GetVarcharState(*value)));
+                }
+                continue;
+            }
+            for (ptr_t group : groups) {
+                ptr_t state = hash_table.GetState(group, expr_idx);
+                output_column.AppendByPtr(partial ? state : aggregate_function.finalize_func_(state));
             }
         }
-
-        ++block_row_idx;
-        ++row_id;
-
-        if (row_id == row_count) {
-            // All hash table data are checked
-            for (SizeT column_id = 0; column_id < column_count; ++column_id) {
-                output_datablock->column_vectors[column_id]->tail_index_ = block_row_idx;
+        if (partial) {
+            ColumnVector &hash_column = *output_block->column_vectors[group_count + aggregates_count];
+            for (ptr_t group : groups) {
+                u64 hash = AggregateHashTable::GetHash(group);
+                hash_column.AppendByPtr(reinterpret_cast<const_ptr_t>(&hash));
             }
-
-            output_datablock->Finalize();
-            output_table->Append(output_datablock);
-            break;
         }
+        output_block->Finalize();
+        output_blocks.emplace_back(std::move(output_block));
     }
-#endif
 }
 
 bool PhysicalAggregate::SimpleAggregateExecute(const Vector<UniquePtr<DataBlock>> &input_blocks,
@@ -769,6 +370,28 @@ SharedPtr<Vector<SharedPtr<DataType>>> PhysicalAggregate::GetOutputTypes() const
     return result;
 }
 
+SharedPtr<Vector<SharedPtr<DataType>>> PhysicalAggregate::GetPartialOutputTypes() const {
+    SharedPtr<Vector<SharedPtr<DataType>>> result = MakeShared<Vector<SharedPtr<DataType>>>();
+    SizeT groups_count = groups_.size();
+    SizeT aggregates_count = aggregates_.size();
+    result->reserve(groups_count + aggregates_count + 1);
+    for (SizeT i = 0; i < groups_count; ++i) {
+        result->emplace_back(MakeShared<DataType>(groups_[i]->Type()));
+    }
+    for (SizeT i = 0; i < aggregates_count; ++i) {
+        const AggregateFunction &aggregate_function = static_cast<AggregateExpression *>(aggregates_[i].get())->aggregate_function_;
+        if (aggregate_function.return_type_.type() == LogicalType::kVarchar) {
+            result->emplace_back(MakeShared<DataType>(LogicalType::kVarchar));
+            continue;
+        }
+        // States are trivially copyable, carry them as fixed width byte arrays.
+        SizeT state_size = aggregate_function.state_size_;
+        result->emplace_back(MakeShared<DataType>(LogicalType::kEmbedding, EmbeddingInfo::Make(EmbeddingDataType::kElemInt8, state_size)));
+    }
+    result->emplace_back(MakeShared<DataType>(LogicalType::kBigInt));
+    return result;
+}
+
 Vector<HashRange> PhysicalAggregate::GetHashRanges(i64 parallel_count) const {
     Vector<HashRange> result;
     result.resize(parallel_count);
@@ -23,11 +23,11 @@ import operator_state;
 import physical_operator;
 import physical_operator_type;
 import data_table;
-import hash_table;
 import base_expression;
 import load_meta;
 import infinity_exception;
 import data_block;
+import hash_table;
 import internal_types;
 import data_type;
 import logger;
@@ -64,13 +64,20 @@ public:
         return 0;
     }
 
-    void GroupByInputTable(const SharedPtr<DataTable> &input_table, SharedPtr<DataTable> &output_table);
-
-    void GenerateGroupByResult(const SharedPtr<DataTable> &input_table, SharedPtr<DataTable> &output_table);
-
     Vector<SharedPtr<BaseExpression>> groups_{};
     Vector<SharedPtr<BaseExpression>> aggregates_{};
-    HashTable hash_table_;
+
+    // Aggregate rows into the group by hash table of the task, output the groups when the input is completed.
+    bool GroupByExecute(const Vector<UniquePtr<DataBlock>> &input_blocks, AggregateOperatorState *aggregate_operator_state, bool task_completed);
+
+    // Hash table of the group by keys and the aggregate states.
+    UniquePtr<AggregateHashTable> CreateHashTable() const;
+
+    // Copy the varchar results of the new groups out of the heap of the input column, see AggregateHashTable::CopyVarcharState().
+    void CopyVarcharStates(AggregateHashTable &hash_table, SizeT expr_idx, const Vector<ptr_t> &new_groups, const ColumnVector &input_column) const;
+
+    // Append the groups of the hash table to output blocks, either as aggregate results or as partial states.
+    void OutputGroups(const AggregateHashTable &hash_table, bool partial, Vector<UniquePtr<DataBlock>> &output_blocks) const;
 
     bool SimpleAggregateExecute(const Vector<UniquePtr<DataBlock>> &input_blocks,
                                 Vector<UniquePtr<DataBlock>> &output_blocks,
@@ -85,6 +92,16 @@ public:
 
     SharedPtr<Vector<SharedPtr<DataType>>> GetOutputTypes() const final;
 
+    // Output the aggregate states of the groups instead of the final results, so that the partial results of all tasks
+    // can be merged by PhysicalMergeAggregate.
+    inline void SetPartialOutput() { partial_output_ = true; }
+
+    inline bool PartialOutput() const { return partial_output_; }
+
+    // Partial output columns: group by keys, raw state bytes of each aggregate, hash of the keys.
+    // An aggregate returning a varchar (FIRST) outputs its result by value instead, it is aggregated again by the merge.
+    SharedPtr<Vector<SharedPtr<DataType>>> GetPartialOutputTypes() const;
+
     bool IsSink() const override { return true; }
 
     Vector<HashRange> GetHashRanges(i64 parallel_count) const;
@@ -93,6 +110,7 @@ private:
     SharedPtr<DataTable> input_table_{};
     u64 groupby_index_{};
     u64 aggregate_index_{};
+    bool partial_output_{false};
 };
 
 } // namespace infinity
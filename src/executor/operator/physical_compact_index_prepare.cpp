@@ -26,9 +26,50 @@ import block_index;
 import txn;
 import status;
 import base_table_ref;
+import compact_state_data;
+import create_index_data;
+import segment_index_entry;
+import segment_entry;
+import internal_types;
 
 namespace infinity {
 
+// Link the indexes of the new segments from the graphs of the compacted segments where the index supports it.
+static void MergeIndexes(const IndexSnapshot &index_snapshot,
+                         CompactStateData *compact_state_data,
+                         const Vector<SegmentIndexEntry *> &segment_index_entries,
+                         CreateIndexSharedData &create_index_shared_data,
+                         TxnTimeStamp begin_ts) {
+    const auto &old_segment_index_entries = index_snapshot.segment_index_entries_;
+    auto remap = [compact_state_data](SegmentID segment_id, SegmentOffset segment_offset) -> Optional<SegmentOffset> {
+        Optional<RowID> new_row_id = compact_state_data->remapper_.TryGetNewRowID(RowID(segment_id, segment_offset));
+        if (!new_row_id.has_value()) {
+            return None;
+        }
+        return new_row_id->segment_offset_;
+    };
+    for (auto *segment_index_entry : segment_index_entries) {
+        const SegmentID segment_id = segment_index_entry->segment_id();
+        for (const auto &compact_segment_data : compact_state_data->segment_data_list_) {
+            if (compact_segment_data.new_segment_->segment_id() != segment_id) {
+                continue;
+            }
+            Vector<SegmentIndexEntry *> old_index_entries;
+            for (const auto *old_segment : compact_segment_data.old_segments_) {
+                auto iter = old_segment_index_entries.find(old_segment->segment_id());
+                if (iter != old_segment_index_entries.end()) {
+                    old_index_entries.push_back(iter->second);
+                }
+            }
+            if (segment_index_entry->CreateIndexByMerge(old_index_entries, remap, begin_ts)) {
+                // the create index do stage skips the linked segment
+                create_index_shared_data.create_index_idxes_.at(segment_id).store(compact_segment_data.new_segment_->row_count());
+            }
+            break;
+        }
+    }
+}
+
 bool PhysicalCompactIndexPrepare::Execute(QueryContext *query_context, OperatorState *operator_state) {
     auto *compact_index_prepare_operator_state = static_cast<CompactIndexPrepareOperatorState *>(operator_state);
     auto *compact_state_data = compact_index_prepare_operator_state->compact_state_data_.get();
@@ -61,6 +102,10 @@ bool PhysicalCompactIndexPrepare::Execute(QueryContext *query_context, OperatorS
     for (auto *segment_index_entry : segment_index_entries) {
         compact_state_data->AddNewIndexSegment(table_index_entry, segment_index_entry);
     }
+    if (create_index_shared_data != nullptr) {
+        const IndexSnapshot &index_snapshot = *index_index->index_snapshots_vec_[create_index_idx];
+        MergeIndexes(index_snapshot, compact_state_data, segment_index_entries, *(*create_index_shared_data)[create_index_idx], txn->BeginTS());
+    }
 
     compact_index_prepare_operator_state->create_index_idx_ = ++create_index_idx;
     if (create_index_idx == index_index->index_snapshots_vec_.size()) {
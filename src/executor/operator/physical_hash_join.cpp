@@ -18,15 +18,181 @@ module;
 import query_context;
 import operator_state;
 import stl;
-
+import base_expression;
+import join_reference;
+import data_block;
+import column_vector;
+import data_type;
+import join_hash_table;
+import join_util;
+import utility;
+import task_scheduler;
+import defer_op;
+import infinity_exception;
+import logger;
+import third_party;
 
 module physical_hash_join;
 
 namespace infinity {
 
-void PhysicalHashJoin::Init() {}
+void PhysicalHashJoin::Init() {
+    if (left_ == nullptr || right_ == nullptr) {
+        return;
+    }
+    output_types_ = GetOutputTypes();
+    SizeT left_column_count = left_->GetOutputTypes()->size();
+    if (!ExtractEquiJoinKeys(conditions_, left_column_count, left_key_ids_, right_key_ids_)) {
+        String error_message = "Hash join requires equality conditions between the left and the right input.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+}
+
+bool PhysicalHashJoin::Execute(QueryContext *query_context, OperatorState *operator_state) {
+    auto *hash_join_operator_state = static_cast<HashJoinOperatorState *>(operator_state);
+    if (!hash_join_operator_state->input_complete_) {
+        return false;
+    }
+
+    auto take_input = [&](u64 fragment_id) {
+        Vector<UniquePtr<DataBlock>> input_blocks;
+        auto iter = hash_join_operator_state->input_data_blocks_.find(fragment_id);
+        if (iter != hash_join_operator_state->input_data_blocks_.end()) {
+            for (auto &input_block : iter->second) {
+                if (input_block.get() != nullptr && input_block->row_count() > 0) {
+                    input_blocks.emplace_back(std::move(input_block));
+                }
+            }
+        }
+        return input_blocks;
+    };
+    Vector<UniquePtr<DataBlock>> probe_blocks = take_input(left_fragment_id_);
+    Vector<UniquePtr<DataBlock>> build_blocks = take_input(right_fragment_id_);
+    hash_join_operator_state->input_data_blocks_.clear();
+
+    // Build and probe run on this worker and on the scheduler workers idle at the moment, so a join doesn't start threads beyond the
+    // cpu limit next to the other query tasks.
+    TaskScheduler *scheduler = query_context->scheduler();
+    const u64 extra_worker_count = scheduler->ReserveExtraWorkers(std::max<SizeT>(1, query_context->cpu_number_limit()) - 1);
+    DeferFn release_workers([&] { scheduler->ReleaseExtraWorkers(extra_worker_count); });
+    const SizeT worker_count = 1 + extra_worker_count;
+    SizeT build_row_count = 0;
+    for (const auto &build_block : build_blocks) {
+        build_row_count += build_block->row_count();
+    }
+
+    // Build: radix partition the right input and build a chained hash table for each partition.
+    JoinHashTable hash_table(&build_blocks, right_key_ids_, JoinHashTable::ChooseRadixBits(build_row_count));
+    hash_table.Build(worker_count);
+
+    // Probe: partition the left input with the same radix bits, then every worker joins whole partitions,
+    // so the build partition it touches stays in cache.
+    Vector<JoinHashEntry> null_key_rows;
+    Vector<Vector<JoinHashEntry>> probe_partitions =
+        JoinHashTable::PartitionRows(probe_blocks, left_key_ids_, hash_table.radix_bits(), worker_count, null_key_rows);
+    Vector<Vector<UniquePtr<DataBlock>>> partition_outputs(probe_partitions.size() + 1);
+    Utility::RunParallel(probe_partitions.size(), worker_count, [&](SizeT partition_idx) {
+        ProbePartition(hash_table, probe_blocks, build_blocks, probe_partitions[partition_idx], partition_outputs[partition_idx]);
+    });
+
+    // Rows with NULL key never match.
+    if (join_type_ == JoinType::kLeft || join_type_ == JoinType::kAnti) {
+        for (const JoinHashEntry &probe_entry : null_key_rows) {
+            AppendJoinOutputRow(partition_outputs.back(),
+                                *output_types_,
+                                probe_blocks[probe_entry.block_idx_].get(),
+                                probe_entry.row_idx_,
+                                nullptr,
+                                0);
+        }
+    }
+
+    for (auto &output_blocks : partition_outputs) {
+        for (auto &output_block : output_blocks) {
+            output_block->Finalize();
+            operator_state->data_block_array_.emplace_back(std::move(output_block));
+        }
+    }
+    operator_state->SetComplete();
+    return true;
+}
+
+void PhysicalHashJoin::ProbePartition(const JoinHashTable &hash_table,
+                                      const Vector<UniquePtr<DataBlock>> &probe_blocks,
+                                      const Vector<UniquePtr<DataBlock>> &build_blocks,
+                                      const Vector<JoinHashEntry> &probe_entries,
+                                      Vector<UniquePtr<DataBlock>> &output_blocks) const {
+    for (const JoinHashEntry &probe_entry : probe_entries) {
+        const DataBlock *probe_block = probe_blocks[probe_entry.block_idx_].get();
+        switch (join_type_) {
+            case JoinType::kInner:
+            case JoinType::kLeft: {
+                SizeT match_count = hash_table.ForEachMatch(probe_entry, probe_block, left_key_ids_, [&](const JoinHashEntry &build_entry) {
+                    AppendJoinOutputRow(output_blocks,
+                                        *output_types_,
+                                        probe_block,
+                                        probe_entry.row_idx_,
+                                        build_blocks[build_entry.block_idx_].get(),
+                                        build_entry.row_idx_);
+                    return true;
+                });
+                if (match_count == 0 && join_type_ == JoinType::kLeft) {
+                    AppendJoinOutputRow(output_blocks, *output_types_, probe_block, probe_entry.row_idx_, nullptr, 0);
+                }
+                break;
+            }
+            case JoinType::kSemi:
+            case JoinType::kAnti: {
+                // Only the existence of a match matters, stop at the first one.
+                SizeT match_count = hash_table.ForEachMatch(probe_entry, probe_block, left_key_ids_, [](const JoinHashEntry &) { return false; });
+                if ((match_count > 0) == (join_type_ == JoinType::kSemi)) {
+                    AppendJoinOutputRow(output_blocks, *output_types_, probe_block, probe_entry.row_idx_, nullptr, 0);
+                }
+                break;
+            }
+            default: {
+                String error_message = fmt::format("Hash join doesn't support join type: {}", static_cast<int>(join_type_));
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+        }
+    }
+}
 
-bool PhysicalHashJoin::Execute(QueryContext *, OperatorState *) { return true; }
+bool PhysicalHashJoin::SupportHashJoin(JoinType join_type,
+                                       const Vector<SharedPtr<BaseExpression>> &conditions,
+                                       const Vector<SharedPtr<DataType>> &left_types,
+                                       const Vector<SharedPtr<DataType>> &right_types) {
+    switch (join_type) {
+        case JoinType::kInner:
+        case JoinType::kLeft:
+        case JoinType::kSemi:
+        case JoinType::kAnti: {
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+    Vector<SizeT> left_key_ids;
+    Vector<SizeT> right_key_ids;
+    if (!ExtractEquiJoinKeys(conditions, left_types.size(), left_key_ids, right_key_ids)) {
+        return false;
+    }
+    for (SizeT key_idx = 0; key_idx < left_key_ids.size(); ++key_idx) {
+        if (right_key_ids[key_idx] >= right_types.size()) {
+            return false;
+        }
+        const DataType &left_type = *left_types[left_key_ids[key_idx]];
+        const DataType &right_type = *right_types[right_key_ids[key_idx]];
+        // Keys are compared by their binary representation, both sides must have the same type.
+        if (left_type != right_type || !JoinHashTable::SupportKeyType(left_type)) {
+            return false;
+        }
+    }
+    return true;
+}
 
 SharedPtr<Vector<String>> PhysicalHashJoin::GetOutputNames() const {
     SharedPtr<Vector<String>> result = MakeShared<Vector<String>>();
@@ -22,10 +22,14 @@ import query_context;
 import operator_state;
 import physical_operator;
 import physical_operator_type;
+import base_expression;
 import load_meta;
 import infinity_exception;
 import internal_types;
+import join_reference;
 import data_type;
+import data_block;
+import join_hash_table;
 import logger;
 
 namespace infinity {
@@ -35,6 +39,15 @@ public:
     explicit PhysicalHashJoin(u64 id, SharedPtr<Vector<LoadMeta>> load_metas)
         : PhysicalOperator(PhysicalOperatorType::kJoinHash, nullptr, nullptr, id, load_metas) {}
 
+    explicit PhysicalHashJoin(u64 id,
+                              JoinType join_type,
+                              Vector<SharedPtr<BaseExpression>> conditions,
+                              UniquePtr<PhysicalOperator> left,
+                              UniquePtr<PhysicalOperator> right,
+                              SharedPtr<Vector<LoadMeta>> load_metas)
+        : PhysicalOperator(PhysicalOperatorType::kJoinHash, std::move(left), std::move(right), id, load_metas), join_type_(join_type),
+          conditions_(std::move(conditions)) {}
+
     ~PhysicalHashJoin() override = default;
 
     void Init() override;
@@ -45,12 +58,44 @@ public:
 
     SharedPtr<Vector<SharedPtr<DataType>>> GetOutputTypes() const final;
 
-    SizeT TaskletCount() override {
-        String error_message = "Not implement: TaskletCount not Implement";
-        LOG_CRITICAL(error_message);
-        UnrecoverableError(error_message);
-        return 0;
+    // Hash join is executed in a serial fragment, the build and probe are parallelized inside the operator.
+    SizeT TaskletCount() override { return 1; }
+
+    inline JoinType join_type() const { return join_type_; }
+
+    inline const Vector<SharedPtr<BaseExpression>> &conditions() const { return conditions_; }
+
+    inline const Vector<SizeT> &left_key_ids() const { return left_key_ids_; }
+
+    inline const Vector<SizeT> &right_key_ids() const { return right_key_ids_; }
+
+    // Ids of the child fragments which produce the probe (left) and the build (right) input.
+    inline void SetInputFragmentIds(u64 left_fragment_id, u64 right_fragment_id) {
+        left_fragment_id_ = left_fragment_id;
+        right_fragment_id_ = right_fragment_id;
     }
+
+    // Check if a join can be executed by hash join: the join type is supported and all conditions are
+    // equalities between a left column and a right column of a hashable type.
+    static bool SupportHashJoin(JoinType join_type,
+                                const Vector<SharedPtr<BaseExpression>> &conditions,
+                                const Vector<SharedPtr<DataType>> &left_types,
+                                const Vector<SharedPtr<DataType>> &right_types);
+
+private:
+    void ProbePartition(const JoinHashTable &hash_table,
+                        const Vector<UniquePtr<DataBlock>> &probe_blocks,
+                        const Vector<UniquePtr<DataBlock>> &build_blocks,
+                        const Vector<JoinHashEntry> &probe_entries,
+                        Vector<UniquePtr<DataBlock>> &output_blocks) const;
+
+    JoinType join_type_{JoinType::kInner};
+    Vector<SharedPtr<BaseExpression>> conditions_{};
+    Vector<SizeT> left_key_ids_{};
+    Vector<SizeT> right_key_ids_{};
+    SharedPtr<Vector<SharedPtr<DataType>>> output_types_{};
+    u64 left_fragment_id_{std::numeric_limits<u64>::max()};
+    u64 right_fragment_id_{std::numeric_limits<u64>::max()};
 };
 
 } // namespace infinity
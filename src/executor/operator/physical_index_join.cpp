@@ -18,17 +18,424 @@ module;
 import stl;
 import query_context;
 import operator_state;
-
+import physical_operator;
+import physical_operator_type;
+import physical_table_scan;
+import physical_index_scan;
+import base_expression;
+import join_reference;
+import data_block;
+import column_vector;
+import data_type;
+import logical_type;
+import value;
+import internal_types;
+import join_util;
+import secondary_index_scan_execute_expression;
+import filter_expression_push_down_helper;
+import table_entry;
+import table_index_entry;
+import table_index_meta;
+import index_base;
+import segment_entry;
+import block_entry;
+import block_column_entry;
+import block_index;
+import knn_filter;
+import bitmask;
+import txn;
+import buffer_manager;
+import default_values;
+import infinity_exception;
+import logger;
+import third_party;
 
 module physical_index_join;
 
 namespace infinity {
 
-void PhysicalIndexJoin::Init() {}
+namespace {
+
+bool SupportIndexKeyType(const DataType &data_type) {
+    switch (data_type.type()) {
+        case LogicalType::kTinyInt:
+        case LogicalType::kSmallInt:
+        case LogicalType::kInteger:
+        case LogicalType::kBigInt:
+        case LogicalType::kFloat:
+        case LogicalType::kDouble:
+        case LogicalType::kDate:
+        case LogicalType::kTime:
+        case LogicalType::kDateTime:
+        case LogicalType::kTimestamp:
+        case LogicalType::kVarchar: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+SizeT BlockIndexRowCount(const BlockIndex &block_index) {
+    SizeT row_count = 0;
+    for (const auto &[segment_id, segment_snapshot] : block_index.segment_block_index_) {
+        row_count += segment_snapshot.segment_offset_;
+    }
+    return row_count;
+}
+
+// Upper bound of the rows produced by the operator, max if it is unknown.
+SizeT EstimateRowCount(const PhysicalOperator *op) {
+    switch (op->operator_type()) {
+        case PhysicalOperatorType::kTableScan: {
+            return BlockIndexRowCount(*static_cast<const PhysicalTableScan *>(op)->base_table_ref_->block_index_);
+        }
+        case PhysicalOperatorType::kIndexScan: {
+            return BlockIndexRowCount(*static_cast<const PhysicalIndexScan *>(op)->GetBlockIndex());
+        }
+        case PhysicalOperatorType::kFilter:
+        case PhysicalOperatorType::kProjection:
+        case PhysicalOperatorType::kLimit: {
+            return EstimateRowCount(op->left());
+        }
+        default: {
+            return std::numeric_limits<SizeT>::max();
+        }
+    }
+}
+
+// Filter of the right rows whose key equals `key`.
+FilterExecuteSingleRange MakeKeyRange(const DataType &key_type, ColumnID inner_key_column_id, const Value &key) {
+    FilterExecuteSingleRange key_range(inner_key_column_id, FilterRangeType::kInterval);
+    switch (key_type.type()) {
+        case LogicalType::kTinyInt: {
+            key_range.SetIntervalRange<TinyIntT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kSmallInt: {
+            key_range.SetIntervalRange<SmallIntT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kInteger: {
+            key_range.SetIntervalRange<IntegerT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kBigInt: {
+            key_range.SetIntervalRange<BigIntT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kFloat: {
+            key_range.SetIntervalRange<FloatT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kDouble: {
+            key_range.SetIntervalRange<DoubleT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kDate: {
+            key_range.SetIntervalRange<DateT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kTime: {
+            key_range.SetIntervalRange<TimeT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kDateTime: {
+            key_range.SetIntervalRange<DateTimeT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kTimestamp: {
+            key_range.SetIntervalRange<TimestampT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        case LogicalType::kVarchar: {
+            key_range.SetIntervalRange<VarcharT>(key, FilterCompareType::kEqual);
+            break;
+        }
+        default: {
+            String error_message = fmt::format("Index join doesn't support key type: {}", key_type.ToString());
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+    }
+    return key_range;
+}
+
+} // namespace
+
+void PhysicalIndexJoin::Init() {
+    if (left_ == nullptr || right_ == nullptr) {
+        return;
+    }
+    output_types_ = GetOutputTypes();
+    Vector<SizeT> left_key_ids;
+    Vector<SizeT> right_key_ids;
+    if (!ExtractEquiJoinKeys(conditions_, left_->GetOutputTypes()->size(), left_key_ids, right_key_ids) || left_key_ids.size() != 1) {
+        String error_message = "Index join requires one equality condition between the left and the right input.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    left_key_id_ = left_key_ids[0];
+    inner_key_column_id_ = static_cast<const PhysicalTableScan *>(right_.get())->ColumnIDs()[right_key_ids[0]];
+    column_index_map_.emplace(inner_key_column_id_, inner_index_entry_);
+}
+
+bool PhysicalIndexJoin::Execute(QueryContext *query_context, OperatorState *operator_state) {
+    OperatorState *prev_op_state = operator_state->prev_op_state_;
+    auto inner_types = right_->GetOutputTypes();
+    Vector<Vector<RowID>> left_inner_rows;
+
+    for (const auto &left_block : prev_op_state->data_block_array_) {
+        Vector<UniquePtr<DataBlock>> output_blocks;
+        // Matched rows are read from the right table in batches of one block.
+        Vector<SizeT> pending_left_rows;
+        Vector<RowID> pending_inner_rows;
+        auto flush_pending_rows = [&]() {
+            if (pending_inner_rows.empty()) {
+                return;
+            }
+            auto inner_block = DataBlock::MakeUniquePtr();
+            inner_block->Init(*inner_types);
+            ReadInnerRows(query_context, pending_inner_rows, inner_block.get());
+            inner_block->Finalize();
+            for (SizeT idx = 0; idx < pending_inner_rows.size(); ++idx) {
+                AppendJoinOutputRow(output_blocks, *output_types_, left_block.get(), pending_left_rows[idx], inner_block.get(), idx);
+            }
+            pending_left_rows.clear();
+            pending_inner_rows.clear();
+        };
+
+        LookupInnerRows(query_context, left_block.get(), left_inner_rows);
+        SizeT left_row_count = left_block->row_count();
+        for (SizeT left_row = 0; left_row < left_row_count; ++left_row) {
+            const Vector<RowID> &inner_rows = left_inner_rows[left_row];
+            switch (join_type_) {
+                case JoinType::kInner:
+                case JoinType::kLeft: {
+                    for (const RowID &inner_row : inner_rows) {
+                        pending_left_rows.emplace_back(left_row);
+                        pending_inner_rows.emplace_back(inner_row);
+                        if (pending_inner_rows.size() == DEFAULT_VECTOR_SIZE) {
+                            flush_pending_rows();
+                        }
+                    }
+                    if (inner_rows.empty() && join_type_ == JoinType::kLeft) {
+                        AppendJoinOutputRow(output_blocks, *output_types_, left_block.get(), left_row, nullptr, 0);
+                    }
+                    break;
+                }
+                case JoinType::kSemi:
+                case JoinType::kAnti: {
+                    if (inner_rows.empty() == (join_type_ == JoinType::kAnti)) {
+                        AppendJoinOutputRow(output_blocks, *output_types_, left_block.get(), left_row, nullptr, 0);
+                    }
+                    break;
+                }
+                default: {
+                    String error_message = fmt::format("Index join doesn't support join type: {}", static_cast<int>(join_type_));
+                    LOG_CRITICAL(error_message);
+                    UnrecoverableError(error_message);
+                }
+            }
+        }
+        flush_pending_rows();
+
+        for (auto &output_block : output_blocks) {
+            output_block->Finalize();
+            operator_state->data_block_array_.emplace_back(std::move(output_block));
+        }
+    }
+    if (operator_state->data_block_array_.empty()) {
+        // The next operator expects at least one input block.
+        auto output_block = DataBlock::MakeUniquePtr();
+        output_block->Init(*output_types_);
+        output_block->Finalize();
+        operator_state->data_block_array_.emplace_back(std::move(output_block));
+    }
+    prev_op_state->data_block_array_.clear();
+    if (prev_op_state->Complete()) {
+        operator_state->SetComplete();
+    }
+    return true;
+}
+
+void PhysicalIndexJoin::LookupInnerRows(QueryContext *query_context, const DataBlock *left_block, Vector<Vector<RowID>> &inner_rows) const {
+    const SharedPtr<ColumnVector> &key_column = left_block->column_vectors[left_key_id_];
+    const DataType &key_type = *key_column->data_type();
+    bool constant_key = key_column->vector_type() == ColumnVectorType::kConstant;
+    SizeT left_row_count = left_block->row_count();
+    inner_rows.assign(left_row_count, {});
+
+    // The key filter of each left row, NULL keys never match and have no filter.
+    Vector<Vector<FilterExecuteElem>> key_filters(left_row_count);
+    for (SizeT left_row = 0; left_row < left_row_count; ++left_row) {
+        SizeT key_idx = constant_key ? 0 : left_row;
+        if (key_column->nulls_ptr_->IsTrue(key_idx)) {
+            key_filters[left_row].emplace_back(MakeKeyRange(key_type, inner_key_column_id_, key_column->GetValue(key_idx)));
+        }
+    }
+    // Varchar is indexed by its hash, the matched rows must be compared with the key.
+    bool check_key = key_type.type() == LogicalType::kVarchar;
 
-bool PhysicalIndexJoin::Execute(QueryContext *, OperatorState *) { return true; }
+    Txn *txn = query_context->GetTxn();
+    TxnTimeStamp begin_ts = txn->BeginTS();
+    BufferManager *buffer_mgr = query_context->storage()->buffer_manager();
+    const BlockIndex *block_index = static_cast<const PhysicalTableScan *>(right_.get())->base_table_ref_->block_index_.get();
+
+    // Each segment is set up once for all rows of the left block, the key column of the last read block is kept for the key checks.
+    for (const auto &[segment_id, segment_snapshot] : block_index->segment_block_index_) {
+        SegmentEntry *segment_entry = segment_snapshot.segment_entry_;
+        const u32 segment_row_count = segment_entry->row_count();
+        const u32 segment_actual_row_count = segment_entry->actual_row_count();
+        DeleteFilter delete_filter(segment_entry, begin_ts, segment_entry->row_count(begin_ts));
+        BlockEntry *current_block_entry = nullptr;
+        SharedPtr<ColumnVector> inner_key_column;
+
+        for (SizeT left_row = 0; left_row < left_row_count; ++left_row) {
+            if (key_filters[left_row].empty()) {
+                continue;
+            }
+            auto selected_rows =
+                SolveSecondaryIndexFilter(key_filters[left_row], column_index_map_, segment_id, segment_row_count, segment_actual_row_count, txn);
+            Vector<RowID> &left_row_inner_rows = inner_rows[left_row];
+            auto append_inner_row = [&](SegmentOffset segment_offset) {
+                if (!delete_filter(segment_offset)) {
+                    return;
+                }
+                if (check_key) {
+                    BlockEntry *block_entry = block_index->GetBlockEntry(segment_id, segment_offset / DEFAULT_BLOCK_CAPACITY);
+                    if (block_entry != current_block_entry) {
+                        current_block_entry = block_entry;
+                        BlockColumnEntry *column_entry = block_entry->GetColumnBlockEntry(inner_key_column_id_);
+                        inner_key_column = MakeShared<ColumnVector>(column_entry->GetColumnVector(buffer_mgr));
+                    }
+                    ColumnValueReader<VarcharT> left_key(key_column);
+                    ColumnValueReader<VarcharT> inner_key(inner_key_column);
+                    if (!CheckReaderValueEquality(left_key[constant_key ? 0 : left_row], inner_key[segment_offset % DEFAULT_BLOCK_CAPACITY])) {
+                        return;
+                    }
+                }
+                left_row_inner_rows.emplace_back(segment_id, segment_offset);
+            };
+            if (std::holds_alternative<Vector<u32>>(selected_rows)) {
+                for (u32 segment_offset : std::get<Vector<u32>>(selected_rows)) {
+                    append_inner_row(segment_offset);
+                }
+            } else {
+                const Bitmask &bitmask = std::get<Bitmask>(selected_rows);
+                for (u32 segment_offset = 0; segment_offset < segment_row_count; ++segment_offset) {
+                    if (bitmask.IsTrue(segment_offset)) {
+                        append_inner_row(segment_offset);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void PhysicalIndexJoin::ReadInnerRows(QueryContext *query_context, const Vector<RowID> &inner_rows, DataBlock *inner_block) const {
+    BufferManager *buffer_mgr = query_context->storage()->buffer_manager();
+    const auto *inner_scan = static_cast<const PhysicalTableScan *>(right_.get());
+    const BlockIndex *block_index = inner_scan->base_table_ref_->block_index_.get();
+    const Vector<SizeT> &column_ids = inner_scan->ColumnIDs();
+
+    // Rows of one key are usually in the same block, keep the column vectors of the last block.
+    BlockEntry *current_block_entry = nullptr;
+    Vector<ColumnVector> column_vectors;
+    for (const RowID &inner_row : inner_rows) {
+        BlockEntry *block_entry = block_index->GetBlockEntry(inner_row.segment_id_, inner_row.segment_offset_ / DEFAULT_BLOCK_CAPACITY);
+        if (block_entry != current_block_entry) {
+            current_block_entry = block_entry;
+            column_vectors.clear();
+            for (SizeT column_id : column_ids) {
+                if (column_id == COLUMN_IDENTIFIER_ROW_ID) {
+                    column_vectors.emplace_back();
+                } else {
+                    column_vectors.emplace_back(block_entry->GetColumnBlockEntry(column_id)->GetColumnVector(buffer_mgr));
+                }
+            }
+        }
+        BlockOffset block_offset = inner_row.segment_offset_ % DEFAULT_BLOCK_CAPACITY;
+        for (SizeT column_idx = 0; column_idx < column_ids.size(); ++column_idx) {
+            ColumnVector &output_column = *inner_block->column_vectors[column_idx];
+            if (column_ids[column_idx] == COLUMN_IDENTIFIER_ROW_ID) {
+                output_column.AppendWith(inner_row, 1);
+            } else {
+                output_column.AppendWith(column_vectors[column_idx], block_offset, 1);
+            }
+        }
+    }
+}
+
+TableIndexEntry *PhysicalIndexJoin::ChooseInnerIndex(QueryContext *query_context,
+                                                     JoinType join_type,
+                                                     const Vector<SharedPtr<BaseExpression>> &conditions,
+                                                     const PhysicalOperator *left,
+                                                     const PhysicalOperator *right) {
+    switch (join_type) {
+        case JoinType::kInner:
+        case JoinType::kLeft:
+        case JoinType::kSemi:
+        case JoinType::kAnti: {
+            break;
+        }
+        default: {
+            return nullptr;
+        }
+    }
+    if (right->operator_type() != PhysicalOperatorType::kTableScan) {
+        return nullptr;
+    }
+    const auto &left_types = *left->GetOutputTypes();
+    const auto &right_types = *right->GetOutputTypes();
+    Vector<SizeT> left_key_ids;
+    Vector<SizeT> right_key_ids;
+    if (!ExtractEquiJoinKeys(conditions, left_types.size(), left_key_ids, right_key_ids) || left_key_ids.size() != 1 ||
+        right_key_ids[0] >= right_types.size()) {
+        return nullptr;
+    }
+    const DataType &key_type = *left_types[left_key_ids[0]];
+    if (key_type != *right_types[right_key_ids[0]] || !SupportIndexKeyType(key_type)) {
+        return nullptr;
+    }
+
+    const auto *inner_scan = static_cast<const PhysicalTableScan *>(right);
+    const Vector<SizeT> &column_ids = inner_scan->ColumnIDs();
+    for (SizeT column_id : column_ids) {
+        if (column_id == COLUMN_IDENTIFIER_CREATE || column_id == COLUMN_IDENTIFIER_DELETE) {
+            return nullptr;
+        }
+    }
+
+    // Each left row costs an index lookup per segment, a scan of the right table is cheaper unless the left input is small.
+    SizeT outer_row_count = EstimateRowCount(left);
+    SizeT inner_row_count = BlockIndexRowCount(*inner_scan->base_table_ref_->block_index_);
+    if (outer_row_count == std::numeric_limits<SizeT>::max() || outer_row_count * INDEX_JOIN_MIN_INNER_RATIO > inner_row_count) {
+        return nullptr;
+    }
+
+    ColumnID inner_key_column_id = column_ids[right_key_ids[0]];
+    TransactionID txn_id = query_context->GetTxn()->TxnID();
+    TxnTimeStamp begin_ts = query_context->GetTxn()->BeginTS();
+    auto *table_entry = inner_scan->base_table_ref_->table_entry_ptr_;
+    auto map_guard = table_entry->IndexMetaMap();
+    for (auto &[index_name, table_index_meta] : *map_guard) {
+        auto [table_index_entry, status] = table_index_meta->GetEntryNolock(txn_id, begin_ts);
+        if (!status.ok()) {
+            // skip invalid entry, for example, the index is deleted
+            continue;
+        }
+        const IndexBase *index_base = table_index_entry->index_base();
+        if (index_base->index_type_ == IndexType::kSecondary && table_entry->GetColumnIdByName(index_base->column_name()) == inner_key_column_id) {
+            return table_index_entry;
+        }
+    }
+    return nullptr;
+}
 
 SharedPtr<Vector<String>> PhysicalIndexJoin::GetOutputNames() const {
+
     SharedPtr<Vector<String>> result = MakeShared<Vector<String>>();
     SharedPtr<Vector<String>> left_output_names = left_->GetOutputNames();
     SharedPtr<Vector<String>> right_output_names = right_->GetOutputNames();
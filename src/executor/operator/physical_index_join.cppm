@@ -22,19 +22,39 @@ import query_context;
 import operator_state;
 import physical_operator;
 import physical_operator_type;
+import base_expression;
 import load_meta;
 import infinity_exception;
 import internal_types;
+import join_reference;
 import data_type;
+import data_block;
+import table_index_entry;
 import logger;
 
 namespace infinity {
 
+// The left input is at most 1/INDEX_JOIN_MIN_INNER_RATIO of the right table for index join to be chosen.
+export constexpr SizeT INDEX_JOIN_MIN_INNER_RATIO = 16;
+
+// Index nested loop join: every left row looks up its key in the secondary index of the right table,
+// only the matched rows of the right table are read. The right child is the table scan of the inner table,
+// it isn't executed and only provides the table and the columns to read.
 export class PhysicalIndexJoin : public PhysicalOperator {
 public:
     explicit PhysicalIndexJoin(u64 id, SharedPtr<Vector<LoadMeta>> load_metas)
         : PhysicalOperator(PhysicalOperatorType::kJoinIndex, nullptr, nullptr, id, load_metas) {}
 
+    explicit PhysicalIndexJoin(u64 id,
+                               JoinType join_type,
+                               Vector<SharedPtr<BaseExpression>> conditions,
+                               UniquePtr<PhysicalOperator> left,
+                               UniquePtr<PhysicalOperator> right,
+                               TableIndexEntry *inner_index_entry,
+                               SharedPtr<Vector<LoadMeta>> load_metas)
+        : PhysicalOperator(PhysicalOperatorType::kJoinIndex, std::move(left), std::move(right), id, load_metas), join_type_(join_type),
+          conditions_(std::move(conditions)), inner_index_entry_(inner_index_entry) {}
+
     ~PhysicalIndexJoin() override = default;
 
     void Init() override;
@@ -45,12 +65,38 @@ public:
 
     SharedPtr<Vector<SharedPtr<DataType>>> GetOutputTypes() const final;
 
-    SizeT TaskletCount() override {
-        String error_message = "Not implement: TaskletCount not Implement";
-        LOG_CRITICAL(error_message);
-        UnrecoverableError(error_message);
-        return 0;
-    }
+    // Left rows are joined independently, the join runs in the tasks of the left input.
+    SizeT TaskletCount() override { return left_->TaskletCount(); }
+
+    inline JoinType join_type() const { return join_type_; }
+
+    inline const Vector<SharedPtr<BaseExpression>> &conditions() const { return conditions_; }
+
+    inline const TableIndexEntry *inner_index_entry() const { return inner_index_entry_; }
+
+    // Return the secondary index used to look up the right table, or nullptr if index join can't be used or
+    // the left input isn't small enough compared with the right table.
+    static TableIndexEntry *ChooseInnerIndex(QueryContext *query_context,
+                                             JoinType join_type,
+                                             const Vector<SharedPtr<BaseExpression>> &conditions,
+                                             const PhysicalOperator *left,
+                                             const PhysicalOperator *right);
+
+private:
+    // Look up the visible rows of the right table whose key equals the key of each row of the left block, inner_rows[i] gets the
+    // rows matching left row i.
+    void LookupInnerRows(QueryContext *query_context, const DataBlock *left_block, Vector<Vector<RowID>> &inner_rows) const;
+
+    // Read the output columns of the right table at the given rows into inner_block.
+    void ReadInnerRows(QueryContext *query_context, const Vector<RowID> &inner_rows, DataBlock *inner_block) const;
+
+    JoinType join_type_{JoinType::kInner};
+    Vector<SharedPtr<BaseExpression>> conditions_{};
+    TableIndexEntry *inner_index_entry_{};
+    SizeT left_key_id_{};
+    ColumnID inner_key_column_id_{};
+    HashMap<ColumnID, TableIndexEntry *> column_index_map_{};
+    SharedPtr<Vector<SharedPtr<DataType>>> output_types_{};
 };
 
 } // namespace infinity
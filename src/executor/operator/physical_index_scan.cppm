@@ -86,6 +86,8 @@ public:
 
     inline auto *TableEntry() const { return base_table_ref_->table_entry_ptr_; }
 
+    inline auto *GetBlockIndex() const { return base_table_ref_->block_index_.get(); }
+
     inline auto &FilterExpression() const { return index_filter_qualified_; }
 
 private:
@@ -68,6 +68,9 @@ import analyzer_pool;
 import bitmask;
 import segment_entry;
 import knn_filter;
+import utility;
+import task_scheduler;
+import defer_op;
 
 namespace infinity {
 
@@ -86,6 +89,8 @@ protected:
 
     const TxnTimeStamp begin_ts_ = common_query_filter_->begin_ts_;
     SegmentID current_segment_id_ = filter_result_ptr_->size() ? filter_result_ptr_->begin()->first : INVALID_SEGMENT_ID;
+    // segments from segment_id_end_ on are left to other tasks, see RestrictSegments()
+    SegmentID segment_id_end_ = INVALID_SEGMENT_ID;
     mutable SegmentID cache_segment_id_ = INVALID_SEGMENT_ID;
     mutable SegmentOffset cache_segment_offset_ = 0;
     using SegEntryT = const SegmentEntry *;
@@ -118,7 +123,7 @@ protected:
         }
         while (true) {
             if (const SegmentID segment_id = doc_id.segment_id_; segment_id > current_segment_id_) {
-                if (const auto it = filter_result_ptr_->lower_bound(segment_id); it == filter_result_ptr_->end()) {
+                if (const auto it = filter_result_ptr_->lower_bound(segment_id); it == filter_result_ptr_->end() || it->first >= segment_id_end_) {
                     current_segment_id_ = INVALID_SEGMENT_ID;
                     return false;
                 } else {
@@ -287,6 +292,13 @@ public:
     FilterIteratorBase(const CommonQueryFilter *common_query_filter, UniquePtr<QueryIteratorT> &&query_iterator)
         : query_iterator_(std::move(query_iterator)), common_query_filter_(common_query_filter) {}
 
+    // Only search the segments in [segment_id_begin, segment_id_end), called before the search starts.
+    void RestrictSegments(SegmentID segment_id_begin, SegmentID segment_id_end) {
+        segment_id_end_ = segment_id_end;
+        const auto it = filter_result_ptr_->lower_bound(segment_id_begin);
+        current_segment_id_ = (it == filter_result_ptr_->end() || it->first >= segment_id_end_) ? INVALID_SEGMENT_ID : it->first;
+    }
+
     // common
     void PrintTree(std::ostream &os, const String &prefix, bool is_final) const override {
         os << prefix;
@@ -367,6 +379,15 @@ class FilterIterator<EarlyTerminateIterator> final : public FilterIteratorBase<E
     RowID common_block_min_possible_doc_id_{}; // not always exist
     RowID common_block_last_doc_id_{};
 
+    // for BulkScore(), docs are checked in ascending order
+    bool SelfAccept(RowID doc_id) {
+        if (!SelfBlockSkipTo(doc_id) || doc_id.segment_id_ != current_segment_id_) {
+            return false;
+        }
+        const auto [success, id] = SelfSeekInBlockRange(doc_id, doc_id);
+        return success && id == doc_id;
+    }
+
 public:
     explicit FilterIterator(const CommonQueryFilter *common_query_filter, UniquePtr<EarlyTerminateIterator> &&query_iterator)
         : FilterIteratorBase(common_query_filter, std::move(query_iterator)) {
@@ -466,6 +487,26 @@ public:
     }
     float BlockMaxBM25Score() override { return query_iterator_->BlockMaxBM25Score(); }
     float BM25Score() override { return query_iterator_->BM25Score(); }
+    bool BulkScore(RowID begin_doc_id,
+                   RowID end_doc_id,
+                   FullTextScoreResultHeap &result_heap,
+                   const std::function<bool(RowID)> &filter,
+                   u32 &candidate_cnt) override {
+        if (current_segment_id_ == INVALID_SEGMENT_ID) {
+            return true;
+        }
+        // only the segments of the filter are scored
+        begin_doc_id = std::max(begin_doc_id, RowID(current_segment_id_, 0));
+        if (segment_id_end_ != INVALID_SEGMENT_ID) {
+            end_doc_id = std::min(end_doc_id, RowID(segment_id_end_, 0));
+        }
+        return query_iterator_->BulkScore(
+            begin_doc_id,
+            end_doc_id,
+            result_heap,
+            [this, &filter](RowID doc_id) { return SelfAccept(doc_id) && filter(doc_id); },
+            candidate_cnt);
+    }
     Pair<bool, RowID> SeekInBlockRange(RowID doc_id, RowID doc_id_no_beyond) override {
         String error_message = "Unreachable code!";
         LOG_CRITICAL(error_message);
@@ -575,6 +616,11 @@ void ExecuteFTSearch(UniquePtr<EarlyTerminateIterator> &et_iter,
     // et_iter is nullptr if fulltext index is present but there's no data
     if (et_iter == nullptr)
         return;
+    // term queries and "OR" of terms are scored a block at a time
+    if (et_iter->BulkScore(RowID(0, 0), INVALID_ROWID, result_heap, [](RowID) { return true; }, blockmax_loop_cnt)) {
+        return;
+    }
+    float pushed_threshold = 0.0f;
     switch (early_term_algo) {
         case EarlyTermAlgo::kBMM: {
             while (true) {
@@ -583,11 +629,11 @@ void ExecuteFTSearch(UniquePtr<EarlyTerminateIterator> &et_iter,
                     break;
                 }
                 ++blockmax_loop_cnt;
-                if (result_heap.AddResult(et_score, id)) {
-                    // update threshold
-                    if (const float new_threshold = result_heap.GetScoreThreshold(); new_threshold > 0.0f) {
-                        et_iter->UpdateScoreThreshold(new_threshold);
-                    }
+                result_heap.AddResult(et_score, id);
+                // update threshold, other tasks of the query may raise it as well
+                if (const float new_threshold = result_heap.GetScoreThreshold(); new_threshold > pushed_threshold) {
+                    et_iter->UpdateScoreThreshold(new_threshold);
+                    pushed_threshold = new_threshold;
                 }
                 if (blockmax_loop_cnt % 10 == 0) {
                     LOG_DEBUG(fmt::format("ExecuteFTSearch has evaluated {} candidates", blockmax_loop_cnt));
@@ -605,11 +651,11 @@ void ExecuteFTSearch(UniquePtr<EarlyTerminateIterator> &et_iter,
                 }
                 RowID id = et_iter->DocID();
                 float et_score = et_iter->BM25Score();
-                if (result_heap.AddResult(et_score, id)) {
-                    // update threshold
-                    if (const float new_threshold = result_heap.GetScoreThreshold(); new_threshold > 0.0f) {
-                        et_iter->UpdateScoreThreshold(new_threshold);
-                    }
+                result_heap.AddResult(et_score, id);
+                // update threshold, other tasks of the query may raise it as well
+                if (const float new_threshold = result_heap.GetScoreThreshold(); new_threshold > pushed_threshold) {
+                    et_iter->UpdateScoreThreshold(new_threshold);
+                    pushed_threshold = new_threshold;
                 }
                 if (blockmax_loop_cnt % 10 == 0) {
                     LOG_DEBUG(fmt::format("ExecuteFTSearch has evaluated {} candidates", blockmax_loop_cnt));
@@ -619,6 +665,64 @@ void ExecuteFTSearch(UniquePtr<EarlyTerminateIterator> &et_iter,
     }
 }
 
+// The segments of the filter are split into contiguous ranges searched by worker_count parallel tasks, on the calling thread
+// and the scheduler workers reserved by the caller. Every task but the first one creates its own iterator with create_et_iter.
+// The tasks share the k-th score of their heaps, so each block-max iterator prunes with the best threshold found in the whole
+// table.
+void ExecuteFTSearchParallel(UniquePtr<EarlyTerminateIterator> &et_iter,
+                             const std::function<UniquePtr<EarlyTerminateIterator>()> &create_et_iter,
+                             const CommonQueryFilter &common_query_filter,
+                             const SizeT worker_count,
+                             const u32 top_n,
+                             FullTextScoreResultHeap &result_heap,
+                             u32 &blockmax_loop_cnt,
+                             const EarlyTermAlgo early_term_algo) {
+    Vector<SegmentID> segment_ids;
+    for (const auto &[segment_id, filter_result] : common_query_filter.filter_result_) {
+        segment_ids.push_back(segment_id);
+    }
+    const SizeT task_count = std::min(worker_count, segment_ids.size());
+    if (et_iter == nullptr || task_count <= 1) {
+        ExecuteFTSearch(et_iter, result_heap, blockmax_loop_cnt, early_term_algo);
+        return;
+    }
+    // the iterators look up the dictionaries, they are created serially and only the search runs in parallel
+    Vector<UniquePtr<EarlyTerminateIterator>> task_iters(task_count);
+    task_iters[0] = std::move(et_iter);
+    for (SizeT task_idx = 1; task_idx < task_count; ++task_idx) {
+        task_iters[task_idx] = create_et_iter();
+    }
+    for (SizeT task_idx = 0; task_idx < task_count; ++task_idx) {
+        const SegmentID segment_id_begin = segment_ids[task_idx * segment_ids.size() / task_count];
+        const SegmentID segment_id_end =
+            task_idx + 1 < task_count ? segment_ids[(task_idx + 1) * segment_ids.size() / task_count] : INVALID_SEGMENT_ID;
+        // the root iterator is created by FilterQueryNode
+        if (task_iters[task_idx] != nullptr) {
+            static_cast<FilterIterator<EarlyTerminateIterator> *>(task_iters[task_idx].get())->RestrictSegments(segment_id_begin, segment_id_end);
+        }
+    }
+
+    FullTextScoreThreshold shared_threshold;
+    Vector<UniquePtr<float[]>> task_score_results(task_count);
+    Vector<UniquePtr<RowID[]>> task_row_id_results(task_count);
+    Vector<u32> task_result_counts(task_count, 0);
+    Vector<u32> task_loop_cnts(task_count, 0);
+    Utility::RunParallel(task_count, task_count, [&](SizeT task_idx) {
+        task_score_results[task_idx] = MakeUniqueForOverwrite<float[]>(top_n);
+        task_row_id_results[task_idx] = MakeUniqueForOverwrite<RowID[]>(top_n);
+        FullTextScoreResultHeap task_heap(top_n, task_score_results[task_idx].get(), task_row_id_results[task_idx].get());
+        task_heap.SetSharedThreshold(&shared_threshold);
+        ExecuteFTSearch(task_iters[task_idx], task_heap, task_loop_cnts[task_idx], early_term_algo);
+        task_result_counts[task_idx] = task_heap.GetResultSize();
+    });
+    for (SizeT task_idx = 0; task_idx < task_count; ++task_idx) {
+        for (u32 i = 0; i < task_result_counts[task_idx]; ++i) {
+            result_heap.AddResult(task_score_results[task_idx][i], task_row_id_results[task_idx][i]);
+        }
+        blockmax_loop_cnt += task_loop_cnts[task_idx];
+    }
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-variable" 
 #pragma clang diagnostic ignored "-Wunused-but-set-variable"
@@ -724,7 +828,38 @@ bool PhysicalMatch::ExecuteInnerHomebrewed(QueryContext *query_context, Operator
 #ifdef INFINITY_DEBUG
         auto blockmax_begin_ts = std::chrono::high_resolution_clock::now();
 #endif
-        ExecuteFTSearch(et_iter, result_heap, blockmax_loop_cnt, early_term_algo_);
+        if (use_ordinary_iter) {
+            // keep the comparison with the ordinary iterator serial
+            ExecuteFTSearch(et_iter, result_heap, blockmax_loop_cnt, early_term_algo_);
+        } else {
+            // every task scores with the column length readers of its own query builder
+            Vector<UniquePtr<QueryBuilder>> task_query_builders;
+            auto create_et_iter = [&]() -> UniquePtr<EarlyTerminateIterator> {
+                auto &task_query_builder = task_query_builders.emplace_back(MakeUnique<QueryBuilder>(base_table_ref_.get()));
+                task_query_builder->Init(index_reader_);
+                auto task_iter = task_query_builder->CreateEarlyTerminateSearch(full_text_query_context, early_term_algo_);
+                if (task_iter != nullptr && begin_threshold_ > 0.0f) {
+                    task_iter->UpdateScoreThreshold(begin_threshold_);
+                }
+                return task_iter;
+            };
+            // the segment ranges are searched on this worker and on the scheduler workers idle at the moment, so concurrent
+            // queries don't multiply the threads
+            const SizeT max_worker_count = std::min<SizeT>(std::max<SizeT>(1, query_context->cpu_number_limit()),
+                                                           std::max<SizeT>(1, common_query_filter_->filter_result_.size()));
+            TaskScheduler *scheduler = query_context->scheduler();
+            const u64 extra_worker_count = scheduler->ReserveExtraWorkers(max_worker_count - 1);
+            DeferFn release_workers([&] { scheduler->ReleaseExtraWorkers(extra_worker_count); });
+            const SizeT worker_count = 1 + extra_worker_count;
+            ExecuteFTSearchParallel(et_iter,
+                                    create_et_iter,
+                                    *common_query_filter_,
+                                    worker_count,
+                                    top_n_,
+                                    result_heap,
+                                    blockmax_loop_cnt,
+                                    early_term_algo_);
+        }
         result_heap.Sort();
         blockmax_result_count = result_heap.GetResultSize();
 #ifdef INFINITY_DEBUG
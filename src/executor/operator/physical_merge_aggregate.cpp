@@ -26,6 +26,13 @@ import data_block;
 
 import physical_aggregate;
 import aggregate_expression;
+import aggregate_function;
+import hash_table;
+import column_vector;
+import logical_type;
+import utility;
+import task_scheduler;
+import defer_op;
 
 import infinity_exception;
 
@@ -36,13 +43,35 @@ namespace infinity {
 template <typename T>
 using MathOperation = std::function<T(T, T)>;
 
+namespace {
+
+constexpr SizeT MERGE_AGGREGATE_MAX_PARTITION_BITS = 8;
+constexpr SizeT MERGE_AGGREGATE_PARTITION_MIN_ROWS = 4096;
+
+} // namespace
+
 void PhysicalMergeAggregate::Init() {}
 
 bool PhysicalMergeAggregate::Execute(QueryContext *query_context, OperatorState *operator_state) {
 
     auto merge_aggregate_op_state = static_cast<MergeAggregateOperatorState *>(operator_state);
 
-    SimpleMergeAggregateExecute(merge_aggregate_op_state);
+    auto agg_op = static_cast<PhysicalAggregate *>(this->left());
+    if (!agg_op->groups_.empty()) {
+        // Groups of one task may appear in any other task, wait for all partial results.
+        if (!merge_aggregate_op_state->input_complete_) {
+            return false;
+        }
+        GroupByMergeAggregateExecute(query_context, merge_aggregate_op_state);
+        merge_aggregate_op_state->SetComplete();
+        return true;
+    }
+
+    for (auto &input_data_block : merge_aggregate_op_state->input_data_blocks_) {
+        merge_aggregate_op_state->input_data_block_ = std::move(input_data_block);
+        SimpleMergeAggregateExecute(merge_aggregate_op_state);
+    }
+    merge_aggregate_op_state->input_data_blocks_.clear();
 
     if (merge_aggregate_op_state->input_complete_) {
 
@@ -108,6 +137,110 @@ void PhysicalMergeAggregate::SimpleMergeAggregateExecute(MergeAggregateOperatorS
     }
 }
 
+void PhysicalMergeAggregate::GroupByMergeAggregateExecute(QueryContext *query_context, MergeAggregateOperatorState *op_state) {
+    auto agg_op = static_cast<PhysicalAggregate *>(this->left());
+    SizeT group_count = agg_op->groups_.size();
+    SizeT aggregates_count = agg_op->aggregates_.size();
+    SizeT hash_column_idx = group_count + aggregates_count;
+
+    Vector<UniquePtr<DataBlock>> input_blocks;
+    SizeT input_row_count = 0;
+    for (auto &input_block : op_state->input_data_blocks_) {
+        if (input_block.get() != nullptr && input_block->row_count() > 0) {
+            input_row_count += input_block->row_count();
+            input_blocks.emplace_back(std::move(input_block));
+        }
+    }
+    op_state->input_data_blocks_.clear();
+    SizeT block_count = input_blocks.size();
+
+    // Make enough partitions to balance the workers, but keep each partition big enough to be worth a hash table.
+    const SizeT cpu_limit = std::max<SizeT>(1, query_context->cpu_number_limit());
+    SizeT partition_bits = 0;
+    while (partition_bits < MERGE_AGGREGATE_MAX_PARTITION_BITS && (1ul << partition_bits) < cpu_limit * 4 &&
+           (input_row_count >> (partition_bits + 1)) >= MERGE_AGGREGATE_PARTITION_MIN_ROWS) {
+        ++partition_bits;
+    }
+    SizeT partition_count = 1ul << partition_bits;
+
+    // The merge runs on this worker and on the scheduler workers idle at the moment, so it doesn't start threads beyond the cpu
+    // limit next to the other query tasks.
+    TaskScheduler *scheduler = query_context->scheduler();
+    const u64 extra_worker_count = scheduler->ReserveExtraWorkers(std::min(cpu_limit, std::max(block_count, partition_count)) - 1);
+    DeferFn release_workers([&] { scheduler->ReleaseExtraWorkers(extra_worker_count); });
+    const SizeT worker_count = 1 + extra_worker_count;
+
+    // 1. Split the rows of each block into partitions by the hashes computed by the aggregate tasks.
+    Vector<Vector<Vector<u32>>> partition_rows(block_count, Vector<Vector<u32>>(partition_count));
+    Utility::RunParallel(block_count, worker_count, [&](SizeT block_idx) {
+        const DataBlock *input_block = input_blocks[block_idx].get();
+        const u64 *hashes = reinterpret_cast<const u64 *>(input_block->column_vectors[hash_column_idx]->data());
+        SizeT row_count = input_block->row_count();
+        for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+            partition_rows[block_idx][AggregateHashTable::PartitionOf(hashes[row_idx], partition_bits)].emplace_back(row_idx);
+        }
+    });
+
+    // 2. Merge the states of the same group in each partition, then output the results of the partition.
+    Vector<Vector<UniquePtr<DataBlock>>> partition_outputs(partition_count);
+    Utility::RunParallel(partition_count, worker_count, [&](SizeT partition_idx) {
+        UniquePtr<AggregateHashTable> hash_table = agg_op->CreateHashTable();
+        Vector<ptr_t> group_ptrs;
+        Vector<ptr_t> new_groups;
+        Vector<ptr_t> state_ptrs;
+        for (SizeT block_idx = 0; block_idx < block_count; ++block_idx) {
+            const Vector<u32> &rows = partition_rows[block_idx][partition_idx];
+            if (rows.empty()) {
+                continue;
+            }
+            const DataBlock *input_block = input_blocks[block_idx].get();
+            Vector<SharedPtr<ColumnVector>> key_columns(input_block->column_vectors.begin(), input_block->column_vectors.begin() + group_count);
+            const u64 *hashes = reinterpret_cast<const u64 *>(input_block->column_vectors[hash_column_idx]->data());
+            new_groups.clear();
+            hash_table->FindOrCreateGroups(key_columns, hashes, rows, group_ptrs, new_groups);
+            for (SizeT expr_idx = 0; expr_idx < aggregates_count; ++expr_idx) {
+                const AggregateFunction &aggregate_function =
+                    static_cast<AggregateExpression *>(agg_op->aggregates_[expr_idx].get())->aggregate_function_;
+                for (ptr_t group : new_groups) {
+                    aggregate_function.init_func_(hash_table->GetState(group, expr_idx));
+                }
+                const SharedPtr<ColumnVector> &partial_column = input_block->column_vectors[group_count + expr_idx];
+                if (aggregate_function.return_type_.type() == LogicalType::kVarchar) {
+                    // the partial results are varchar values, e.g. FIRST of each task, aggregate them again
+                    auto partial_results = MakeShared<ColumnVector>(partial_column->data_type());
+                    partial_results->Initialize(ColumnVectorType::kFlat, rows.size());
+                    state_ptrs.resize(rows.size());
+                    for (SizeT idx = 0; idx < rows.size(); ++idx) {
+                        partial_results->AppendWith(*partial_column, rows[idx], 1);
+                        state_ptrs[idx] = hash_table->GetState(group_ptrs[idx], expr_idx);
+                    }
+                    aggregate_function.scatter_update_func_(state_ptrs.data(), partial_results, rows.size());
+                    agg_op->CopyVarcharStates(*hash_table, expr_idx, new_groups, *partial_results);
+                    continue;
+                }
+                const_ptr_t partial_states = partial_column->data();
+                SizeT state_size = aggregate_function.state_size_;
+                for (SizeT idx = 0; idx < rows.size(); ++idx) {
+                    aggregate_function.combine_func_(hash_table->GetState(group_ptrs[idx], expr_idx), partial_states + rows[idx] * state_size);
+                }
+            }
+        }
+        agg_op->OutputGroups(*hash_table, false, partition_outputs[partition_idx]);
+    });
+
+    for (auto &output_blocks : partition_outputs) {
+        for (auto &output_block : output_blocks) {
+            op_state->data_block_array_.emplace_back(std::move(output_block));
+        }
+    }
+    if (op_state->data_block_array_.empty()) {
+        auto output_block = DataBlock::MakeUniquePtr();
+        output_block->Init(*output_types_);
+        output_block->Finalize();
+        op_state->data_block_array_.emplace_back(std::move(output_block));
+    }
+}
+
 template <typename T>
 void PhysicalMergeAggregate::HandleAggregateFunction(const String &function_name, MergeAggregateOperatorState *op_state, SizeT col_idx) {
     LOG_TRACE(function_name);
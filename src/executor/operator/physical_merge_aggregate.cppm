@@ -73,6 +73,10 @@ public:
 
     void SimpleMergeAggregateExecute(MergeAggregateOperatorState *merge_aggregate_op_state);
 
+    // Merge the partial group by results of all aggregate tasks. The groups are split into partitions by hash,
+    // and each partition is merged into its own hash table by one worker.
+    void GroupByMergeAggregateExecute(QueryContext *query_context, MergeAggregateOperatorState *merge_aggregate_op_state);
+
     template <typename T>
     void UpdateData(MergeAggregateOperatorState *op_state, MathOperation<T> operation, SizeT col_idx);
 
@@ -49,11 +49,17 @@ import merge_knn;
 import knn_result_handler;
 import ann_ivf_flat;
 import annivfflat_index_data;
+import ann_ivf_pq;
+import annivfpq_index_data;
+import diskann_index_data;
 import buffer_handle;
 import data_block;
 import bitmask;
 import column_vector;
 import index_hnsw;
+import index_ivfflat;
+import float16;
+import bfloat16;
 import status;
 import create_index_info;
 import knn_expr;
@@ -236,7 +242,8 @@ void PhysicalKnnScan::PlanWithIndex(QueryContext *query_context) { // TODO: retu
             }
             // check index type
             if (auto index_type = table_index_entry->index_base()->index_type_;
-                index_type != IndexType::kIVFFlat and index_type != IndexType::kHnsw) {
+                index_type != IndexType::kIVFFlat and index_type != IndexType::kIVFPQ and index_type != IndexType::kDiskAnn and
+                index_type != IndexType::kHnsw) {
                 LOG_TRACE(fmt::format("KnnScan: PlanWithIndex(): Skipping non-knn index."));
                 continue;
             }
@@ -310,7 +317,14 @@ void PhysicalKnnScan::ExecuteInternal(QueryContext *query_context, KnnScanOperat
                 block_entry->SetDeleteBitmask(begin_ts, bitmask);
                 ColumnVector column_vector = block_column_entry->GetColumnVector(buffer_mgr);
                 auto data = reinterpret_cast<const DataType *>(column_vector.data());
-                merge_heap->Search(query, data, knn_scan_shared_data->dimension_, dist_func->dist_func_, row_count, segment_id, block_id, bitmask);
+                const SizeT dimension = knn_scan_shared_data->dimension_;
+                if (dist_func->bounded_dist_func_ != nullptr) {
+                    // the rows are abandoned as soon as their partial distance can't beat the threshold
+                    merge_heap->Search(query, data, dimension, dist_func->bounded_dist_func_, row_count, segment_id, block_id, bitmask);
+                } else {
+                    merge_heap->Search(query, data, dimension, dist_func->dist_func_, row_count, segment_id, block_id, bitmask);
+                }
+                merge_heap->SyncBound(knn_scan_shared_data->topk_bound_);
             }
             block_column_idx = knn_scan_shared_data->current_block_idx_++;
         } while (block_column_idx < brute_task_n);
@@ -349,205 +363,471 @@ void PhysicalKnnScan::ExecuteInternal(QueryContext *query_context, KnnScanOperat
             }
             bool use_bitmask = !bitmask.IsAllTrue();
 
-            switch (segment_index_entry->table_index_entry()->index_base()->index_type_) {
-                case IndexType::kIVFFlat: {
-                    BufferHandle index_handle = segment_index_entry->GetIndex();
-                    auto index = static_cast<const AnnIVFFlatIndexData<DataType> *>(index_handle.GetData());
-                    i32 n_probes = 1;
-                    auto IVFFlatScanTemplate = [&]<typename AnnIVFFlatType, typename... OptionalFilter>(OptionalFilter &&...filter) {
-                        AnnIVFFlatType ann_ivfflat_query(query,
-                                                         knn_scan_shared_data->query_count_,
-                                                         knn_scan_shared_data->topk_,
-                                                         knn_scan_shared_data->dimension_,
-                                                         knn_scan_shared_data->elem_type_);
-                        ann_ivfflat_query.Begin();
-                        ann_ivfflat_query.Search(index, segment_id, n_probes, std::forward<OptionalFilter>(filter)...);
-                        ann_ivfflat_query.EndWithoutSort();
-                        auto dists = ann_ivfflat_query.GetDistances();
-                        auto row_ids = ann_ivfflat_query.GetIDs();
-                        // TODO: now only work for one query
-                        // FIXME: cant work for multiple queries
-                        auto result_count = std::lower_bound(dists,
-                                                             dists + knn_scan_shared_data->topk_,
-                                                             AnnIVFFlatType::InvalidValue(),
-                                                             AnnIVFFlatType::CompareDist) -
-                                            dists;
-                        merge_heap->Search(dists, row_ids, result_count);
-                    };
-                    auto IVFFlatScan = [&]<typename... OptionalFilter>(OptionalFilter &&...filter) {
+            // Merge the sorted candidates of an IVF index, recomputing their distances with the raw vectors if rerank is set.
+            auto MergeIVFResult = [&](u64 query_idx, DataType *dists, RowID *row_ids, SizeT result_count, bool rerank) {
+                if (!rerank) {
+                    merge_heap->Search(query_idx, dists, row_ids, result_count);
+                    return;
+                }
+                const SizeT dimension = knn_scan_shared_data->dimension_;
+                const DataType *query_i = query + query_idx * dimension;
+                std::sort(row_ids, row_ids + result_count); // read the raw vectors block by block
+                BlockID prev_block_id = -1;
+                ColumnVector column_vector;
+                for (SizeT idx = 0; idx < result_count; ++idx) {
+                    SegmentOffset segment_offset = row_ids[idx].segment_offset_;
+                    BlockID block_id = segment_offset / DEFAULT_BLOCK_CAPACITY;
+                    BlockOffset block_offset = segment_offset % DEFAULT_BLOCK_CAPACITY;
+                    if (block_id != prev_block_id) {
+                        prev_block_id = block_id;
+                        BlockEntry *block_entry = block_index->GetBlockEntry(segment_id, block_id);
+                        BlockColumnEntry *block_column_entry = block_entry->GetColumnBlockEntry(knn_column_id);
+                        column_vector = block_column_entry->GetColumnVector(buffer_mgr);
+                    }
+                    const auto *data = reinterpret_cast<const DataType *>(column_vector.data()) + block_offset * dimension;
+                    DataType distance = dist_func->dist_func_(query_i, data, dimension);
+                    merge_heap->Search(query_idx, &distance, row_ids + idx, 1);
+                }
+            };
+
+            KnnFilterStrategy filter_strategy = KnnFilterStrategy::kIndex;
+            if (use_bitmask) {
+                SizeT filtered_row_count = 0;
+                if (std::holds_alternative<Vector<u32>>(filter_result)) {
+                    filtered_row_count = std::get<Vector<u32>>(filter_result).size();
+                } else {
+                    filtered_row_count = bitmask.CountTrue();
+                }
+                if (knn_scan_shared_data->filter_strategy_.has_value()) {
+                    filter_strategy = *knn_scan_shared_data->filter_strategy_;
+                } else {
+                    filter_strategy = ChooseKnnFilterStrategy(filtered_row_count, segment_row_count, knn_scan_shared_data->topk_);
+                }
+                LOG_TRACE(fmt::format("KnnScan: segment {} filter passes {}/{} rows", segment_id, filtered_row_count, segment_row_count));
+            }
+
+            if (filter_strategy == KnnFilterStrategy::kBruteForce) {
+                // The index search would mostly visit rows failing the filter, scanning the passing rows is exact and cheaper.
+                const SizeT dimension = knn_scan_shared_data->dimension_;
+                const bool check_delete = segment_entry->CheckAnyDelete(begin_ts);
+                DeleteFilter delete_filter(segment_entry, begin_ts, block_index->GetSegmentOffset(segment_id));
+                BlockID prev_block_id = -1;
+                ColumnVector column_vector;
+                auto ScanRow = [&](SegmentOffset segment_offset) {
+                    if (check_delete && !delete_filter(segment_offset)) {
+                        return;
+                    }
+                    BlockID block_id = segment_offset / DEFAULT_BLOCK_CAPACITY;
+                    BlockOffset block_offset = segment_offset % DEFAULT_BLOCK_CAPACITY;
+                    if (block_id != prev_block_id) {
+                        prev_block_id = block_id;
+                        BlockEntry *block_entry = block_index->GetBlockEntry(segment_id, block_id);
+                        BlockColumnEntry *block_column_entry = block_entry->GetColumnBlockEntry(knn_column_id);
+                        column_vector = block_column_entry->GetColumnVector(buffer_mgr);
+                    }
+                    const auto *data = reinterpret_cast<const DataType *>(column_vector.data()) + block_offset * dimension;
+                    merge_heap->Search(query, data, dimension, dist_func->dist_func_, segment_id, segment_offset);
+                };
+                if (std::holds_alternative<Vector<u32>>(filter_result)) {
+                    for (u32 row_id : std::get<Vector<u32>>(filter_result)) {
+                        ScanRow(row_id);
+                    }
+                } else {
+                    for (SegmentOffset segment_offset = 0; segment_offset < segment_row_count; ++segment_offset) {
+                        if (bitmask.IsTrue(segment_offset)) {
+                            ScanRow(segment_offset);
+                        }
+                    }
+                }
+            } else {
+                switch (segment_index_entry->table_index_entry()->index_base()->index_type_) {
+                    case IndexType::kIVFFlat: {
+                        BufferHandle index_handle = segment_index_entry->GetIndex();
+                        const auto *index_ivfflat = static_cast<const IndexIVFFlat *>(segment_index_entry->table_index_entry()->index_base());
+                        const u32 n_probes = knn_scan_shared_data->ivf_nprobe_;
+                        const u64 query_count = knn_scan_shared_data->query_count_;
+                        // plain lists give exact distances, only the scalar quantized ones are worth reranking
+                        const bool rerank = knn_scan_shared_data->rerank_ && index_ivfflat->encode_type_ != IVFFlatEncodeType::kPlain;
+                        const u32 candidate_n = knn_scan_shared_data->topk_ * (rerank ? IVF_RERANK_CANDIDATE_FACTOR : 1);
+                        auto IVFFlatScanTemplate = [&]<typename AnnIVFFlatType, typename IndexData, typename... OptionalFilter>(
+                                                       OptionalFilter &&...filter) {
+                            auto index = static_cast<const IndexData *>(index_handle.GetData());
+                            AnnIVFFlatType ann_ivfflat_query(query,
+                                                             query_count,
+                                                             candidate_n,
+                                                             knn_scan_shared_data->dimension_,
+                                                             knn_scan_shared_data->elem_type_);
+                            ann_ivfflat_query.Begin();
+                            if (!rerank) {
+                                // the candidates that can't beat the results of the other segments are skipped
+                                merge_heap->SyncBound(knn_scan_shared_data->topk_bound_);
+                                for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                    ann_ivfflat_query.TightenThreshold(query_idx, merge_heap->GetThreshold(query_idx));
+                                }
+                            }
+                            ann_ivfflat_query.Search(index, segment_id, n_probes, std::forward<OptionalFilter>(filter)...);
+                            ann_ivfflat_query.End();
+                            for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                DataType *dists = ann_ivfflat_query.GetDistanceByIdx(query_idx);
+                                RowID *row_ids = ann_ivfflat_query.GetIDByIdx(query_idx);
+                                const SizeT result_count =
+                                    std::lower_bound(dists, dists + candidate_n, AnnIVFFlatType::InvalidValue(), AnnIVFFlatType::CompareDist) - dists;
+                                MergeIVFResult(query_idx, dists, row_ids, result_count, rerank);
+                            }
+                        };
+                        auto IVFFlatScanEncoded = [&]<typename VectorDataType, typename... OptionalFilter>(OptionalFilter &&...filter) {
+                            using IndexData = AnnIVFFlatIndexData<DataType, VectorDataType>;
+                            switch (knn_scan_shared_data->knn_distance_type_) {
+                                case KnnDistanceType::kL2: {
+                                    IVFFlatScanTemplate.template operator()<AnnIVFFlatL2<DataType, VectorDataType>, IndexData>(
+                                        std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                case KnnDistanceType::kInnerProduct: {
+                                    IVFFlatScanTemplate.template operator()<AnnIVFFlatIP<DataType, VectorDataType>, IndexData>(
+                                        std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                case KnnDistanceType::kCosine: {
+                                    if constexpr (std::is_same_v<VectorDataType, DataType>) {
+                                        IVFFlatScanTemplate.template operator()<AnnIVFFlatCOS<DataType>, IndexData>(
+                                            std::forward<OptionalFilter>(filter)...);
+                                    } else {
+                                        Status status = Status::NotSupport("Not implemented KNN distance for scalar quantized IVFFlat index");
+                                        LOG_ERROR(status.message());
+                                        RecoverableError(status);
+                                    }
+                                    break;
+                                }
+                                default: {
+                                    Status status = Status::NotSupport("Not implemented KNN distance");
+                                    LOG_ERROR(status.message());
+                                    RecoverableError(status);
+                                }
+                            }
+                        };
+                        auto IVFFlatScan = [&]<typename... OptionalFilter>(OptionalFilter &&...filter) {
+                            switch (index_ivfflat->encode_type_) {
+                                case IVFFlatEncodeType::kPlain: {
+                                    IVFFlatScanEncoded.template operator()<DataType>(std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                case IVFFlatEncodeType::kFloat16: {
+                                    IVFFlatScanEncoded.template operator()<float16_t>(std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                case IVFFlatEncodeType::kBFloat16: {
+                                    IVFFlatScanEncoded.template operator()<bfloat16_t>(std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                case IVFFlatEncodeType::kInt8: {
+                                    IVFFlatScanEncoded.template operator()<u8>(std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                default: {
+                                    String error_message = "Invalid IVFFlat encode type";
+                                    LOG_CRITICAL(error_message);
+                                    UnrecoverableError(error_message);
+                                }
+                            }
+                        };
+                        if (use_bitmask) {
+                            if (segment_entry->CheckAnyDelete(begin_ts)) {
+                                DeleteWithBitmaskFilter filter(bitmask, segment_entry, begin_ts);
+                                IVFFlatScan(filter);
+                            } else {
+                                BitmaskFilter<SegmentOffset> filter(bitmask);
+                                IVFFlatScan(filter);
+                            }
+                        } else {
+                            SegmentOffset max_segment_offset = block_index->GetSegmentOffset(segment_id);
+                            if (segment_entry->CheckAnyDelete(begin_ts)) {
+                                DeleteFilter filter(segment_entry, begin_ts, max_segment_offset);
+                                IVFFlatScan(filter);
+                            } else {
+                                IVFFlatScan();
+                            }
+                        }
+                        break;
+                    }
+                    case IndexType::kIVFPQ: {
+                        BufferHandle index_handle = segment_index_entry->GetIndex();
+                        auto index = static_cast<const AnnIVFPQIndexData<DataType> *>(index_handle.GetData());
+                        const u32 n_probes = knn_scan_shared_data->ivf_nprobe_;
+                        const u64 query_count = knn_scan_shared_data->query_count_;
+                        const u32 dimension = knn_scan_shared_data->dimension_;
+                        const bool rerank = knn_scan_shared_data->rerank_;
+                        // the codes only give approximate distances, keep more candidates when they are reranked with the raw vectors
+                        const u32 candidate_n = knn_scan_shared_data->topk_ * (rerank ? IVF_RERANK_CANDIDATE_FACTOR : 1);
+                        auto IVFPQScanTemplate = [&]<typename AnnIVFPQType, typename... OptionalFilter>(OptionalFilter &&...filter) {
+                            AnnIVFPQType ann_ivfpq_query(query, query_count, candidate_n, dimension, knn_scan_shared_data->elem_type_);
+                            ann_ivfpq_query.Begin();
+                            if (!rerank) {
+                                merge_heap->SyncBound(knn_scan_shared_data->topk_bound_);
+                                for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                    ann_ivfpq_query.TightenThreshold(query_idx, merge_heap->GetThreshold(query_idx));
+                                }
+                            }
+                            ann_ivfpq_query.Search(index, segment_id, n_probes, std::forward<OptionalFilter>(filter)...);
+                            ann_ivfpq_query.End();
+                            for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                DataType *dists = ann_ivfpq_query.GetDistanceByIdx(query_idx);
+                                RowID *row_ids = ann_ivfpq_query.GetIDByIdx(query_idx);
+                                const SizeT result_count =
+                                    std::lower_bound(dists, dists + candidate_n, AnnIVFPQType::InvalidValue(), AnnIVFPQType::CompareDist) - dists;
+                                MergeIVFResult(query_idx, dists, row_ids, result_count, rerank);
+                            }
+                        };
+                        auto IVFPQScan = [&]<typename... OptionalFilter>(OptionalFilter &&...filter) {
+                            switch (knn_scan_shared_data->knn_distance_type_) {
+                                case KnnDistanceType::kL2: {
+                                    IVFPQScanTemplate.template operator()<AnnIVFPQL2<DataType>>(std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                case KnnDistanceType::kInnerProduct: {
+                                    IVFPQScanTemplate.template operator()<AnnIVFPQIP<DataType>>(std::forward<OptionalFilter>(filter)...);
+                                    break;
+                                }
+                                default: {
+                                    Status status = Status::NotSupport("Not implemented KNN distance for IVFPQ index");
+                                    LOG_ERROR(status.message());
+                                    RecoverableError(status);
+                                }
+                            }
+                        };
+                        if (use_bitmask) {
+                            if (segment_entry->CheckAnyDelete(begin_ts)) {
+                                DeleteWithBitmaskFilter filter(bitmask, segment_entry, begin_ts);
+                                IVFPQScan(filter);
+                            } else {
+                                BitmaskFilter<SegmentOffset> filter(bitmask);
+                                IVFPQScan(filter);
+                            }
+                        } else {
+                            SegmentOffset max_segment_offset = block_index->GetSegmentOffset(segment_id);
+                            if (segment_entry->CheckAnyDelete(begin_ts)) {
+                                DeleteFilter filter(segment_entry, begin_ts, max_segment_offset);
+                                IVFPQScan(filter);
+                            } else {
+                                IVFPQScan();
+                            }
+                        }
+                        break;
+                    }
+                    case IndexType::kDiskAnn: {
+                        BufferHandle index_handle = segment_index_entry->GetIndex();
+                        auto index = static_cast<const DiskAnnIndexData<DataType> *>(index_handle.GetData());
+                        MetricType metric = MetricType::kInvalid;
                         switch (knn_scan_shared_data->knn_distance_type_) {
                             case KnnDistanceType::kL2: {
-                                IVFFlatScanTemplate.template operator()<AnnIVFFlatL2<DataType>>(std::forward<OptionalFilter>(filter)...);
+                                metric = MetricType::kMetricL2;
                                 break;
                             }
                             case KnnDistanceType::kInnerProduct: {
-                                IVFFlatScanTemplate.template operator()<AnnIVFFlatIP<DataType>>(std::forward<OptionalFilter>(filter)...);
-                                break;
-                            }
-                            case KnnDistanceType::kCosine: {
-                                IVFFlatScanTemplate.template operator()<AnnIVFFlatCOS<DataType>>(std::forward<OptionalFilter>(filter)...);
+                                metric = MetricType::kMetricInnerProduct;
                                 break;
                             }
                             default: {
-                                Status status = Status::NotSupport("Not implemented KNN distance");
+                                Status status = Status::NotSupport("Not implemented KNN distance for DiskAnn index");
                                 LOG_ERROR(status.message());
                                 RecoverableError(status);
                             }
                         }
-                    };
-                    if (use_bitmask) {
-                        if (segment_entry->CheckAnyDelete(begin_ts)) {
-                            DeleteWithBitmaskFilter filter(bitmask, segment_entry, begin_ts);
-                            IVFFlatScan(filter);
-                        } else {
-                            BitmaskFilter<SegmentOffset> filter(bitmask);
-                            IVFFlatScan(filter);
+                        if (index->data_num_ != 0 && index->metric_ != metric) {
+                            Status status = Status::NotSupport("KNN distance doesn't match the metric of DiskAnn index");
+                            LOG_ERROR(status.message());
+                            RecoverableError(status);
+                        }
+                        const u64 query_count = knn_scan_shared_data->query_count_;
+                        const u32 dimension = knn_scan_shared_data->dimension_;
+                        SizeT search_list = knn_scan_shared_data->diskann_search_list_;
+                        if (search_list == 0) {
+                            search_list = index->build_list_size_;
                         }
-                    } else {
-                        SegmentOffset max_segment_offset = block_index->GetSegmentOffset(segment_id);
-                        if (segment_entry->CheckAnyDelete(begin_ts)) {
-                            DeleteFilter filter(segment_entry, begin_ts, max_segment_offset);
-                            IVFFlatScan(filter);
+                        search_list = std::max<SizeT>(search_list, knn_scan_shared_data->topk_);
+                        const u32 beam_width = knn_scan_shared_data->diskann_beam_width_;
+                        auto DiskAnnScan = [&](auto &&filter) {
+                            for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                auto add_result = [&](DataType distance, SegmentOffset segment_offset) {
+                                    if (filter(segment_offset)) {
+                                        RowID row_id(segment_id, segment_offset);
+                                        merge_heap->Search(query_idx, &distance, &row_id, 1);
+                                    }
+                                };
+                                index->Search(query + query_idx * dimension, search_list, beam_width, add_result);
+                            }
+                        };
+                        if (use_bitmask) {
+                            if (segment_entry->CheckAnyDelete(begin_ts)) {
+                                DeleteWithBitmaskFilter filter(bitmask, segment_entry, begin_ts);
+                                DiskAnnScan(filter);
+                            } else {
+                                BitmaskFilter<SegmentOffset> filter(bitmask);
+                                DiskAnnScan(filter);
+                            }
                         } else {
-                            IVFFlatScan();
+                            SegmentOffset max_segment_offset = block_index->GetSegmentOffset(segment_id);
+                            if (segment_entry->CheckAnyDelete(begin_ts)) {
+                                DeleteFilter filter(segment_entry, begin_ts, max_segment_offset);
+                                DiskAnnScan(filter);
+                            } else {
+                                DiskAnnScan([](SegmentOffset) { return true; });
+                            }
                         }
+                        break;
                     }
-                    break;
-                }
-                case IndexType::kHnsw: {
-                    const auto *index_hnsw = static_cast<const IndexHnsw *>(segment_index_entry->table_index_entry()->index_base());
-
-                    auto hnsw_search = [&](BufferHandle index_handle, bool with_lock, int chunk_id = -1) {
-                        AbstractHnsw<f32, SegmentOffset> abstract_hnsw(index_handle.GetDataMut(), index_hnsw);
-
-                        bool rerank = false;
-                        for (const auto &opt_param : knn_scan_shared_data->opt_params_) {
-                            if (opt_param.param_name_ == "ef") {
-                                u64 ef = std::stoull(opt_param.param_value_);
-                                abstract_hnsw.SetEf(ef);
-                            } else if (opt_param.param_name_ == "rerank") {
+                    case IndexType::kHnsw: {
+                        const auto *index_hnsw = static_cast<const IndexHnsw *>(segment_index_entry->table_index_entry()->index_base());
+
+                        auto hnsw_search = [&](BufferHandle index_handle, bool with_lock, int chunk_id = -1) {
+                            AbstractHnsw<f32, SegmentOffset> abstract_hnsw(index_handle.GetDataMut(), index_hnsw);
+
+                            if (knn_scan_shared_data->hnsw_ef_ != 0) {
+                                abstract_hnsw.SetEf(knn_scan_shared_data->hnsw_ef_);
+                            }
+                            bool rerank = false;
+                            if (knn_scan_shared_data->rerank_) {
                                 if (abstract_hnsw.RerankDist()) {
                                     rerank = true;
                                 } else {
                                     LOG_WARN("rerank for this hnsw type is not valid");
                                 }
                             }
-                        }
 
-                        i64 result_n = -1;
-                        for (u64 query_idx = 0; query_idx < knn_scan_shared_data->query_count_; ++query_idx) {
-                            const DataType *query =
-                                static_cast<const DataType *>(knn_scan_shared_data->query_embedding_) + query_idx * knn_scan_shared_data->dimension_;
-
-                            SizeT result_n1 = 0;
-                            UniquePtr<DataType[]> d_ptr = nullptr;
-                            UniquePtr<SegmentOffset[]> l_ptr = nullptr;
+                            // All queries are searched in one batch so their graph walks are interleaved.
+                            const SizeT query_count = knn_scan_shared_data->query_count_;
+                            const SizeT topk = knn_scan_shared_data->topk_;
+                            Vector<const DataType *> queries(query_count);
+                            for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                queries[query_idx] = query + query_idx * knn_scan_shared_data->dimension_;
+                            }
+                            Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<SegmentOffset[]>>> search_results;
+                            auto FilteredSearch = [&](const auto &filter) {
+                                if (filter_strategy != KnnFilterStrategy::kExpandedIndex) {
+                                    search_results = abstract_hnsw.KnnSearchBatch(queries.data(), query_count, topk, filter, with_lock);
+                                    return;
+                                }
+                                search_results.clear();
+                                for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                    search_results.push_back(abstract_hnsw.KnnSearchExpanded(queries[query_idx], topk, filter, with_lock));
+                                }
+                            };
                             if (use_bitmask) {
                                 if (segment_entry->CheckAnyDelete(begin_ts)) {
                                     DeleteWithBitmaskFilter filter(bitmask, segment_entry, begin_ts);
-                                    std::tie(result_n1, d_ptr, l_ptr) =
-                                        abstract_hnsw.KnnSearch(query, knn_scan_shared_data->topk_, filter, with_lock);
+                                    FilteredSearch(filter);
                                 } else {
                                     BitmaskFilter<SegmentOffset> filter(bitmask);
-                                    std::tie(result_n1, d_ptr, l_ptr) =
-                                        abstract_hnsw.KnnSearch(query, knn_scan_shared_data->topk_, filter, with_lock);
+                                    FilteredSearch(filter);
                                 }
                             } else {
                                 SegmentOffset max_segment_offset = block_index->GetSegmentOffset(segment_id);
                                 if (segment_entry->CheckAnyDelete(begin_ts)) {
                                     DeleteFilter filter(segment_entry, begin_ts, max_segment_offset);
-                                    std::tie(result_n1, d_ptr, l_ptr) =
-                                        abstract_hnsw.KnnSearch(query, knn_scan_shared_data->topk_, filter, with_lock);
+                                    search_results = abstract_hnsw.KnnSearchBatch(queries.data(), query_count, topk, filter, with_lock);
                                 } else {
                                     if (!with_lock) {
-                                        std::tie(result_n1, d_ptr, l_ptr) = abstract_hnsw.KnnSearch(query, knn_scan_shared_data->topk_, false);
+                                        search_results = abstract_hnsw.KnnSearchBatch(queries.data(), query_count, topk, false);
                                     } else {
                                         AppendFilter filter(max_segment_offset);
-                                        std::tie(result_n1, d_ptr, l_ptr) = abstract_hnsw.KnnSearch(query, knn_scan_shared_data->topk_, filter, true);
+                                        search_results = abstract_hnsw.KnnSearchBatch(queries.data(), query_count, topk, filter, true);
                                     }
                                 }
                             }
 
-                            if (result_n < 0) {
-                                result_n = result_n1;
-                            } else if (result_n != (i64)result_n1) {
-                                String error_message = "KnnScan: result_n mismatch";
-                                LOG_CRITICAL(error_message);
-                                UnrecoverableError(error_message);
-                            }
-
-                            if (abstract_hnsw.RerankDist() && rerank) {
-                                Vector<SizeT> idxes(result_n);
-                                std::iota(idxes.begin(), idxes.end(), 0);
-                                std::sort(idxes.begin(), idxes.end(), [&](SizeT i, SizeT j) { return l_ptr[i] < l_ptr[j]; }); // sort by segment offset
-                                BlockID prev_block_id = -1;
-                                ColumnVector column_vector;
-                                for (SizeT idx : idxes) {
-                                    SegmentOffset segment_offset = l_ptr[idx];
-                                    BlockID block_id = segment_offset / DEFAULT_BLOCK_CAPACITY;
-                                    BlockOffset block_offset = segment_offset % DEFAULT_BLOCK_CAPACITY;
-                                    if (block_id != prev_block_id) {
-                                        prev_block_id = block_id;
-                                        BlockEntry *block_entry = block_index->GetBlockEntry(segment_id, block_id);
-                                        BlockColumnEntry *block_column_entry = block_entry->GetColumnBlockEntry(knn_column_id);
-                                        column_vector = block_column_entry->GetColumnVector(buffer_mgr);
-                                    }
-                                    const auto *data = reinterpret_cast<const DataType *>(column_vector.data());
-                                    data += block_offset * knn_scan_shared_data->dimension_;
-                                    merge_heap->Search(query, data, knn_scan_shared_data->dimension_, dist_func->dist_func_, segment_id, segment_offset);
+                            i64 result_n = -1;
+                            for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+                                const DataType *query = queries[query_idx];
+                                auto &[result_n1, d_ptr, l_ptr] = search_results[query_idx];
+
+                                if (result_n < 0) {
+                                    result_n = result_n1;
+                                } else if (result_n != (i64)result_n1) {
+                                    String error_message = "KnnScan: result_n mismatch";
+                                    LOG_CRITICAL(error_message);
+                                    UnrecoverableError(error_message);
                                 }
-                            } else {
-                                switch (knn_scan_shared_data->knn_distance_type_) {
-                                    case KnnDistanceType::kInvalid: {
-                                        String error_message = "Invalid distance type";
-                                        LOG_CRITICAL(error_message);
-                                        UnrecoverableError(error_message);
-                                    }
-                                    case KnnDistanceType::kL2:
-                                    case KnnDistanceType::kHamming: {
-                                        break;
+
+                                if (abstract_hnsw.RerankDist() && rerank) {
+                                    Vector<SizeT> idxes(result_n);
+                                    std::iota(idxes.begin(), idxes.end(), 0);
+                                    // sort by segment offset
+                                    std::sort(idxes.begin(), idxes.end(), [&](SizeT i, SizeT j) { return l_ptr[i] < l_ptr[j]; });
+                                    BlockID prev_block_id = -1;
+                                    ColumnVector column_vector;
+                                    for (SizeT idx : idxes) {
+                                        SegmentOffset segment_offset = l_ptr[idx];
+                                        BlockID block_id = segment_offset / DEFAULT_BLOCK_CAPACITY;
+                                        BlockOffset block_offset = segment_offset % DEFAULT_BLOCK_CAPACITY;
+                                        if (block_id != prev_block_id) {
+                                            prev_block_id = block_id;
+                                            BlockEntry *block_entry = block_index->GetBlockEntry(segment_id, block_id);
+                                            BlockColumnEntry *block_column_entry = block_entry->GetColumnBlockEntry(knn_column_id);
+                                            column_vector = block_column_entry->GetColumnVector(buffer_mgr);
+                                        }
+                                        const auto *data = reinterpret_cast<const DataType *>(column_vector.data());
+                                        data += block_offset * knn_scan_shared_data->dimension_;
+                                        merge_heap->Search(query,
+                                                           data,
+                                                           knn_scan_shared_data->dimension_,
+                                                           dist_func->dist_func_,
+                                                           segment_id,
+                                                           segment_offset);
                                     }
-                                    // FIXME:
-                                    case KnnDistanceType::kCosine:
-                                    case KnnDistanceType::kInnerProduct: {
-                                        for (i64 i = 0; i < result_n; ++i) {
-                                            d_ptr[i] = -d_ptr[i];
+                                } else {
+                                    switch (knn_scan_shared_data->knn_distance_type_) {
+                                        case KnnDistanceType::kInvalid: {
+                                            String error_message = "Invalid distance type";
+                                            LOG_CRITICAL(error_message);
+                                            UnrecoverableError(error_message);
+                                        }
+                                        case KnnDistanceType::kL2:
+                                        case KnnDistanceType::kHamming: {
+                                            break;
+                                        }
+                                        // FIXME:
+                                        case KnnDistanceType::kCosine:
+                                        case KnnDistanceType::kInnerProduct: {
+                                            for (i64 i = 0; i < result_n; ++i) {
+                                                d_ptr[i] = -d_ptr[i];
+                                            }
+                                            break;
                                         }
-                                        break;
                                     }
-                                }
 
-                                auto row_ids = MakeUniqueForOverwrite<RowID[]>(result_n);
-                                for (i64 i = 0; i < result_n; ++i) {
-                                    row_ids[i] = RowID{segment_id, l_ptr[i]};
-                                }
+                                    auto row_ids = MakeUniqueForOverwrite<RowID[]>(result_n);
+                                    for (i64 i = 0; i < result_n; ++i) {
+                                        row_ids[i] = RowID{segment_id, l_ptr[i]};
+                                    }
 
-                                merge_heap->Search(0, d_ptr.get(), row_ids.get(), result_n);
+                                    merge_heap->Search(0, d_ptr.get(), row_ids.get(), result_n);
+                                }
+                            }
+                        };
+
+                        auto [chunk_index_entries, memory_index_entry] = segment_index_entry->GetHnswIndexSnapshot();
+                        int i = 0;
+                        for (auto &chunk_index_entry : chunk_index_entries) {
+                            if (chunk_index_entry->CheckVisible(txn)) {
+                                BufferHandle index_handle = chunk_index_entry->GetIndex();
+                                hnsw_search(index_handle, false, i++);
                             }
                         }
-                    };
-
-                    auto [chunk_index_entries, memory_index_entry] = segment_index_entry->GetHnswIndexSnapshot();
-                    int i = 0;
-                    for (auto &chunk_index_entry : chunk_index_entries) {
-                        if (chunk_index_entry->CheckVisible(txn)) {
-                            BufferHandle index_handle = chunk_index_entry->GetIndex();
-                            hnsw_search(index_handle, false, i++);
+                        if (memory_index_entry.get() != nullptr) {
+                            BufferHandle index_handle = memory_index_entry->GetIndex();
+                            hnsw_search(index_handle, true);
                         }
+
+                        break;
                     }
-                    if (memory_index_entry.get() != nullptr) {
-                        BufferHandle index_handle = memory_index_entry->GetIndex();
-                        hnsw_search(index_handle, true);
+                    default: {
+                        Status status = Status::NotSupport("Not implemented index type");
+                        LOG_ERROR(status.message());
+                        RecoverableError(status);
                     }
-
-                    break;
-                }
-                default: {
-                    Status status = Status::NotSupport("Not implemented index type");
-                    LOG_ERROR(status.message());
-                    RecoverableError(status);
                 }
             }
+            merge_heap->SyncBound(knn_scan_shared_data->topk_bound_);
         }
     }
     if (knn_scan_shared_data->current_index_idx_ >= index_task_n && knn_scan_shared_data->current_block_idx_ >= brute_task_n) {
@@ -104,10 +104,8 @@ void PhysicalTableScan::ExecuteInternal(QueryContext *query_context, TableScanOp
 
     TableScanFunctionData *table_scan_function_data_ptr = table_scan_operator_state->table_scan_function_data_.get();
     const BlockIndex *block_index = table_scan_function_data_ptr->block_index_;
-    Vector<GlobalBlockID> *block_ids = table_scan_function_data_ptr->global_block_ids_.get();
     const Vector<SizeT> &column_ids = table_scan_function_data_ptr->column_ids_;
-    u64 &block_ids_idx = table_scan_function_data_ptr->current_block_ids_idx_;
-    if (block_ids_idx >= block_ids->size()) {
+    if (!table_scan_function_data_ptr->has_current_block_ && !table_scan_function_data_ptr->NextBlock()) {
         // No data or all data is read
         table_scan_operator_state->SetComplete();
         return;
@@ -116,19 +114,13 @@ void PhysicalTableScan::ExecuteInternal(QueryContext *query_context, TableScanOp
     TxnTimeStamp begin_ts = query_context->GetTxn()->BeginTS();
     SizeT &read_offset = table_scan_function_data_ptr->current_read_offset_;
 
-    {
-        String out;
-        for (auto &global_block_id : *block_ids) {
-            out += fmt::format("({},{}) ", global_block_id.segment_id_, global_block_id.block_id_);
-        }
-        LOG_TRACE(fmt::format("TableScan: block_ids: {}", out));
-    }
-
     // Here we assume output is a fresh data block, we have never written anything into it.
     auto write_capacity = output_ptr->available_capacity();
-    while (block_ids_idx < block_ids->size()) {
-        u32 segment_id = block_ids->at(block_ids_idx).segment_id_;
-        u16 block_id = block_ids->at(block_ids_idx).block_id_;
+    bool all_block_read = false;
+    bool output_written = false;
+    while (true) {
+        u32 segment_id = table_scan_function_data_ptr->current_block_id_.segment_id_;
+        u16 block_id = table_scan_function_data_ptr->current_block_id_.block_id_;
 
         BlockEntry *current_block_entry = block_index->GetBlockEntry(segment_id, block_id);
         if (read_offset == 0) {
@@ -136,22 +128,28 @@ void PhysicalTableScan::ExecuteInternal(QueryContext *query_context, TableScanOp
             const auto &fast_rough_filter = *current_block_entry->GetFastRoughFilter();
             if (fast_rough_filter_evaluator_ and !fast_rough_filter_evaluator_->Evaluate(begin_ts, fast_rough_filter)) {
                 // skip this block
-                LOG_TRACE(fmt::format("TableScan: block_ids_idx: {}, block_ids.size(): {}, skipped after apply FastRoughFilter",
-                                      block_ids_idx,
-                                      block_ids->size()));
-                ++block_ids_idx;
+                LOG_TRACE(fmt::format("TableScan: block ({},{}) skipped after apply FastRoughFilter", segment_id, block_id));
+                if (!table_scan_function_data_ptr->NextBlock()) {
+                    all_block_read = true;
+                    break;
+                }
                 continue;
             } else {
-                LOG_TRACE(fmt::format("TableScan: block_ids_idx: {}, block_ids.size(): {}, not skipped after apply FastRoughFilter",
-                                      block_ids_idx,
-                                      block_ids->size()));
+                LOG_TRACE(fmt::format("TableScan: block ({},{}) not skipped after apply FastRoughFilter", segment_id, block_id));
             }
         }
         auto [row_begin, row_end] = current_block_entry->GetVisibleRange(begin_ts, read_offset);
         if (row_begin == row_end) {
-            // we have read all data from current block, move to next block
-            ++block_ids_idx;
-            read_offset = 0;
+            // we have read all data from current block. The output must not mix the rows of two morsels, return it before taking the
+            // next block from the shared queue.
+            if (output_written) {
+                table_scan_function_data_ptr->has_current_block_ = false;
+                break;
+            }
+            if (!table_scan_function_data_ptr->NextBlock()) {
+                all_block_read = true;
+                break;
+            }
             continue;
         }
         if (write_capacity == 0) {
@@ -188,13 +186,12 @@ void PhysicalTableScan::ExecuteInternal(QueryContext *query_context, TableScanOp
         }
 
         // write_size = already read size = already write size
+        output_written = true;
         write_capacity -= write_size;
         read_offset += write_size;
     }
 
-    LOG_TRACE(fmt::format("TableScan: block_ids_idx: {}, block_ids.size(): {}", block_ids_idx, block_ids->size()));
-
-    if (block_ids_idx >= block_ids->size()) {
+    if (all_block_read) {
         table_scan_operator_state->SetComplete();
     }
 
@@ -71,6 +71,8 @@ import bg_task;
 import buffer_obj;
 import file_worker_type;
 import system_info;
+import histogram;
+import hnsw_common;
 
 namespace infinity {
 
@@ -381,18 +383,24 @@ void PhysicalShow::Init() {
             break;
         }
         case ShowType::kShowBuffer: {
-            output_names_->reserve(5);
-            output_types_->reserve(5);
+            output_names_->reserve(8);
+            output_types_->reserve(8);
             output_names_->emplace_back("path");
             output_names_->emplace_back("status");
             output_names_->emplace_back("size");
             output_names_->emplace_back("buffered_type");
             output_names_->emplace_back("type");
+            output_names_->emplace_back("hits");
+            output_names_->emplace_back("misses");
+            output_names_->emplace_back("evictions");
             output_types_->emplace_back(varchar_type);
             output_types_->emplace_back(varchar_type);
             output_types_->emplace_back(bigint_type);
             output_types_->emplace_back(varchar_type);
             output_types_->emplace_back(varchar_type);
+            output_types_->emplace_back(bigint_type);
+            output_types_->emplace_back(bigint_type);
+            output_types_->emplace_back(bigint_type);
             break;
         }
         case ShowType::kShowQueries: {
@@ -1055,7 +1063,9 @@ void PhysicalShow::ExecuteShowIndexSegment(QueryContext *query_context, ShowOper
 
             Vector<SharedPtr<ChunkIndexEntry>> chunk_index_entries;
             switch(index_base->index_type_) {
-                case IndexType::kIVFFlat: {
+                case IndexType::kIVFFlat:
+                case IndexType::kIVFPQ:
+                case IndexType::kDiskAnn: {
                     Status status3 = Status::InvalidIndexName(index_type_name);
                     show_operator_state->status_ = status3;
                     LOG_ERROR(fmt::format("{} isn't implemented.", index_type_name));
@@ -1095,6 +1105,23 @@ void PhysicalShow::ExecuteShowIndexSegment(QueryContext *query_context, ShowOper
         }
     }
 
+    if (table_index_entry->table_index_def()->index_type_ == IndexType::kHnsw) {
+        SizeT column_id = 0;
+        {
+            Value value = Value::MakeVarchar("build_progress");
+            ValueExpression value_expr(value);
+            value_expr.AppendToChunk(output_block_ptr->column_vectors[column_id]);
+        }
+
+        ++column_id;
+        {
+            const auto &build_progress = segment_index_entry->build_progress();
+            Value value = Value::MakeVarchar(fmt::format("{}/{}", build_progress.done_.load(), build_progress.total_.load()));
+            ValueExpression value_expr(value);
+            value_expr.AppendToChunk(output_block_ptr->column_vectors[column_id]);
+        }
+    }
+
     output_block_ptr->Finalize();
     show_operator_state->output_.emplace_back(std::move(output_block_ptr));
 }
@@ -1134,7 +1161,9 @@ void PhysicalShow::ExecuteShowIndexChunk(QueryContext *query_context, ShowOperat
 
     Vector<SharedPtr<ChunkIndexEntry>> chunk_indexes;
     switch(index_base->index_type_) {
-        case IndexType::kIVFFlat: {
+        case IndexType::kIVFFlat:
+        case IndexType::kIVFPQ:
+        case IndexType::kDiskAnn: {
             Status status3 = Status::InvalidIndexName(index_type_name);
             show_operator_state->status_ = status3;
             LOG_ERROR(fmt::format("{} isn't implemented.", index_type_name));
@@ -3711,6 +3740,29 @@ void PhysicalShow::ExecuteShowGlobalVariable(QueryContext *query_context, ShowOp
             value_expr.AppendToChunk(output_block_ptr->column_vectors[0]);
             break;
         }
+        case GlobalVariable::kWALFlushBatchSize:
+        case GlobalVariable::kWALFlushLatency: {
+            Vector<SharedPtr<ColumnDef>> output_column_defs = {
+                MakeShared<ColumnDef>(0, varchar_type, "value", std::set<ConstraintType>()),
+            };
+
+            SharedPtr<TableDef> table_def = TableDef::Make(MakeShared<String>("default_db"), MakeShared<String>("variables"), output_column_defs);
+            output_ = MakeShared<DataTable>(table_def, TableType::kResult);
+
+            Vector<SharedPtr<DataType>> output_column_types{
+                varchar_type,
+            };
+
+            output_block_ptr->Init(output_column_types);
+
+            WalManager *wal_manager = query_context->storage()->wal_manager();
+            const Log2Histogram &histogram = global_var == GlobalVariable::kWALFlushBatchSize ? wal_manager->flush_batch_size_histogram()
+                                                                                                  : wal_manager->flush_latency_histogram();
+            Value value = Value::MakeVarchar(histogram.ToString());
+            ValueExpression value_expr(value);
+            value_expr.AppendToChunk(output_block_ptr->column_vectors[0]);
+            break;
+        }
         default: {
             operator_state->status_ = Status::NoSysVar(object_name_);
             LOG_ERROR(operator_state->status_.message());
@@ -4191,6 +4243,50 @@ void PhysicalShow::ExecuteShowGlobalVariables(QueryContext *query_context, ShowO
                 }
                 break;
             }
+            case GlobalVariable::kWALFlushBatchSize: {
+                {
+                    // option name
+                    Value value = Value::MakeVarchar(var_name);
+                    ValueExpression value_expr(value);
+                    value_expr.AppendToChunk(output_block_ptr->column_vectors[0]);
+                }
+                {
+                    // option value
+                    WalManager *wal_manager = query_context->storage()->wal_manager();
+                    Value value = Value::MakeVarchar(wal_manager->flush_batch_size_histogram().ToString());
+                    ValueExpression value_expr(value);
+                    value_expr.AppendToChunk(output_block_ptr->column_vectors[1]);
+                }
+                {
+                    // option description
+                    Value value = Value::MakeVarchar("Committed transactions per WAL flush");
+                    ValueExpression value_expr(value);
+                    value_expr.AppendToChunk(output_block_ptr->column_vectors[2]);
+                }
+                break;
+            }
+            case GlobalVariable::kWALFlushLatency: {
+                {
+                    // option name
+                    Value value = Value::MakeVarchar(var_name);
+                    ValueExpression value_expr(value);
+                    value_expr.AppendToChunk(output_block_ptr->column_vectors[0]);
+                }
+                {
+                    // option value
+                    WalManager *wal_manager = query_context->storage()->wal_manager();
+                    Value value = Value::MakeVarchar(wal_manager->flush_latency_histogram().ToString());
+                    ValueExpression value_expr(value);
+                    value_expr.AppendToChunk(output_block_ptr->column_vectors[1]);
+                }
+                {
+                    // option description
+                    Value value = Value::MakeVarchar("Microseconds to write and sync each WAL flush");
+                    ValueExpression value_expr(value);
+                    value_expr.AppendToChunk(output_block_ptr->column_vectors[2]);
+                }
+                break;
+            }
             default: {
                 operator_state->status_ = Status::NoSysVar(var_name);
                 LOG_ERROR(operator_state->status_.message());
@@ -4330,6 +4426,9 @@ void PhysicalShow::ExecuteShowBuffer(QueryContext *query_context, ShowOperatorSt
         MakeShared<ColumnDef>(2, bigint_type, "size", std::set<ConstraintType>()),
         MakeShared<ColumnDef>(3, varchar_type, "buffered_type", std::set<ConstraintType>()),
         MakeShared<ColumnDef>(4, varchar_type, "type", std::set<ConstraintType>()),
+        MakeShared<ColumnDef>(5, bigint_type, "hits", std::set<ConstraintType>()),
+        MakeShared<ColumnDef>(6, bigint_type, "misses", std::set<ConstraintType>()),
+        MakeShared<ColumnDef>(7, bigint_type, "evictions", std::set<ConstraintType>()),
     };
 
     SharedPtr<TableDef> table_def = TableDef::Make(MakeShared<String>("default_db"), MakeShared<String>("show_buffer"), column_defs);
@@ -4341,6 +4440,9 @@ void PhysicalShow::ExecuteShowBuffer(QueryContext *query_context, ShowOperatorSt
         bigint_type,
         varchar_type,
         varchar_type,
+        bigint_type,
+        bigint_type,
+        bigint_type,
     };
 
     UniquePtr<DataBlock> output_block_ptr = DataBlock::MakeUniquePtr();
@@ -4387,6 +4489,24 @@ void PhysicalShow::ExecuteShowBuffer(QueryContext *query_context, ShowOperatorSt
             ValueExpression value_expr(value);
             value_expr.AppendToChunk(output_block_ptr->column_vectors[4]);
         }
+        {
+            // hits
+            Value value = Value::MakeBigInt(static_cast<i64>(buffer_object_info.hit_count_));
+            ValueExpression value_expr(value);
+            value_expr.AppendToChunk(output_block_ptr->column_vectors[5]);
+        }
+        {
+            // misses
+            Value value = Value::MakeBigInt(static_cast<i64>(buffer_object_info.miss_count_));
+            ValueExpression value_expr(value);
+            value_expr.AppendToChunk(output_block_ptr->column_vectors[6]);
+        }
+        {
+            // evictions
+            Value value = Value::MakeBigInt(static_cast<i64>(buffer_object_info.eviction_count_));
+            ValueExpression value_expr(value);
+            value_expr.AppendToChunk(output_block_ptr->column_vectors[7]);
+        }
 
         ++ row_count;
         if (row_count == output_block_ptr->capacity()) {
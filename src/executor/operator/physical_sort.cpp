@@ -26,6 +26,8 @@ import data_table;
 import data_block;
 import default_values;
 import column_vector;
+import vector_buffer;
+import fix_heap;
 import expression_state;
 import base_expression;
 import expression_evaluator;
@@ -38,6 +40,16 @@ import third_party;
 import status;
 import physical_top;
 import logger;
+import sort_key_encoder;
+import radix_sort;
+import storage;
+import buffer_manager;
+import local_file_system;
+import file_system;
+import file_system_type;
+import logical_type;
+import data_type;
+import config;
 
 namespace infinity {
 
@@ -48,74 +60,187 @@ struct BlockRawIndex {
     u32 offset_;
 };
 
-class Comparator {
-public:
-    explicit Comparator(const CompareTwoRowAndPreferLeft &prefer_left_function,
-                        const Vector<UniquePtr<DataBlock>> &order_by_blocks,
-                        const Vector<SharedPtr<BaseExpression>> &expressions,
-                        Vector<SharedPtr<ExpressionState>> &expr_states)
-        : prefer_left_function_(prefer_left_function), order_by_blocks_(order_by_blocks), expressions_(expressions), expr_states_(expr_states) {}
+namespace {
 
-    void Init() {
-        if (order_by_blocks_.empty()) {
-            return;
-        }
-        eval_results_ = PhysicalTop::GetEvalColumns(expressions_, expr_states_, order_by_blocks_);
+// A buffered run may take 1 / SORT_RUN_MEMORY_RATIO of the buffer manager memory before it is spilled.
+constexpr SizeT SORT_RUN_MEMORY_RATIO = 4;
+
+Atomic<u64> sort_spill_file_id{0};
+
+// The radix of a row is the first 8 bytes of its encoded key.
+struct SortEntry {
+    u64 prefix_;
+    u32 row_;
+};
+
+u64 LoadKeyPrefix(const char *key, SizeT key_size) {
+    u64 prefix = 0;
+    SizeT prefix_size = std::min(key_size, sizeof(u64));
+    for (SizeT i = 0; i < prefix_size; ++i) {
+        prefix = (prefix << 8) | static_cast<u8>(key[i]);
     }
+    return prefix << ((sizeof(u64) - prefix_size) * 8);
+}
+
+struct SortRun {
+    // Blocks -> Expressions
+    Vector<Vector<SharedPtr<ColumnVector>>> eval_columns_;
+    Vector<BlockRawIndex> row_indexes_;
+    Vector<char> keys_;
+};
+
+struct SortEntryRadix {
+    u64 operator()(const SortEntry &entry) const { return entry.prefix_; }
+};
 
-    bool Compare(BlockRawIndex left_index, BlockRawIndex right_index) {
-        auto &left = eval_results_[left_index.block_idx_];
-        auto &right = eval_results_[right_index.block_idx_];
-        return prefer_left_function_.Compare(left, left_index.offset_, right, right_index.offset_);
+class SortEntryLess {
+public:
+    SortEntryLess(const SortKeyEncoder *encoder, const SortRun *run) : encoder_(encoder), run_(run) {}
+
+    bool operator()(const SortEntry &left, const SortEntry &right) const {
+        if (left.prefix_ != right.prefix_) {
+            return left.prefix_ < right.prefix_;
+        }
+        i32 result = encoder_->Compare(MakeRow(left.row_), MakeRow(right.row_));
+        if (result != 0) {
+            return result < 0;
+        }
+        // Keep the input order of equal rows.
+        return left.row_ < right.row_;
     }
 
 private:
-    const CompareTwoRowAndPreferLeft &prefer_left_function_;
-    const Vector<UniquePtr<DataBlock>> &order_by_blocks_;
-    const Vector<SharedPtr<BaseExpression>> &expressions_;
-    Vector<SharedPtr<ExpressionState>> &expr_states_;
+    SortKeyRow MakeRow(u32 row) const {
+        const BlockRawIndex &index = run_->row_indexes_[row];
+        return {run_->keys_.data() + row * encoder_->key_size(), &run_->eval_columns_[index.block_idx_], index.offset_};
+    }
 
-    // Blocks -> Expressions
-    Vector<Vector<SharedPtr<ColumnVector>>> eval_results_;
+    const SortKeyEncoder *encoder_;
+    const SortRun *run_;
 };
 
-Vector<BlockRawIndex> MergeTwoIndexes(Vector<BlockRawIndex> &&indexes_a, Vector<BlockRawIndex> &&indexes_b, Comparator &comparator) {
-    if (indexes_a.empty() || indexes_b.empty()) {
-        return indexes_a.empty() ? indexes_b : indexes_a;
+// Memory taken by a block, counting the full capacity of the fixed part.
+SizeT EstimateBlockBytes(const DataBlock &block) {
+    SizeT bytes = 0;
+    for (const auto &column : block.column_vectors) {
+        bytes += column->data_type_size_ * block.capacity();
+        if (column->buffer_.get() != nullptr && column->buffer_->fix_heap_mgr_.get() != nullptr) {
+            bytes += column->buffer_->fix_heap_mgr_->total_size();
+        }
+    }
+    return bytes;
+}
+
+bool CanSpill(const DataBlock &block) {
+    for (const auto &column : block.column_vectors) {
+        if (column->data_type()->type() == LogicalType::kHugeInt) {
+            // Column vector can't serialize huge integer.
+            return false;
+        }
+    }
+    return true;
+}
+
+// A spilled run, read back one block at a time.
+class SpilledRunReader {
+public:
+    explicit SpilledRunReader(const String &path) {
+        auto [file_handler, status] = fs_.OpenFile(path, FileFlags::READ_FLAG, FileLockType::kReadLock);
+        if (!status.ok()) {
+            LOG_CRITICAL(status.message());
+            UnrecoverableError(status.message());
+        }
+        file_handler_ = std::move(file_handler);
     }
-    Vector<BlockRawIndex> merged_indexes;
-    merged_indexes.reserve(indexes_a.size() + indexes_b.size());
 
-    auto ptr_a = indexes_a.begin();
-    auto ptr_b = indexes_b.begin();
+    ~SpilledRunReader() { fs_.Close(*file_handler_); }
 
-    while (ptr_a != indexes_a.end() && ptr_b != indexes_b.end()) {
-        if (comparator.Compare(*ptr_a, *ptr_b)) {
-            merged_indexes.push_back(*ptr_a);
-            ++ptr_a;
-        } else {
-            merged_indexes.push_back(*ptr_b);
-            ++ptr_b;
+    // Load the next block of the run and encode its keys, return false at the end of the run.
+    bool LoadNextBlock(const Vector<SharedPtr<BaseExpression>> &expressions,
+                       Vector<SharedPtr<ExpressionState>> &expr_states,
+                       const SortKeyEncoder &encoder) {
+        i32 block_size = 0;
+        if (fs_.Read(*file_handler_, &block_size, sizeof(i32)) != sizeof(i32)) {
+            return false;
         }
+        buffer_.resize(block_size);
+        if (fs_.Read(*file_handler_, buffer_.data(), block_size) != block_size) {
+            String error_message = "Failed to read the spilled sort run.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        char *ptr = buffer_.data();
+        SharedPtr<DataBlock> spilled_block = DataBlock::ReadAdv(ptr, block_size);
+        blocks_.clear();
+        blocks_.emplace_back(DataBlock::MakeUniquePtr());
+        blocks_[0]->Init(spilled_block->column_vectors);
+
+        eval_columns_ = PhysicalTop::GetEvalColumns(expressions, expr_states, blocks_);
+        keys_.resize(blocks_[0]->row_count() * encoder.key_size());
+        encoder.Encode(eval_columns_[0], blocks_[0]->row_count(), keys_.data());
+        offset_ = 0;
+        return true;
     }
-    if (ptr_a != indexes_a.end()) {
-        merged_indexes.insert(merged_indexes.end(), ptr_a, indexes_a.end());
+
+    bool Next(const Vector<SharedPtr<BaseExpression>> &expressions, Vector<SharedPtr<ExpressionState>> &expr_states, const SortKeyEncoder &encoder) {
+        if (++offset_ < blocks_[0]->row_count()) {
+            return true;
+        }
+        return LoadNextBlock(expressions, expr_states, encoder);
     }
-    if (ptr_b != indexes_b.end()) {
-        merged_indexes.insert(merged_indexes.end(), ptr_b, indexes_b.end());
+
+    [[nodiscard]] inline const DataBlock *block() const { return blocks_[0].get(); }
+    [[nodiscard]] inline SizeT offset() const { return offset_; }
+    [[nodiscard]] inline SortKeyRow row(SizeT key_size) const { return {keys_.data() + offset_ * key_size, &eval_columns_[0], offset_}; }
+
+private:
+    LocalFileSystem fs_{};
+    UniquePtr<FileHandler> file_handler_{};
+    Vector<char> buffer_{};
+    Vector<UniquePtr<DataBlock>> blocks_{};
+    Vector<Vector<SharedPtr<ColumnVector>>> eval_columns_{};
+    Vector<char> keys_{};
+    SizeT offset_{};
+};
+
+// A sorted run written to a new file in the temp dir. Every block is written as | size (4 bytes) | serialized block |
+class SpilledRunWriter {
+public:
+    explicit SpilledRunWriter(QueryContext *query_context) {
+        String temp_dir = *query_context->storage()->buffer_manager()->GetTempDir();
+        if (!fs_.Exists(temp_dir)) {
+            fs_.CreateDirectory(temp_dir);
+        }
+        path_ = fmt::format("{}/sort_run_{}", temp_dir, sort_spill_file_id.fetch_add(1));
+        auto [file_handler, status] = fs_.OpenFile(path_, FileFlags::WRITE_FLAG | FileFlags::CREATE_FLAG, FileLockType::kWriteLock);
+        if (!status.ok()) {
+            LOG_CRITICAL(status.message());
+            UnrecoverableError(status.message());
+        }
+        file_handler_ = std::move(file_handler);
     }
 
-    return merged_indexes;
-}
+    ~SpilledRunWriter() { fs_.Close(*file_handler_); }
 
-Vector<BlockRawIndex> MergeIndexes(Vector<Vector<BlockRawIndex>> &indexes_group, SizeT l, SizeT r, Comparator &comparator) {
-    if (l > r or r >= indexes_group.size())
-        return Vector<BlockRawIndex>();
-    if (l == r)
-        return indexes_group[l];
-    SizeT mid = (l + r) >> 1;
-    return MergeTwoIndexes(MergeIndexes(indexes_group, l, mid, comparator), MergeIndexes(indexes_group, mid + 1, r, comparator), comparator);
-}
+    void Append(const DataBlock &block) {
+        buffer_.resize(sizeof(i32) + block.GetSizeInBytes());
+        char *ptr = buffer_.data() + sizeof(i32);
+        block.WriteAdv(ptr);
+        i32 block_size = ptr - buffer_.data() - sizeof(i32);
+        std::memcpy(buffer_.data(), &block_size, sizeof(i32));
+        fs_.Write(*file_handler_, buffer_.data(), sizeof(i32) + block_size);
+    }
+
+    [[nodiscard]] inline const String &path() const { return path_; }
+
+private:
+    LocalFileSystem fs_{};
+    UniquePtr<FileHandler> file_handler_{};
+    String path_{};
+    Vector<char> buffer_{};
+};
+
+} // namespace
 
 void CopyWithIndexes(const Vector<UniquePtr<DataBlock>> &input_blocks,
                      Vector<UniquePtr<DataBlock>> &output_blocks,
@@ -127,7 +252,7 @@ void CopyWithIndexes(const Vector<UniquePtr<DataBlock>> &input_blocks,
     SizeT start_block_index = output_blocks.size();
     auto block_count = (block_indexes.size() + DEFAULT_BLOCK_CAPACITY - 1) / DEFAULT_BLOCK_CAPACITY;
 
-    // copy with block_indexes and push to unmerge_sorted_blocks
+    // copy with block_indexes and push to output_blocks
     for (SizeT i = 0; i < block_count; ++i) {
         auto sorted_datablock = DataBlock::MakeUniquePtr();
         sorted_datablock->Init(input_blocks[0]->types());
@@ -157,66 +282,210 @@ void PhysicalSort::Init() {
         LOG_CRITICAL(error_message);
         UnrecoverableError(error_message);
     }
-    Vector<std::function<std::strong_ordering(const SharedPtr<ColumnVector> &, u32, const SharedPtr<ColumnVector> &, u32)>> sort_functions;
-    sort_functions.reserve(sort_expr_count);
-    for (u32 i = 0; i < sort_expr_count; ++i) {
-        sort_functions.emplace_back(PhysicalTop::GenerateSortFunction(order_by_types_[i], expressions_[i]));
+    Vector<SharedPtr<DataType>> key_types;
+    key_types.reserve(sort_expr_count);
+    for (const auto &expression : expressions_) {
+        key_types.emplace_back(MakeShared<DataType>(expression->Type()));
     }
-    prefer_left_function_ = CompareTwoRowAndPreferLeft(std::move(sort_functions));
+    sort_key_encoder_ = MakeUnique<SortKeyEncoder>(std::move(key_types), order_by_types_);
 }
 
-bool PhysicalSort::Execute(QueryContext *, OperatorState *operator_state) {
-    auto *prev_op_state = operator_state->prev_op_state_;
-    auto *sort_operator_state = static_cast<SortOperatorState *>(operator_state);
+void PhysicalSort::SortBlocks(const Vector<UniquePtr<DataBlock>> &input_blocks,
+                              Vector<SharedPtr<ExpressionState>> &expr_states,
+                              Vector<UniquePtr<DataBlock>> &output_blocks) const {
+    if (input_blocks.empty()) {
+        return;
+    }
+    SortRun run;
+    run.eval_columns_ = PhysicalTop::GetEvalColumns(expressions_, expr_states, input_blocks);
+    for (u32 block_id = 0; block_id < input_blocks.size(); ++block_id) {
+        for (u32 offset = 0; offset < input_blocks[block_id]->row_count(); ++offset) {
+            run.row_indexes_.emplace_back(block_id, offset);
+        }
+    }
+
+    // Encode the keys of every row
+    SizeT row_count = run.row_indexes_.size();
+    SizeT key_size = sort_key_encoder_->key_size();
+    run.keys_.resize(row_count * key_size);
+    SizeT row_start = 0;
+    for (SizeT block_id = 0; block_id < input_blocks.size(); ++block_id) {
+        sort_key_encoder_->Encode(run.eval_columns_[block_id], input_blocks[block_id]->row_count(), run.keys_.data() + row_start * key_size);
+        row_start += input_blocks[block_id]->row_count();
+    }
+
+    Vector<SortEntry> entries(row_count);
+    for (u32 row = 0; row < row_count; ++row) {
+        entries[row].prefix_ = LoadKeyPrefix(run.keys_.data() + row * key_size, key_size);
+        entries[row].row_ = row;
+    }
+    // Radix sort on the key prefix, equal prefixes are sorted by the full key.
+    if (row_count > 1) {
+        ShiftBasedRadixSorter<SortEntry, SortEntryRadix, SortEntryLess, 56, true>::RadixSort(SortEntryRadix(),
+                                                                                          SortEntryLess(sort_key_encoder_.get(), &run),
+                                                                                          entries.data(),
+                                                                                          entries.size(),
+                                                                                          16);
+    }
 
-    // Generate block indexes
     Vector<BlockRawIndex> block_indexes;
-    auto pre_op_state = operator_state->prev_op_state_;
+    block_indexes.reserve(row_count);
+    for (const auto &entry : entries) {
+        block_indexes.push_back(run.row_indexes_[entry.row_]);
+    }
+    CopyWithIndexes(input_blocks, output_blocks, block_indexes);
+}
 
-    block_indexes.reserve(pre_op_state->data_block_array_.size() * DEFAULT_BLOCK_CAPACITY);
-    // filling block_indexes
-    for (u32 block_id = 0; block_id < pre_op_state->data_block_array_.size(); block_id++) {
-        for (u32 offset = 0; offset < pre_op_state->data_block_array_[block_id]->row_count(); offset++) {
-            block_indexes.emplace_back(block_id, offset);
+void PhysicalSort::SpillRun(QueryContext *query_context, SortOperatorState *sort_operator_state) const {
+    Vector<UniquePtr<DataBlock>> sorted_blocks;
+    SortBlocks(sort_operator_state->run_blocks_, sort_operator_state->expr_states_, sorted_blocks);
+    sort_operator_state->run_blocks_.clear();
+    sort_operator_state->run_bytes_ = 0;
+
+    SpilledRunWriter writer(query_context);
+    sort_operator_state->spill_files_.emplace_back(writer.path());
+    for (const auto &sorted_block : sorted_blocks) {
+        sort_operator_state->spill_block_bytes_ = std::max(sort_operator_state->spill_block_bytes_, EstimateBlockBytes(*sorted_block));
+        writer.Append(*sorted_block);
+    }
+    LOG_TRACE(fmt::format("Spill sort run of {} blocks to {}", sorted_blocks.size(), writer.path()));
+}
+
+void PhysicalSort::MergeSpilledRuns(const Vector<String> &spill_files,
+                                    Vector<SharedPtr<ExpressionState>> &expr_states,
+                                    const std::function<void(UniquePtr<DataBlock>)> &emit_block) const {
+    const SortKeyEncoder &encoder = *sort_key_encoder_;
+    SizeT key_size = encoder.key_size();
+
+    Vector<UniquePtr<SpilledRunReader>> readers;
+    readers.reserve(spill_files.size());
+    for (const auto &spill_file : spill_files) {
+        readers.emplace_back(MakeUnique<SpilledRunReader>(spill_file));
+    }
+    // Rows of the earlier run go first if the keys are equal, the runs are spilled in the input order.
+    auto run_less = [&](SizeT left, SizeT right) {
+        i32 result = encoder.Compare(readers[left]->row(key_size), readers[right]->row(key_size));
+        return result != 0 ? result < 0 : left < right;
+    };
+    auto run_greater = [&](SizeT left, SizeT right) { return run_less(right, left); };
+    std::priority_queue<SizeT, Vector<SizeT>, decltype(run_greater)> heap(run_greater);
+    for (SizeT run_idx = 0; run_idx < readers.size(); ++run_idx) {
+        if (readers[run_idx]->LoadNextBlock(expressions_, expr_states, encoder)) {
+            heap.push(run_idx);
         }
     }
-    auto &expr_states = (static_cast<SortOperatorState *>(operator_state))->expr_states_;
-    auto block_comparator = Comparator(prefer_left_function_, pre_op_state->data_block_array_, expressions_, expr_states);
 
-    block_comparator.Init();
-    // sort block_indexes
-    std::sort(block_indexes.begin(), block_indexes.end(), [&block_comparator](BlockRawIndex x, BlockRawIndex y) -> bool {
-        // Be careful! std::sort needs a strict ordering comparator. ("<" instead of "<=")
-        return !block_comparator.Compare(y, x);
-    });
+    UniquePtr<DataBlock> output_block{};
+    SizeT output_row_count = 0;
+    while (!heap.empty()) {
+        SizeT run_idx = heap.top();
+        heap.pop();
+        SpilledRunReader &reader = *readers[run_idx];
+        if (output_block.get() == nullptr) {
+            output_block = DataBlock::MakeUniquePtr();
+            output_block->Init(reader.block()->types());
+        }
+        const Vector<SharedPtr<ColumnVector>> &output_columns = output_block->column_vectors;
+        for (SizeT column_id = 0; column_id < output_columns.size(); ++column_id) {
+            output_columns[column_id]->AppendWith(*reader.block()->column_vectors[column_id], reader.offset(), 1);
+        }
+        if (++output_row_count % DEFAULT_BLOCK_CAPACITY == 0) {
+            output_block->Finalize();
+            emit_block(std::move(output_block));
+        }
+        if (reader.Next(expressions_, expr_states, encoder)) {
+            heap.push(run_idx);
+        }
+    }
+    if (output_block.get() != nullptr) {
+        output_block->Finalize();
+        emit_block(std::move(output_block));
+    }
+}
+
+void PhysicalSort::MergeRuns(QueryContext *query_context, SortOperatorState *sort_operator_state) const {
+    auto &expr_states = sort_operator_state->expr_states_;
+    auto &spill_files = sort_operator_state->spill_files_;
+    LocalFileSystem fs;
+
+    // Every open run holds its serialized and its loaded block, merge at most fan_in runs at a time and write the
+    // merged runs back to the temp dir until the rest fit in the memory budget.
+    SizeT memory_limit = query_context->global_config()->BufferManagerSize() / SORT_RUN_MEMORY_RATIO;
+    SizeT run_bytes = std::max(SizeT(1), 2 * sort_operator_state->spill_block_bytes_);
+    SizeT fan_in = std::max(SizeT(2), memory_limit / run_bytes);
+    while (spill_files.size() > fan_in) {
+        Vector<String> input_files = spill_files;
+        Vector<String> merged_files;
+        for (SizeT start = 0; start < input_files.size(); start += fan_in) {
+            Vector<String> group(input_files.begin() + start, input_files.begin() + std::min(start + fan_in, input_files.size()));
+            if (group.size() == 1) {
+                merged_files.emplace_back(group[0]);
+                continue;
+            }
+            SpilledRunWriter writer(query_context);
+            // Listed in the state so that it is removed if the query fails.
+            spill_files.emplace_back(writer.path());
+            merged_files.emplace_back(writer.path());
+            MergeSpilledRuns(group, expr_states, [&](UniquePtr<DataBlock> block) { writer.Append(*block); });
+            for (const auto &spill_file : group) {
+                fs.DeleteFile(spill_file);
+            }
+        }
+        LOG_TRACE(fmt::format("Merge {} sort runs into {}", input_files.size(), merged_files.size()));
+        spill_files = std::move(merged_files);
+    }
+
+    auto &output_blocks = sort_operator_state->data_block_array_;
+    MergeSpilledRuns(spill_files, expr_states, [&](UniquePtr<DataBlock> block) { output_blocks.push_back(std::move(block)); });
+    for (const auto &spill_file : spill_files) {
+        fs.DeleteFile(spill_file);
+    }
+    spill_files.clear();
+}
 
-    CopyWithIndexes(pre_op_state->data_block_array_, sort_operator_state->unmerge_sorted_blocks_, block_indexes);
+bool PhysicalSort::Execute(QueryContext *query_context, OperatorState *operator_state) {
+    auto *prev_op_state = operator_state->prev_op_state_;
+    auto *sort_operator_state = static_cast<SortOperatorState *>(operator_state);
+
+    // Buffer the input blocks of the current run
+    auto &run_blocks = sort_operator_state->run_blocks_;
+    for (auto &input_block : prev_op_state->data_block_array_) {
+        if (input_block->row_count() == 0) {
+            continue;
+        }
+        sort_operator_state->run_bytes_ += EstimateBlockBytes(*input_block);
+        run_blocks.push_back(std::move(input_block));
+    }
     prev_op_state->data_block_array_.clear();
 
+    // Spill the run if it exceeds the memory budget
+    SizeT memory_limit = query_context->global_config()->BufferManagerSize() / SORT_RUN_MEMORY_RATIO;
+    if (sort_operator_state->run_bytes_ > memory_limit && CanSpill(*run_blocks[0])) {
+        SpillRun(query_context, sort_operator_state);
+    }
+
     if (!prev_op_state->Complete()) {
         return false;
     }
-    auto &unmerge_sorted_blocks = sort_operator_state->unmerge_sorted_blocks_;
-    auto merge_comparator = Comparator(prefer_left_function_, unmerge_sorted_blocks, expressions_, expr_states);
-    Vector<Vector<BlockRawIndex>> indexes_group;
-
-    merge_comparator.Init();
-    indexes_group.reserve(unmerge_sorted_blocks.size());
-
-    for (u32 block_id = 0; block_id < unmerge_sorted_blocks.size(); ++block_id) {
-        Vector<BlockRawIndex> indexes;
-        indexes.reserve(unmerge_sorted_blocks[block_id]->row_count());
 
-        for (u32 offset = 0; offset < unmerge_sorted_blocks[block_id]->row_count(); ++offset) {
-            indexes.emplace_back(block_id, offset);
+    auto &output_blocks = sort_operator_state->data_block_array_;
+    if (sort_operator_state->spill_files_.empty()) {
+        // All rows fit in memory, no merge is needed.
+        SortBlocks(run_blocks, sort_operator_state->expr_states_, output_blocks);
+        run_blocks.clear();
+        sort_operator_state->run_bytes_ = 0;
+    } else {
+        if (!run_blocks.empty()) {
+            SpillRun(query_context, sort_operator_state);
         }
-        indexes_group.push_back(std::move(indexes));
+        MergeRuns(query_context, sort_operator_state);
+    }
+    if (output_blocks.empty()) {
+        auto empty_block = DataBlock::MakeUniquePtr();
+        empty_block->Init(*GetOutputTypes());
+        empty_block->Finalize();
+        output_blocks.push_back(std::move(empty_block));
     }
-    auto merge_indexes = MergeIndexes(indexes_group, 0, indexes_group.size() - 1, merge_comparator);
-    indexes_group.clear();
-
-    CopyWithIndexes(sort_operator_state->unmerge_sorted_blocks_, sort_operator_state->data_block_array_, merge_indexes);
-    sort_operator_state->unmerge_sorted_blocks_.clear();
     sort_operator_state->SetComplete();
     return true;
 }
@@ -29,9 +29,11 @@ import data_block;
 import load_meta;
 import infinity_exception;
 import physical_top;
+import expression_state;
 import internal_types;
 import select_statement;
 import data_type;
+import sort_key_encoder;
 
 namespace infinity {
 
@@ -64,8 +66,24 @@ public:
     Vector<OrderType> order_by_types_{};
 
 private:
+    // Sort the rows of the input blocks by the encoded keys, the sorted rows are appended to output_blocks.
+    void SortBlocks(const Vector<UniquePtr<DataBlock>> &input_blocks,
+                    Vector<SharedPtr<ExpressionState>> &expr_states,
+                    Vector<UniquePtr<DataBlock>> &output_blocks) const;
+
+    // Sort the buffered input blocks as a run and write it to a file in the temp dir.
+    void SpillRun(QueryContext *query_context, SortOperatorState *sort_operator_state) const;
+
+    // K-way merge the spilled runs, every full output block is passed to emit_block.
+    void MergeSpilledRuns(const Vector<String> &spill_files,
+                          Vector<SharedPtr<ExpressionState>> &expr_states,
+                          const std::function<void(UniquePtr<DataBlock>)> &emit_block) const;
+
+    // Merge the spilled runs into the output blocks, in several passes if there are too many runs to open at once.
+    void MergeRuns(QueryContext *query_context, SortOperatorState *sort_operator_state) const;
+
     u64 input_table_index_{};
-    CompareTwoRowAndPreferLeft prefer_left_function_; // compare function
+    UniquePtr<SortKeyEncoder> sort_key_encoder_{};
 };
 
 } // namespace infinity
@@ -14,15 +14,373 @@
 
 module;
 
+#include <string>
+import stl;
 import query_context;
 import operator_state;
+import physical_operator;
+import physical_operator_type;
+import physical_sort;
+import physical_project;
+import load_meta;
+import base_expression;
+import reference_expression;
+import expression_type;
+import select_statement;
+import join_reference;
+import data_block;
+import column_vector;
+import data_type;
+import sort_key_encoder;
+import join_util;
+import task_scheduler;
+import infinity_exception;
+import logger;
+import third_party;
 
 module physical_sort_merge_join;
 
 namespace infinity {
 
-void PhysicalSortMergeJoin::Init() {}
+namespace {
 
-bool PhysicalSortMergeJoin::Execute(QueryContext *, OperatorState *) { return true; }
+// One input of the merge join. The keys are encoded in the input order, rows_ are the rows with non-NULL key in key order.
+struct MergeJoinInput {
+    Vector<UniquePtr<DataBlock>> blocks_{};
+    Vector<Vector<SharedPtr<ColumnVector>>> key_columns_{};
+    // Block index and row index of each input row.
+    Vector<Pair<u32, u32>> locations_{};
+    Vector<char> keys_{};
+    Vector<u32> rows_{};
+    Vector<u32> null_key_rows_{};
+};
+
+bool HasNullKey(const Vector<SharedPtr<ColumnVector>> &key_columns, SizeT row_idx) {
+    for (const auto &key_column : key_columns) {
+        SizeT idx = key_column->vector_type() == ColumnVectorType::kConstant ? 0 : row_idx;
+        if (!key_column->nulls_ptr_->IsTrue(idx)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Column of the child output for every column the projection reads, -1 for the columns the projection loads itself.
+Vector<i64> ProjectInputColumns(const PhysicalProject &project) {
+    Vector<i64> input_columns;
+    SizeT child_column_count = project.left()->GetOutputTypes()->size();
+    input_columns.reserve(child_column_count);
+    for (SizeT column_idx = 0; column_idx < child_column_count; ++column_idx) {
+        input_columns.emplace_back(column_idx);
+    }
+    if (const auto &load_metas = project.load_metas(); load_metas.get() != nullptr) {
+        for (const auto &load_meta : *load_metas) {
+            input_columns.insert(input_columns.begin() + load_meta.index_, -1);
+        }
+    }
+    return input_columns;
+}
+
+SortKeyRow MakeRow(const SortKeyEncoder &encoder, const MergeJoinInput &input, u32 row) {
+    const auto &[block_idx, row_idx] = input.locations_[row];
+    return {input.keys_.data() + row * encoder.key_size(), &input.key_columns_[block_idx], row_idx};
+}
+
+i32 CompareRows(const SortKeyEncoder &encoder, const MergeJoinInput &left, u32 left_row, const MergeJoinInput &right, u32 right_row) {
+    return encoder.Compare(MakeRow(encoder, left, left_row), MakeRow(encoder, right, right_row));
+}
+
+// Encode the join keys of the input and order its rows by key, the sort is skipped if the input is already in key order.
+void PrepareInput(const SortKeyEncoder &encoder, const Vector<SizeT> &key_ids, MergeJoinInput &input) {
+    SizeT row_count = 0;
+    for (const auto &block : input.blocks_) {
+        row_count += block->row_count();
+    }
+    input.keys_.resize(row_count * encoder.key_size());
+    input.locations_.reserve(row_count);
+    input.rows_.reserve(row_count);
+
+    SizeT row_offset = 0;
+    for (u32 block_idx = 0; block_idx < input.blocks_.size(); ++block_idx) {
+        const DataBlock &block = *input.blocks_[block_idx];
+        Vector<SharedPtr<ColumnVector>> key_columns;
+        key_columns.reserve(key_ids.size());
+        for (SizeT key_id : key_ids) {
+            key_columns.emplace_back(block.column_vectors[key_id]);
+        }
+        SizeT block_row_count = block.row_count();
+        encoder.Encode(key_columns, block_row_count, input.keys_.data() + row_offset * encoder.key_size());
+        for (u32 row_idx = 0; row_idx < block_row_count; ++row_idx) {
+            u32 row = row_offset + row_idx;
+            input.locations_.emplace_back(block_idx, row_idx);
+            if (HasNullKey(key_columns, row_idx)) {
+                input.null_key_rows_.emplace_back(row);
+            } else {
+                input.rows_.emplace_back(row);
+            }
+        }
+        input.key_columns_.emplace_back(std::move(key_columns));
+        row_offset += block_row_count;
+    }
+
+    bool sorted = true;
+    for (SizeT idx = 1; idx < input.rows_.size(); ++idx) {
+        if (CompareRows(encoder, input, input.rows_[idx - 1], input, input.rows_[idx]) > 0) {
+            sorted = false;
+            break;
+        }
+    }
+    if (!sorted) {
+        std::stable_sort(input.rows_.begin(), input.rows_.end(), [&](u32 left_row, u32 right_row) {
+            return CompareRows(encoder, input, left_row, input, right_row) < 0;
+        });
+    }
+}
+
+} // namespace
+
+void PhysicalSortMergeJoin::Init() {
+    if (left_ == nullptr || right_ == nullptr) {
+        return;
+    }
+    output_types_ = GetOutputTypes();
+    if (!SupportMergeJoin(join_type_, conditions_, *left_->GetOutputTypes(), *right_->GetOutputTypes())) {
+        String error_message = "Merge join requires equality conditions between the left and the right input.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    ExtractEquiJoinKeys(conditions_, left_->GetOutputTypes()->size(), left_key_ids_, right_key_ids_);
+}
+
+bool PhysicalSortMergeJoin::Execute(QueryContext *query_context, OperatorState *operator_state) {
+    auto *merge_join_operator_state = static_cast<MergeJoinOperatorState *>(operator_state);
+    if (!merge_join_operator_state->input_complete_) {
+        return false;
+    }
+
+    auto take_input = [&](u64 fragment_id, MergeJoinInput &input) {
+        auto iter = merge_join_operator_state->input_data_blocks_.find(fragment_id);
+        if (iter == merge_join_operator_state->input_data_blocks_.end()) {
+            return;
+        }
+        for (auto &input_block : iter->second) {
+            if (input_block.get() != nullptr && input_block->row_count() > 0) {
+                input.blocks_.emplace_back(std::move(input_block));
+            }
+        }
+    };
+    MergeJoinInput left_input;
+    MergeJoinInput right_input;
+    take_input(left_fragment_id_, left_input);
+    take_input(right_fragment_id_, right_input);
+    merge_join_operator_state->input_data_blocks_.clear();
+
+    Vector<SharedPtr<DataType>> key_types;
+    for (SizeT key_id : left_key_ids_) {
+        key_types.emplace_back((*output_types_)[key_id]);
+    }
+    SortKeyEncoder encoder(std::move(key_types), Vector<OrderType>(left_key_ids_.size(), OrderType::kAsc));
+
+    // Both inputs are encoded and sorted independently, the other one on a scheduler worker if one is idle.
+    SizeT worker_count = std::max<SizeT>(1, query_context->cpu_number_limit());
+    query_context->scheduler()->RunParallel(2, worker_count, [&](SizeT input_idx) {
+        if (input_idx == 0) {
+            PrepareInput(encoder, left_key_ids_, left_input);
+        } else {
+            PrepareInput(encoder, right_key_ids_, right_input);
+        }
+    });
+
+    Vector<UniquePtr<DataBlock>> output_blocks;
+    auto append_left_row = [&](u32 left_row) {
+        const auto &[block_idx, row_idx] = left_input.locations_[left_row];
+        AppendJoinOutputRow(output_blocks, *output_types_, left_input.blocks_[block_idx].get(), row_idx, nullptr, 0);
+    };
+    auto append_joined_row = [&](u32 left_row, u32 right_row) {
+        const auto &[left_block_idx, left_row_idx] = left_input.locations_[left_row];
+        const auto &[right_block_idx, right_row_idx] = right_input.locations_[right_row];
+        AppendJoinOutputRow(output_blocks,
+                            *output_types_,
+                            left_input.blocks_[left_block_idx].get(),
+                            left_row_idx,
+                            right_input.blocks_[right_block_idx].get(),
+                            right_row_idx);
+    };
+    bool keep_unmatched = join_type_ == JoinType::kLeft || join_type_ == JoinType::kAnti;
+
+    // Rows with NULL key never match, NULL is the smallest key so they come first.
+    if (keep_unmatched) {
+        for (u32 left_row : left_input.null_key_rows_) {
+            append_left_row(left_row);
+        }
+    }
+
+    const Vector<u32> &left_rows = left_input.rows_;
+    const Vector<u32> &right_rows = right_input.rows_;
+    SizeT left_idx = 0;
+    SizeT right_idx = 0;
+    while (left_idx < left_rows.size() && right_idx < right_rows.size()) {
+        i32 result = CompareRows(encoder, left_input, left_rows[left_idx], right_input, right_rows[right_idx]);
+        if (result < 0) {
+            if (keep_unmatched) {
+                append_left_row(left_rows[left_idx]);
+            }
+            ++left_idx;
+            continue;
+        }
+        if (result > 0) {
+            ++right_idx;
+            continue;
+        }
+        // Every left row of the key matches the whole group of right rows with the same key.
+        SizeT right_end = right_idx + 1;
+        while (right_end < right_rows.size() && CompareRows(encoder, right_input, right_rows[right_idx], right_input, right_rows[right_end]) == 0) {
+            ++right_end;
+        }
+        do {
+            u32 left_row = left_rows[left_idx];
+            if (join_type_ == JoinType::kInner || join_type_ == JoinType::kLeft) {
+                for (SizeT idx = right_idx; idx < right_end; ++idx) {
+                    append_joined_row(left_row, right_rows[idx]);
+                }
+            } else if (join_type_ == JoinType::kSemi) {
+                append_left_row(left_row);
+            }
+            ++left_idx;
+        } while (left_idx < left_rows.size() && CompareRows(encoder, left_input, left_rows[left_idx], right_input, right_rows[right_idx]) == 0);
+        right_idx = right_end;
+    }
+    if (keep_unmatched) {
+        for (; left_idx < left_rows.size(); ++left_idx) {
+            append_left_row(left_rows[left_idx]);
+        }
+    }
+
+    for (auto &output_block : output_blocks) {
+        output_block->Finalize();
+        operator_state->data_block_array_.emplace_back(std::move(output_block));
+    }
+    operator_state->SetComplete();
+    return true;
+}
+
+bool PhysicalSortMergeJoin::SupportMergeJoin(JoinType join_type,
+                                             const Vector<SharedPtr<BaseExpression>> &conditions,
+                                             const Vector<SharedPtr<DataType>> &left_types,
+                                             const Vector<SharedPtr<DataType>> &right_types) {
+    switch (join_type) {
+        case JoinType::kInner:
+        case JoinType::kLeft:
+        case JoinType::kSemi:
+        case JoinType::kAnti: {
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+    Vector<SizeT> left_key_ids;
+    Vector<SizeT> right_key_ids;
+    if (!ExtractEquiJoinKeys(conditions, left_types.size(), left_key_ids, right_key_ids)) {
+        return false;
+    }
+    for (SizeT key_idx = 0; key_idx < left_key_ids.size(); ++key_idx) {
+        if (right_key_ids[key_idx] >= right_types.size()) {
+            return false;
+        }
+        const DataType &left_type = *left_types[left_key_ids[key_idx]];
+        const DataType &right_type = *right_types[right_key_ids[key_idx]];
+        // Keys of both sides are encoded by one encoder, both sides must have the same type.
+        if (left_type != right_type || !SortKeyEncoder::SupportKeyType(left_type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PhysicalSortMergeJoin::InputsSortedByKeys(const Vector<SharedPtr<BaseExpression>> &conditions,
+                                               const PhysicalOperator *left,
+                                               const PhysicalOperator *right) {
+    Vector<SizeT> left_key_ids;
+    Vector<SizeT> right_key_ids;
+    if (!ExtractEquiJoinKeys(conditions, left->GetOutputTypes()->size(), left_key_ids, right_key_ids)) {
+        return false;
+    }
+    auto sorted_by_keys = [](const PhysicalOperator *input, Vector<SizeT> key_ids) {
+        // The binder puts a projection above the sort of a subquery, projections keep the row order, so follow the keys
+        // through the projected columns.
+        while (input != nullptr && input->operator_type() == PhysicalOperatorType::kProjection) {
+            const auto *project = static_cast<const PhysicalProject *>(input);
+            if (project->left() == nullptr) {
+                return false;
+            }
+            Vector<i64> input_columns = ProjectInputColumns(*project);
+            for (SizeT &key_id : key_ids) {
+                const auto &expression = project->expressions_[key_id];
+                if (expression->type() != ExpressionType::kReference) {
+                    return false;
+                }
+                SizeT column_idx = static_cast<const ReferenceExpression *>(expression.get())->column_index();
+                if (column_idx >= input_columns.size() || input_columns[column_idx] < 0) {
+                    return false;
+                }
+                key_id = input_columns[column_idx];
+            }
+            input = project->left();
+        }
+        if (input == nullptr || input->operator_type() != PhysicalOperatorType::kSort) {
+            return false;
+        }
+        const auto *sort = static_cast<const PhysicalSort *>(input);
+        if (sort->expressions_.size() < key_ids.size()) {
+            return false;
+        }
+        for (SizeT key_idx = 0; key_idx < key_ids.size(); ++key_idx) {
+            const auto &expression = sort->expressions_[key_idx];
+            if (sort->order_by_types_[key_idx] != OrderType::kAsc || expression->type() != ExpressionType::kReference) {
+                return false;
+            }
+            if (static_cast<const ReferenceExpression *>(expression.get())->column_index() != key_ids[key_idx]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    return sorted_by_keys(left, left_key_ids) && sorted_by_keys(right, right_key_ids);
+}
+
+SharedPtr<Vector<String>> PhysicalSortMergeJoin::GetOutputNames() const {
+    SharedPtr<Vector<String>> result = MakeShared<Vector<String>>();
+    SharedPtr<Vector<String>> left_output_names = left_->GetOutputNames();
+    SharedPtr<Vector<String>> right_output_names = right_->GetOutputNames();
+
+    result->reserve(left_output_names->size() + right_output_names->size());
+    for (auto &name_str : *left_output_names) {
+        result->emplace_back(name_str);
+    }
+
+    for (auto &name_str : *right_output_names) {
+        result->emplace_back(name_str);
+    }
+
+    return result;
+}
+
+SharedPtr<Vector<SharedPtr<DataType>>> PhysicalSortMergeJoin::GetOutputTypes() const {
+    SharedPtr<Vector<SharedPtr<DataType>>> result = MakeShared<Vector<SharedPtr<DataType>>>();
+    SharedPtr<Vector<SharedPtr<DataType>>> left_output_types = left_->GetOutputTypes();
+    SharedPtr<Vector<SharedPtr<DataType>>> right_output_types = right_->GetOutputTypes();
+
+    result->reserve(left_output_types->size() + right_output_types->size());
+    for (auto &left_type : *left_output_types) {
+        result->emplace_back(left_type);
+    }
+
+    for (auto &right_type : *right_output_types) {
+        result->emplace_back(right_type);
+    }
+
+    return result;
+}
 
 } // namespace infinity
@@ -22,10 +22,13 @@ import query_context;
 import operator_state;
 import physical_operator;
 import physical_operator_type;
+import base_expression;
 import load_meta;
 import infinity_exception;
 import internal_types;
+import join_reference;
 import data_type;
+import data_block;
 import logger;
 
 namespace infinity {
@@ -35,26 +38,57 @@ public:
     explicit PhysicalSortMergeJoin(u64 id, SharedPtr<Vector<LoadMeta>> load_metas)
         : PhysicalOperator(PhysicalOperatorType::kJoinMerge, nullptr, nullptr, id, load_metas) {}
 
+    explicit PhysicalSortMergeJoin(u64 id,
+                                   JoinType join_type,
+                                   Vector<SharedPtr<BaseExpression>> conditions,
+                                   UniquePtr<PhysicalOperator> left,
+                                   UniquePtr<PhysicalOperator> right,
+                                   SharedPtr<Vector<LoadMeta>> load_metas)
+        : PhysicalOperator(PhysicalOperatorType::kJoinMerge, std::move(left), std::move(right), id, load_metas), join_type_(join_type),
+          conditions_(std::move(conditions)) {}
+
     ~PhysicalSortMergeJoin() override = default;
 
     void Init() override;
 
     bool Execute(QueryContext *query_context, OperatorState *operator_state) final;
 
-    inline SharedPtr<Vector<String>> GetOutputNames() const final { return output_names_; }
+    SharedPtr<Vector<String>> GetOutputNames() const final;
+
+    SharedPtr<Vector<SharedPtr<DataType>>> GetOutputTypes() const final;
+
+    // Merge join is executed in a serial fragment, both inputs are collected before the merge.
+    SizeT TaskletCount() override { return 1; }
 
-    inline SharedPtr<Vector<SharedPtr<DataType>>> GetOutputTypes() const final { return output_types_; }
+    inline JoinType join_type() const { return join_type_; }
 
-    SizeT TaskletCount() override {
-        String error_message = "Not implement: TaskletCount not Implement";
-        LOG_CRITICAL(error_message);
-        UnrecoverableError(error_message);
-        return 0;
+    inline const Vector<SharedPtr<BaseExpression>> &conditions() const { return conditions_; }
+
+    // Ids of the child fragments which produce the left and the right input.
+    inline void SetInputFragmentIds(u64 left_fragment_id, u64 right_fragment_id) {
+        left_fragment_id_ = left_fragment_id;
+        right_fragment_id_ = right_fragment_id;
     }
 
+    // Check if a join can be executed by merge join: the join type is supported and all conditions are
+    // equalities between a left column and a right column of the same sortable type.
+    static bool SupportMergeJoin(JoinType join_type,
+                                 const Vector<SharedPtr<BaseExpression>> &conditions,
+                                 const Vector<SharedPtr<DataType>> &left_types,
+                                 const Vector<SharedPtr<DataType>> &right_types);
+
+    // Check if both inputs are already sorted ascending by the join keys, so merge join needs no sort. An input is a sort
+    // on the keys, or projections of such a sort that pass the key columns through.
+    static bool InputsSortedByKeys(const Vector<SharedPtr<BaseExpression>> &conditions, const PhysicalOperator *left, const PhysicalOperator *right);
+
 private:
-    SharedPtr<Vector<String>> output_names_{};
+    JoinType join_type_{JoinType::kInner};
+    Vector<SharedPtr<BaseExpression>> conditions_{};
+    Vector<SizeT> left_key_ids_{};
+    Vector<SizeT> right_key_ids_{};
     SharedPtr<Vector<SharedPtr<DataType>>> output_types_{};
+    u64 left_fragment_id_{std::numeric_limits<u64>::max()};
+    u64 right_fragment_id_{std::numeric_limits<u64>::max()};
 };
 
 } // namespace infinity
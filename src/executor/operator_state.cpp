@@ -14,6 +14,9 @@
 
 module;
 
+#include <filesystem>
+#include <system_error>
+
 module operator_state;
 
 import data_block;
@@ -26,6 +29,14 @@ import third_party;
 
 namespace infinity {
 
+SortOperatorState::~SortOperatorState() {
+    // Spilled runs are left behind if the query fails before they are merged.
+    for (const auto &spill_file : spill_files_) {
+        std::error_code error_code;
+        std::filesystem::remove(spill_file, error_code);
+    }
+}
+
 void QueueSourceState::MarkCompletedTask(u64 fragment_id) {
     auto it = num_tasks_.find(fragment_id);
     if (it != num_tasks_.end()) {
@@ -116,6 +127,20 @@ bool QueueSourceState::GetData() {
             fusion_op_state->input_complete_ = completed;
             break;
         }
+        case PhysicalOperatorType::kJoinHash: {
+            auto *fragment_data = static_cast<FragmentData *>(fragment_data_base.get());
+            HashJoinOperatorState *hash_join_op_state = (HashJoinOperatorState *)next_op_state;
+            hash_join_op_state->input_data_blocks_[fragment_data->fragment_id_].push_back(std::move(fragment_data->data_block_));
+            hash_join_op_state->input_complete_ = completed;
+            break;
+        }
+        case PhysicalOperatorType::kJoinMerge: {
+            auto *fragment_data = static_cast<FragmentData *>(fragment_data_base.get());
+            MergeJoinOperatorState *merge_join_op_state = (MergeJoinOperatorState *)next_op_state;
+            merge_join_op_state->input_data_blocks_[fragment_data->fragment_id_].push_back(std::move(fragment_data->data_block_));
+            merge_join_op_state->input_complete_ = completed;
+            break;
+        }
         case PhysicalOperatorType::kMergeLimit: {
             auto *fragment_data = static_cast<FragmentData *>(fragment_data_base.get());
             MergeLimitOperatorState *limit_op_state = (MergeLimitOperatorState *)next_op_state;
@@ -143,8 +168,7 @@ bool QueueSourceState::GetData() {
         case PhysicalOperatorType::kMergeAggregate: {
             auto *fragment_data = static_cast<FragmentData *>(fragment_data_base.get());
             MergeAggregateOperatorState *merge_aggregate_op_state = (MergeAggregateOperatorState *)next_op_state;
-            // merge_aggregate_op_state->input_data_blocks_.push_back(std::move(fragment_data->data_block_));
-            merge_aggregate_op_state->input_data_block_ = std::move(fragment_data->data_block_);
+            merge_aggregate_op_state->input_data_blocks_.push_back(std::move(fragment_data->data_block_));
 
             // {
             //     auto row = merge_aggregate_op_state->input_data_block_->row_count();
@@ -37,6 +37,7 @@ import internal_types;
 import column_def;
 import data_type;
 import segment_entry;
+import hash_table;
 
 namespace infinity {
 
@@ -71,6 +72,8 @@ export struct AggregateOperatorState : public OperatorState {
         : OperatorState(PhysicalOperatorType::kAggregate), states_(std::move(states)) {}
 
     Vector<UniquePtr<char[]>> states_;
+    // Groups and their aggregate states of GROUP BY, created on the first input block.
+    UniquePtr<AggregateHashTable> hash_table_{};
 };
 
 // Merge Aggregate
@@ -78,7 +81,8 @@ export struct MergeAggregateOperatorState : public OperatorState {
     inline explicit MergeAggregateOperatorState() : OperatorState(PhysicalOperatorType::kMergeAggregate) {}
 
     /// Since merge agg is the first op, no previous operator state. This ptr is to get input data.
-    // Vector<UniquePtr<DataBlock>> input_data_blocks_{nullptr};
+    Vector<UniquePtr<DataBlock>> input_data_blocks_{};
+    // The block being merged by simple aggregate.
     UniquePtr<DataBlock> input_data_block_{nullptr};
     bool input_complete_{false};
 };
@@ -181,6 +185,11 @@ export struct MergeHashOperatorState : public OperatorState {
 // Hash Join
 export struct HashJoinOperatorState : public OperatorState {
     inline explicit HashJoinOperatorState() : OperatorState(PhysicalOperatorType::kJoinHash) {}
+
+    // Hash join is the first op, this is to tell op that both sides are drained.
+    bool input_complete_{false};
+    // Input blocks of the probe side and the build side, keyed by the id of the child fragment.
+    Map<u64, Vector<UniquePtr<DataBlock>>> input_data_blocks_{};
 };
 
 // Nested Loop
@@ -191,6 +200,11 @@ export struct NestedLoopOperatorState : public OperatorState {
 // Merge Join
 export struct MergeJoinOperatorState : public OperatorState {
     inline explicit MergeJoinOperatorState() : OperatorState(PhysicalOperatorType::kJoinMerge) {}
+
+    // Merge join is the first op, this is to tell op that both sides are drained.
+    bool input_complete_{false};
+    // Input blocks of the left side and the right side, keyed by the id of the child fragment.
+    Map<u64, Vector<UniquePtr<DataBlock>>> input_data_blocks_{};
 };
 
 // Index Join
@@ -240,8 +254,12 @@ export struct ProjectionOperatorState : public OperatorState {
 // Sort
 export struct SortOperatorState : public OperatorState {
     inline explicit SortOperatorState() : OperatorState(PhysicalOperatorType::kSort) {}
+    ~SortOperatorState() override;
     Vector<SharedPtr<ExpressionState>> expr_states_; // expression states
-    Vector<UniquePtr<DataBlock>> unmerge_sorted_blocks_{};
+    Vector<UniquePtr<DataBlock>> run_blocks_{};      // input blocks of the current run, not sorted yet
+    SizeT run_bytes_{};
+    Vector<String> spill_files_{}; // sorted runs spilled to the temp dir
+    SizeT spill_block_bytes_{};    // largest spilled block, bounds how many runs are merged at once
 };
 
 // Merge Sort
@@ -495,10 +513,11 @@ export struct AggregateSourceState : public SourceState {
 };
 
 export struct TableScanSourceState : public SourceState {
-    explicit TableScanSourceState(SharedPtr<Vector<GlobalBlockID>> global_ids)
-        : SourceState(SourceStateType::kTableScan), global_ids_(std::move(global_ids)) {}
+    explicit TableScanSourceState(SharedPtr<TableScanMorselQueue> morsel_queue)
+        : SourceState(SourceStateType::kTableScan), morsel_queue_(std::move(morsel_queue)) {}
 
-    SharedPtr<Vector<GlobalBlockID>> global_ids_;
+    // Shared by all tasks of the fragment.
+    SharedPtr<TableScanMorselQueue> morsel_queue_;
 };
 
 export struct MatchTensorScanSourceState : public SourceState {
@@ -579,6 +598,8 @@ export struct MaterializeSinkState : public SinkState {
     SharedPtr<Vector<SharedPtr<DataType>>> column_types_{};
     SharedPtr<Vector<String>> column_names_{};
     Vector<UniquePtr<DataBlock>> data_block_array_{};
+    // Table scan morsel of each block in data_block_array_, empty if the fragment doesn't start with a table scan.
+    Vector<SizeT> data_block_morsel_ids_{};
 
     bool empty_result_{false};
 };
@@ -42,6 +42,8 @@ import physical_optimize;
 import physical_hash;
 import physical_hash_join;
 import physical_index_join;
+import physical_sort_merge_join;
+import table_index_entry;
 import physical_import;
 import physical_index_scan;
 import physical_insert;
@@ -608,6 +610,10 @@ UniquePtr<PhysicalOperator> PhysicalPlanner::BuildAggregate(const SharedPtr<Logi
     if (tasklet_count == 1) {
         return physical_agg_op;
     } else {
+        if (!physical_agg_op->groups_.empty()) {
+            // Two phase group by: every task pre-aggregates its input, the merge operator combines the partial states.
+            physical_agg_op->SetPartialOutput();
+        }
         return MakeUnique<PhysicalMergeAggregate>(query_context_ptr_->GetNextNodeID(),
                                                   logical_aggregate->base_table_ref_,
                                                   std::move(physical_agg_op),
@@ -641,6 +647,49 @@ UniquePtr<PhysicalOperator> PhysicalPlanner::BuildJoin(const SharedPtr<LogicalNo
     left_physical_operator = BuildPhysicalOperator(left_node);
     right_physical_operator = BuildPhysicalOperator(right_node);
 
+    // Small left input and an indexed right table: look up the secondary index with every left row instead of scanning the table.
+    TableIndexEntry *inner_index_entry = PhysicalIndexJoin::ChooseInnerIndex(query_context_ptr_,
+                                                                             logical_join->join_type_,
+                                                                             logical_join->conditions_,
+                                                                             left_physical_operator.get(),
+                                                                             right_physical_operator.get());
+    if (inner_index_entry != nullptr) {
+        return MakeUnique<PhysicalIndexJoin>(logical_operator->node_id(),
+                                             logical_join->join_type_,
+                                             logical_join->conditions_,
+                                             std::move(left_physical_operator),
+                                             std::move(right_physical_operator),
+                                             inner_index_entry,
+                                             logical_operator->load_metas());
+    }
+
+    // Both inputs are already sorted by the join keys: merge them without building a hash table.
+    if (PhysicalSortMergeJoin::SupportMergeJoin(logical_join->join_type_,
+                                                logical_join->conditions_,
+                                                *left_physical_operator->GetOutputTypes(),
+                                                *right_physical_operator->GetOutputTypes()) &&
+        PhysicalSortMergeJoin::InputsSortedByKeys(logical_join->conditions_, left_physical_operator.get(), right_physical_operator.get())) {
+        return MakeUnique<PhysicalSortMergeJoin>(logical_operator->node_id(),
+                                                 logical_join->join_type_,
+                                                 logical_join->conditions_,
+                                                 std::move(left_physical_operator),
+                                                 std::move(right_physical_operator),
+                                                 logical_operator->load_metas());
+    }
+
+    // Equi-join: build a hash table on the right input and probe it with the left input.
+    if (PhysicalHashJoin::SupportHashJoin(logical_join->join_type_,
+                                          logical_join->conditions_,
+                                          *left_physical_operator->GetOutputTypes(),
+                                          *right_physical_operator->GetOutputTypes())) {
+        return MakeUnique<PhysicalHashJoin>(logical_operator->node_id(),
+                                            logical_join->join_type_,
+                                            logical_join->conditions_,
+                                            std::move(left_physical_operator),
+                                            std::move(right_physical_operator),
+                                            logical_operator->load_metas());
+    }
+
     return MakeUnique<PhysicalNestedLoopJoin>(logical_operator->node_id(),
                                               logical_join->join_type_,
                                               logical_join->conditions_,
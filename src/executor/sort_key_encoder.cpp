@@ -0,0 +1,274 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+#include <type_traits>
+
+module sort_key_encoder;
+
+import stl;
+import column_vector;
+import vector_buffer;
+import fix_heap;
+import data_type;
+import logical_type;
+import internal_types;
+import select_statement;
+import status;
+import infinity_exception;
+import logger;
+import third_party;
+
+namespace infinity {
+
+namespace {
+
+template <typename T>
+inline void StoreBigEndian(char *dst, T value) {
+    for (SizeT i = 0; i < sizeof(T); ++i) {
+        dst[i] = static_cast<char>(value >> ((sizeof(T) - 1 - i) * 8));
+    }
+}
+
+template <typename T>
+inline void EncodeSigned(char *dst, T value) {
+    using U = std::make_unsigned_t<T>;
+    constexpr U sign_bit = U(1) << (sizeof(T) * 8 - 1);
+    StoreBigEndian<U>(dst, static_cast<U>(value) ^ sign_bit);
+}
+
+template <typename T, typename U>
+inline void EncodeFloat(char *dst, T value) {
+    constexpr U sign_bit = U(1) << (sizeof(T) * 8 - 1);
+    if (value == 0) {
+        // -0.0 and 0.0 are equal.
+        value = 0;
+    }
+    U bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    bits = (bits & sign_bit) ? ~bits : (bits | sign_bit);
+    StoreBigEndian<U>(dst, bits);
+}
+
+SizeT SortKeyValueSize(const DataType &data_type) {
+    switch (data_type.type()) {
+        case LogicalType::kBoolean:
+        case LogicalType::kTinyInt: {
+            return 1;
+        }
+        case LogicalType::kVarchar: {
+            // Prefix and the truncated byte.
+            return SORT_KEY_VARCHAR_PREFIX_SIZE + 1;
+        }
+        default: {
+            return data_type.Size();
+        }
+    }
+}
+
+std::string_view ReadVarchar(const ColumnVector &column, SizeT idx, String &buffer) {
+    const VarcharT &varchar = reinterpret_cast<const VarcharT *>(column.data())[idx];
+    if (varchar.IsInlined()) {
+        return {varchar.short_.data_, static_cast<SizeT>(varchar.length_)};
+    }
+    buffer.resize(varchar.length_);
+    column.buffer_->fix_heap_mgr_->ReadFromHeap(buffer.data(), varchar.vector_.chunk_id_, varchar.vector_.chunk_offset_, varchar.length_);
+    return buffer;
+}
+
+} // namespace
+
+SortKeyEncoder::SortKeyEncoder(Vector<SharedPtr<DataType>> key_types, Vector<OrderType> order_types)
+    : key_types_(std::move(key_types)), order_types_(std::move(order_types)) {
+    if (key_types_.size() != order_types_.size()) {
+        String error_message = "Sort key types and order types mismatch.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    key_offsets_.reserve(key_types_.size());
+    for (const auto &key_type : key_types_) {
+        if (!SupportKeyType(*key_type)) {
+            Status status = Status::NotSupport(fmt::format("OrderBy LogicalType {} not implemented.", key_type->ToString()));
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+        }
+        key_offsets_.emplace_back(key_size_);
+        key_size_ += 1 + SortKeyValueSize(*key_type);
+        if (key_type->type() == LogicalType::kVarchar) {
+            varchar_key_ids_.emplace_back(key_offsets_.size() - 1);
+        }
+    }
+}
+
+bool SortKeyEncoder::SupportKeyType(const DataType &data_type) {
+    switch (data_type.type()) {
+        case LogicalType::kBoolean:
+        case LogicalType::kTinyInt:
+        case LogicalType::kSmallInt:
+        case LogicalType::kInteger:
+        case LogicalType::kBigInt:
+        case LogicalType::kHugeInt:
+        case LogicalType::kFloat:
+        case LogicalType::kDouble:
+        case LogicalType::kVarchar:
+        case LogicalType::kDate:
+        case LogicalType::kTime:
+        case LogicalType::kDateTime:
+        case LogicalType::kTimestamp:
+        case LogicalType::kRowID: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+void SortKeyEncoder::Encode(const Vector<SharedPtr<ColumnVector>> &key_columns, SizeT row_count, char *output) const {
+    std::memset(output, 0, row_count * key_size_);
+    for (SizeT key_idx = 0; key_idx < key_types_.size(); ++key_idx) {
+        const ColumnVector &column = *key_columns[key_idx];
+        bool is_constant = column.vector_type() == ColumnVectorType::kConstant;
+        for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+            SizeT idx = is_constant ? 0 : row_idx;
+            char *slot = output + row_idx * key_size_ + key_offsets_[key_idx];
+            if (!column.nulls_ptr_->IsTrue(idx)) {
+                continue;
+            }
+            slot[0] = 1;
+            char *value = slot + 1;
+            const_ptr_t data = column.data();
+            switch (key_types_[key_idx]->type()) {
+                case LogicalType::kBoolean: {
+                    value[0] = column.buffer_->GetCompactBit(idx) ? 1 : 0;
+                    break;
+                }
+                case LogicalType::kTinyInt: {
+                    EncodeSigned(value, reinterpret_cast<const TinyIntT *>(data)[idx]);
+                    break;
+                }
+                case LogicalType::kSmallInt: {
+                    EncodeSigned(value, reinterpret_cast<const SmallIntT *>(data)[idx]);
+                    break;
+                }
+                case LogicalType::kInteger: {
+                    EncodeSigned(value, reinterpret_cast<const IntegerT *>(data)[idx]);
+                    break;
+                }
+                case LogicalType::kBigInt: {
+                    EncodeSigned(value, reinterpret_cast<const BigIntT *>(data)[idx]);
+                    break;
+                }
+                case LogicalType::kHugeInt: {
+                    const HugeIntT &huge_int = reinterpret_cast<const HugeIntT *>(data)[idx];
+                    EncodeSigned(value, huge_int.upper);
+                    EncodeSigned(value + sizeof(i64), huge_int.lower);
+                    break;
+                }
+                case LogicalType::kFloat: {
+                    EncodeFloat<FloatT, u32>(value, reinterpret_cast<const FloatT *>(data)[idx]);
+                    break;
+                }
+                case LogicalType::kDouble: {
+                    EncodeFloat<DoubleT, u64>(value, reinterpret_cast<const DoubleT *>(data)[idx]);
+                    break;
+                }
+                case LogicalType::kVarchar: {
+                    const VarcharT &varchar = reinterpret_cast<const VarcharT *>(data)[idx];
+                    SizeT prefix_size = std::min(static_cast<SizeT>(varchar.length_), SORT_KEY_VARCHAR_PREFIX_SIZE);
+                    if (varchar.IsInlined()) {
+                        std::memcpy(value, varchar.short_.data_, prefix_size);
+                    } else {
+                        column.buffer_->fix_heap_mgr_->ReadFromHeap(value, varchar.vector_.chunk_id_, varchar.vector_.chunk_offset_, prefix_size);
+                    }
+                    value[SORT_KEY_VARCHAR_PREFIX_SIZE] = varchar.length_ > SORT_KEY_VARCHAR_PREFIX_SIZE ? 1 : 0;
+                    break;
+                }
+                case LogicalType::kDate: {
+                    EncodeSigned(value, reinterpret_cast<const DateT *>(data)[idx].value);
+                    break;
+                }
+                case LogicalType::kTime: {
+                    EncodeSigned(value, reinterpret_cast<const TimeT *>(data)[idx].value);
+                    break;
+                }
+                case LogicalType::kDateTime: {
+                    const DateTimeT &datetime = reinterpret_cast<const DateTimeT *>(data)[idx];
+                    EncodeSigned(value, datetime.date.value);
+                    EncodeSigned(value + sizeof(i32), datetime.time.value);
+                    break;
+                }
+                case LogicalType::kTimestamp: {
+                    const TimestampT &timestamp = reinterpret_cast<const TimestampT *>(data)[idx];
+                    EncodeSigned(value, timestamp.date.value);
+                    EncodeSigned(value + sizeof(i32), timestamp.time.value);
+                    break;
+                }
+                case LogicalType::kRowID: {
+                    StoreBigEndian<u64>(value, reinterpret_cast<const RowID *>(data)[idx].ToUint64());
+                    break;
+                }
+                default: {
+                    String error_message = "Unexpected sort key type.";
+                    LOG_CRITICAL(error_message);
+                    UnrecoverableError(error_message);
+                }
+            }
+        }
+        if (order_types_[key_idx] == OrderType::kDesc) {
+            SizeT slot_size = 1 + SortKeyValueSize(*key_types_[key_idx]);
+            for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+                char *slot = output + row_idx * key_size_ + key_offsets_[key_idx];
+                for (SizeT i = 0; i < slot_size; ++i) {
+                    slot[i] = ~slot[i];
+                }
+            }
+        }
+    }
+}
+
+i32 SortKeyEncoder::Compare(const SortKeyRow &left, const SortKeyRow &right) const {
+    SizeT offset = 0;
+    for (SizeT key_idx : varchar_key_ids_) {
+        SizeT slot_end = key_offsets_[key_idx] + 1 + SortKeyValueSize(*key_types_[key_idx]);
+        i32 result = std::memcmp(left.key_ + offset, right.key_ + offset, slot_end - offset);
+        if (result != 0) {
+            return result;
+        }
+        offset = slot_end;
+        // Equal slots, check the truncated byte of either row.
+        char truncated = order_types_[key_idx] == OrderType::kAsc ? 1 : ~1;
+        if (left.key_[slot_end - 1] == truncated) {
+            result = CompareVarchar(key_idx, left, right);
+            if (result != 0) {
+                return result;
+            }
+        }
+    }
+    return std::memcmp(left.key_ + offset, right.key_ + offset, key_size_ - offset);
+}
+
+i32 SortKeyEncoder::CompareVarchar(SizeT key_idx, const SortKeyRow &left, const SortKeyRow &right) const {
+    const ColumnVector &left_column = *(*left.columns_)[key_idx];
+    const ColumnVector &right_column = *(*right.columns_)[key_idx];
+    SizeT left_idx = left_column.vector_type() == ColumnVectorType::kConstant ? 0 : left.row_idx_;
+    SizeT right_idx = right_column.vector_type() == ColumnVectorType::kConstant ? 0 : right.row_idx_;
+    String left_buffer;
+    String right_buffer;
+    i32 result = ReadVarchar(left_column, left_idx, left_buffer).compare(ReadVarchar(right_column, right_idx, right_buffer));
+    return order_types_[key_idx] == OrderType::kAsc ? result : -result;
+}
+
+} // namespace infinity
@@ -0,0 +1,76 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module sort_key_encoder;
+
+import stl;
+import column_vector;
+import internal_types;
+import data_type;
+import select_statement;
+
+namespace infinity {
+
+// Bytes of a varchar key kept in the normalized key, longer strings are compared in full when the prefixes are equal.
+export constexpr SizeT SORT_KEY_VARCHAR_PREFIX_SIZE = 16;
+
+// A row to compare: its encoded key and the key columns it was encoded from. The columns are only read for varchar keys
+// truncated in both rows.
+export struct SortKeyRow {
+    const char *key_;
+    const Vector<SharedPtr<ColumnVector>> *columns_;
+    SizeT row_idx_;
+};
+
+// Encode ORDER BY keys of a row into a fixed width byte string, memcmp of two encoded keys gives the order of the rows.
+//
+// Every key is a valid byte followed by the value bytes:
+// - NULL is encoded as valid byte 0 with zero value bytes, so NULL is the smallest value.
+// - Integers are stored big-endian with the sign bit flipped.
+// - Floats flip the sign bit of positive values and all bits of negative values.
+// - Varchar keeps the first SORT_KEY_VARCHAR_PREFIX_SIZE bytes, padded with zero, and a last byte that is 1 if the
+//   string is longer than the prefix.
+// All bytes of a key are inverted for descending order.
+//
+// memcmp alone is not the row order once a varchar key is truncated: two rows with the same prefix would be ordered
+// by the keys after it. Compare checks the truncated varchar keys in full before going on to the next key.
+export class SortKeyEncoder {
+public:
+    SortKeyEncoder(Vector<SharedPtr<DataType>> key_types, Vector<OrderType> order_types);
+
+    // Encode the keys of rows [0, row_count), the key of row i is written to output + i * key_size().
+    void Encode(const Vector<SharedPtr<ColumnVector>> &key_columns, SizeT row_count, char *output) const;
+
+    // Compare two rows in the sort order. Returns < 0, 0 or > 0.
+    i32 Compare(const SortKeyRow &left, const SortKeyRow &right) const;
+
+    [[nodiscard]] inline SizeT key_size() const { return key_size_; }
+
+    // Check if values of the given type can be used as a sort key.
+    static bool SupportKeyType(const DataType &data_type);
+
+private:
+    // Compare the full strings of a varchar key.
+    i32 CompareVarchar(SizeT key_idx, const SortKeyRow &left, const SortKeyRow &right) const;
+
+    Vector<SharedPtr<DataType>> key_types_{};
+    Vector<OrderType> order_types_{};
+    Vector<SizeT> key_offsets_{};
+    SizeT key_size_{};
+    Vector<SizeT> varchar_key_ids_{};
+};
+
+} // namespace infinity
@@ -52,6 +52,12 @@ public:
         RecoverableError(status);
     }
 
+    inline void Combine(const AvgState &) {
+        Status status = Status::NotSupport("Combine average state.");
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+
     inline ptr_t Finalize() {
         Status status = Status::NotSupport("Finalize average state.");
         LOG_ERROR(status.message());
@@ -92,6 +98,11 @@ public:
         value_ += (input[idx] * count);
     }
 
+    inline void Combine(const AvgState &other) {
+        this->count_ += other.count_;
+        value_ += other.value_;
+    }
+
     [[nodiscard]] inline ptr_t Finalize() {
         result_ = value_ / count_;
         return (ptr_t)&result_;
@@ -128,6 +139,11 @@ public:
         value_ += (input[idx] * count);
     }
 
+    inline void Combine(const AvgState &other) {
+        this->count_ += other.count_;
+        value_ += other.value_;
+    }
+
     inline ptr_t Finalize() {
         result_ = value_ / count_;
         return (ptr_t)&result_;
@@ -164,6 +180,11 @@ public:
         value_ += (input[idx] * count);
     }
 
+    inline void Combine(const AvgState &other) {
+        this->count_ += other.count_;
+        value_ += other.value_;
+    }
+
     inline ptr_t Finalize() {
         result_ = value_ / count_;
         return (ptr_t)&result_;
@@ -200,6 +221,11 @@ public:
         value_ += (input[idx] * count);
     }
 
+    inline void Combine(const AvgState &other) {
+        this->count_ += other.count_;
+        value_ += other.value_;
+    }
+
     inline ptr_t Finalize() {
         result_ = value_ / count_;
         return (ptr_t)&result_;
@@ -236,6 +262,11 @@ public:
         value_ += (input[idx] * count);
     }
 
+    inline void Combine(const AvgState &other) {
+        this->count_ += other.count_;
+        value_ += other.value_;
+    }
+
     inline ptr_t Finalize() {
         result_ = value_ / count_;
         return (ptr_t)&result_;
@@ -272,6 +303,11 @@ public:
         value_ += (input[idx] * count);
     }
 
+    inline void Combine(const AvgState &other) {
+        this->count_ += other.count_;
+        value_ += other.value_;
+    }
+
     inline ptr_t Finalize() {
         result_ = value_ / count_;
         return (ptr_t)&result_;
@@ -40,6 +40,8 @@ public:
 
     inline void ConstantUpdate(ValueType *__restrict, SizeT, SizeT count) { count_ += count; }
 
+    inline void Combine(const CountState &other) { count_ += other.count_; }
+
     inline ptr_t Finalize() { return (ptr_t)&count_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(i64); }
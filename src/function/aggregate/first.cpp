@@ -53,6 +53,14 @@ public:
         value_ = input[idx];
     }
 
+    inline void Combine(const FirstState &other) {
+        if (is_set_ || !other.is_set_)
+            return;
+
+        is_set_ = true;
+        value_ = other.value_;
+    }
+
     [[nodiscard]] inline ptr_t Finalize() const { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(FirstState<ValueType, ResultType>); }
@@ -84,6 +92,14 @@ public:
         value_ = input[idx];
     }
 
+    inline void Combine(const FirstState &other) {
+        if (is_set_ || !other.is_set_)
+            return;
+
+        is_set_ = true;
+        value_ = other.value_;
+    }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(FirstState<VarcharT, VarcharT>); }
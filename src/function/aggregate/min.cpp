@@ -54,6 +54,12 @@ public:
         UnrecoverableError(error_message);
     }
 
+    void Combine(const MinState &) {
+        String error_message = "Not implement: MinState::Combine";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+
     [[nodiscard]] ptr_t Finalize() const {
         String error_message = "Not implement: MinState::Finalize";
         LOG_CRITICAL(error_message);
@@ -78,6 +84,8 @@ public:
 
     inline void ConstantUpdate(const BooleanT *__restrict input, SizeT idx, SizeT) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return 1; }
@@ -94,6 +102,8 @@ public:
 
     inline void ConstantUpdate(const TinyIntT *__restrict input, SizeT idx, SizeT) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(TinyIntT); }
@@ -110,6 +120,8 @@ public:
 
     inline void ConstantUpdate(const SmallIntT *__restrict input, SizeT idx, SizeT ) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(SmallIntT); }
@@ -126,6 +138,8 @@ public:
 
     inline void ConstantUpdate(const IntegerT *__restrict input, SizeT idx, SizeT) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(IntegerT); }
@@ -142,6 +156,8 @@ public:
 
     inline void ConstantUpdate(const BigIntT *__restrict input, SizeT idx, SizeT) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(BigIntT); }
@@ -161,6 +177,8 @@ public:
 
     inline void ConstantUpdate(const HugeIntT *__restrict input, SizeT idx, SizeT) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(HugeIntT); }
@@ -177,6 +195,8 @@ public:
 
     inline void ConstantUpdate(const FloatT *__restrict input, SizeT idx, SizeT) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(FloatT); }
@@ -193,6 +213,8 @@ public:
 
     inline void ConstantUpdate(const DoubleT *__restrict input, SizeT idx, SizeT) { value_ = input[idx] < value_ ? input[idx] : value_; }
 
+    inline void Combine(const MinState &other) { Update(&other.value_, 0); }
+
     inline ptr_t Finalize() { return (ptr_t)&value_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(DoubleT); }
@@ -52,6 +52,12 @@ public:
         RecoverableError(status);
     }
 
+    inline void Combine(const SumState &) {
+        Status status = Status::NotSupport("Not implemented");
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+
     inline ptr_t Finalize() {
         Status status = Status::NotSupport("Not implemented");
         LOG_ERROR(status.message());
@@ -76,6 +82,8 @@ public:
 
     inline void ConstantUpdate(const TinyIntT *__restrict input, SizeT idx, SizeT count) { sum_ += input[idx] * count; }
 
+    inline void Combine(const SumState &other) { sum_ += other.sum_; }
+
     inline ptr_t Finalize() { return (ptr_t)&sum_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(i64); }
@@ -92,6 +100,8 @@ public:
 
     inline void ConstantUpdate(const SmallIntT *__restrict input, SizeT idx, SizeT count) { sum_ += input[idx] * count; }
 
+    inline void Combine(const SumState &other) { sum_ += other.sum_; }
+
     inline ptr_t Finalize() { return (ptr_t)&sum_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(i64); }
@@ -108,6 +118,8 @@ public:
 
     inline void ConstantUpdate(const IntegerT *__restrict input, SizeT idx, SizeT count) { sum_ += input[idx] * count; }
 
+    inline void Combine(const SumState &other) { sum_ += other.sum_; }
+
     inline ptr_t Finalize() { return (ptr_t)&sum_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(i64); }
@@ -124,6 +136,8 @@ public:
 
     inline void ConstantUpdate(const BigIntT *__restrict input, SizeT idx, SizeT count) { sum_ += input[idx] * count; }
 
+    inline void Combine(const SumState &other) { sum_ += other.sum_; }
+
     inline ptr_t Finalize() { return (ptr_t)&sum_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(i64); }
@@ -140,6 +154,8 @@ public:
 
     inline void ConstantUpdate(const FloatT *__restrict input, SizeT idx, SizeT count) { sum_ += input[idx] * count; }
 
+    inline void Combine(const SumState &other) { sum_ += other.sum_; }
+
     inline ptr_t Finalize() { return (ptr_t)&sum_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(DoubleT); }
@@ -156,6 +172,8 @@ public:
 
     inline void ConstantUpdate(const DoubleT *__restrict input, SizeT idx, SizeT count) { sum_ += input[idx] * count; }
 
+    inline void Combine(const SumState &other) { sum_ += other.sum_; }
+
     inline ptr_t Finalize() { return (ptr_t)&sum_; }
 
     inline static SizeT Size(const DataType &) { return sizeof(DoubleT); }
@@ -35,43 +35,58 @@ import logger;
 namespace infinity {
 
 export class RowIDRemap {
-    using RowIDMap = HashMap<GlobalBlockID, Vector<Pair<BlockOffset, RowID>>, GlobalBlockIDHash>;
+    // the rows [block_offset_, block_offset_ + row_count_) of a block are moved to the rows from new_row_id_
+    struct RowRange {
+        BlockOffset block_offset_;
+        BlockOffset row_count_;
+        RowID new_row_id_;
+    };
+    using RowIDMap = HashMap<GlobalBlockID, Vector<RowRange>, GlobalBlockIDHash>;
 
 public:
     RowIDRemap(SizeT block_capacity = DEFAULT_BLOCK_CAPACITY) : block_capacity_(block_capacity) {}
 
-    void AddMap(SegmentID segment_id, BlockID block_id, BlockOffset block_offset, RowID new_row_id) {
+    void AddMap(SegmentID segment_id, BlockID block_id, BlockOffset block_offset, BlockOffset row_count, RowID new_row_id) {
         std::lock_guard lock(mutex_);
         auto &block_vec = row_id_map_[GlobalBlockID(segment_id, block_id)];
-        block_vec.emplace_back(block_offset, new_row_id);
+        block_vec.push_back({block_offset, row_count, new_row_id});
     }
 
-    RowID GetNewRowID(SegmentID segment_id, BlockID block_id, BlockOffset block_offset) const {
-        auto &block_vec = row_id_map_.at(GlobalBlockID(segment_id, block_id));
-        auto iter =
-            std::upper_bound(block_vec.begin(),
-                             block_vec.end(),
-                             block_offset,
-                             [](BlockOffset block_offset, const Pair<BlockOffset, RowID> &pair) { return block_offset < pair.first; } // NOLINT
-            );
+    // None if the row is not moved
+    Optional<RowID> TryGetNewRowID(SegmentID segment_id, BlockID block_id, BlockOffset block_offset) const {
+        auto map_iter = row_id_map_.find(GlobalBlockID(segment_id, block_id));
+        if (map_iter == row_id_map_.end()) {
+            return None;
+        }
+        const auto &block_vec = map_iter->second;
+        auto iter = std::upper_bound(block_vec.begin(),
+                                     block_vec.end(),
+                                     block_offset,
+                                     [](BlockOffset block_offset, const RowRange &range) { return block_offset < range.block_offset_; });
         if (iter == block_vec.begin()) {
-            String error_message = "RowID not found";
-            LOG_CRITICAL(error_message);
-            UnrecoverableError(error_message);
+            return None;
         }
         --iter;
-        RowID rtn = iter->second;
-        rtn.segment_offset_ += iter->first - block_offset;
+        if (block_offset >= iter->block_offset_ + iter->row_count_) {
+            return None;
+        }
+        RowID rtn = iter->new_row_id_;
+        rtn.segment_offset_ += block_offset - iter->block_offset_;
         return rtn;
     }
 
-    void AddMap(RowID old_row_id, RowID new_row_id) {
-        std::lock_guard lock(mutex_);
-        AddMap(old_row_id.segment_id_, old_row_id.segment_offset_ / block_capacity_, old_row_id.segment_offset_ % block_capacity_, new_row_id);
+    Optional<RowID> TryGetNewRowID(RowID old_row_id) const {
+        return TryGetNewRowID(old_row_id.segment_id_, old_row_id.segment_offset_ / block_capacity_, old_row_id.segment_offset_ % block_capacity_);
     }
 
     RowID GetNewRowID(RowID old_row_id) const {
-        return GetNewRowID(old_row_id.segment_id_, old_row_id.segment_offset_ / block_capacity_, old_row_id.segment_offset_ % block_capacity_);
+        Optional<RowID> new_row_id = TryGetNewRowID(old_row_id);
+        if (!new_row_id.has_value()) {
+            String error_message = "RowID not found";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        return *new_row_id;
     }
 
 private:
@@ -14,6 +14,8 @@
 
 module;
 
+#include <string>
+
 module knn_scan_data;
 
 import stl;
@@ -45,11 +47,70 @@ import logger;
 
 namespace infinity {
 
+KnnFilterStrategy ChooseKnnFilterStrategy(SizeT filtered_row_count, SizeT segment_row_count, SizeT topk) {
+    if (filtered_row_count >= segment_row_count) {
+        return KnnFilterStrategy::kIndex;
+    }
+    const f64 selectivity = static_cast<f64>(filtered_row_count) / segment_row_count;
+    if (filtered_row_count <= topk || selectivity <= KNN_FILTER_BRUTE_FORCE_SELECTIVITY) {
+        return KnnFilterStrategy::kBruteForce;
+    }
+    if (selectivity <= KNN_FILTER_EXPANDED_SELECTIVITY) {
+        return KnnFilterStrategy::kExpandedIndex;
+    }
+    return KnnFilterStrategy::kIndex;
+}
+
+KnnFilterStrategy StringToKnnFilterStrategy(const String &str) {
+    if (str == "index") {
+        return KnnFilterStrategy::kIndex;
+    } else if (str == "expanded") {
+        return KnnFilterStrategy::kExpandedIndex;
+    } else if (str == "brute_force") {
+        return KnnFilterStrategy::kBruteForce;
+    }
+    Status status = Status::InvalidParameterValue("filter_strategy", str, "index, expanded or brute_force");
+    LOG_ERROR(status.message());
+    RecoverableError(status);
+    return KnnFilterStrategy::kIndex;
+}
+
+KnnScanSharedData::KnnScanSharedData(SharedPtr<BaseTableRef> table_ref,
+                                     UniquePtr<Vector<BlockColumnEntry *>> block_column_entries,
+                                     UniquePtr<Vector<SegmentIndexEntry *>> index_entries,
+                                     Vector<InitParameter> opt_params,
+                                     i64 topk,
+                                     i64 dimension,
+                                     i64 query_embedding_count,
+                                     void *query_embedding,
+                                     EmbeddingDataType elem_type,
+                                     KnnDistanceType knn_distance_type)
+    : table_ref_(table_ref), block_column_entries_(std::move(block_column_entries)), index_entries_(std::move(index_entries)),
+      opt_params_(std::move(opt_params)), topk_(topk), dimension_(dimension), query_count_(query_embedding_count), query_embedding_(query_embedding),
+      elem_type_(elem_type), knn_distance_type_(knn_distance_type), topk_bound_(query_embedding_count) {
+    for (const auto &opt_param : opt_params_) {
+        if (opt_param.param_name_ == "ef") {
+            hnsw_ef_ = std::stoull(opt_param.param_value_);
+        } else if (opt_param.param_name_ == "nprobe") {
+            ivf_nprobe_ = std::max(1ull, std::stoull(opt_param.param_value_));
+        } else if (opt_param.param_name_ == "rerank") {
+            rerank_ = true;
+        } else if (opt_param.param_name_ == "search_list") {
+            diskann_search_list_ = std::stoull(opt_param.param_value_);
+        } else if (opt_param.param_name_ == "beam_width") {
+            diskann_beam_width_ = std::max(1ull, std::stoull(opt_param.param_value_));
+        } else if (opt_param.param_name_ == "filter_strategy") {
+            filter_strategy_ = StringToKnnFilterStrategy(opt_param.param_value_);
+        }
+    }
+}
+
 template <>
 KnnDistance1<f32>::KnnDistance1(KnnDistanceType dist_type) {
     switch (dist_type) {
         case KnnDistanceType::kL2: {
             dist_func_ = L2Distance<f32, f32, f32, SizeT>;
+            bounded_dist_func_ = L2DistanceBounded<f32, f32, f32, SizeT>;
             break;
         }
         case KnnDistanceType::kCosine: {
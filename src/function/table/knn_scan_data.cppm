@@ -37,6 +37,29 @@ import internal_types;
 
 namespace infinity {
 
+// Candidates kept per query for each result when the approximate distances of an IVF index are reranked with the raw vectors.
+export constexpr u32 IVF_RERANK_CANDIDATE_FACTOR = 4;
+
+// How the index search of a segment handles a common query filter, chosen by the fraction of the segment rows passing it.
+export enum class KnnFilterStrategy {
+    // search the index and drop the results failing the filter
+    kIndex,
+    // HNSW only: walk through the vertices failing the filter to their neighbors, see KnnHnsw::SearchLayerExpanded
+    kExpandedIndex,
+    // skip the index and scan the passing rows
+    kBruteForce,
+};
+
+// Filters passing at most this fraction of the rows, or no more rows than topk, are searched by brute force.
+export constexpr f64 KNN_FILTER_BRUTE_FORCE_SELECTIVITY = 0.01;
+// Filters passing at most this fraction of the rows use the expanded HNSW traversal.
+export constexpr f64 KNN_FILTER_EXPANDED_SELECTIVITY = 0.2;
+
+export KnnFilterStrategy ChooseKnnFilterStrategy(SizeT filtered_row_count, SizeT segment_row_count, SizeT topk);
+
+// Parse the "filter_strategy" search option: index, expanded or brute_force.
+export KnnFilterStrategy StringToKnnFilterStrategy(const String &str);
+
 export class KnnScanSharedData {
 public:
     KnnScanSharedData(SharedPtr<BaseTableRef> table_ref,
@@ -48,10 +71,7 @@ public:
                       i64 query_embedding_count,
                       void *query_embedding,
                       EmbeddingDataType elem_type,
-                      KnnDistanceType knn_distance_type)
-        : table_ref_(table_ref), block_column_entries_(std::move(block_column_entries)), index_entries_(std::move(index_entries)),
-          opt_params_(std::move(opt_params)), topk_(topk), dimension_(dimension), query_count_(query_embedding_count),
-          query_embedding_(query_embedding), elem_type_(elem_type), knn_distance_type_(knn_distance_type) {}
+                      KnnDistanceType knn_distance_type);
 
 public:
     const SharedPtr<BaseTableRef> table_ref_{};
@@ -67,6 +87,21 @@ public:
     const EmbeddingDataType elem_type_{EmbeddingDataType::kElemInvalid};
     const KnnDistanceType knn_distance_type_{KnnDistanceType::kInvalid};
 
+    // Parsed from opt_params_ once for all index searches, 0 if ef is not given.
+    SizeT hnsw_ef_{0};
+    // Lists probed by each query of an IVF index.
+    SizeT ivf_nprobe_{1};
+    // Recompute the distances of approximate index results with the raw vectors.
+    bool rerank_{false};
+    // Candidate list size of a DiskAnn search, 0 to use the build list size of the index.
+    SizeT diskann_search_list_{0};
+    // Node records a DiskAnn search reads per round.
+    SizeT diskann_beam_width_{4};
+    // Strategy of the filtered index searches given by the "filter_strategy" option, chosen per segment by ChooseKnnFilterStrategy if unset.
+    Optional<KnnFilterStrategy> filter_strategy_{};
+    // Thresholds shared by the tasks, each task drops the results that can't be in the merged top k.
+    MergeKnnBound topk_bound_;
+
     atomic_u64 current_block_idx_{0};
     atomic_u64 current_index_idx_{0};
 };
@@ -100,8 +135,11 @@ public:
 
 public:
     using DistFunc = DataType (*)(const DataType *, const DataType *, SizeT);
+    using BoundedDistFunc = DataType (*)(const DataType *, const DataType *, SizeT, DataType);
 
     DistFunc dist_func_{};
+    // Set for the metrics whose partial sums only grow, nullptr otherwise.
+    BoundedDistFunc bounded_dist_func_{};
 };
 
 template <>
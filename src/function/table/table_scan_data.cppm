@@ -24,16 +24,51 @@ export module table_scan_function_data;
 
 namespace infinity {
 
+// Blocks to scan shared by all tasks of a table scan fragment. A task takes the next block when it has read the current one, so the
+// tasks stay busy until the last block no matter how the rows are distributed over segments and blocks. Each block is a morsel tagged
+// with its index in the block list, the materialized result of the fragment is put back in that order.
+export class TableScanMorselQueue {
+public:
+    explicit TableScanMorselQueue(SharedPtr<Vector<GlobalBlockID>> global_block_ids) : global_block_ids_(std::move(global_block_ids)) {}
+
+    // Return false if all blocks have been taken.
+    bool Next(GlobalBlockID &global_block_id, SizeT &morsel_idx) {
+        u64 block_ids_idx = next_block_ids_idx_.fetch_add(1, std::memory_order_relaxed);
+        if (block_ids_idx >= global_block_ids_->size()) {
+            return false;
+        }
+        global_block_id = (*global_block_ids_)[block_ids_idx];
+        morsel_idx = block_ids_idx;
+        return true;
+    }
+
+    [[nodiscard]] inline SizeT BlockCount() const { return global_block_ids_->size(); }
+
+private:
+    SharedPtr<Vector<GlobalBlockID>> global_block_ids_{};
+    Atomic<u64> next_block_ids_idx_{0};
+};
+
 export class TableScanFunctionData : public TableFunctionData {
 public:
-    TableScanFunctionData(const BlockIndex *block_index, const SharedPtr<Vector<GlobalBlockID>> &global_block_ids, const Vector<SizeT> &column_ids)
-        : block_index_(block_index), global_block_ids_(global_block_ids), column_ids_(column_ids) {}
+    TableScanFunctionData(const BlockIndex *block_index, const SharedPtr<TableScanMorselQueue> &morsel_queue, const Vector<SizeT> &column_ids)
+        : block_index_(block_index), morsel_queue_(morsel_queue), column_ids_(column_ids) {}
+
+    // Take the next block from the shared queue, return false if there is none left.
+    bool NextBlock() {
+        has_current_block_ = morsel_queue_->Next(current_block_id_, current_morsel_idx_);
+        current_read_offset_ = 0;
+        return has_current_block_;
+    }
 
     const BlockIndex *block_index_{};
-    const SharedPtr<Vector<GlobalBlockID>> &global_block_ids_{};
+    const SharedPtr<TableScanMorselQueue> morsel_queue_{};
     const Vector<SizeT> &column_ids_{};
 
-    u64 current_block_ids_idx_{0};
+    bool has_current_block_{false};
+    GlobalBlockID current_block_id_{0, 0};
+    // Morsel of the current block, every output block holds the rows of one morsel.
+    SizeT current_morsel_idx_{0};
     SizeT current_read_offset_{0};
 };
 
@@ -1406,9 +1406,9 @@ Status Config::Init(const SharedPtr<String> &config_path, DefaultConfig* default
                                 if (IsEqual(flush_option_str, "flush_at_once")) {
                                     flush_option_type = FlushOptionType::kFlushAtOnce;
                                 } else if (IsEqual(flush_option_str, "only_write")) {
-                                    flush_option_type = FlushOptionType::kFlushAtOnce;
+                                    flush_option_type = FlushOptionType::kOnlyWrite;
                                 } else if (IsEqual(flush_option_str, "flush_per_second")) {
-                                    flush_option_type = FlushOptionType::kFlushAtOnce;
+                                    flush_option_type = FlushOptionType::kFlushPerSecond;
                                 } else {
                                     return Status::InvalidConfig(fmt::format("Unsupported flush option: {}", flush_option_str));
                                 }
@@ -43,6 +43,8 @@ export enum class GlobalVariable {
     kSystemMemoryUsage,         // global
     kOpenFileCount,             // global
     kCPUUsage,                  // global
+    kWALFlushBatchSize,         // global
+    kWALFlushLatency,           // global
     kInvalid,
 };
 
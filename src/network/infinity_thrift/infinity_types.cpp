@@ -377,7 +377,9 @@ int _kIndexTypeValues[] = {
   IndexType::FullText,
   IndexType::BMP,
   IndexType::Secondary,
-  IndexType::EMVB
+  IndexType::EMVB,
+  IndexType::IVFPQ,
+  IndexType::DiskAnn
 };
 const char* _kIndexTypeNames[] = {
   "IVFFlat",
@@ -386,9 +388,11 @@ const char* _kIndexTypeNames[] = {
   "FullText",
   "BMP",
   "Secondary",
-  "EMVB"
+  "EMVB",
+  "IVFPQ",
+  "DiskAnn"
 };
-const std::map<int, const char*> _IndexType_VALUES_TO_NAMES(::apache::thrift::TEnumIterator(7, _kIndexTypeValues, _kIndexTypeNames), ::apache::thrift::TEnumIterator(-1, nullptr, nullptr));
+const std::map<int, const char*> _IndexType_VALUES_TO_NAMES(::apache::thrift::TEnumIterator(9, _kIndexTypeValues, _kIndexTypeNames), ::apache::thrift::TEnumIterator(-1, nullptr, nullptr));
 
 std::ostream& operator<<(std::ostream& out, const IndexType::type& val) {
   std::map<int, const char*>::const_iterator it = _IndexType_VALUES_TO_NAMES.find(val);
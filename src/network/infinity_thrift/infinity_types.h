@@ -194,7 +194,9 @@ struct IndexType {
     FullText = 3,
     BMP = 4,
     Secondary = 5,
-    EMVB = 6
+    EMVB = 6,
+    IVFPQ = 7,
+    DiskAnn = 8
   };
 };
 
@@ -7727,6 +7727,10 @@ Return2:
         index_type = infinity::IndexType::kBMP;
     } else if (strcmp((yyvsp[-1].str_value), "ivfflat") == 0) {
         index_type = infinity::IndexType::kIVFFlat;
+    } else if (strcmp((yyvsp[-1].str_value), "ivfpq") == 0) {
+        index_type = infinity::IndexType::kIVFPQ;
+    } else if (strcmp((yyvsp[-1].str_value), "diskann") == 0) {
+        index_type = infinity::IndexType::kDiskAnn;
     } else if (strcmp((yyvsp[-1].str_value), "emvb") == 0) {
         index_type = infinity::IndexType::kEMVB;
     } else {
@@ -3151,6 +3151,10 @@ index_info_list_one_pack : '(' identifier_array ')' USING IDENTIFIER with_index_
         index_type = infinity::IndexType::kBMP;
     } else if (strcmp($5, "ivfflat") == 0) {
         index_type = infinity::IndexType::kIVFFlat;
+    } else if (strcmp($5, "ivfpq") == 0) {
+        index_type = infinity::IndexType::kIVFPQ;
+    } else if (strcmp($5, "diskann") == 0) {
+        index_type = infinity::IndexType::kDiskAnn;
     } else if (strcmp($5, "emvb") == 0) {
         index_type = infinity::IndexType::kEMVB;
     } else {
@@ -39,6 +39,12 @@ std::string IndexInfo::IndexTypeToString(IndexType index_type) {
         case IndexType::kBMP: {
             return "BMP";
         }
+        case IndexType::kIVFPQ: {
+            return "IVFPQ";
+        }
+        case IndexType::kDiskAnn: {
+            return "DiskAnn";
+        }
         case IndexType::kInvalid: {
             ParserError("Invalid conflict type.");
         }
@@ -59,6 +65,10 @@ IndexType IndexInfo::StringToIndexType(const std::string &index_type_str) {
         return IndexType::kEMVB;
     } else if (index_type_str == "BMP") {
         return IndexType::kBMP;
+    } else if (index_type_str == "IVFPQ") {
+        return IndexType::kIVFPQ;
+    } else if (index_type_str == "DiskAnn") {
+        return IndexType::kDiskAnn;
     } else {
         return IndexType::kInvalid;
     }
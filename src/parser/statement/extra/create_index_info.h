@@ -28,6 +28,8 @@ enum class IndexType {
     kFullText,
     kSecondary,
     kEMVB,
+    kIVFPQ,
+    kDiskAnn,
     kInvalid,
 };
 
@@ -225,7 +225,20 @@ SharedPtr<LogicalNode> BoundSelectStatement::BuildPlan(QueryContext *query_conte
                 match_node->top_n_ = DEFAULT_MATCH_TEXT_OPTION_TOP_N;
             }
 
-            SearchDriver search_driver(column2analyzer, default_field);
+            // option: term expansion
+            iter = search_ops.options_.find("term_expansion");
+            String term_expansion;
+            if (iter != search_ops.options_.end()) {
+                term_expansion = iter->second;
+                if (term_expansion != "prefix" and term_expansion != "suffix" and term_expansion != "substring" and
+                    term_expansion != "wildcard") {
+                    Status status = Status::SyntaxError("term_expansion option must be prefix, suffix, substring or wildcard");
+                    LOG_ERROR(status.message());
+                    RecoverableError(status);
+                }
+            }
+
+            SearchDriver search_driver(column2analyzer, default_field, term_expansion);
             UniquePtr<QueryNode> query_tree = search_driver.ParseSingleWithFields(match_node->match_expr_->fields_, match_node->match_expr_->matching_text_);
             if (query_tree.get() == nullptr) {
                 Status status = Status::ParseMatchExprFailed(match_node->match_expr_->fields_, match_node->match_expr_->matching_text_);
@@ -1457,7 +1457,7 @@ void ExplainLogicalPlan::Explain(const LogicalShow *show_node, SharedPtr<Vector<
             result->emplace_back(MakeShared<String>(show_str));
 
             String output_columns_str = String(intent_size, ' ');
-            output_columns_str += " - output columns: [path, status, size, buffered_type, type]";
+            output_columns_str += " - output columns: [path, status, size, buffered_type, type, hits, misses, evictions]";
             result->emplace_back(MakeShared<String>(output_columns_str));
             break;
         }
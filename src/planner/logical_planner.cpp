@@ -68,6 +68,8 @@ import status;
 import default_values;
 import index_base;
 import index_ivfflat;
+import index_ivfpq;
+import index_diskann;
 import index_hnsw;
 import index_secondary;
 import index_emvb;
@@ -699,6 +701,20 @@ Status LogicalPlanner::BuildCreateIndex(const CreateStatement *statement, Shared
             base_index_ptr = IndexIVFFlat::Make(index_name, index_filename, {index_info->column_name_}, *(index_info->index_param_list_));
             break;
         }
+        case IndexType::kIVFPQ: {
+            assert(index_info->index_param_list_ != nullptr);
+            IndexIVFPQ::ValidateColumnDataType(base_table_ref, index_info->column_name_); // may throw exception
+            SizeT dimension = IndexIVFPQ::ColumnDimension(base_table_ref, index_info->column_name_);
+            base_index_ptr =
+                IndexIVFPQ::Make(index_name, index_filename, {index_info->column_name_}, *(index_info->index_param_list_), dimension);
+            break;
+        }
+        case IndexType::kDiskAnn: {
+            assert(index_info->index_param_list_ != nullptr);
+            IndexDiskAnn::ValidateColumnDataType(base_table_ref, index_info->column_name_); // may throw exception
+            base_index_ptr = IndexDiskAnn::Make(index_name, index_filename, {index_info->column_name_}, *(index_info->index_param_list_));
+            break;
+        }
         case IndexType::kSecondary: {
             IndexSecondary::ValidateColumnDataType(base_table_ref, index_info->column_name_); // may throw exception
             base_index_ptr = IndexSecondary::Make(index_name, index_filename, {index_info->column_name_});
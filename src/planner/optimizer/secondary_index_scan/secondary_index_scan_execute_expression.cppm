@@ -133,7 +133,7 @@ export using FilterIntervalRange = std::variant<std::monostate,
 // because some rows may be deleted, kAlwaysTrue is meaningless
 // kInterval of the same column can be merged in "AND" condition
 // kAlwaysFalse can be merged with any other condition
-enum class FilterRangeType : i8 { kEmpty, kInterval };
+export enum class FilterRangeType : i8 { kEmpty, kInterval };
 
 export class FilterExecuteSingleRange {
     ColumnID column_id_{};
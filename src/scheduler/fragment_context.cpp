@@ -101,7 +101,7 @@ UniquePtr<OperatorState> MakeTableScanState(PhysicalTableScan *physical_table_sc
     UniquePtr<OperatorState> operator_state = MakeUnique<TableScanOperatorState>();
     TableScanOperatorState *table_scan_op_state_ptr = (TableScanOperatorState *)(operator_state.get());
     table_scan_op_state_ptr->table_scan_function_data_ = MakeUnique<TableScanFunctionData>(physical_table_scan->GetBlockIndex(),
-                                                                                           table_scan_source_state->global_ids_,
+                                                                                           table_scan_source_state->morsel_queue_,
                                                                                            physical_table_scan->ColumnIDs());
     return operator_state;
 }
@@ -492,6 +492,15 @@ MakeTaskState(SizeT operator_id, const Vector<PhysicalOperator *> &physical_ops,
         case PhysicalOperatorType::kFusion: {
             return MakeTaskStateTemplate<FusionOperatorState>(physical_ops[operator_id]);
         }
+        case PhysicalOperatorType::kJoinHash: {
+            return MakeTaskStateTemplate<HashJoinOperatorState>(physical_ops[operator_id]);
+        }
+        case PhysicalOperatorType::kJoinMerge: {
+            return MakeTaskStateTemplate<MergeJoinOperatorState>(physical_ops[operator_id]);
+        }
+        case PhysicalOperatorType::kJoinIndex: {
+            return MakeTaskStateTemplate<IndexJoinOperatorState>(physical_ops[operator_id]);
+        }
         default: {
             String error_message = fmt::format("Not support {} now", PhysicalOperatorToString(physical_ops[operator_id]->operator_type()));
             LOG_CRITICAL(error_message);
@@ -883,7 +892,9 @@ void FragmentContext::MakeSourceState(i64 parallel_count) {
         case PhysicalOperatorType::kMergeKnn:
         case PhysicalOperatorType::kMergeMatchTensor:
         case PhysicalOperatorType::kMergeMatchSparse:
-        case PhysicalOperatorType::kFusion: {
+        case PhysicalOperatorType::kFusion:
+        case PhysicalOperatorType::kJoinHash:
+        case PhysicalOperatorType::kJoinMerge: {
             if (fragment_type_ != FragmentType::kSerialMaterialize) {
                 UnrecoverableError(
                     fmt::format("{} should be serial materialized fragment", PhysicalOperatorToString(first_operator->operator_type())));
@@ -925,9 +936,7 @@ void FragmentContext::MakeSourceState(i64 parallel_count) {
         case PhysicalOperatorType::kIntersect:
         case PhysicalOperatorType::kExcept:
         case PhysicalOperatorType::kDummyScan:
-        case PhysicalOperatorType::kJoinHash:
         case PhysicalOperatorType::kJoinNestedLoop:
-        case PhysicalOperatorType::kJoinMerge:
         case PhysicalOperatorType::kJoinIndex:
         case PhysicalOperatorType::kCrossProduct:
         case PhysicalOperatorType::kPreparedPlan: {
@@ -943,11 +952,11 @@ void FragmentContext::MakeSourceState(i64 parallel_count) {
                 UnrecoverableError(error_message);
             }
 
-            // Partition the hash range to each source state
+            // All tasks pull blocks from one queue instead of a fixed partition of the blocks
             auto *table_scan_operator = (PhysicalTableScan *)first_operator;
-            Vector<SharedPtr<Vector<GlobalBlockID>>> blocks_group = table_scan_operator->PlanBlockEntries(parallel_count);
+            auto morsel_queue = MakeShared<TableScanMorselQueue>(table_scan_operator->PlanBlockEntries(1)[0]);
             for (i64 task_id = 0; task_id < parallel_count; ++task_id) {
-                tasks_[task_id]->source_state_ = MakeUnique<TableScanSourceState>(blocks_group[task_id]);
+                tasks_[task_id]->source_state_ = MakeUnique<TableScanSourceState>(morsel_queue);
             }
             break;
         }
@@ -1065,6 +1074,8 @@ void FragmentContext::MakeSourceState(i64 parallel_count) {
 void FragmentContext::MakeSinkState(i64 parallel_count) {
     PhysicalOperator *first_operator = this->GetOperators().back();
     PhysicalOperator *last_operator = this->GetOperators().front();
+    // The output of this fragment is sent to the parent fragment instead of being materialized.
+    bool sink_to_queue = fragment_ptr_->GetSinkNode() != nullptr && fragment_ptr_->GetSinkNode()->sink_type() == SinkType::kLocalQueue;
     switch (last_operator->operator_type()) {
 
         case PhysicalOperatorType::kInvalid: {
@@ -1207,7 +1218,8 @@ void FragmentContext::MakeSinkState(i64 parallel_count) {
         }
         case PhysicalOperatorType::kTableScan:
         case PhysicalOperatorType::kFilter:
-        case PhysicalOperatorType::kIndexScan: {
+        case PhysicalOperatorType::kIndexScan:
+        case PhysicalOperatorType::kJoinIndex: {
             if (fragment_type_ == FragmentType::kSerialMaterialize) {
                 UnrecoverableError(
                     fmt::format("{} should in parallel materialized/stream fragment", PhysicalOperatorToString(last_operator->operator_type())));
@@ -1220,6 +1232,11 @@ void FragmentContext::MakeSinkState(i64 parallel_count) {
             }
 
             for (u64 task_id = 0; (i64)task_id < parallel_count; ++task_id) {
+                if (sink_to_queue) {
+                    // Input fragment of a join
+                    tasks_[task_id]->sink_state_ = MakeUnique<QueueSinkState>(fragment_ptr_->FragmentID(), task_id);
+                    continue;
+                }
                 tasks_[task_id]->sink_state_ = MakeUnique<MaterializeSinkState>(fragment_ptr_->FragmentID(), task_id);
                 MaterializeSinkState *sink_state_ptr = static_cast<MaterializeSinkState *>(tasks_[task_id]->sink_state_.get());
                 sink_state_ptr->column_types_ = last_operator->GetOutputTypes();
@@ -1228,7 +1245,16 @@ void FragmentContext::MakeSinkState(i64 parallel_count) {
             break;
         }
         case PhysicalOperatorType::kProjection: {
-            if (fragment_type_ == FragmentType::kSerialMaterialize) {
+            if (sink_to_queue) {
+                if ((i64)tasks_.size() != parallel_count) {
+                    String error_message = fmt::format("{} task count isn't correct.", PhysicalOperatorToString(last_operator->operator_type()));
+                    LOG_CRITICAL(error_message);
+                    UnrecoverableError(error_message);
+                }
+                for (u64 task_id = 0; (i64)task_id < parallel_count; ++task_id) {
+                    tasks_[task_id]->sink_state_ = MakeUnique<QueueSinkState>(fragment_ptr_->FragmentID(), task_id);
+                }
+            } else if (fragment_type_ == FragmentType::kSerialMaterialize) {
                 if (tasks_.size() != 1) {
                     String error_message = "SerialMaterialize type fragment should only have 1 task.";
                     LOG_CRITICAL(error_message);
@@ -1258,11 +1284,31 @@ void FragmentContext::MakeSinkState(i64 parallel_count) {
         case PhysicalOperatorType::kUnionAll:
         case PhysicalOperatorType::kIntersect:
         case PhysicalOperatorType::kExcept:
-        case PhysicalOperatorType::kDummyScan:
         case PhysicalOperatorType::kJoinHash:
+        case PhysicalOperatorType::kJoinMerge: {
+            if (fragment_type_ != FragmentType::kSerialMaterialize) {
+                UnrecoverableError(
+                    fmt::format("{} should in serial materialized fragment", PhysicalOperatorToString(last_operator->operator_type())));
+            }
+
+            if (tasks_.size() != 1) {
+                String error_message = fmt::format("{} task count isn't correct.", PhysicalOperatorToString(last_operator->operator_type()));
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+
+            if (sink_to_queue) {
+                tasks_[0]->sink_state_ = MakeUnique<QueueSinkState>(fragment_ptr_->FragmentID(), 0);
+            } else {
+                tasks_[0]->sink_state_ = MakeUnique<MaterializeSinkState>(fragment_ptr_->FragmentID(), 0);
+                MaterializeSinkState *sink_state_ptr = static_cast<MaterializeSinkState *>(tasks_[0]->sink_state_.get());
+                sink_state_ptr->column_types_ = last_operator->GetOutputTypes();
+                sink_state_ptr->column_names_ = last_operator->GetOutputNames();
+            }
+            break;
+        }
+        case PhysicalOperatorType::kDummyScan:
         case PhysicalOperatorType::kJoinNestedLoop:
-        case PhysicalOperatorType::kJoinMerge:
-        case PhysicalOperatorType::kJoinIndex:
         case PhysicalOperatorType::kCrossProduct:
         case PhysicalOperatorType::kAlter:
         case PhysicalOperatorType::kPreparedPlan: {
@@ -1378,6 +1424,8 @@ void FragmentContext::CreateTasks(i64 cpu_count, i64 operator_count, FragmentCon
         case PhysicalOperatorType::kMergeKnn:
         case PhysicalOperatorType::kMergeMatchTensor:
         case PhysicalOperatorType::kMergeMatchSparse:
+        case PhysicalOperatorType::kJoinHash:
+        case PhysicalOperatorType::kJoinMerge:
         case PhysicalOperatorType::kProjection: {
             // Serial Materialize
             parallel_count = 1;
@@ -1579,11 +1627,29 @@ SharedPtr<DataTable> ParallelMaterializedFragmentCtx::GetResultInternal() {
             result_table = DataTable::MakeResultTable(column_defs);
         }
 
+        if (!materialize_sink_state->data_block_morsel_ids_.empty()) {
+            // Table scan tasks took their blocks from a shared queue, the blocks are put back in morsel order below
+            continue;
+        }
         for (auto &result_data_block : materialize_sink_state->data_block_array_) {
             result_table->Append(std::move(result_data_block));
         }
     }
 
+    // A morsel is read by one task, whose blocks of the morsel are already in order, so a stable sort restores the scan order.
+    Vector<Pair<SizeT, UniquePtr<DataBlock>>> morsel_blocks;
+    for (const auto &task : tasks_) {
+        auto *materialize_sink_state = static_cast<MaterializeSinkState *>(task->sink_state_.get());
+        for (SizeT block_idx = 0; block_idx < materialize_sink_state->data_block_morsel_ids_.size(); ++block_idx) {
+            morsel_blocks.emplace_back(materialize_sink_state->data_block_morsel_ids_[block_idx],
+                                       std::move(materialize_sink_state->data_block_array_[block_idx]));
+        }
+    }
+    std::stable_sort(morsel_blocks.begin(), morsel_blocks.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    for (auto &[morsel_idx, data_block] : morsel_blocks) {
+        result_table->Append(std::move(data_block));
+    }
+
     return result_table;
 }
 
@@ -33,6 +33,7 @@ import query_context;
 import base_table_ref;
 import defer_op;
 import fragment_context;
+import table_scan_function_data;
 import status;
 import parser_assert;
 
@@ -113,6 +114,13 @@ void FragmentTask::OnExecute() {
     } else if (execute_success) {
         PhysicalSink *sink_op = fragment_context->GetSinkOperator();
         sink_op->Execute(query_context, fragment_context, sink_state_.get());
+        if (sink_state_->state_type() == SinkStateType::kMaterialize && source_state_->state_type_ == SourceStateType::kTableScan) {
+            // Tag the new blocks with the morsel they were read from, the fragment result is put back in morsel order
+            auto *table_scan_op_state = static_cast<TableScanOperatorState *>(operator_states_[operator_count_ - 1].get());
+            auto *materialize_sink_state = static_cast<MaterializeSinkState *>(sink_state_.get());
+            materialize_sink_state->data_block_morsel_ids_.resize(materialize_sink_state->data_block_array_.size(),
+                                                                  table_scan_op_state->table_scan_function_data_->current_morsel_idx_);
+        }
     }
 }
 
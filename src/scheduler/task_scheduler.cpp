@@ -38,6 +38,8 @@ import base_statement;
 import extra_ddl_info;
 import create_statement;
 import command_statement;
+import utility;
+import defer_op;
 
 namespace infinity {
 
@@ -50,7 +52,6 @@ void TaskScheduler::Init(Config *config_ptr) {
     const u64 config_cpu_limit = config_ptr->CPULimit();
     worker_count_ = std::min(cpu_count, config_cpu_limit);
     worker_array_.reserve(worker_count_);
-    worker_workloads_.resize(worker_count_);
 
     Vector<u64> cpu_id_vec;
     cpu_id_vec.reserve(cpu_count);
@@ -65,13 +66,10 @@ void TaskScheduler::Init(Config *config_ptr) {
 
     for (u64 worker_id = 0; worker_id < worker_count_; ++worker_id) {
         const u64 cpu_id = cpu_id_vec[worker_id];
-        UniquePtr<FragmentTaskBlockQueue> worker_queue = MakeUnique<FragmentTaskBlockQueue>();
-        UniquePtr<Thread> worker_thread = MakeUnique<Thread>(&TaskScheduler::WorkerLoop, this, worker_queue.get(), worker_id);
-        // Pin the thread to specific cpu
-        ThreadUtil::pin(*worker_thread, cpu_id);
-
-        worker_array_.emplace_back(cpu_id, std::move(worker_queue), std::move(worker_thread));
-        worker_workloads_[worker_id] = 0;
+        worker_array_.emplace_back(cpu_id,
+                                   ThreadUtil::GetNumaNode(cpu_id),
+                                   MakeUnique<FragmentTaskBlockQueue>(),
+                                   MakeUnique<FragmentTaskDeque>());
     }
 
     if (worker_array_.empty()) {
@@ -80,30 +78,44 @@ void TaskScheduler::Init(Config *config_ptr) {
         UnrecoverableError(error_message);
     }
 
+    // Steal from the next workers on the same NUMA node first, then from the other nodes.
+    for (u64 worker_id = 0; worker_id < worker_count_; ++worker_id) {
+        auto &worker = worker_array_[worker_id];
+        for (u64 offset = 1; offset < worker_count_; ++offset) {
+            worker.steal_order_.push_back((worker_id + offset) % worker_count_);
+        }
+        std::stable_sort(worker.steal_order_.begin(), worker.steal_order_.end(), [&](u64 left, u64 right) {
+            return (worker_array_[left].numa_node_ != worker.numa_node_) < (worker_array_[right].numa_node_ != worker.numa_node_);
+        });
+    }
+
+    running_ = true;
+    for (u64 worker_id = 0; worker_id < worker_count_; ++worker_id) {
+        auto &worker = worker_array_[worker_id];
+        worker.thread_ = MakeUnique<Thread>(&TaskScheduler::WorkerLoop, this, worker_id);
+        // Pin the thread to specific cpu
+        ThreadUtil::pin(*worker.thread_, worker.cpu_id_);
+    }
+
     initialized_ = true;
 }
 
 void TaskScheduler::UnInit() {
     initialized_ = false;
-    UniquePtr<FragmentTask> terminate_task = MakeUnique<FragmentTask>(true);
+    {
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        running_ = false;
+    }
+    idle_cv_.notify_all();
 
     for (const auto &worker : worker_array_) {
-        worker.queue_->Enqueue(terminate_task.get());
         worker.thread_->join();
     }
 }
 
-u64 TaskScheduler::FindLeastWorkloadWorker() {
-    u64 min_workload = worker_workloads_[0];
-    u64 min_workload_worker_id = 0;
-    for (u64 worker_id = 1; worker_id < worker_count_ && min_workload; ++worker_id) {
-        u64 current_worker_load = worker_workloads_[worker_id];
-        if (current_worker_load < min_workload) {
-            min_workload = current_worker_load;
-            min_workload_worker_id = worker_id;
-        }
-    }
-    return min_workload_worker_id;
+u64 TaskScheduler::NextWorker() {
+    // Idle workers steal the queued tasks, so round robin is enough to spread them.
+    return next_worker_id_.fetch_add(1, std::memory_order_relaxed) % worker_count_;
 }
 
 void TaskScheduler::Schedule(PlanFragment *plan_fragment, const BaseStatement *base_statement) {
@@ -166,8 +178,7 @@ void TaskScheduler::Schedule(PlanFragment *plan_fragment, const BaseStatement *b
                 LOG_CRITICAL(error_message);
                 UnrecoverableError(error_message);
             }
-            u64 worker_id = FindLeastWorkloadWorker();
-            ScheduleTask(task.get(), worker_id);
+            ScheduleTask(task.get(), NextWorker());
         }
     }
 }
@@ -203,8 +214,7 @@ void TaskScheduler::ScheduleFragment(PlanFragment *plan_fragment) {
     }
     for (auto *task_ptr : task_ptrs) {
         if (task_ptr->LastWorkerID() == -1) {
-            u64 worker_id = FindLeastWorkloadWorker();
-            ScheduleTask(task_ptr, worker_id);
+            ScheduleTask(task_ptr, NextWorker());
         } else {
             ScheduleTask(task_ptr, task_ptr->LastWorkerID());
         }
@@ -212,37 +222,141 @@ void TaskScheduler::ScheduleFragment(PlanFragment *plan_fragment) {
 }
 
 void TaskScheduler::ScheduleTask(FragmentTask *task, u64 worker_id) {
-    ++worker_workloads_[worker_id];
+    ++queued_task_count_;
     worker_array_[worker_id].queue_->Enqueue(task);
+    {
+        // Idle workers check the count under the lock, so the notification can't be lost.
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+    }
+    idle_cv_.notify_one();
 }
 
-void TaskScheduler::WorkerLoop(FragmentTaskBlockQueue *task_queue, i64 worker_id) {
+FragmentTask *TaskScheduler::PopTask(Worker &worker) {
+    Vector<FragmentTask *> dequeue_output;
+    if (worker.queue_->TryDequeueBulk(dequeue_output)) {
+        for (auto *task : dequeue_output) {
+            worker.deque_->Push(task);
+        }
+    }
+    FragmentTask *task = worker.deque_->Pop();
+    if (task != nullptr) {
+        --queued_task_count_;
+    }
+    return task;
+}
+
+FragmentTask *TaskScheduler::StealTask(Worker &worker) {
+    for (u64 victim_id : worker.steal_order_) {
+        auto &victim = worker_array_[victim_id];
+        FragmentTask *task = victim.deque_->Steal();
+        // The victim may be busy in a long task and hasn't moved its queue to the deque yet.
+        if (task == nullptr) {
+            victim.queue_->TryDequeue(task);
+        }
+        if (task != nullptr) {
+            --queued_task_count_;
+            ++steal_count_;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool TaskScheduler::TryUseWorker() {
+    u64 used = used_worker_count_.load();
+    while (used < worker_count_) {
+        if (used_worker_count_.compare_exchange_weak(used, used + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::UnuseWorker() { --used_worker_count_; }
+
+u64 TaskScheduler::ReserveExtraWorkers(u64 max_count, u64 keep_idle_count) {
+    u64 used = used_worker_count_.load();
+    while (true) {
+        const u64 idle_count = used < worker_count_ ? worker_count_ - used : 0;
+        const u64 count = std::min(max_count, idle_count > keep_idle_count ? idle_count - keep_idle_count : 0);
+        if (count == 0) {
+            return 0;
+        }
+        if (used_worker_count_.compare_exchange_weak(used, used + count)) {
+            reserved_worker_count_ += count;
+            return count;
+        }
+    }
+}
+
+void TaskScheduler::ReleaseExtraWorkers(u64 count) {
+    if (count == 0) {
+        return;
+    }
+    reserved_worker_count_ -= count;
+    used_worker_count_ -= count;
+    {
+        // Workers held back by the reservation wait for a free worker slot under the lock.
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+    }
+    idle_cv_.notify_all();
+}
+
+void TaskScheduler::RunParallel(SizeT task_count, SizeT max_worker_count, const std::function<void(SizeT)> &func) {
+    const SizeT worker_count = std::min(task_count, max_worker_count);
+    const u64 extra_worker_count = worker_count <= 1 ? 0 : ReserveExtraWorkers(worker_count - 1);
+    DeferFn release_workers([&] { ReleaseExtraWorkers(extra_worker_count); });
+    Utility::RunParallel(task_count, 1 + extra_worker_count, func);
+}
+
+bool TaskScheduler::WaitForTask() {
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [this] { return (queued_task_count_ > 0 && used_worker_count_ < worker_count_) || !running_; });
+    return running_;
+}
+
+void TaskScheduler::WorkerLoop(i64 worker_id) {
+    auto &worker = worker_array_[worker_id];
     List<FragmentTask *> task_lists;
     auto iter = task_lists.end();
-    auto last_iter = task_lists.end();
+    // A worker takes a worker slot before it starts its first task, so the running workers and the workers reserved by
+    // ReserveExtraWorkers never exceed the worker count.
+    bool busy = false;
     while (true) {
-        if (iter == last_iter) {
-            Vector<FragmentTask *> dequeue_output;
-            if (task_lists.empty()) {
-                task_queue->DequeueBulk(dequeue_output);
-            } else {
-                task_queue->TryDequeueBulk(dequeue_output);
+        if (iter == task_lists.end()) {
+            if (!running_) {
+                if (busy) {
+                    UnuseWorker();
+                    busy = false;
+                }
+                break;
             }
-            if (!dequeue_output.empty()) {
-                task_lists.insert(task_lists.end(), dequeue_output.begin(), dequeue_output.end());
+            if (!busy) {
+                if (!TryUseWorker()) {
+                    WaitForTask();
+                    continue;
+                }
+                busy = true;
+            }
+            // Start one new task per round over the running tasks, the others stay in the deque for the idle workers.
+            FragmentTask *new_task = PopTask(worker);
+            if (new_task == nullptr && task_lists.empty()) {
+                new_task = StealTask(worker);
+                if (new_task == nullptr) {
+                    UnuseWorker();
+                    busy = false;
+                    WaitForTask();
+                    continue;
+                }
+            }
+            if (new_task != nullptr) {
+                task_lists.push_back(new_task);
             }
-            last_iter = task_lists.end();
-        }
-        if (iter == task_lists.end()) {
             iter = task_lists.begin();
         }
         auto &fragment_task = *iter;
-        if (fragment_task->IsTerminator()) {
-            break;
-        }
         auto *fragment_ctx = fragment_task->fragment_context();
         if (!fragment_ctx->notifier()->StartTask()) {
-            --worker_workloads_[worker_id];
             iter = task_lists.erase(iter);
             continue;
         }
@@ -256,12 +370,10 @@ void TaskScheduler::WorkerLoop(FragmentTaskBlockQueue *task_queue, i64 worker_id
         if (fragment_task->status() != FragmentTaskStatus::kError) {
             if (fragment_task->IsComplete()) {
                 // auto *sink_op = fragment_ctx->GetSinkOperator();
-                --worker_workloads_[worker_id];
                 fragment_task->CompleteTask();
                 iter = task_lists.erase(iter);
                 finish = true;
             } else if (fragment_task->QuitFromWorkerLoop()) {
-                --worker_workloads_[worker_id];
                 iter = task_lists.erase(iter);
             } else {
                 ++iter;
@@ -269,7 +381,6 @@ void TaskScheduler::WorkerLoop(FragmentTaskBlockQueue *task_queue, i64 worker_id
         } else {
             error = true;
             finish = true;
-            --worker_workloads_[worker_id];
             iter = task_lists.erase(iter);
         }
         if (finish || error) {
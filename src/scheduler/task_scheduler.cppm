@@ -20,6 +20,7 @@ import config;
 import stl;
 import fragment_task;
 import blocking_queue;
+import work_stealing_deque;
 import base_statement;
 
 namespace infinity {
@@ -28,12 +29,19 @@ class QueryContext;
 class PlanFragment;
 
 using FragmentTaskBlockQueue = BlockingQueue<FragmentTask*>;
+using FragmentTaskDeque = WorkStealingDeque<FragmentTask>;
 
 struct Worker {
-    Worker(u64 cpu_id, UniquePtr<FragmentTaskBlockQueue> queue, UniquePtr<Thread> thread)
-        : cpu_id_(cpu_id), queue_(std::move(queue)), thread_(std::move(thread)) {}
+    Worker(u64 cpu_id, u16 numa_node, UniquePtr<FragmentTaskBlockQueue> queue, UniquePtr<FragmentTaskDeque> deque)
+        : cpu_id_(cpu_id), numa_node_(numa_node), queue_(std::move(queue)), deque_(std::move(deque)) {}
     u64 cpu_id_{0};
+    u16 numa_node_{0};
+    // Tasks scheduled to the worker by other threads, moved to `deque_` by the worker itself.
     UniquePtr<FragmentTaskBlockQueue> queue_{};
+    // Tasks not started yet, the worker pops from the bottom and idle workers steal from the top.
+    UniquePtr<FragmentTaskDeque> deque_{};
+    // Other workers to steal from, workers on the same NUMA node first.
+    Vector<u64> steal_order_{};
     UniquePtr<Thread> thread_{};
 };
 
@@ -55,22 +63,61 @@ public:
 
     void DumpPlanFragment(PlanFragment *plan_fragment);
 
+    [[nodiscard]] inline u64 steal_count() const { return steal_count_.load(); }
+
+    // Reserve at most `max_count` of the idle workers for work run on its own threads, such as an index build, so the machine isn't
+    // oversubscribed. The reserved workers don't start new tasks until they are given back by ReleaseExtraWorkers. At least
+    // `keep_idle_count` idle workers are left for the queries. Returns the number reserved.
+    u64 ReserveExtraWorkers(u64 max_count, u64 keep_idle_count = 0);
+
+    void ReleaseExtraWorkers(u64 count);
+
+    // Run func(0) ... func(task_count - 1) on the calling thread and on the workers idle at the moment, at most max_worker_count
+    // threads in all. For the parallel work inside an operator or an index build, which would oversubscribe the workers otherwise.
+    void RunParallel(SizeT task_count, SizeT max_worker_count, const std::function<void(SizeT)> &func);
+
+    // Workers running some task.
+    [[nodiscard]] inline u64 busy_worker_count() const { return used_worker_count_ - reserved_worker_count_; }
+
 private:
-    u64 FindLeastWorkloadWorker();
+    u64 NextWorker();
 
     void ScheduleTask(FragmentTask *task, u64 worker_id);
 
     void RunTask(FragmentTask *task);
 
-    void WorkerLoop(FragmentTaskBlockQueue *task_queue, i64 worker_id);
+    // Take a task from the worker's own queue.
+    FragmentTask *PopTask(Worker &worker);
+
+    // Take a task from the other workers.
+    FragmentTask *StealTask(Worker &worker);
+
+    // Take a worker slot for a worker starting to run tasks, fails if all slots are used or reserved.
+    bool TryUseWorker();
+
+    void UnuseWorker();
+
+    // Wait until some task is queued and a worker slot is free, return false if the scheduler is stopped.
+    bool WaitForTask();
+
+    void WorkerLoop(i64 worker_id);
 
 private:
     bool initialized_{false};
+    Atomic<bool> running_{false};
 
     Vector<Worker> worker_array_{};
-    Deque<Atomic<u64>> worker_workloads_{};
-
     u64 worker_count_{0};
+    Atomic<u64> next_worker_id_{0};
+
+    // Tasks in the queues and deques of the workers, i.e. scheduled but not picked by any worker.
+    Atomic<u64> queued_task_count_{0};
+    Atomic<u64> steal_count_{0};
+    // Workers running some task plus the idle workers lent out by ReserveExtraWorkers, never more than `worker_count_`.
+    Atomic<u64> used_worker_count_{0};
+    Atomic<u64> reserved_worker_count_{0};
+    std::mutex idle_mutex_{};
+    std::condition_variable idle_cv_{};
 };
 
 } // namespace infinity
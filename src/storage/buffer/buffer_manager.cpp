@@ -26,8 +26,29 @@ import logger;
 import specific_concurrent_queue;
 import infinity_exception;
 import buffer_obj;
+import file_worker_type;
+import eviction_policy;
 
 namespace infinity {
+
+namespace {
+
+// Column data is scanned once by most queries, index files are reused by every search on them.
+u32 DefaultEvictionPriority(FileWorkerType file_type) {
+    switch (file_type) {
+        case FileWorkerType::kDataFile:
+        case FileWorkerType::kRawFile:
+        case FileWorkerType::kVersionDataFile: {
+            return 0;
+        }
+        default: {
+            return 1;
+        }
+    }
+}
+
+} // namespace
+
 BufferManager::BufferManager(u64 memory_limit, SharedPtr<String> data_dir, SharedPtr<String> temp_dir)
     : data_dir_(std::move(data_dir)), temp_dir_(std::move(temp_dir)), memory_limit_(memory_limit), current_memory_size_(0) {
     LocalFileSystem fs;
@@ -36,6 +57,15 @@ BufferManager::BufferManager(u64 memory_limit, SharedPtr<String> data_dir, Share
     }
 
     fs.CleanupDirectory(*temp_dir_);
+
+    SizeT file_type_count = static_cast<SizeT>(FileWorkerType::kInvalid);
+    eviction_policies_.reserve(file_type_count);
+    eviction_priorities_.reserve(file_type_count);
+    for (SizeT type_idx = 0; type_idx < file_type_count; ++type_idx) {
+        eviction_policies_.emplace_back(EvictionPolicy::Make(EvictionPolicyType::kSegmentedLRU));
+        eviction_priorities_.emplace_back(DefaultEvictionPriority(static_cast<FileWorkerType>(type_idx)));
+    }
+    UpdateEvictionOrder();
 }
 
 BufferManager::~BufferManager() { RemoveClean(); }
@@ -97,7 +127,7 @@ void BufferManager::RemoveClean() {
     {
         std::unique_lock lock(gc_locker_);
         for (auto *buffer_obj : clean_list) {
-            gc_set_.erase(buffer_obj);
+            GetEvictionPolicy(buffer_obj)->Remove(buffer_obj);
         }
     }
     {
@@ -116,7 +146,11 @@ void BufferManager::RemoveClean() {
 
 SizeT BufferManager::WaitingGCObjectCount() {
     std::unique_lock lock(gc_locker_);
-    return gc_set_.size();
+    SizeT count = 0;
+    for (const auto &eviction_policy : eviction_policies_) {
+        count += eviction_policy->Size();
+    }
+    return count;
 }
 
 SizeT BufferManager::BufferedObjectCount() {
@@ -126,20 +160,36 @@ SizeT BufferManager::BufferedObjectCount() {
 
 void BufferManager::RequestSpace(SizeT need_size) {
     std::unique_lock lock(gc_locker_);
-    auto iter = gc_set_.begin();
-    while (current_memory_size_ + need_size > memory_limit_ && iter != gc_set_.end()) {
-        auto *buffer_obj = *iter;
-
-        // Free return false when the buffer is freed by cleanup
-        // will not dead lock because caller is in kNew or kFree state, and `buffer_obj` is in kUnloaded or kLoaded state
-        auto status = buffer_obj->Free();
-        if (status == BufferFreeStatus::kCleaned) {
-            ++iter;
-        } else {
+    for (FileWorkerType file_type : eviction_order_) {
+        if (current_memory_size_ + need_size <= memory_limit_) {
+            break;
+        }
+        EvictionPolicy *eviction_policy = eviction_policies_[static_cast<SizeT>(file_type)].get();
+        // Bound the visits, buffers that are loaded or locked concurrently must not keep the loop spinning.
+        SizeT max_visit_count = 2 * eviction_policy->Size();
+        for (SizeT visit_count = 0; visit_count < max_visit_count && current_memory_size_ + need_size > memory_limit_; ++visit_count) {
+            auto *buffer_obj = eviction_policy->Victim();
+            if (buffer_obj == nullptr) {
+                break;
+            }
+            if (buffer_obj->TestAndClearReferenced()) {
+                eviction_policy->Promote(buffer_obj);
+                continue;
+            }
+
+            // Free return false when the buffer is freed by cleanup
+            // will not dead lock because caller is in kNew or kFree state, and `buffer_obj` is in kUnloaded or kLoaded state
+            auto status = buffer_obj->Free();
+            if (status == BufferFreeStatus::kCleaned) {
+                eviction_policy->Skip(buffer_obj);
+                continue;
+            }
             if (status == BufferFreeStatus::kSuccess) {
                 current_memory_size_ -= buffer_obj->GetBufferSize();
+                ++eviction_count_;
             }
-            iter = gc_set_.erase(iter);
+            // A loaded buffer is pushed again when it is unloaded.
+            eviction_policy->Remove(buffer_obj);
         }
     }
     if (current_memory_size_ + need_size > memory_limit_) {
@@ -152,7 +202,7 @@ void BufferManager::RequestSpace(SizeT need_size) {
 
 void BufferManager::PushGCQueue(BufferObj *buffer_obj) {
     std::unique_lock lock(gc_locker_);
-    gc_set_.insert(buffer_obj);
+    GetEvictionPolicy(buffer_obj)->Insert(buffer_obj);
 }
 
 void BufferManager::AddToCleanList(BufferObj *buffer_obj, bool do_free) {
@@ -208,12 +258,46 @@ void BufferManager::MoveTemp(BufferObj *buffer_obj) {
     }
 }
 
-bool BufferManager::RemoveFromGCQueueInner(BufferObj *buffer_obj) {
-    if (auto iter = gc_set_.find(buffer_obj); iter != gc_set_.end()) {
-        gc_set_.erase(iter);
-        return true;
+bool BufferManager::RemoveFromGCQueueInner(BufferObj *buffer_obj) { return GetEvictionPolicy(buffer_obj)->Remove(buffer_obj); }
+
+EvictionPolicy *BufferManager::GetEvictionPolicy(BufferObj *buffer_obj) {
+    return eviction_policies_[static_cast<SizeT>(buffer_obj->file_worker()->Type())].get();
+}
+
+void BufferManager::UpdateEvictionOrder() {
+    eviction_order_.clear();
+    for (SizeT type_idx = 0; type_idx < eviction_policies_.size(); ++type_idx) {
+        eviction_order_.emplace_back(static_cast<FileWorkerType>(type_idx));
     }
-    return false;
+    std::stable_sort(eviction_order_.begin(), eviction_order_.end(), [&](FileWorkerType left, FileWorkerType right) {
+        return eviction_priorities_[static_cast<SizeT>(left)] < eviction_priorities_[static_cast<SizeT>(right)];
+    });
+}
+
+void BufferManager::SetEvictionPolicy(FileWorkerType file_type, EvictionPolicyType policy_type, u32 priority) {
+    if (file_type == FileWorkerType::kInvalid) {
+        String error_message = "BufferManager::SetEvictionPolicy: invalid file worker type.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    SizeT type_idx = static_cast<SizeT>(file_type);
+    std::unique_lock lock(gc_locker_);
+    auto &eviction_policy = eviction_policies_[type_idx];
+    if (eviction_policy->type() != policy_type) {
+        auto new_eviction_policy = EvictionPolicy::Make(policy_type);
+        for (auto *buffer_obj : eviction_policy->Objects()) {
+            new_eviction_policy->Insert(buffer_obj);
+        }
+        eviction_policy = std::move(new_eviction_policy);
+    }
+    eviction_priorities_[type_idx] = priority;
+    UpdateEvictionOrder();
+    LOG_INFO(fmt::format("Eviction policy of {} buffers: {}, priority: {}", FileWorkerType2Str(file_type), EvictionPolicyTypeToString(policy_type), priority));
+}
+
+EvictionPolicyType BufferManager::GetEvictionPolicyType(FileWorkerType file_type) {
+    std::unique_lock lock(gc_locker_);
+    return eviction_policies_[static_cast<SizeT>(file_type)]->type();
 }
 
 Vector<BufferObjectInfo> BufferManager::GetBufferObjectsInfo() {
@@ -229,6 +313,9 @@ Vector<BufferObjectInfo> BufferManager::GetBufferObjectsInfo() {
             buffer_object_info.buffered_type_ = buffer_object_ptr->type();
             buffer_object_info.file_type_ = buffer_object_ptr->file_worker()->Type();
             buffer_object_info.object_size_ = buffer_object_ptr->GetBufferSize();
+            buffer_object_info.hit_count_ = buffer_object_ptr->hit_count();
+            buffer_object_info.miss_count_ = buffer_object_ptr->miss_count();
+            buffer_object_info.eviction_count_ = buffer_object_ptr->eviction_count();
             result.emplace_back(buffer_object_info);
         }
     }
@@ -16,6 +16,8 @@ module;
 
 import stl;
 import file_worker;
+import file_worker_type;
+import eviction_policy;
 // import specific_concurrent_queue;
 
 export module buffer_manager;
@@ -57,6 +59,18 @@ public:
 
     Vector<BufferObjectInfo> GetBufferObjectsInfo();
 
+    // Unloaded buffers of the given file type are freed in the order of the policy.
+    // Buffers of lower priority are freed first, buffers of higher priority only when that is not enough.
+    void SetEvictionPolicy(FileWorkerType file_type, EvictionPolicyType policy_type, u32 priority);
+
+    EvictionPolicyType GetEvictionPolicyType(FileWorkerType file_type);
+
+    u64 hit_count() const { return hit_count_; }
+
+    u64 miss_count() const { return miss_count_; }
+
+    u64 eviction_count() const { return eviction_count_; }
+
 private:
     friend class BufferObj;
 
@@ -77,6 +91,10 @@ private:
 private:
     bool RemoveFromGCQueueInner(BufferObj *buffer_obj);
 
+    EvictionPolicy *GetEvictionPolicy(BufferObj *buffer_obj);
+
+    void UpdateEvictionOrder();
+
 private:
     SharedPtr<String> data_dir_;
     SharedPtr<String> temp_dir_;
@@ -88,8 +106,15 @@ private:
     HashMap<String, UniquePtr<BufferObj>> buffer_map_{};
 
     std::mutex gc_locker_{};
-    using GCListIter = List<BufferObj *>::iterator;
-    HashSet<BufferObj *> gc_set_{};
+    // Indexed by FileWorkerType.
+    Vector<UniquePtr<EvictionPolicy>> eviction_policies_{};
+    Vector<u32> eviction_priorities_{};
+    // File types in ascending priority.
+    Vector<FileWorkerType> eviction_order_{};
+
+    Atomic<u64> hit_count_{};
+    Atomic<u64> miss_count_{};
+    Atomic<u64> eviction_count_{};
 
     std::mutex clean_locker_{};
     Vector<BufferObj *> clean_list_{};
@@ -49,9 +49,15 @@ BufferHandle BufferObj::Load() {
     switch (status_) {
         case BufferStatus::kLoaded:
         case BufferStatus::kUnloaded: {
+            ++hit_count_;
+            ++buffer_mgr_->hit_count_;
+            referenced_ = true;
             break;
         }
         case BufferStatus::kFreed: {
+            ++miss_count_;
+            ++buffer_mgr_->miss_count_;
+            referenced_ = false;
             buffer_mgr_->RequestSpace(GetBufferSize());
             if (type_ == BufferType::kEphemeral) {
                 String error_message = "Invalid status";
@@ -109,6 +115,7 @@ BufferFreeStatus BufferObj::Free() {
     }
     file_worker_->FreeInMemory();
     status_ = BufferStatus::kFreed;
+    ++eviction_count_;
     return BufferFreeStatus::kSuccess;
 }
 
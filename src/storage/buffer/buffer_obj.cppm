@@ -45,6 +45,9 @@ export struct BufferObjectInfo {
     BufferType buffered_type_{BufferType::kTemp};
     FileWorkerType file_type_{FileWorkerType::kInvalid};
     SizeT object_size_{};
+    u64 hit_count_{};
+    u64 miss_count_{};
+    u64 eviction_count_{};
 };
 
 export String BufferStatusToString(BufferStatus status) {
@@ -98,6 +101,9 @@ public:
     // called by BufferMgr in GC process.
     BufferFreeStatus Free();
 
+    // called by BufferMgr in GC process, returns if the buffer is loaded since the last call.
+    bool TestAndClearReferenced() { return referenced_.exchange(false); }
+
     // called when checkpoint. or in "IMPORT" operator.
     bool Save();
 
@@ -136,6 +142,20 @@ public:
     BufferType type() const { return type_; }
     u64 rc() const { return rc_; }
 
+    // Load calls served from memory, read from disk and Free calls that released the memory.
+    u64 hit_count() const {
+        std::unique_lock<std::mutex> locker(w_locker_);
+        return hit_count_;
+    }
+    u64 miss_count() const {
+        std::unique_lock<std::mutex> locker(w_locker_);
+        return miss_count_;
+    }
+    u64 eviction_count() const {
+        std::unique_lock<std::mutex> locker(w_locker_);
+        return eviction_count_;
+    }
+
     // check the invalid state, only used in tests.
     void CheckState() const;
 
@@ -148,6 +168,12 @@ protected:
     BufferType type_{BufferType::kTemp};
     u64 rc_{0};
     const UniquePtr<FileWorker> file_worker_;
+
+    // Set without gc lock when the buffer is loaded from memory, read by the eviction policy.
+    Atomic<bool> referenced_{false};
+    u64 hit_count_{0};
+    u64 miss_count_{0};
+    u64 eviction_count_{0};
 };
 
 } // namespace infinity
\ No newline at end of file
@@ -0,0 +1,159 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+module eviction_policy;
+
+import stl;
+import infinity_exception;
+import logger;
+
+namespace infinity {
+
+UniquePtr<EvictionPolicy> EvictionPolicy::Make(EvictionPolicyType policy_type) {
+    switch (policy_type) {
+        case EvictionPolicyType::kClock: {
+            return MakeUnique<ClockEvictionPolicy>();
+        }
+        case EvictionPolicyType::kSegmentedLRU: {
+            return MakeUnique<SegmentedLRUEvictionPolicy>();
+        }
+    }
+    String error_message = "Invalid eviction policy type.";
+    LOG_CRITICAL(error_message);
+    UnrecoverableError(error_message);
+    return nullptr;
+}
+
+void ClockEvictionPolicy::Insert(BufferObj *buffer_obj) {
+    if (index_.contains(buffer_obj)) {
+        return;
+    }
+    // Insert behind the hand, so the new object is the last one the hand reaches.
+    auto iter = ring_.insert(hand_, buffer_obj);
+    index_.emplace(buffer_obj, iter);
+}
+
+bool ClockEvictionPolicy::Remove(BufferObj *buffer_obj) {
+    auto index_iter = index_.find(buffer_obj);
+    if (index_iter == index_.end()) {
+        return false;
+    }
+    EntryIter iter = index_iter->second;
+    if (iter == hand_) {
+        ++hand_;
+    }
+    ring_.erase(iter);
+    index_.erase(index_iter);
+    return true;
+}
+
+BufferObj *ClockEvictionPolicy::Victim() {
+    if (ring_.empty()) {
+        return nullptr;
+    }
+    if (hand_ == ring_.end()) {
+        hand_ = ring_.begin();
+    }
+    return *hand_;
+}
+
+void ClockEvictionPolicy::Promote(BufferObj *buffer_obj) { Advance(buffer_obj); }
+
+void ClockEvictionPolicy::Skip(BufferObj *buffer_obj) { Advance(buffer_obj); }
+
+Vector<BufferObj *> ClockEvictionPolicy::Objects() const {
+    Vector<BufferObj *> result;
+    result.reserve(ring_.size());
+    result.insert(result.end(), List<BufferObj *>::const_iterator(hand_), ring_.end());
+    result.insert(result.end(), ring_.begin(), List<BufferObj *>::const_iterator(hand_));
+    return result;
+}
+
+void ClockEvictionPolicy::Advance(BufferObj *buffer_obj) {
+    if (hand_ != ring_.end() && *hand_ == buffer_obj) {
+        ++hand_;
+    }
+}
+
+void SegmentedLRUEvictionPolicy::Insert(BufferObj *buffer_obj) {
+    if (index_.contains(buffer_obj)) {
+        return;
+    }
+    auto iter = probation_.insert(probation_.end(), buffer_obj);
+    index_.emplace(buffer_obj, Location{false, iter});
+}
+
+bool SegmentedLRUEvictionPolicy::Remove(BufferObj *buffer_obj) {
+    auto index_iter = index_.find(buffer_obj);
+    if (index_iter == index_.end()) {
+        return false;
+    }
+    auto &[is_protected, iter] = index_iter->second;
+    (is_protected ? protected_ : probation_).erase(iter);
+    index_.erase(index_iter);
+    return true;
+}
+
+BufferObj *SegmentedLRUEvictionPolicy::Victim() {
+    if (!probation_.empty()) {
+        return probation_.front();
+    }
+    if (!protected_.empty()) {
+        return protected_.front();
+    }
+    return nullptr;
+}
+
+void SegmentedLRUEvictionPolicy::Promote(BufferObj *buffer_obj) {
+    auto index_iter = index_.find(buffer_obj);
+    if (index_iter == index_.end()) {
+        return;
+    }
+    auto &[is_protected, iter] = index_iter->second;
+    protected_.splice(protected_.end(), is_protected ? protected_ : probation_, iter);
+    is_protected = true;
+    Demote();
+}
+
+void SegmentedLRUEvictionPolicy::Skip(BufferObj *buffer_obj) {
+    auto index_iter = index_.find(buffer_obj);
+    if (index_iter == index_.end()) {
+        return;
+    }
+    auto &[is_protected, iter] = index_iter->second;
+    List<BufferObj *> &segment = is_protected ? protected_ : probation_;
+    segment.splice(segment.end(), segment, iter);
+}
+
+Vector<BufferObj *> SegmentedLRUEvictionPolicy::Objects() const {
+    Vector<BufferObj *> result;
+    result.reserve(index_.size());
+    result.insert(result.end(), probation_.begin(), probation_.end());
+    result.insert(result.end(), protected_.begin(), protected_.end());
+    return result;
+}
+
+void SegmentedLRUEvictionPolicy::Demote() {
+    // Keep at least one object in the protected segment.
+    while (protected_.size() > 1 && protected_.size() * 100 > index_.size() * protected_percent_) {
+        BufferObj *buffer_obj = protected_.front();
+        auto &location = index_[buffer_obj];
+        probation_.splice(probation_.end(), protected_, location.iter_);
+        location.is_protected_ = false;
+    }
+}
+
+} // namespace infinity
@@ -0,0 +1,139 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module eviction_policy;
+
+import stl;
+
+namespace infinity {
+
+class BufferObj;
+
+export enum class EvictionPolicyType : i8 {
+    kClock,
+    kSegmentedLRU,
+};
+
+export String EvictionPolicyTypeToString(EvictionPolicyType policy_type) {
+    switch (policy_type) {
+        case EvictionPolicyType::kClock:
+            return "Clock";
+        case EvictionPolicyType::kSegmentedLRU:
+            return "SegmentedLRU";
+    }
+    return "Invalid";
+}
+
+// Order in which unloaded buffer objects are freed when the memory limit is reached.
+// The policy never dereferences the objects. It is not thread safe, the buffer manager calls it under its gc lock.
+export class EvictionPolicy {
+public:
+    virtual ~EvictionPolicy() = default;
+
+    // The object is unloaded and can be freed. Inserting a tracked object is a no-op.
+    virtual void Insert(BufferObj *buffer_obj) = 0;
+
+    // Stop tracking the object. Returns false if it is not tracked.
+    virtual bool Remove(BufferObj *buffer_obj) = 0;
+
+    // The object to free next, nullptr if nothing is tracked. The object stays tracked until Remove.
+    virtual BufferObj *Victim() = 0;
+
+    // The victim has been accessed since it was inserted, keep it longer.
+    virtual void Promote(BufferObj *buffer_obj) = 0;
+
+    // The victim can't be freed now, Victim returns another object next time.
+    virtual void Skip(BufferObj *buffer_obj) = 0;
+
+    // Tracked objects in eviction order.
+    virtual Vector<BufferObj *> Objects() const = 0;
+
+    virtual SizeT Size() const = 0;
+
+    virtual EvictionPolicyType type() const = 0;
+
+    static UniquePtr<EvictionPolicy> Make(EvictionPolicyType policy_type);
+};
+
+// Second chance: the hand sweeps the ring, a promoted object is passed over until the hand comes back.
+export class ClockEvictionPolicy final : public EvictionPolicy {
+public:
+    void Insert(BufferObj *buffer_obj) final;
+
+    bool Remove(BufferObj *buffer_obj) final;
+
+    BufferObj *Victim() final;
+
+    void Promote(BufferObj *buffer_obj) final;
+
+    void Skip(BufferObj *buffer_obj) final;
+
+    Vector<BufferObj *> Objects() const final;
+
+    SizeT Size() const final { return index_.size(); }
+
+    EvictionPolicyType type() const final { return EvictionPolicyType::kClock; }
+
+private:
+    using EntryIter = List<BufferObj *>::iterator;
+
+    void Advance(BufferObj *buffer_obj);
+
+    List<BufferObj *> ring_{};
+    HashMap<BufferObj *, EntryIter> index_{};
+    // Points to the next candidate, end() wraps around to begin().
+    EntryIter hand_{ring_.end()};
+};
+
+// New objects enter the probation segment, promoted objects move to the protected segment.
+// Victims are taken from the probation segment first, so a large scan can't flush the objects that are reused.
+export class SegmentedLRUEvictionPolicy final : public EvictionPolicy {
+public:
+    // At most protected_percent of the tracked objects are kept in the protected segment.
+    explicit SegmentedLRUEvictionPolicy(SizeT protected_percent = 80) : protected_percent_(protected_percent) {}
+
+    void Insert(BufferObj *buffer_obj) final;
+
+    bool Remove(BufferObj *buffer_obj) final;
+
+    BufferObj *Victim() final;
+
+    void Promote(BufferObj *buffer_obj) final;
+
+    void Skip(BufferObj *buffer_obj) final;
+
+    Vector<BufferObj *> Objects() const final;
+
+    SizeT Size() const final { return index_.size(); }
+
+    EvictionPolicyType type() const final { return EvictionPolicyType::kSegmentedLRU; }
+
+private:
+    struct Location {
+        bool is_protected_{};
+        List<BufferObj *>::iterator iter_{};
+    };
+
+    void Demote();
+
+    const SizeT protected_percent_;
+    // Least recently used at the front.
+    List<BufferObj *> probation_{};
+    List<BufferObj *> protected_{};
+    HashMap<BufferObj *, Location> index_{};
+};
+
+} // namespace infinity
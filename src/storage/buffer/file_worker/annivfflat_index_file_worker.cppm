@@ -32,6 +32,8 @@ import column_def;
 import logger;
 import internal_types;
 import file_worker_type;
+import float16;
+import bfloat16;
 
 namespace infinity {
 
@@ -70,6 +72,10 @@ protected:
     void ReadFromFileImpl() override;
 
 private:
+    // Calls func with a null pointer of the index data type selected by the encode type of the index.
+    template <typename Func>
+    void VisitIndexData(Func &&func) const;
+
     EmbeddingDataType GetType() const;
 
     SizeT GetDimension() const;
@@ -110,7 +116,9 @@ void AnnIVFFlatIndexFileWorker<DataType>::AllocateInMemory() {
     }
     switch (GetType()) {
         case kElemFloat: {
-            data_ = static_cast<void *>(new AnnIVFFlatIndexData<DataType>(index_ivfflat->metric_type_, dimension, centroids_count));
+            VisitIndexData([&]<typename IndexData>(IndexData *) {
+                data_ = static_cast<void *>(new IndexData(index_ivfflat->metric_type_, dimension, centroids_count));
+            });
             break;
         }
         default: {
@@ -128,23 +136,52 @@ void AnnIVFFlatIndexFileWorker<DataType>::FreeInMemory() {
         LOG_CRITICAL(error_message);
         UnrecoverableError(error_message);
     }
-    auto index = static_cast<AnnIVFFlatIndexData<DataType> *>(data_);
-    delete index;
+    VisitIndexData([&]<typename IndexData>(IndexData *) { delete static_cast<IndexData *>(data_); });
     data_ = nullptr;
 }
 
 template <typename DataType>
 void AnnIVFFlatIndexFileWorker<DataType>::WriteToFileImpl(bool to_spill, bool &prepare_success) {
-    auto *index = static_cast<AnnIVFFlatIndexData<DataType> *>(data_);
-    index->SaveIndexInner(*file_handler_);
+    VisitIndexData([&]<typename IndexData>(IndexData *) { static_cast<IndexData *>(data_)->SaveIndexInner(*file_handler_); });
     prepare_success = true;
 }
 
 template <typename DataType>
 void AnnIVFFlatIndexFileWorker<DataType>::ReadFromFileImpl() {
-    data_ = new AnnIVFFlatIndexData<DataType>();
-    auto *index = static_cast<AnnIVFFlatIndexData<DataType> *>(data_);
-    index->ReadIndexInner(*file_handler_);
+    VisitIndexData([&]<typename IndexData>(IndexData *) {
+        auto *index = new IndexData();
+        data_ = static_cast<void *>(index);
+        index->ReadIndexInner(*file_handler_);
+    });
+}
+
+template <typename DataType>
+template <typename Func>
+void AnnIVFFlatIndexFileWorker<DataType>::VisitIndexData(Func &&func) const {
+    const auto *index_ivfflat = static_cast<const IndexIVFFlat *>(index_base_.get());
+    switch (index_ivfflat->encode_type_) {
+        case IVFFlatEncodeType::kPlain: {
+            func(static_cast<AnnIVFFlatIndexData<DataType> *>(nullptr));
+            break;
+        }
+        case IVFFlatEncodeType::kFloat16: {
+            func(static_cast<AnnIVFFlatIndexData<DataType, float16_t> *>(nullptr));
+            break;
+        }
+        case IVFFlatEncodeType::kBFloat16: {
+            func(static_cast<AnnIVFFlatIndexData<DataType, bfloat16_t> *>(nullptr));
+            break;
+        }
+        case IVFFlatEncodeType::kInt8: {
+            func(static_cast<AnnIVFFlatIndexData<DataType, u8> *>(nullptr));
+            break;
+        }
+        default: {
+            String error_message = "Invalid IVFFlat encode type";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+    }
 }
 
 template <typename DataType>
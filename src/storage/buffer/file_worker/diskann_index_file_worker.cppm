@@ -0,0 +1,169 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module diskann_index_file_worker;
+
+import stl;
+import index_file_worker;
+import file_worker;
+
+import index_base;
+import diskann_index_data;
+import infinity_exception;
+import index_diskann;
+import logical_type;
+import embedding_info;
+import create_index_info;
+import column_def;
+import logger;
+import internal_types;
+import file_worker_type;
+
+namespace infinity {
+
+export template <typename DataType>
+class DiskAnnIndexFileWorker : public IndexFileWorker {
+public:
+    explicit DiskAnnIndexFileWorker(SharedPtr<String> file_dir,
+                                    SharedPtr<String> file_name,
+                                    SharedPtr<IndexBase> index_base,
+                                    SharedPtr<ColumnDef> column_def)
+        : IndexFileWorker(std::move(file_dir), std::move(file_name), index_base, column_def) {}
+
+    virtual ~DiskAnnIndexFileWorker() override;
+
+public:
+    void AllocateInMemory() override;
+
+    void FreeInMemory() override;
+
+    FileWorkerType Type() const override { return FileWorkerType::kDiskAnnIndexFile; }
+
+protected:
+    void WriteToFileImpl(bool to_spill, bool &prepare_success) override;
+
+    void ReadFromFileImpl() override;
+
+    // Only the PQ codes and the labels of a persisted index are loaded, the node records stay in the file.
+    bool ReadInPlaceImpl(const String &file_path) override;
+
+private:
+    EmbeddingDataType GetType() const;
+
+    SizeT GetDimension() const;
+};
+
+template <typename DataType>
+DiskAnnIndexFileWorker<DataType>::~DiskAnnIndexFileWorker() {
+    if (data_ != nullptr) {
+        FreeInMemory();
+        data_ = nullptr;
+    }
+}
+
+template <typename DataType>
+void DiskAnnIndexFileWorker<DataType>::AllocateInMemory() {
+    if (data_) {
+        String error_message = "Data is already allocated.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    if (index_base_->index_type_ != IndexType::kDiskAnn) {
+        String error_message = "Index type is mismatched";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    auto data_type = column_def_->type();
+    if (data_type->type() != LogicalType::kEmbedding) {
+        String error_message = "Index should be created on embedding column now.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    SizeT dimension = GetDimension();
+
+    const auto *index_diskann = static_cast<const IndexDiskAnn *>(index_base_.get());
+    switch (GetType()) {
+        case kElemFloat: {
+            data_ = static_cast<void *>(new DiskAnnIndexData<DataType>(index_diskann->metric_type_,
+                                                                       dimension,
+                                                                       index_diskann->max_degree_,
+                                                                       index_diskann->build_list_size_,
+                                                                       index_diskann->alpha_,
+                                                                       index_diskann->pq_subspace_num_));
+            break;
+        }
+        default: {
+            String error_message = "Index should be created on float embedding column now.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+    }
+}
+
+template <typename DataType>
+void DiskAnnIndexFileWorker<DataType>::FreeInMemory() {
+    if (!data_) {
+        String error_message = "Data is not allocated.";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    auto index = static_cast<DiskAnnIndexData<DataType> *>(data_);
+    delete index;
+    data_ = nullptr;
+}
+
+template <typename DataType>
+void DiskAnnIndexFileWorker<DataType>::WriteToFileImpl(bool, bool &prepare_success) {
+    auto *index = static_cast<DiskAnnIndexData<DataType> *>(data_);
+    index->SaveIndexInner(*file_handler_);
+    prepare_success = true;
+}
+
+template <typename DataType>
+void DiskAnnIndexFileWorker<DataType>::ReadFromFileImpl() {
+    data_ = new DiskAnnIndexData<DataType>();
+    auto *index = static_cast<DiskAnnIndexData<DataType> *>(data_);
+    index->ReadIndexInner(*file_handler_);
+}
+
+template <typename DataType>
+bool DiskAnnIndexFileWorker<DataType>::ReadInPlaceImpl(const String &file_path) {
+    if (GetType() != kElemFloat) {
+        return false;
+    }
+    auto *index = new DiskAnnIndexData<DataType>();
+    index->ReadIndexInPlace(file_path);
+    data_ = static_cast<void *>(index);
+    return true;
+}
+
+template <typename DataType>
+EmbeddingDataType DiskAnnIndexFileWorker<DataType>::GetType() const {
+    auto data_type = column_def_->type();
+    auto type_info = data_type->type_info().get();
+    auto embedding_info = (EmbeddingInfo *)type_info;
+    return embedding_info->Type();
+}
+
+template <typename DataType>
+SizeT DiskAnnIndexFileWorker<DataType>::GetDimension() const {
+    auto data_type = column_def_->type();
+    auto type_info = data_type->type_info().get();
+    auto embedding_info = (EmbeddingInfo *)type_info;
+    return embedding_info->Dimension();
+}
+
+} // namespace infinity
@@ -77,6 +77,9 @@ void FileWorker::ReadFromFile(bool from_spill) {
     LocalFileSystem fs;
 
     String read_path = fmt::format("{}/{}", ChooseFileDir(from_spill), *file_name_);
+    if (!from_spill && ReadInPlaceImpl(read_path)) {
+        return;
+    }
     u8 flags = FileFlags::READ_FLAG;
     auto [file_handler, status] = fs.OpenFile(read_path, flags, FileLockType::kReadLock);
     if(!status.ok()) {
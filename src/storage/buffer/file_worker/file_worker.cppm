@@ -67,6 +67,10 @@ protected:
 
     virtual void ReadFromFileImpl() = 0;
 
+    // Load the persisted file in place (mapping it, or reading only the part kept in memory) instead of reading it whole,
+    // return false to fall back to ReadFromFileImpl.
+    virtual bool ReadInPlaceImpl(const String &) { return false; }
+
 private:
     String ChooseFileDir(bool spill) const { return spill ? fmt::format("{}{}", *temp_dir_, *file_dir_) : *file_dir_; }
 
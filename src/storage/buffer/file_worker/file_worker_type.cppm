@@ -33,6 +33,8 @@ export enum class FileWorkerType {
     kIndexFile,
     kEMVBIndexFile,
     kBMPIndexFile,
+    kIVFPQIndexFile,
+    kDiskAnnIndexFile,
     kInvalid,
 };
 
@@ -68,6 +70,12 @@ export String FileWorkerType2Str(FileWorkerType type) {
         case FileWorkerType::kBMPIndexFile: {
             return "BMP index";
         }
+        case FileWorkerType::kIVFPQIndexFile: {
+            return "IVF PQ index";
+        }
+        case FileWorkerType::kDiskAnnIndexFile: {
+            return "DiskAnn index";
+        }
         case FileWorkerType::kInvalid: {
             String error_message = "Invalid file worker type";
             LOG_CRITICAL(error_message);
@@ -31,6 +31,9 @@ import embedding_info;
 import create_index_info;
 import internal_types;
 import abstract_hnsw;
+import local_file_system;
+import file_system_type;
+import status;
 
 namespace infinity {
 HnswFileWorker::~HnswFileWorker() {
@@ -101,6 +104,12 @@ void HnswFileWorker::FreeInMemory() {
         }
     }
     data_ = nullptr;
+    if (!mmap_path_.empty()) {
+        // The index refers to the mapped memory, so unmap only after it is freed.
+        LocalFileSystem fs;
+        fs.MunmapFile(mmap_path_);
+        mmap_path_.clear();
+    }
 }
 
 void HnswFileWorker::CompressToLVQ() {
@@ -113,6 +122,23 @@ void HnswFileWorker::CompressToLVQ() {
     EmbeddingDataType embedding_type = GetType();
     switch (embedding_type) {
         case kElemFloat: {
+            if (!mmap_path_.empty()) {
+                // The index is searched in place in the mapped index file, and the compressed index would still use the mapped
+                // graph. The index is saved to the same file later, so read it into memory of its own and unmap the file first.
+                LocalFileSystem fs;
+                auto [file_handler, status] = fs.OpenFile(mmap_path_, FileFlags::READ_FLAG, FileLockType::kReadLock);
+                if (!status.ok()) {
+                    LOG_CRITICAL(status.message());
+                    UnrecoverableError(status.message());
+                }
+                AbstractHnsw<f32, SegmentOffset> loaded_hnsw(nullptr, index_hnsw);
+                loaded_hnsw.Load(*file_handler);
+                AbstractHnsw<f32, SegmentOffset> mapped_hnsw(data_, index_hnsw);
+                mapped_hnsw.Free();
+                data_ = loaded_hnsw.RawPtr();
+                fs.MunmapFile(mmap_path_);
+                mmap_path_.clear();
+            }
             AbstractHnsw<f32, SegmentOffset> abstract_hnsw(data_, index_hnsw);
             abstract_hnsw.CompressToLVQ();
             data_ = abstract_hnsw.RawPtr();
@@ -168,6 +194,27 @@ void HnswFileWorker::ReadFromFileImpl() {
     }
 }
 
+bool HnswFileWorker::ReadInPlaceImpl(const String &file_path) {
+    const IndexHnsw *index_hnsw = static_cast<const IndexHnsw *>(index_base_.get());
+    EmbeddingDataType embedding_type = GetType();
+    if (embedding_type != kElemFloat) {
+        return false;
+    }
+    LocalFileSystem fs;
+    u8 *mmap_data = nullptr;
+    SizeT mmap_len = 0;
+    if (fs.MmapFile(file_path, mmap_data, mmap_len) != 0) {
+        LOG_WARN(fmt::format("Mmap hnsw index file {} failed, read it instead.", file_path));
+        return false;
+    }
+    // The persisted index is searched in place: vectors, graph and labels are not copied.
+    AbstractHnsw<f32, SegmentOffset> abstract_hnsw(nullptr, index_hnsw);
+    abstract_hnsw.LoadFromPtr(reinterpret_cast<char *>(mmap_data));
+    data_ = abstract_hnsw.RawPtr();
+    mmap_path_ = file_path;
+    return true;
+}
+
 EmbeddingDataType HnswFileWorker::GetType() const {
     auto data_type = column_def_->type();
     auto type_info = data_type->type_info().get();
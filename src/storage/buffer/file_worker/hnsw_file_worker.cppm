@@ -57,6 +57,8 @@ protected:
 
     void ReadFromFileImpl() override;
 
+    bool ReadInPlaceImpl(const String &file_path) override;
+
 private:
     EmbeddingDataType GetType() const;
 
@@ -65,6 +67,8 @@ private:
 private:
     SizeT chunk_size_{};
     SizeT max_chunk_num_{};
+    // Path of the mapped index file, empty if the index is in heap memory.
+    String mmap_path_{};
 };
 
 } // namespace infinity
\ No newline at end of file
@@ -22,6 +22,8 @@ module index_base;
 import stl;
 import serialize;
 import index_ivfflat;
+import index_ivfpq;
+import index_diskann;
 import index_hnsw;
 import index_full_text;
 import index_secondary;
@@ -119,8 +121,14 @@ SharedPtr<IndexBase> IndexBase::ReadAdv(char *&ptr, int32_t maxbytes) {
     switch (index_type) {
         case IndexType::kIVFFlat: {
             size_t centroids_count = ReadBufAdv<size_t>(ptr);
-            MetricType metric_type = ReadBufAdv<MetricType>(ptr);
-            res = MakeShared<IndexIVFFlat>(index_name, file_name, column_names, centroids_count, metric_type);
+            i32 metric_type_value = ReadBufAdv<i32>(ptr);
+            IVFFlatEncodeType encode_type = IVFFlatEncodeType::kPlain;
+            if (metric_type_value & IVF_FLAT_ENCODE_TYPE_FLAG) {
+                metric_type_value &= ~IVF_FLAT_ENCODE_TYPE_FLAG;
+                encode_type = ReadBufAdv<IVFFlatEncodeType>(ptr);
+            }
+            MetricType metric_type = static_cast<MetricType>(metric_type_value);
+            res = MakeShared<IndexIVFFlat>(index_name, file_name, column_names, centroids_count, metric_type, encode_type);
             break;
         }
         case IndexType::kHnsw: {
@@ -154,6 +162,36 @@ SharedPtr<IndexBase> IndexBase::ReadAdv(char *&ptr, int32_t maxbytes) {
             res = MakeShared<IndexBMP>(index_name, file_name, std::move(column_names), block_size, compress_type);
             break;
         }
+        case IndexType::kIVFPQ: {
+            SizeT centroids_count = ReadBufAdv<SizeT>(ptr);
+            MetricType metric_type = ReadBufAdv<MetricType>(ptr);
+            u32 pq_subspace_num = ReadBufAdv<u32>(ptr);
+            u32 pq_subspace_bits = ReadBufAdv<u32>(ptr);
+            res = MakeShared<IndexIVFPQ>(index_name,
+                                         file_name,
+                                         std::move(column_names),
+                                         centroids_count,
+                                         metric_type,
+                                         pq_subspace_num,
+                                         pq_subspace_bits);
+            break;
+        }
+        case IndexType::kDiskAnn: {
+            MetricType metric_type = ReadBufAdv<MetricType>(ptr);
+            u32 max_degree = ReadBufAdv<u32>(ptr);
+            u32 build_list_size = ReadBufAdv<u32>(ptr);
+            f32 alpha = ReadBufAdv<f32>(ptr);
+            u32 pq_subspace_num = ReadBufAdv<u32>(ptr);
+            res = MakeShared<IndexDiskAnn>(index_name,
+                                           file_name,
+                                           std::move(column_names),
+                                           metric_type,
+                                           max_degree,
+                                           build_list_size,
+                                           alpha,
+                                           pq_subspace_num);
+            break;
+        }
         case IndexType::kInvalid: {
             String error_message = "Error index method while reading";
             LOG_CRITICAL(error_message);
@@ -206,7 +244,11 @@ SharedPtr<IndexBase> IndexBase::Deserialize(const nlohmann::json &index_def_json
         case IndexType::kIVFFlat: {
             size_t centroids_count = index_def_json["centroids_count"];
             MetricType metric_type = StringToMetricType(index_def_json["metric_type"]);
-            auto ptr = MakeShared<IndexIVFFlat>(index_name, file_name, std::move(column_names), centroids_count, metric_type);
+            IVFFlatEncodeType encode_type = IVFFlatEncodeType::kPlain;
+            if (index_def_json.contains("encode_type")) {
+                encode_type = StringToIVFFlatEncodeType(index_def_json["encode_type"]);
+            }
+            auto ptr = MakeShared<IndexIVFFlat>(index_name, file_name, std::move(column_names), centroids_count, metric_type, encode_type);
             res = std::static_pointer_cast<IndexBase>(ptr);
             break;
         }
@@ -243,6 +285,36 @@ SharedPtr<IndexBase> IndexBase::Deserialize(const nlohmann::json &index_def_json
             res = MakeShared<IndexBMP>(index_name, file_name, std::move(column_names), block_size, compress_type);
             break;
         }
+        case IndexType::kIVFPQ: {
+            SizeT centroids_count = index_def_json["centroids_count"];
+            MetricType metric_type = StringToMetricType(index_def_json["metric_type"]);
+            u32 pq_subspace_num = index_def_json["pq_subspace_num"];
+            u32 pq_subspace_bits = index_def_json["pq_subspace_bits"];
+            res = MakeShared<IndexIVFPQ>(index_name,
+                                         file_name,
+                                         std::move(column_names),
+                                         centroids_count,
+                                         metric_type,
+                                         pq_subspace_num,
+                                         pq_subspace_bits);
+            break;
+        }
+        case IndexType::kDiskAnn: {
+            MetricType metric_type = StringToMetricType(index_def_json["metric_type"]);
+            u32 max_degree = index_def_json["R"];
+            u32 build_list_size = index_def_json["L"];
+            f32 alpha = index_def_json["alpha"];
+            u32 pq_subspace_num = index_def_json["pq_subspace_num"];
+            res = MakeShared<IndexDiskAnn>(index_name,
+                                           file_name,
+                                           std::move(column_names),
+                                           metric_type,
+                                           max_degree,
+                                           build_list_size,
+                                           alpha,
+                                           pq_subspace_num);
+            break;
+        }
         case IndexType::kInvalid: {
             String error_message = "Error index method while deserializing";
             LOG_CRITICAL(error_message);
@@ -0,0 +1,166 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+#include <sstream>
+#include <string>
+
+module index_diskann;
+
+import stl;
+import index_base;
+import status;
+import infinity_exception;
+import third_party;
+import serialize;
+import logical_type;
+import type_info;
+import embedding_info;
+import internal_types;
+import statement_common;
+import logger;
+
+namespace infinity {
+
+SharedPtr<IndexBase> IndexDiskAnn::Make(SharedPtr<String> index_name,
+                                        const String &file_name,
+                                        Vector<String> column_names,
+                                        const Vector<InitParameter *> &index_param_list) {
+    MetricType metric_type = MetricType::kInvalid;
+    u32 max_degree = DISKANN_DEFAULT_R;
+    u32 build_list_size = DISKANN_DEFAULT_L;
+    f32 alpha = DISKANN_DEFAULT_ALPHA;
+    u32 pq_subspace_num = 0;
+    auto parse_positive = [](const InitParameter *para) {
+        const int val = std::stoi(para->param_value_);
+        if (val <= 0) {
+            Status status = Status::InvalidIndexParam(para->param_name_);
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+        }
+        return u32(val);
+    };
+    for (auto para : index_param_list) {
+        if (para->param_name_ == "metric") {
+            metric_type = StringToMetricType(para->param_value_);
+        } else if (para->param_name_ == "R") {
+            max_degree = parse_positive(para);
+        } else if (para->param_name_ == "L") {
+            build_list_size = parse_positive(para);
+        } else if (para->param_name_ == "alpha") {
+            alpha = std::stof(para->param_value_);
+            if (alpha < 1.0f) {
+                Status status = Status::InvalidIndexParam("alpha");
+                LOG_ERROR(status.message());
+                RecoverableError(status);
+            }
+        } else if (para->param_name_ == "pq_subspace_num") {
+            pq_subspace_num = parse_positive(para);
+        } else {
+            Status status = Status::InvalidIndexParam(para->param_name_);
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+        }
+    }
+    if (metric_type == MetricType::kInvalid || pq_subspace_num == 0) {
+        Status status = Status::LackIndexParam();
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+    if (metric_type != MetricType::kMetricL2 && metric_type != MetricType::kMetricInnerProduct) {
+        Status status = Status::InvalidIndexParam("metric");
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+    return MakeShared<IndexDiskAnn>(index_name, file_name, std::move(column_names), metric_type, max_degree, build_list_size, alpha, pq_subspace_num);
+}
+
+bool IndexDiskAnn::operator==(const IndexDiskAnn &other) const {
+    if (this->index_type_ != other.index_type_ || this->file_name_ != other.file_name_ || this->column_names_ != other.column_names_) {
+        return false;
+    }
+    return metric_type_ == other.metric_type_ && max_degree_ == other.max_degree_ && build_list_size_ == other.build_list_size_ &&
+           alpha_ == other.alpha_ && pq_subspace_num_ == other.pq_subspace_num_;
+}
+
+bool IndexDiskAnn::operator!=(const IndexDiskAnn &other) const { return !(*this == other); }
+
+i32 IndexDiskAnn::GetSizeInBytes() const {
+    SizeT size = IndexBase::GetSizeInBytes();
+    size += sizeof(metric_type_);
+    size += sizeof(max_degree_);
+    size += sizeof(build_list_size_);
+    size += sizeof(alpha_);
+    size += sizeof(pq_subspace_num_);
+    return size;
+}
+
+void IndexDiskAnn::WriteAdv(char *&ptr) const {
+    IndexBase::WriteAdv(ptr);
+    WriteBufAdv(ptr, metric_type_);
+    WriteBufAdv(ptr, max_degree_);
+    WriteBufAdv(ptr, build_list_size_);
+    WriteBufAdv(ptr, alpha_);
+    WriteBufAdv(ptr, pq_subspace_num_);
+}
+
+String IndexDiskAnn::ToString() const {
+    std::stringstream ss;
+    ss << IndexBase::ToString() << ", " << BuildOtherParamsString();
+    return ss.str();
+}
+
+String IndexDiskAnn::BuildOtherParamsString() const {
+    return fmt::format("metric = {}, R = {}, L = {}, alpha = {}, pq_subspace_num = {}",
+                       MetricTypeToString(metric_type_),
+                       max_degree_,
+                       build_list_size_,
+                       alpha_,
+                       pq_subspace_num_);
+}
+
+nlohmann::json IndexDiskAnn::Serialize() const {
+    nlohmann::json res = IndexBase::Serialize();
+    res["metric_type"] = MetricTypeToString(metric_type_);
+    res["R"] = max_degree_;
+    res["L"] = build_list_size_;
+    res["alpha"] = alpha_;
+    res["pq_subspace_num"] = pq_subspace_num_;
+    return res;
+}
+
+void IndexDiskAnn::ValidateColumnDataType(const SharedPtr<BaseTableRef> &base_table_ref, const String &column_name) {
+    auto &column_names_vector = *(base_table_ref->column_names_);
+    auto &column_types_vector = *(base_table_ref->column_types_);
+    SizeT column_id = std::find(column_names_vector.begin(), column_names_vector.end(), column_name) - column_names_vector.begin();
+    if (column_id == column_names_vector.size()) {
+        Status status = Status::ColumnNotExist(column_name);
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    } else if (auto &data_type = column_types_vector[column_id]; data_type->type() != LogicalType::kEmbedding) {
+        Status status = Status::InvalidIndexDefinition(
+            fmt::format("Attempt to create DiskAnn index on column: {}, data type: {}.", column_name, data_type->ToString()));
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    } else if (const auto embedding_info = static_cast<EmbeddingInfo *>(data_type->type_info().get());
+               embedding_info->Type() != EmbeddingDataType::kElemFloat) {
+        Status status = Status::InvalidIndexDefinition(
+            fmt::format("Attempt to create DiskAnn index on column: {}, data type: {}.", column_name, data_type->ToString()));
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+}
+
+} // namespace infinity
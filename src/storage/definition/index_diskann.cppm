@@ -0,0 +1,84 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module index_diskann;
+
+import stl;
+import index_base;
+import third_party;
+import base_table_ref;
+import create_index_info;
+import statement_common;
+
+namespace infinity {
+
+export constexpr u32 DISKANN_DEFAULT_R = 64;
+export constexpr u32 DISKANN_DEFAULT_L = 100;
+export constexpr f32 DISKANN_DEFAULT_ALPHA = 1.2f;
+
+export class IndexDiskAnn final : public IndexBase {
+public:
+    static SharedPtr<IndexBase>
+    Make(SharedPtr<String> index_name, const String &file_name, Vector<String> column_names, const Vector<InitParameter *> &index_param_list);
+
+    IndexDiskAnn(SharedPtr<String> index_name,
+                 const String &file_name,
+                 Vector<String> column_names,
+                 MetricType metric_type,
+                 u32 max_degree,
+                 u32 build_list_size,
+                 f32 alpha,
+                 u32 pq_subspace_num)
+        : IndexBase(IndexType::kDiskAnn, std::move(index_name), file_name, std::move(column_names)), metric_type_(metric_type),
+          max_degree_(max_degree), build_list_size_(build_list_size), alpha_(alpha), pq_subspace_num_(pq_subspace_num) {}
+
+    ~IndexDiskAnn() final = default;
+
+    bool operator==(const IndexDiskAnn &other) const;
+
+    bool operator!=(const IndexDiskAnn &other) const;
+
+public:
+    i32 GetSizeInBytes() const override;
+
+    void WriteAdv(char *&ptr) const override;
+
+    String ToString() const override;
+
+    String BuildOtherParamsString() const override;
+
+    nlohmann::json Serialize() const override;
+
+public:
+    static void ValidateColumnDataType(const SharedPtr<BaseTableRef> &base_table_ref, const String &column_name);
+
+public:
+    const MetricType metric_type_{MetricType::kInvalid};
+
+    // R, the maximum out degree of a graph node
+    const u32 max_degree_{};
+
+    // L, the candidate list size of the searches run while building
+    const u32 build_list_size_{};
+
+    // pruning factor of the long range edges, at least 1
+    const f32 alpha_{};
+
+    // the vectors kept in memory are split into pq_subspace_num_ subspaces, each encoded with 8 bits
+    const u32 pq_subspace_num_{};
+};
+
+} // namespace infinity
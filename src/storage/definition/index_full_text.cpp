@@ -58,7 +58,7 @@ SharedPtr<IndexBase> IndexFullText::Make(SharedPtr<String> index_name,
     if (analyzer_name.empty()) {
         analyzer_name = "standard";
     }
-    auto [analyzer, status] = AnalyzerPool::instance().GetAnalyzer(analyzer_name);
+    auto [analyzer, status] = AnalyzerPool::instance().GetThreadLocalAnalyzer(analyzer_name);
     if (!status.ok()) {
         RecoverableError(status);
     }
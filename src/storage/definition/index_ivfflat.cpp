@@ -33,17 +33,49 @@ import logger;
 
 namespace infinity {
 
+String IVFFlatEncodeTypeToString(IVFFlatEncodeType encode_type) {
+    switch (encode_type) {
+        case IVFFlatEncodeType::kPlain:
+            return "plain";
+        case IVFFlatEncodeType::kFloat16:
+            return "fp16";
+        case IVFFlatEncodeType::kBFloat16:
+            return "bf16";
+        case IVFFlatEncodeType::kInt8:
+            return "int8";
+        default:
+            return "invalid";
+    }
+}
+
+IVFFlatEncodeType StringToIVFFlatEncodeType(const String &str) {
+    if (str == "plain") {
+        return IVFFlatEncodeType::kPlain;
+    } else if (str == "fp16") {
+        return IVFFlatEncodeType::kFloat16;
+    } else if (str == "bf16") {
+        return IVFFlatEncodeType::kBFloat16;
+    } else if (str == "int8") {
+        return IVFFlatEncodeType::kInt8;
+    } else {
+        return IVFFlatEncodeType::kInvalid;
+    }
+}
+
 SharedPtr<IndexBase> IndexIVFFlat::Make(SharedPtr<String> index_name,
                                         const String &file_name,
                                         Vector<String> column_names,
                                         const Vector<InitParameter *> &index_param_list) {
     SizeT centroids_count = 0;
     MetricType metric_type = MetricType::kInvalid;
+    IVFFlatEncodeType encode_type = IVFFlatEncodeType::kPlain;
     for (auto para : index_param_list) {
         if (para->param_name_ == "centroids_count") {
             centroids_count = std::stoi(para->param_value_);
         } else if (para->param_name_ == "metric") {
             metric_type = StringToMetricType(para->param_value_);
+        } else if (para->param_name_ == "encode") {
+            encode_type = StringToIVFFlatEncodeType(para->param_value_);
         }
     }
     if (metric_type == MetricType::kInvalid) {
@@ -51,14 +83,19 @@ SharedPtr<IndexBase> IndexIVFFlat::Make(SharedPtr<String> index_name,
         LOG_ERROR(status.message());
         RecoverableError(status);
     }
-    return MakeShared<IndexIVFFlat>(index_name, file_name, std::move(column_names), centroids_count, metric_type);
+    if (encode_type == IVFFlatEncodeType::kInvalid) {
+        Status status = Status::InvalidIndexParam("encode");
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+    return MakeShared<IndexIVFFlat>(index_name, file_name, std::move(column_names), centroids_count, metric_type, encode_type);
 }
 
 bool IndexIVFFlat::operator==(const IndexIVFFlat &other) const {
     if (this->index_type_ != other.index_type_ || this->file_name_ != other.file_name_ || this->column_names_ != other.column_names_) {
         return false;
     }
-    return centroids_count_ == other.centroids_count_ && metric_type_ == other.metric_type_;
+    return centroids_count_ == other.centroids_count_ && metric_type_ == other.metric_type_ && encode_type_ == other.encode_type_;
 }
 
 bool IndexIVFFlat::operator!=(const IndexIVFFlat &other) const { return !(*this == other); }
@@ -67,13 +104,21 @@ i32 IndexIVFFlat::GetSizeInBytes() const {
     SizeT size = IndexBase::GetSizeInBytes();
     size += sizeof(centroids_count_);
     size += sizeof(metric_type_);
+    if (encode_type_ != IVFFlatEncodeType::kPlain) {
+        size += sizeof(encode_type_);
+    }
     return size;
 }
 
 void IndexIVFFlat::WriteAdv(char *&ptr) const {
     IndexBase::WriteAdv(ptr);
     WriteBufAdv(ptr, centroids_count_);
-    WriteBufAdv(ptr, metric_type_);
+    if (encode_type_ == IVFFlatEncodeType::kPlain) {
+        WriteBufAdv(ptr, metric_type_);
+    } else {
+        WriteBufAdv(ptr, static_cast<i32>(metric_type_) | IVF_FLAT_ENCODE_TYPE_FLAG);
+        WriteBufAdv(ptr, encode_type_);
+    }
 }
 
 SharedPtr<IndexBase> IndexIVFFlat::ReadAdv(char *&, int32_t) {
@@ -85,13 +130,17 @@ SharedPtr<IndexBase> IndexIVFFlat::ReadAdv(char *&, int32_t) {
 
 String IndexIVFFlat::ToString() const {
     std::stringstream ss;
-    ss << IndexBase::ToString() << ", " << centroids_count_ << ", " << MetricTypeToString(metric_type_);
+    ss << IndexBase::ToString() << ", " << centroids_count_ << ", " << MetricTypeToString(metric_type_) << ", "
+       << IVFFlatEncodeTypeToString(encode_type_);
     return ss.str();
 }
 
 String IndexIVFFlat::BuildOtherParamsString() const {
     std::stringstream ss;
     ss << "metric = " << MetricTypeToString(metric_type_) << ", centroids_count = " << centroids_count_;
+    if (encode_type_ != IVFFlatEncodeType::kPlain) {
+        ss << ", encode = " << IVFFlatEncodeTypeToString(encode_type_);
+    }
     return ss.str();
 }
 
@@ -99,6 +148,7 @@ nlohmann::json IndexIVFFlat::Serialize() const {
     nlohmann::json res = IndexBase::Serialize();
     res["centroids_count"] = centroids_count_;
     res["metric_type"] = MetricTypeToString(metric_type_);
+    res["encode_type"] = IVFFlatEncodeTypeToString(encode_type_);
     return res;
 }
 
@@ -26,14 +26,37 @@ import create_index_info;
 import statement_common;
 
 namespace infinity {
+
+// Element type the vectors are stored with in the inverted lists. The query and the centroids stay f32.
+export enum class IVFFlatEncodeType : i8 {
+    kPlain,
+    kFloat16,
+    kBFloat16,
+    kInt8,
+    kInvalid,
+};
+
+// The binary layout of IVFFlat ends with the metric type, as it did before encode types existed. An index with another encode type
+// sets this bit in the metric type and writes the encode type after it, so the layout of plain indexes doesn't change.
+export constexpr i32 IVF_FLAT_ENCODE_TYPE_FLAG = 1 << 30;
+
+export String IVFFlatEncodeTypeToString(IVFFlatEncodeType encode_type);
+
+export IVFFlatEncodeType StringToIVFFlatEncodeType(const String &str);
+
 export class IndexIVFFlat final : public IndexBase {
 public:
     static SharedPtr<IndexBase>
     Make(SharedPtr<String> index_name, const String &file_name, Vector<String> column_names, const Vector<InitParameter *> &index_param_list);
 
-    IndexIVFFlat(SharedPtr<String> index_name, const String &file_name, Vector<String> column_names, SizeT centroids_count, MetricType metric_type)
+    IndexIVFFlat(SharedPtr<String> index_name,
+                 const String &file_name,
+                 Vector<String> column_names,
+                 SizeT centroids_count,
+                 MetricType metric_type,
+                 IVFFlatEncodeType encode_type = IVFFlatEncodeType::kPlain)
         : IndexBase(IndexType::kIVFFlat, index_name, file_name, std::move(column_names)), centroids_count_(centroids_count),
-          metric_type_(metric_type) {}
+          metric_type_(metric_type), encode_type_(encode_type) {}
 
     ~IndexIVFFlat() final = default;
 
@@ -63,6 +86,8 @@ public:
     const SizeT centroids_count_{};
 
     const MetricType metric_type_{MetricType::kInvalid};
+
+    const IVFFlatEncodeType encode_type_{IVFFlatEncodeType::kPlain};
 };
 
 } // namespace infinity
\ No newline at end of file
@@ -0,0 +1,170 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+#include <sstream>
+#include <string>
+
+module index_ivfpq;
+
+import stl;
+import index_base;
+import status;
+import infinity_exception;
+import third_party;
+import serialize;
+import logical_type;
+import type_info;
+import embedding_info;
+import internal_types;
+import statement_common;
+import logger;
+
+namespace infinity {
+
+SharedPtr<IndexBase> IndexIVFPQ::Make(SharedPtr<String> index_name,
+                                      const String &file_name,
+                                      Vector<String> column_names,
+                                      const Vector<InitParameter *> &index_param_list,
+                                      SizeT dimension) {
+    SizeT centroids_count = 0;
+    MetricType metric_type = MetricType::kInvalid;
+    u32 pq_subspace_num = 0;
+    u32 pq_subspace_bits = 8;
+    for (auto para : index_param_list) {
+        if (para->param_name_ == "centroids_count") {
+            centroids_count = std::stoi(para->param_value_);
+        } else if (para->param_name_ == "metric") {
+            metric_type = StringToMetricType(para->param_value_);
+        } else if (para->param_name_ == "pq_subspace_num") {
+            const int val = std::stoi(para->param_value_);
+            if (val <= 0) {
+                Status status = Status::InvalidIndexParam("pq_subspace_num");
+                LOG_ERROR(status.message());
+                RecoverableError(status);
+            }
+            pq_subspace_num = u32(val);
+        } else if (para->param_name_ == "pq_subspace_bits") {
+            pq_subspace_bits = std::stoi(para->param_value_);
+        } else {
+            Status status = Status::InvalidIndexParam(para->param_name_);
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+        }
+    }
+    if (metric_type == MetricType::kInvalid || pq_subspace_num == 0) {
+        Status status = Status::LackIndexParam();
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+    if (metric_type != MetricType::kMetricL2 && metric_type != MetricType::kMetricInnerProduct) {
+        Status status = Status::InvalidIndexParam("metric");
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+    if (pq_subspace_bits != 4 && pq_subspace_bits != 8) {
+        Status status = Status::InvalidIndexParam("pq_subspace_bits");
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+    if (dimension % pq_subspace_num != 0) {
+        Status status = Status::InvalidIndexParam("pq_subspace_num");
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+    return MakeShared<IndexIVFPQ>(index_name, file_name, std::move(column_names), centroids_count, metric_type, pq_subspace_num, pq_subspace_bits);
+}
+
+bool IndexIVFPQ::operator==(const IndexIVFPQ &other) const {
+    if (this->index_type_ != other.index_type_ || this->file_name_ != other.file_name_ || this->column_names_ != other.column_names_) {
+        return false;
+    }
+    return centroids_count_ == other.centroids_count_ && metric_type_ == other.metric_type_ && pq_subspace_num_ == other.pq_subspace_num_ &&
+           pq_subspace_bits_ == other.pq_subspace_bits_;
+}
+
+bool IndexIVFPQ::operator!=(const IndexIVFPQ &other) const { return !(*this == other); }
+
+i32 IndexIVFPQ::GetSizeInBytes() const {
+    SizeT size = IndexBase::GetSizeInBytes();
+    size += sizeof(centroids_count_);
+    size += sizeof(metric_type_);
+    size += sizeof(pq_subspace_num_);
+    size += sizeof(pq_subspace_bits_);
+    return size;
+}
+
+void IndexIVFPQ::WriteAdv(char *&ptr) const {
+    IndexBase::WriteAdv(ptr);
+    WriteBufAdv(ptr, centroids_count_);
+    WriteBufAdv(ptr, metric_type_);
+    WriteBufAdv(ptr, pq_subspace_num_);
+    WriteBufAdv(ptr, pq_subspace_bits_);
+}
+
+String IndexIVFPQ::ToString() const {
+    std::stringstream ss;
+    ss << IndexBase::ToString() << ", " << BuildOtherParamsString();
+    return ss.str();
+}
+
+String IndexIVFPQ::BuildOtherParamsString() const {
+    return fmt::format("metric = {}, centroids_count = {}, pq_subspace_num = {}, pq_subspace_bits = {}",
+                       MetricTypeToString(metric_type_),
+                       centroids_count_,
+                       pq_subspace_num_,
+                       pq_subspace_bits_);
+}
+
+nlohmann::json IndexIVFPQ::Serialize() const {
+    nlohmann::json res = IndexBase::Serialize();
+    res["centroids_count"] = centroids_count_;
+    res["metric_type"] = MetricTypeToString(metric_type_);
+    res["pq_subspace_num"] = pq_subspace_num_;
+    res["pq_subspace_bits"] = pq_subspace_bits_;
+    return res;
+}
+
+void IndexIVFPQ::ValidateColumnDataType(const SharedPtr<BaseTableRef> &base_table_ref, const String &column_name) {
+    auto &column_names_vector = *(base_table_ref->column_names_);
+    auto &column_types_vector = *(base_table_ref->column_types_);
+    SizeT column_id = std::find(column_names_vector.begin(), column_names_vector.end(), column_name) - column_names_vector.begin();
+    if (column_id == column_names_vector.size()) {
+        Status status = Status::ColumnNotExist(column_name);
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    } else if (auto &data_type = column_types_vector[column_id]; data_type->type() != LogicalType::kEmbedding) {
+        Status status = Status::InvalidIndexDefinition(
+            fmt::format("Attempt to create IVFPQ index on column: {}, data type: {}.", column_name, data_type->ToString()));
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    } else if (const auto embedding_info = static_cast<EmbeddingInfo *>(data_type->type_info().get());
+               embedding_info->Type() != EmbeddingDataType::kElemFloat) {
+        Status status = Status::InvalidIndexDefinition(
+            fmt::format("Attempt to create IVFPQ index on column: {}, data type: {}.", column_name, data_type->ToString()));
+        LOG_ERROR(status.message());
+        RecoverableError(status);
+    }
+}
+
+SizeT IndexIVFPQ::ColumnDimension(const SharedPtr<BaseTableRef> &base_table_ref, const String &column_name) {
+    auto &column_names_vector = *(base_table_ref->column_names_);
+    auto &column_types_vector = *(base_table_ref->column_types_);
+    SizeT column_id = std::find(column_names_vector.begin(), column_names_vector.end(), column_name) - column_names_vector.begin();
+    const auto embedding_info = static_cast<EmbeddingInfo *>(column_types_vector[column_id]->type_info().get());
+    return embedding_info->Dimension();
+}
+
+} // namespace infinity
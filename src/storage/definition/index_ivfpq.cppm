@@ -0,0 +1,81 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module index_ivfpq;
+
+import stl;
+import index_base;
+import third_party;
+import base_table_ref;
+import create_index_info;
+import statement_common;
+
+namespace infinity {
+
+export class IndexIVFPQ final : public IndexBase {
+public:
+    // `dimension` is the embedding dimension of the column, which pq_subspace_num must divide.
+    static SharedPtr<IndexBase> Make(SharedPtr<String> index_name,
+                                     const String &file_name,
+                                     Vector<String> column_names,
+                                     const Vector<InitParameter *> &index_param_list,
+                                     SizeT dimension);
+
+    IndexIVFPQ(SharedPtr<String> index_name,
+               const String &file_name,
+               Vector<String> column_names,
+               SizeT centroids_count,
+               MetricType metric_type,
+               u32 pq_subspace_num,
+               u32 pq_subspace_bits)
+        : IndexBase(IndexType::kIVFPQ, std::move(index_name), file_name, std::move(column_names)), centroids_count_(centroids_count),
+          metric_type_(metric_type), pq_subspace_num_(pq_subspace_num), pq_subspace_bits_(pq_subspace_bits) {}
+
+    ~IndexIVFPQ() final = default;
+
+    bool operator==(const IndexIVFPQ &other) const;
+
+    bool operator!=(const IndexIVFPQ &other) const;
+
+public:
+    i32 GetSizeInBytes() const override;
+
+    void WriteAdv(char *&ptr) const override;
+
+    String ToString() const override;
+
+    String BuildOtherParamsString() const override;
+
+    nlohmann::json Serialize() const override;
+
+public:
+    static void ValidateColumnDataType(const SharedPtr<BaseTableRef> &base_table_ref, const String &column_name);
+
+    // Embedding dimension of a column that passed ValidateColumnDataType.
+    static SizeT ColumnDimension(const SharedPtr<BaseTableRef> &base_table_ref, const String &column_name);
+
+public:
+    const SizeT centroids_count_{};
+
+    const MetricType metric_type_{MetricType::kInvalid};
+
+    // the dimension is split into pq_subspace_num_ subspaces, each encoded with pq_subspace_bits_ (4 or 8) bits
+    const u32 pq_subspace_num_{};
+
+    const u32 pq_subspace_bits_{};
+};
+
+} // namespace infinity
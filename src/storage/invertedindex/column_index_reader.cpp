@@ -41,6 +41,7 @@ import third_party;
 import blockmax_term_doc_iterator;
 import default_values;
 import logger;
+import fst;
 
 namespace infinity {
 void ColumnIndexReader::Open(optionflag_t flag, String &&index_dir, Map<SegmentID, SharedPtr<SegmentIndexEntry>> &&index_by_segment) {
@@ -108,6 +109,70 @@ UniquePtr<BlockMaxTermDocIterator> ColumnIndexReader::LookupBlockMax(const Strin
     return result;
 }
 
+Vector<String> ColumnIndexReader::ExpandTerms(const TermAutomaton &automaton, SizeT max_expansions) {
+    // fuzzy terms are ranked by edit distance, so each segment yields all of them. Other terms are kept in lexicographical order,
+    // each segment yields its first max_expansions terms, so the first max_expansions terms of the union are exact
+    const bool fuzzy = std::holds_alternative<LevenshteinAutomaton>(automaton);
+    const SizeT segment_limit = fuzzy ? std::numeric_limits<SizeT>::max() : max_expansions;
+    Vector<String> terms;
+    for (const auto &segment_reader : segment_readers_) {
+        segment_reader->ExpandTerms(automaton, segment_limit, terms);
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    if (terms.size() <= max_expansions) {
+        return terms;
+    }
+    if (!fuzzy || max_expansions == 0) {
+        terms.resize(max_expansions);
+        return terms;
+    }
+
+    // keep the closest terms, among the terms at the last kept distance the ones in most documents
+    struct FuzzyTerm {
+        u32 distance_;
+        u32 doc_freq_;
+        SizeT term_idx_;
+    };
+    const auto &levenshtein = std::get<LevenshteinAutomaton>(automaton);
+    Vector<FuzzyTerm> fuzzy_terms;
+    fuzzy_terms.reserve(terms.size());
+    for (SizeT term_idx = 0; term_idx < terms.size(); ++term_idx) {
+        fuzzy_terms.push_back({levenshtein.Distance(terms[term_idx]), 0, term_idx});
+    }
+    std::stable_sort(fuzzy_terms.begin(), fuzzy_terms.end(), [](const FuzzyTerm &lhs, const FuzzyTerm &rhs) {
+        return lhs.distance_ < rhs.distance_;
+    });
+    const u32 last_distance = fuzzy_terms[max_expansions - 1].distance_;
+    SizeT last_begin = max_expansions - 1;
+    while (last_begin > 0 && fuzzy_terms[last_begin - 1].distance_ == last_distance) {
+        --last_begin;
+    }
+    SizeT last_end = max_expansions;
+    while (last_end < fuzzy_terms.size() && fuzzy_terms[last_end].distance_ == last_distance) {
+        ++last_end;
+    }
+    for (SizeT i = last_begin; i < last_end; ++i) {
+        auto posting_iterator = Lookup(terms[fuzzy_terms[i].term_idx_], false);
+        fuzzy_terms[i].doc_freq_ = posting_iterator.get() != nullptr ? posting_iterator->GetDocFreq() : 0;
+    }
+    std::stable_sort(fuzzy_terms.begin() + last_begin, fuzzy_terms.begin() + last_end, [](const FuzzyTerm &lhs, const FuzzyTerm &rhs) {
+        return lhs.doc_freq_ > rhs.doc_freq_;
+    });
+    fuzzy_terms.resize(max_expansions);
+
+    // the kept terms are returned in lexicographical order as the other expansions
+    std::sort(fuzzy_terms.begin(), fuzzy_terms.end(), [](const FuzzyTerm &lhs, const FuzzyTerm &rhs) {
+        return lhs.term_idx_ < rhs.term_idx_;
+    });
+    Vector<String> kept_terms;
+    kept_terms.reserve(max_expansions);
+    for (const FuzzyTerm &fuzzy_term : fuzzy_terms) {
+        kept_terms.push_back(std::move(terms[fuzzy_term.term_idx_]));
+    }
+    return kept_terms;
+}
+
 float ColumnIndexReader::GetAvgColumnLength() const {
     u64 column_len_sum = 0;
     u32 column_len_cnt = 0;
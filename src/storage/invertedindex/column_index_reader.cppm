@@ -25,6 +25,7 @@ import memory_indexer;
 import internal_types;
 import segment_index_entry;
 import chunk_index_entry;
+import fst;
 
 export module column_index_reader;
 
@@ -41,6 +42,10 @@ public:
 
     UniquePtr<BlockMaxTermDocIterator> LookupBlockMax(const String &term, float weight, bool fetch_position = true);
 
+    // at most `max_expansions` terms accepted by the automaton in any segment, in lexicographical order. Fuzzy terms are the closest
+    // ones to the query, then the ones in most documents, other terms are the lexicographically first ones
+    Vector<String> ExpandTerms(const TermAutomaton &automaton, SizeT max_expansions);
+
     float GetAvgColumnLength() const;
 
     optionflag_t GetOptionFlag() const { return flag_; }
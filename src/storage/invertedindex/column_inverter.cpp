@@ -51,13 +51,18 @@ ColumnInverter::ColumnInverter(PostingWriterProvider posting_writer_provider, Ve
     : posting_writer_provider_(posting_writer_provider), column_lengths_(column_lengths) {}
 
 void ColumnInverter::InitAnalyzer(const String &analyzer_name) {
-    auto [analyzer, status] = AnalyzerPool::instance().GetAnalyzer(analyzer_name);
+    GetAnalyzer(analyzer_name);
+    analyzer_name_ = analyzer_name;
+}
+
+Analyzer *ColumnInverter::GetAnalyzer(const String &analyzer_name) {
+    auto [analyzer, status] = AnalyzerPool::instance().GetThreadLocalAnalyzer(analyzer_name);
     if(!status.ok()) {
         Status status = Status::UnexpectedError(fmt::format("Invalid analyzer: {}", analyzer_name));
         LOG_ERROR(status.message());
         RecoverableError(status);
     }
-    analyzer_ = std::move(analyzer);
+    return analyzer;
 }
 
 ColumnInverter::~ColumnInverter() = default;
@@ -69,12 +74,15 @@ SizeT ColumnInverter::InvertColumn(SharedPtr<ColumnVector> column_vector, u32 ro
     doc_count_ = row_count;
     Vector<u32> column_lengths(row_count);
     SizeT term_count_sum = 0;
+    // InitAnalyzer() may run on another thread, the whole batch is analyzed by the analyzer of the inverting thread
+    Analyzer *analyzer = GetAnalyzer(analyzer_name_);
+    terms_per_doc_.reserve(terms_per_doc_.size() + row_count);
     for (SizeT i = 0; i < row_count; ++i) {
         String data = column_vector->ToString(row_offset + i);
         if (data.empty()) {
             continue;
         }
-        SizeT term_count = InvertColumn(begin_doc_id + i, data);
+        SizeT term_count = InvertColumn(analyzer, begin_doc_id + i, data);
         column_lengths[i] = term_count;
         term_count_sum += term_count;
     }
@@ -82,9 +90,9 @@ SizeT ColumnInverter::InvertColumn(SharedPtr<ColumnVector> column_vector, u32 ro
     return term_count_sum;
 }
 
-SizeT ColumnInverter::InvertColumn(u32 doc_id, const String &val) {
+SizeT ColumnInverter::InvertColumn(Analyzer *analyzer, u32 doc_id, const String &val) {
     auto terms_once_ = MakeUnique<TermList>();
-    analyzer_->Analyze(val, *terms_once_);
+    analyzer->Analyze(val, *terms_once_);
     SizeT term_count = terms_once_->size();
     terms_per_doc_.push_back(Pair<u32, UniquePtr<TermList>>(doc_id, std::move(terms_once_)));
     return term_count;
@@ -91,7 +91,9 @@ private:
         bool operator()(const u32 lhs, const u32 rhs) const;
     };
 
-    SizeT InvertColumn(u32 doc_id, const String &val);
+    static Analyzer *GetAnalyzer(const String &analyzer_name);
+
+    SizeT InvertColumn(Analyzer *analyzer, u32 doc_id, const String &val);
 
     const char *GetTermFromRef(u32 term_ref) const { return &terms_[term_ref << 2]; }
 
@@ -113,7 +115,7 @@ private:
 
     void MergePrepare();
 
-    UniquePtr<Analyzer> analyzer_{nullptr};
+    String analyzer_name_{};
     u32 begin_doc_id_{0};
     u32 doc_count_{0};
     u32 merged_{1};
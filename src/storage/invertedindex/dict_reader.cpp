@@ -82,4 +82,19 @@ bool DictionaryReader::Next(String &term, TermMeta &term_meta) {
     return true;
 }
 
+void DictionaryReader::ExpandTerms(const TermAutomaton &automaton, SizeT limit, Vector<String> &terms) {
+    if (limit == 0) {
+        return;
+    }
+    const SizeT old_size = terms.size();
+    std::visit(
+        [&](const auto &aut) {
+            fst_->Search(aut, [&](const u8 *key_ptr, SizeT key_len, u64) {
+                terms.emplace_back(reinterpret_cast<const char *>(key_ptr), key_len);
+                return terms.size() - old_size < limit;
+            });
+        },
+        automaton);
+}
+
 } // namespace infinity
\ No newline at end of file
@@ -43,5 +43,8 @@ public:
     void InitIterator(const String &prefix);
 
     bool Next(String &term, TermMeta &term_meta);
+
+    // Appends the terms accepted by the automaton in lexicographical order, at most `limit` of them.
+    void ExpandTerms(const TermAutomaton &automaton, SizeT limit, Vector<String> &terms);
 };
 } // namespace infinity
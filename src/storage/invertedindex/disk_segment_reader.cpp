@@ -34,6 +34,7 @@ import byte_slice_reader;
 import infinity_exception;
 import status;
 import logger;
+import fst;
 
 namespace infinity {
 
@@ -77,4 +78,10 @@ bool DiskIndexSegmentReader::GetSegmentPosting(const String &term, SegmentPostin
     return true;
 }
 
+void DiskIndexSegmentReader::ExpandTerms(const TermAutomaton &automaton, SizeT limit, Vector<String> &terms) const {
+    if (dict_reader_.get() != nullptr) {
+        dict_reader_->ExpandTerms(automaton, limit, terms);
+    }
+}
+
 } // namespace infinity
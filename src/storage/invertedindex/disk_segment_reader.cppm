@@ -26,6 +26,7 @@ import posting_list_format;
 import local_file_system;
 import internal_types;
 import term_meta;
+import fst;
 
 namespace infinity {
 export class DiskIndexSegmentReader : public IndexSegmentReader {
@@ -36,6 +37,8 @@ public:
 
     bool GetSegmentPosting(const String &term, SegmentPosting &seg_posting, bool fetch_position = true) const override;
 
+    void ExpandTerms(const TermAutomaton &automaton, SizeT limit, Vector<String> &terms) const override;
+
 private:
     RowID base_row_id_{INVALID_ROWID};
     SharedPtr<DictionaryReader> dict_reader_;
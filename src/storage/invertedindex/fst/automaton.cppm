@@ -0,0 +1,232 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+export module fst:automaton;
+import stl;
+
+/// Automata that select keys of an fst byte by byte.
+///
+/// An automaton has a `State` type and four operations:
+/// - `Start()` returns the state before any input.
+/// - `Accept(state, byte)` returns the state after one more input byte.
+/// - `IsMatch(state)` tells whether the input read so far is accepted.
+/// - `CanMatch(state)` tells whether any continuation of the input can be accepted,
+///   `Fst::Search` skips the whole subtree of a node once it returns false.
+///
+/// Wildcard and Levenshtein automata work on unicode code points, the bytes of a
+/// multi-byte UTF-8 sequence are buffered in the state until the code point is complete.
+
+namespace infinity {
+
+struct Utf8State {
+    u32 code_point_{0};
+    u8 remaining_{0};
+};
+
+/// Feeds one byte, returns true once a code point is complete in `state.code_point_`.
+bool FeedUtf8(Utf8State &state, u8 b) {
+    if (state.remaining_ > 0) {
+        state.code_point_ = (state.code_point_ << 6) | (b & 0x3F);
+        return --state.remaining_ == 0;
+    }
+    if ((b & 0xE0) == 0xC0) {
+        state.code_point_ = b & 0x1F;
+        state.remaining_ = 1;
+    } else if ((b & 0xF0) == 0xE0) {
+        state.code_point_ = b & 0x0F;
+        state.remaining_ = 2;
+    } else if ((b & 0xF8) == 0xF0) {
+        state.code_point_ = b & 0x07;
+        state.remaining_ = 3;
+    } else {
+        // ASCII, or an invalid leading byte taken as a code point of its own
+        state.code_point_ = b;
+        return true;
+    }
+    return false;
+}
+
+Vector<u32> DecodeUtf8(const String &text) {
+    Vector<u32> code_points;
+    Utf8State state;
+    for (char c : text) {
+        if (FeedUtf8(state, static_cast<u8>(c))) {
+            code_points.push_back(state.code_point_);
+        }
+    }
+    return code_points;
+}
+
+/// Matches the keys starting with `prefix`.
+export class PrefixAutomaton {
+public:
+    // number of prefix bytes matched so far, -1 after a mismatch
+    using State = i64;
+
+    explicit PrefixAutomaton(String prefix) : prefix_(std::move(prefix)) {}
+
+    State Start() const { return 0; }
+
+    State Accept(State state, u8 b) const {
+        if (state < 0 || state >= static_cast<i64>(prefix_.size())) {
+            return state;
+        }
+        return static_cast<u8>(prefix_[state]) == b ? state + 1 : -1;
+    }
+
+    bool IsMatch(State state) const { return state == static_cast<i64>(prefix_.size()); }
+
+    bool CanMatch(State state) const { return state >= 0; }
+
+private:
+    String prefix_;
+};
+
+/// Matches the keys against a pattern where `*` stands for any sequence of characters and `?` for exactly one character.
+export class WildcardAutomaton {
+public:
+    struct State {
+        // active_[i] is set if the input read so far can be followed by pattern_[i..]
+        Vector<bool> active_;
+        Utf8State utf8_;
+    };
+
+    explicit WildcardAutomaton(const String &pattern) : pattern_(DecodeUtf8(pattern)) {}
+
+    State Start() const {
+        State state;
+        state.active_.resize(pattern_.size() + 1, false);
+        state.active_[0] = true;
+        SkipStars(state.active_);
+        return state;
+    }
+
+    State Accept(const State &state, u8 b) const {
+        State next;
+        next.utf8_ = state.utf8_;
+        if (!FeedUtf8(next.utf8_, b)) {
+            next.active_ = state.active_;
+            return next;
+        }
+        const u32 c = next.utf8_.code_point_;
+        next.active_.resize(pattern_.size() + 1, false);
+        for (SizeT i = 0; i < pattern_.size(); ++i) {
+            if (!state.active_[i]) {
+                continue;
+            }
+            if (pattern_[i] == '*') {
+                next.active_[i] = true;
+            } else if (pattern_[i] == '?' || pattern_[i] == c) {
+                next.active_[i + 1] = true;
+            }
+        }
+        SkipStars(next.active_);
+        return next;
+    }
+
+    bool IsMatch(const State &state) const { return state.utf8_.remaining_ == 0 && state.active_.back(); }
+
+    bool CanMatch(const State &state) const { return std::find(state.active_.begin(), state.active_.end(), true) != state.active_.end(); }
+
+private:
+    // `*` also matches the empty sequence
+    void SkipStars(Vector<bool> &active) const {
+        for (SizeT i = 0; i < pattern_.size(); ++i) {
+            if (active[i] && pattern_[i] == '*') {
+                active[i + 1] = true;
+            }
+        }
+    }
+
+    Vector<u32> pattern_;
+};
+
+/// Matches the keys within `max_edits` insertions, deletions or substitutions of `query`.
+export class LevenshteinAutomaton {
+public:
+    struct State {
+        // row_[i] is the edit distance between the input read so far and the first i characters of the query,
+        // capped at max_edits + 1
+        Vector<u32> row_;
+        Utf8State utf8_;
+    };
+
+    LevenshteinAutomaton(const String &query, u32 max_edits) : query_(DecodeUtf8(query)), max_edits_(max_edits) {}
+
+    State Start() const {
+        State state;
+        state.row_.resize(query_.size() + 1);
+        for (SizeT i = 0; i <= query_.size(); ++i) {
+            state.row_[i] = std::min<u32>(i, max_edits_ + 1);
+        }
+        return state;
+    }
+
+    State Accept(const State &state, u8 b) const {
+        State next;
+        next.utf8_ = state.utf8_;
+        if (!FeedUtf8(next.utf8_, b)) {
+            next.row_ = state.row_;
+            return next;
+        }
+        const u32 c = next.utf8_.code_point_;
+        next.row_.resize(query_.size() + 1);
+        next.row_[0] = std::min(state.row_[0] + 1, max_edits_ + 1);
+        for (SizeT i = 1; i <= query_.size(); ++i) {
+            u32 distance = state.row_[i - 1] + (query_[i - 1] == c ? 0 : 1);
+            distance = std::min(distance, state.row_[i] + 1);
+            distance = std::min(distance, next.row_[i - 1] + 1);
+            next.row_[i] = std::min(distance, max_edits_ + 1);
+        }
+        return next;
+    }
+
+    bool IsMatch(const State &state) const { return state.utf8_.remaining_ == 0 && state.row_.back() <= max_edits_; }
+
+    bool CanMatch(const State &state) const { return *std::min_element(state.row_.begin(), state.row_.end()) <= max_edits_; }
+
+    /// Edit distance between `key` and the query, max_edits + 1 if it is larger than max_edits.
+    u32 Distance(const String &key) const {
+        State state = Start();
+        for (char c : key) {
+            state = Accept(state, static_cast<u8>(c));
+        }
+        return state.utf8_.remaining_ == 0 ? state.row_.back() : max_edits_ + 1;
+    }
+
+private:
+    Vector<u32> query_;
+    u32 max_edits_;
+};
+
+export using TermAutomaton = std::variant<PrefixAutomaton, WildcardAutomaton, LevenshteinAutomaton>;
+
+/// Runs the automaton over a single key.
+export bool AutomatonMatches(const TermAutomaton &automaton, const String &key) {
+    return std::visit(
+        [&key](const auto &aut) {
+            auto state = aut.Start();
+            for (char c : key) {
+                if (!aut.CanMatch(state)) {
+                    return false;
+                }
+                state = aut.Accept(state, static_cast<u8>(c));
+            }
+            return aut.IsMatch(state);
+        },
+        automaton);
+}
+
+} // namespace infinity
@@ -179,6 +179,59 @@ public:
         return Get(key_ptr, key_len, val);
     }
 
+    /// Visits the keys accepted by `automaton` in lexicographical order.
+    ///
+    /// The subtree of a node is skipped as soon as the automaton reports that
+    /// no key below it can match, so the cost depends on the number of
+    /// matching keys rather than on the size of the fst.
+    /// `callback(key_ptr, key_len, val)` returns false to stop the search.
+    template <typename Automaton, typename Callback>
+    void Search(const Automaton &automaton, Callback &&callback) {
+        struct SearchState {
+            Node node_;
+            SizeT trans_;
+            Output out_;
+            typename Automaton::State aut_state_;
+        };
+        Vector<u8> inp;
+        Vector<SearchState> stack;
+        auto start = automaton.Start();
+        if (!automaton.CanMatch(start)) {
+            return;
+        }
+        Node root = Root();
+        if (root.IsFinal() && automaton.IsMatch(start)) {
+            if (!callback(inp.data(), 0, root.FinalOutput().Value())) {
+                return;
+            }
+        }
+        stack.push_back(SearchState{root, 0, Output(), std::move(start)});
+        while (!stack.empty()) {
+            SearchState &state = stack.back();
+            if (state.trans_ >= state.node_.Len()) {
+                if (stack.size() > 1) {
+                    inp.pop_back();
+                }
+                stack.pop_back();
+                continue;
+            }
+            Transition t = state.node_.TransAt(state.trans_++);
+            auto next_aut_state = automaton.Accept(state.aut_state_, t.inp_);
+            if (!automaton.CanMatch(next_aut_state)) {
+                continue;
+            }
+            Output out = state.out_.Cat(t.out_);
+            Node next_node = NodeAt(t.addr_);
+            inp.push_back(t.inp_);
+            if (next_node.IsFinal() && automaton.IsMatch(next_aut_state)) {
+                if (!callback(inp.data(), inp.size(), out.Cat(next_node.FinalOutput()).Value())) {
+                    return;
+                }
+            }
+            stack.push_back(SearchState{next_node, 0, out, std::move(next_aut_state)});
+        }
+    }
+
 private:
     /// Returns the root node of this fst.
     Node Root() { return Node(meta_.root_addr_, data_ptr_); }
@@ -72,4 +72,37 @@ export u32 RowID2DocID(u32 segment_id, u32 block_id, u32 block_offset) {
 
 export RowID DocID2RowID(u32 doc_id) { return RowID((doc_id - 1) >> SEGMENT_OFFSET_IN_DOCID, (doc_id - 1) & SEGMENT_MASK_IN_DOCID); }
 
+// Column lengths are quantized to a byte for scoring, in the encoding of Lucene norms:
+// lengths below COLUMN_NORM_EXACT_NUM are kept as is, larger ones keep 4 significant bits.
+export constexpr u32 COLUMN_NORM_EXACT_NUM = 24;
+
+export constexpr u32 NormToColumnLength(u8 norm) {
+    if (norm < COLUMN_NORM_EXACT_NUM) {
+        return norm;
+    }
+    const u32 i = norm - COLUMN_NORM_EXACT_NUM;
+    const u32 bits = i & 0x07;
+    const u32 shift = i >> 3;
+    return COLUMN_NORM_EXACT_NUM + (shift == 0 ? bits : (bits | 0x08) << (shift - 1));
+}
+
+// Rounds up to the smallest norm not shorter than column_len, the quantized BM25 score of a document
+// then never exceeds the block max score computed from the exact lengths.
+export u8 ColumnLengthToNorm(u32 column_len) {
+    if (column_len < COLUMN_NORM_EXACT_NUM) {
+        return column_len;
+    }
+    u32 low = COLUMN_NORM_EXACT_NUM;
+    u32 high = std::numeric_limits<u8>::max();
+    while (low < high) {
+        const u32 mid = (low + high) / 2;
+        if (NormToColumnLength(mid) < column_len) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
 } // namespace infinity
@@ -24,6 +24,7 @@ import index_defines;
 import posting_writer;
 import memory_indexer;
 import third_party;
+import fst;
 
 namespace infinity {
 InMemIndexSegmentReader::InMemIndexSegmentReader(MemoryIndexer *memory_indexer)
@@ -39,4 +40,18 @@ bool InMemIndexSegmentReader::GetSegmentPosting(const String &term, SegmentPosti
     return false;
 }
 
+void InMemIndexSegmentReader::ExpandTerms(const TermAutomaton &automaton, SizeT limit, Vector<String> &terms) const {
+    // the in-memory dictionary has no fst, run the automaton over each term
+    const SizeT old_size = terms.size();
+    posting_table_->store_.ForEach([&](const String &term, const SharedPtr<PostingWriter> &) {
+        if (terms.size() - old_size >= limit) {
+            return false;
+        }
+        if (AutomatonMatches(automaton, term)) {
+            terms.push_back(term);
+        }
+        return true;
+    });
+}
+
 } // namespace infinity
\ No newline at end of file
@@ -111,6 +111,42 @@ Pair<bool, RowID> PostingIterator::PeekInBlockRange(RowID doc_id, RowID doc_id_n
     return {false, INVALID_ROWID};
 }
 
+u32 PostingIterator::DecodeBlock(RowID doc_id, RowID doc_id_no_beyond, RowID *doc_ids, tf_t *tfs) {
+    const RowID seek_end = std::min(doc_id_no_beyond, last_doc_id_in_current_block_);
+    if (doc_id > seek_end) {
+        return 0;
+    }
+    if (!finish_decode_docid_) {
+        posting_decoder_->DecodeCurrentDocIDBuffer(doc_buffer_);
+        finish_decode_docid_ = true;
+    }
+    DecodeTFBuffer();
+    // the block keeps the deltas of doc ids, start again from its first doc
+    RowID current_row_id = last_doc_id_in_prev_block_ + doc_buffer_[0];
+    u32 i = 0;
+    while (current_row_id < doc_id) {
+        current_row_id += doc_buffer_[++i];
+    }
+    u32 count = 0;
+    while (current_row_id <= seek_end) {
+        doc_ids[count] = current_row_id;
+        tfs[count] = tf_buffer_[i];
+        ++count;
+        if (current_row_id == last_doc_id_in_current_block_) {
+            break;
+        }
+        current_row_id += doc_buffer_[++i];
+    }
+    if (count > 0) {
+        // offset of the last decoded doc in the buffer
+        const u32 last_offset = doc_ids[count - 1] == current_row_id ? i : i - 1;
+        current_row_id_ = doc_ids[count - 1];
+        doc_buffer_cursor_ = doc_buffer_ + last_offset + 1;
+        need_move_to_current_doc_ = true;
+    }
+    return count;
+}
+
 void PostingIterator::MoveToCurrentDoc(bool fetch_position) {
     need_move_to_current_doc_ = false;
     in_doc_pos_iter_inited_ = false;
@@ -47,6 +47,10 @@ public:
 
     Pair<bool, RowID> PeekInBlockRange(RowID doc_id, RowID doc_id_no_beyond);
 
+    // Decodes the docs of the current block in [doc_id, doc_id_no_beyond] with their tf at once, returns the doc count.
+    // Available after SkipTo(), the iterator is left on the last decoded doc.
+    u32 DecodeBlock(RowID doc_id, RowID doc_id_no_beyond, RowID *doc_ids, tf_t *tfs);
+
     void SeekPosition(pos_t pos, pos_t &result);
 
     docpayload_t GetCurrentDocPayload() {
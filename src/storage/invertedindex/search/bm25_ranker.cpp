@@ -25,20 +25,30 @@ import third_party;
 namespace infinity {
 
 constexpr float k1 = 1.2F;
-constexpr float b = 0.75F;
 
 BM25Ranker::BM25Ranker(u64 total_df) : total_df_(std::max(total_df, 1UL)) {}
 
-void BM25Ranker::AddTermParam(u64 tf, u64 df, float avg_column_len, u32 column_len, float weight) {
+void BM25Ranker::AddTermParam(u64 tf, u64 df, float bm25_norm, float weight) {
     float smooth_idf = std::log(1.0F + (total_df_ - df + 0.5F) / (df + 0.5F));
-    float smooth_tf = (k1 + 1.0F) * tf / (tf + k1 * (1.0F - b + b * column_len / avg_column_len));
+    float smooth_tf = (k1 + 1.0F) * tf / (tf + bm25_norm);
     score_ += smooth_idf * smooth_tf * weight;
 }
 
-void BM25Ranker::AddPhraseParam(float tf, u64 df, float avg_column_len, u32 column_len, float weight) {
+void BM25Ranker::AddPhraseParam(float tf, u64 df, float bm25_norm, float weight) {
     float smooth_idf = std::log(1.0F + (total_df_ - df + 0.5F) / (df + 0.5F));
-    float smooth_tf = (k1 + 1.0F) * tf / (tf + k1 * (1.0F - b + b * column_len / avg_column_len));
+    float smooth_tf = (k1 + 1.0F) * tf / (tf + bm25_norm);
     score_ += smooth_idf * smooth_tf * weight;
 }
 
+void BM25ScoreBlock(const float common_score,
+                    const tf_t *__restrict tfs,
+                    const float *__restrict bm25_norms,
+                    const u32 count,
+                    float *__restrict scores) {
+    for (u32 i = 0; i < count; ++i) {
+        const float tf = tfs[i];
+        scores[i] = common_score * tf / (tf + bm25_norms[i]);
+    }
+}
+
 } // namespace infinity
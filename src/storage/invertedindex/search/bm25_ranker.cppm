@@ -25,9 +25,10 @@ public:
     BM25Ranker(u64 total_df);
     ~BM25Ranker() = default;
 
-    void AddTermParam(u64 tf, u64 df, float avg_column_len, u32 column_len, float weight);
+    // bm25_norm: k1 * (1 - b + b * column_len / avg_column_len), see FullTextColumnLengthReader::GetBM25Norm
+    void AddTermParam(u64 tf, u64 df, float bm25_norm, float weight);
 
-    void AddPhraseParam(float tf, u64 df, float avg_colum_len, u32 column_len, float weight);
+    void AddPhraseParam(float tf, u64 df, float bm25_norm, float weight);
 
     float GetScore() { return score_; }
 
@@ -35,4 +36,8 @@ private:
     float score_{0};
     u64 total_df_{0};
 };
+
+// Scores a block of docs of one term: scores[i] = common_score * tfs[i] / (tfs[i] + bm25_norms[i]),
+// common_score includes weight * smooth_idf * (k1 + 1). Kept as a plain loop over the arrays so that it is vectorized.
+export void BM25ScoreBlock(float common_score, const tf_t *tfs, const float *bm25_norms, u32 count, float *scores);
 } // namespace infinity
\ No newline at end of file
@@ -30,20 +30,26 @@ import file_system;
 import local_file_system;
 import chunk_index_entry;
 import memory_indexer;
-import buffer_obj;
-import buffer_handle;
 
 namespace infinity {
 
+// BM25 parameters
+constexpr float k1 = 1.2F;
+constexpr float b = 0.75F;
+
 FullTextColumnLengthReader::FullTextColumnLengthReader(UniquePtr<FileSystem> file_system,
                                                        const String &index_dir,
                                                        const Vector<SharedPtr<ChunkIndexEntry>> &chunk_index_entries,
-                                                       SharedPtr<MemoryIndexer> memory_indexer)
-    : file_system_(std::move(file_system)), index_dir_(index_dir), chunk_index_entries_(chunk_index_entries), memory_indexer_(memory_indexer) {}
+                                                       SharedPtr<MemoryIndexer> memory_indexer,
+                                                       float avg_column_len)
+    : file_system_(std::move(file_system)), index_dir_(index_dir), chunk_index_entries_(chunk_index_entries), memory_indexer_(memory_indexer) {
+    for (SizeT norm = 0; norm < bm25_norm_table_.size(); ++norm) {
+        bm25_norm_table_[norm] = k1 * (1.0F - b + b * NormToColumnLength(norm) / avg_column_len);
+    }
+}
 
-u32 FullTextColumnLengthReader::SeekFile(RowID row_id) {
+u8 FullTextColumnLengthReader::SeekChunk(RowID row_id) {
     // determine the ChunkIndexEntry which contains row_id
-    current_chunk_buffer_handle_.~BufferHandle();
     SizeT left = 0;
     SizeT right = chunk_index_entries_.size();
     SizeT current_chunk = std::numeric_limits<SizeT>::max();
@@ -62,22 +68,24 @@ u32 FullTextColumnLengthReader::SeekFile(RowID row_id) {
         return 0;
     }
 
-    // Load the column-length file of the ChunkIndexEntry
-    current_chunk_buffer_handle_ = chunk_index_entries_[current_chunk]->GetBufferObj()->Load();
-    column_lengths_ = (const u32 *)current_chunk_buffer_handle_.GetData();
+    // the norms of a chunk are loaded once and shared with the other queries
+    current_chunk_norms_ = chunk_index_entries_[current_chunk]->GetColumnNorms();
+    column_norms_ = current_chunk_norms_->data();
     current_chunk_base_rowid_ = chunk_index_entries_[current_chunk]->base_rowid_;
     current_chunk_row_count_ = chunk_index_entries_[current_chunk]->row_count_;
-    return column_lengths_[row_id - current_chunk_base_rowid_];
+    return column_norms_[row_id - current_chunk_base_rowid_];
 }
 
 void ColumnLengthReader::AppendColumnLength(IndexReader *index_reader, const Vector<u64> &column_ids, Vector<float> &avg_column_length) {
     u64 column_id = column_ids.back();
     ColumnIndexReader *reader = index_reader->GetColumnIndexReader(column_id);
+    const float avg_column_len = reader->GetAvgColumnLength();
     column_length_vector_.emplace_back(MakeUnique<FullTextColumnLengthReader>(MakeUnique<LocalFileSystem>(),
                                                                               reader->index_dir_,
                                                                               reader->chunk_index_entries_,
-                                                                              reader->memory_indexer_));
-    avg_column_length.emplace_back(reader->GetAvgColumnLength());
+                                                                              reader->memory_indexer_,
+                                                                              avg_column_len));
+    avg_column_length.emplace_back(avg_column_len);
 }
 
 } // namespace infinity
\ No newline at end of file
@@ -24,7 +24,6 @@ import internal_types;
 import chunk_index_entry;
 import memory_indexer;
 import buffer_obj;
-import buffer_handle;
 
 namespace infinity {
 class SegmentIndexEntry;
@@ -37,33 +36,40 @@ public:
     FullTextColumnLengthReader(UniquePtr<FileSystem> file_system,
                                const String &index_dir,
                                const Vector<SharedPtr<ChunkIndexEntry>> &chunk_index_entries,
-                               SharedPtr<MemoryIndexer> memory_indexer);
+                               SharedPtr<MemoryIndexer> memory_indexer,
+                               float avg_column_len);
 
-    inline u32 GetColumnLength(RowID row_id) {
+    // column length quantized by ColumnLengthToNorm
+    inline u8 GetColumnNorm(RowID row_id) {
         if (row_id >= current_chunk_base_rowid_ && row_id < current_chunk_base_rowid_ + current_chunk_row_count_) [[likely]] {
-            assert(column_lengths_ != nullptr);
-            return column_lengths_[row_id - current_chunk_base_rowid_];
+            assert(column_norms_ != nullptr);
+            return column_norms_[row_id - current_chunk_base_rowid_];
         }
         if (memory_indexer_.get() != nullptr) {
             RowID base_rowid = memory_indexer_->GetBaseRowId();
             u32 doc_count = memory_indexer_->GetDocCount();
             if (row_id >= base_rowid && row_id < base_rowid + doc_count) {
-                return memory_indexer_->GetColumnLength(row_id - base_rowid);
+                return ColumnLengthToNorm(memory_indexer_->GetColumnLength(row_id - base_rowid));
             }
         }
-        return SeekFile(row_id);
+        return SeekChunk(row_id);
     }
 
+    // k1 * (1 - b + b * column_len / avg_column_len) of BM25
+    inline float GetBM25Norm(RowID row_id) { return bm25_norm_table_[GetColumnNorm(row_id)]; }
+
 private:
-    u32 SeekFile(RowID row_id);
+    u8 SeekChunk(RowID row_id);
     UniquePtr<FileSystem> file_system_;
     const String &index_dir_;
     const Vector<SharedPtr<ChunkIndexEntry>> &chunk_index_entries_; // must in ascending order
     SharedPtr<MemoryIndexer> memory_indexer_;
-    const u32 *column_lengths_{nullptr};
+    const u8 *column_norms_{nullptr};
     RowID current_chunk_base_rowid_{(u64)0};
     u32 current_chunk_row_count_{0};
-    BufferHandle current_chunk_buffer_handle_{};
+    SharedPtr<Vector<u8>> current_chunk_norms_{};
+    // BM25 length normalization of each norm, computed once per query
+    Array<float, 256> bm25_norm_table_{};
 };
 
 export class ColumnLengthReader {
@@ -74,7 +80,7 @@ public:
 
     FullTextColumnLengthReader *GetColumnLengthReader(u32 scorer_column_idx) { return column_length_vector_[scorer_column_idx].get(); }
 
-    inline u32 GetColumnLength(u32 scorer_column_idx, RowID row_id) { return column_length_vector_[scorer_column_idx]->GetColumnLength(row_id); }
+    inline float GetBM25Norm(u32 scorer_column_idx, RowID row_id) { return column_length_vector_[scorer_column_idx]->GetBM25Norm(row_id); }
 };
 
 } // namespace infinity
\ No newline at end of file
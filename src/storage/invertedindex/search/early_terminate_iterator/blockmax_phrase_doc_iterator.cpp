@@ -359,8 +359,7 @@ void BlockMaxPhraseDocIterator::InitBM25Info(u64 total_df, float avg_column_len,
 
 float BlockMaxPhraseDocIterator::BM25Score() {
     auto tf = current_phrase_freq_;
-    auto doc_len = column_length_reader_->GetColumnLength(doc_id_);
-    return bm25_common_score_ * tf / (tf + k1 * (1.0F - b + b * doc_len / avg_column_len_));
+    return bm25_common_score_ * tf / (tf + column_length_reader_->GetBM25Norm(doc_id_));
 }
 
 float BlockMaxPhraseDocIterator::BlockMaxBM25Score() {
@@ -443,15 +442,13 @@ Tuple<bool, float, RowID> BlockMaxPhraseDocIterator::TermSeekInBlockRange(u32 te
 float BlockMaxPhraseDocIterator::TermBM25Score(u32 term_id) {
     // bm25_common_score_ * tf / (tf + k1 * (1.0F - b + b * column_len / avg_column_len));
     auto tf = pos_iters_[term_id]->GetCurrentTF();
-    auto doc_len = term_column_length_reader_[term_id]->GetColumnLength(term_doc_id_[term_id]);
-    return term_bm25_common_score_[term_id] * tf / (tf + k1 * (1.0F - b + b * doc_len / avg_column_len_));
+    return term_bm25_common_score_[term_id] * tf / (tf + term_column_length_reader_[term_id]->GetBM25Norm(term_doc_id_[term_id]));
 }
 
 float BlockMaxPhraseDocIterator::TermBM25Score(infinity::u32 term_id, infinity::tf_t phrase_freq) {
     // bm25_common_score_ * tf / (tf + k1 * (1.0F - b + b * column_len / avg_column_len));
     auto tf = phrase_freq;
-    auto doc_len = term_column_length_reader_[term_id]->GetColumnLength(term_doc_id_[term_id]);
-    return term_bm25_common_score_[term_id] * tf / (tf + k1 * (1.0F - b + b * doc_len / avg_column_len_));
+    return term_bm25_common_score_[term_id] * tf / (tf + term_column_length_reader_[term_id]->GetBM25Norm(term_doc_id_[term_id]));
 }
 
 void BlockMaxPhraseDocIterator::TermInitBM25Info(u32 term_id, u64 total_df, float avg_column_len, FullTextColumnLengthReader *column_length_reader) {
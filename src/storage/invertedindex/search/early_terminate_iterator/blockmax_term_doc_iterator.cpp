@@ -28,6 +28,8 @@ import internal_types;
 import segment_posting;
 import posting_iterator;
 import column_length_io;
+import bm25_ranker;
+import fulltext_score_result_heap;
 import infinity_exception;
 import logger;
 
@@ -147,7 +149,7 @@ float BlockMaxTermDocIterator::BlockMaxBM25Score() {
     }
 }
 
-Pair<tf_t, u32> BlockMaxTermDocIterator::GetScoreData() { return {iter_.GetCurrentTF(), column_length_reader_->GetColumnLength(doc_id_)}; }
+Pair<tf_t, float> BlockMaxTermDocIterator::GetScoreData() { return {iter_.GetCurrentTF(), column_length_reader_->GetBM25Norm(doc_id_)}; }
 
 // weight included
 float BlockMaxTermDocIterator::BM25Score() {
@@ -158,12 +160,54 @@ float BlockMaxTermDocIterator::BM25Score() {
     calc_score_cnt_++;
     prev_calc_score_doc_id_ = doc_id_;
     // bm25_common_score_ * tf / (tf + k1 * (1.0F - b + b * column_len / avg_column_len));
-    const auto [tf, doc_len] = GetScoreData();
-    const float p = f1 + f2 * doc_len;
-    bm25_score_cache_ = bm25_common_score_ * tf / (tf + p);
+    const auto [tf, bm25_norm] = GetScoreData();
+    bm25_score_cache_ = bm25_common_score_ * tf / (tf + bm25_norm);
     return bm25_score_cache_;
 }
 
+u32 BlockMaxTermDocIterator::ScoreBlock(RowID doc_id, RowID doc_id_no_beyond, RowID *doc_ids, float *scores) {
+    const u32 count = iter_.DecodeBlock(doc_id, doc_id_no_beyond, doc_ids, block_tfs_);
+    for (u32 i = 0; i < count; ++i) {
+        block_bm25_norms_[i] = column_length_reader_->GetBM25Norm(doc_ids[i]);
+    }
+    BM25ScoreBlock(bm25_common_score_, block_tfs_, block_bm25_norms_, count, scores);
+    if (count > 0) {
+        doc_id_ = doc_ids[count - 1];
+    }
+    calc_score_cnt_ += count;
+    return count;
+}
+
+bool BlockMaxTermDocIterator::BulkScore(RowID begin_doc_id,
+                                        RowID end_doc_id,
+                                        FullTextScoreResultHeap &result_heap,
+                                        const std::function<bool(RowID)> &filter,
+                                        u32 &candidate_cnt) {
+    RowID doc_ids[MAX_DOC_PER_RECORD];
+    float scores[MAX_DOC_PER_RECORD];
+    float threshold = std::max(threshold_, result_heap.GetScoreThreshold());
+    for (RowID doc_id = begin_doc_id; doc_id < end_doc_id && BlockSkipTo(doc_id, threshold); doc_id = BlockLastDocID() + 1) {
+        doc_id = std::max(doc_id, BlockMinPossibleDocID());
+        if (doc_id >= end_doc_id) {
+            break;
+        }
+        const u32 count = ScoreBlock(doc_id, std::min(BlockLastDocID(), end_doc_id - 1), doc_ids, scores);
+        for (u32 i = 0; i < count; ++i) {
+            if (scores[i] < threshold || !filter(doc_ids[i])) {
+                continue;
+            }
+            ++candidate_cnt;
+            if (result_heap.AddResult(scores[i], doc_ids[i])) {
+                threshold = std::max(threshold, result_heap.GetScoreThreshold());
+            }
+        }
+        // the heap threshold may be raised by other tasks
+        threshold = std::max(threshold, result_heap.GetScoreThreshold());
+    }
+    threshold_ = threshold;
+    return true;
+}
+
 Pair<bool, RowID> BlockMaxTermDocIterator::SeekInBlockRange(RowID doc_id, RowID doc_id_no_beyond) {
     const RowID block_last = BlockLastDocID();
     const RowID seek_end = std::min(doc_id_no_beyond, block_last);
@@ -249,4 +293,89 @@ void BlockMaxTermDocIterator::PrintTree(std::ostream &os, const String &prefix,
     os << '\n';
 }
 
+// the scores of a window are accumulated by doc offset, a window lies in one segment
+constexpr u32 BULK_SCORE_WINDOW_SIZE = 4096;
+
+bool BulkScoreTermUnion(const Vector<UniquePtr<EarlyTerminateIterator>> &iterators,
+                        float threshold,
+                        RowID begin_doc_id,
+                        RowID end_doc_id,
+                        FullTextScoreResultHeap &result_heap,
+                        const std::function<bool(RowID)> &filter,
+                        u32 &candidate_cnt) {
+    Vector<BlockMaxTermDocIterator *> terms;
+    for (const auto &iter : iterators) {
+        auto *term_iter = dynamic_cast<BlockMaxTermDocIterator *>(iter.get());
+        if (term_iter == nullptr) {
+            return false;
+        }
+        terms.push_back(term_iter);
+    }
+    Vector<float> window_scores(BULK_SCORE_WINDOW_SIZE, 0.0F);
+    Vector<u64> window_hits(BULK_SCORE_WINDOW_SIZE / 64, 0);
+    RowID doc_ids[MAX_DOC_PER_RECORD];
+    float scores[MAX_DOC_PER_RECORD];
+    for (RowID doc_id = begin_doc_id; doc_id < end_doc_id;) {
+        // the heap threshold may be raised by other tasks
+        threshold = std::max(threshold, result_heap.GetScoreThreshold());
+        // the window starts at the first candidate block, and ends no later than any current block
+        // so that every term contributes at most its current block
+        RowID window_start = INVALID_ROWID;
+        for (auto it = terms.begin(); it != terms.end();) {
+            if (!(*it)->BlockSkipTo(doc_id, 0.0F)) {
+                it = terms.erase(it);
+                continue;
+            }
+            window_start = std::min(window_start, std::max(doc_id, (*it)->BlockMinPossibleDocID()));
+            ++it;
+        }
+        if (terms.empty() || window_start >= end_doc_id) {
+            break;
+        }
+        RowID window_end(window_start.segment_id_, window_start.segment_offset_ + (BULK_SCORE_WINDOW_SIZE - 1));
+        window_end = std::min(window_end, end_doc_id - 1);
+        for (auto *term_iter : terms) {
+            window_end = std::min(window_end, term_iter->BlockLastDocID());
+        }
+        float window_upper_bound = 0.0F;
+        for (auto *term_iter : terms) {
+            if (term_iter->BlockMinPossibleDocID() <= window_end) {
+                window_upper_bound += term_iter->BlockMaxBM25Score();
+            }
+        }
+        if (window_upper_bound >= threshold) {
+            for (auto *term_iter : terms) {
+                if (term_iter->BlockMinPossibleDocID() > window_end) {
+                    continue;
+                }
+                const u32 count = term_iter->ScoreBlock(window_start, window_end, doc_ids, scores);
+                for (u32 i = 0; i < count; ++i) {
+                    const u32 offset = doc_ids[i].segment_offset_ - window_start.segment_offset_;
+                    window_scores[offset] += scores[i];
+                    window_hits[offset / 64] |= 1ULL << (offset % 64);
+                }
+            }
+            const u32 window_len = window_end.segment_offset_ - window_start.segment_offset_ + 1;
+            for (u32 j = 0; j < (window_len + 63) / 64; ++j) {
+                for (u64 hits = window_hits[j]; hits != 0; hits &= hits - 1) {
+                    const u32 offset = j * 64 + __builtin_ctzll(hits);
+                    const float score = window_scores[offset];
+                    window_scores[offset] = 0.0F;
+                    const RowID id = window_start + offset;
+                    if (score < threshold || !filter(id)) {
+                        continue;
+                    }
+                    ++candidate_cnt;
+                    if (result_heap.AddResult(score, id)) {
+                        threshold = std::max(threshold, result_heap.GetScoreThreshold());
+                    }
+                }
+                window_hits[j] = 0;
+            }
+        }
+        doc_id = window_end + 1;
+    }
+    return true;
+}
+
 } // namespace infinity
\ No newline at end of file
@@ -22,6 +22,7 @@ import internal_types;
 import posting_iterator;
 import term_doc_iterator;
 import early_terminate_iterator;
+import fulltext_score_result_heap;
 
 namespace infinity {
 class SegmentPosting;
@@ -67,6 +68,16 @@ public:
     // weight included
     float BM25Score() override;
 
+    // Scores the docs of the current block in [doc_id, doc_id_no_beyond] at once, returns the doc count.
+    // Available after BlockSkipTo(), weight included.
+    u32 ScoreBlock(RowID doc_id, RowID doc_id_no_beyond, RowID *doc_ids, float *scores);
+
+    bool BulkScore(RowID begin_doc_id,
+                   RowID end_doc_id,
+                   FullTextScoreResultHeap &result_heap,
+                   const std::function<bool(RowID)> &filter,
+                   u32 &candidate_cnt) override;
+
     void PrintTree(std::ostream &os, const String &prefix, bool is_final) const override;
 
     // debug info
@@ -74,7 +85,7 @@ public:
     const String *column_name_ptr_ = nullptr;
 
 private:
-    Pair<tf_t, u32> GetScoreData();
+    Pair<tf_t, float> GetScoreData();
 
     // similar to TermDocIterator
     PostingIterator iter_; // initialized in constructor and InitPostingIterator() function
@@ -89,6 +100,9 @@ private:
     float bm25_common_score_ = 0; // include: weight * smooth_idf * (k1 + 1.0F)
     float block_max_bm25_score_cache_ = 0;
     RowID block_max_bm25_score_cache_end_id_ = INVALID_ROWID;
+    // buffers for ScoreBlock
+    alignas(64) tf_t block_tfs_[MAX_DOC_PER_RECORD] = {};
+    alignas(64) float block_bm25_norms_[MAX_DOC_PER_RECORD] = {};
     // cache for PeekInBlockRange
     RowID peek_doc_id_range_start_ = INVALID_ROWID;
     RowID peek_doc_id_range_end_ = INVALID_ROWID;
@@ -107,4 +121,14 @@ private:
     RowID last_target_doc_id_ = INVALID_ROWID;
 };
 
+// Block-at-a-time evaluation of the union of term iterators, used by the "OR" iterators.
+// Returns false if some iterator is not a BlockMaxTermDocIterator.
+export bool BulkScoreTermUnion(const Vector<UniquePtr<EarlyTerminateIterator>> &iterators,
+                               float threshold,
+                               RowID begin_doc_id,
+                               RowID end_doc_id,
+                               FullTextScoreResultHeap &result_heap,
+                               const std::function<bool(RowID)> &filter,
+                               u32 &candidate_cnt);
+
 } // namespace infinity
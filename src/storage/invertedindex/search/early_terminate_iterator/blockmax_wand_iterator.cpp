@@ -21,6 +21,8 @@ import stl;
 import third_party;
 import index_defines;
 import early_terminate_iterator;
+import blockmax_term_doc_iterator;
+import fulltext_score_result_heap;
 import internal_types;
 import logger;
 import infinity_exception;
@@ -307,4 +309,12 @@ bool BlockMaxWandIterator::NotPartCheckExist(RowID doc_id) {
     return false;
 }
 
+bool BlockMaxWandIterator::BulkScore(RowID begin_doc_id,
+                                     RowID end_doc_id,
+                                     FullTextScoreResultHeap &result_heap,
+                                     const std::function<bool(RowID)> &filter,
+                                     u32 &candidate_cnt) {
+    return BulkScoreTermUnion(sorted_iterators_, threshold_, begin_doc_id, end_doc_id, result_heap, filter, candidate_cnt);
+}
+
 } // namespace infinity
\ No newline at end of file
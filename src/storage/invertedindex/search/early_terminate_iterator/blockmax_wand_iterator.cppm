@@ -18,6 +18,7 @@ export module blockmax_wand_iterator;
 import stl;
 import index_defines;
 import early_terminate_iterator;
+import fulltext_score_result_heap;
 import internal_types;
 
 namespace infinity {
@@ -53,6 +54,13 @@ public:
 
     bool NotPartCheckExist(RowID doc_id) override;
 
+    // available if all the children are term iterators
+    bool BulkScore(RowID begin_doc_id,
+                   RowID end_doc_id,
+                   FullTextScoreResultHeap &result_heap,
+                   const std::function<bool(RowID)> &filter,
+                   u32 &candidate_cnt) override;
+
     void PrintTree(std::ostream &os, const String &prefix, bool is_final) const override {
         return MultiQueryEarlyTerminateIteratorCommonPrintTree(this, "BlockMaxWandIterator", sorted_iterators_, os, prefix, is_final);
     }
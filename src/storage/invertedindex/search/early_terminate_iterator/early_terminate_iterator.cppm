@@ -20,6 +20,7 @@ export module early_terminate_iterator;
 import stl;
 import index_defines;
 import internal_types;
+import fulltext_score_result_heap;
 
 namespace infinity {
 
@@ -100,6 +101,17 @@ public:
     // return false: may not find the next valid inner doc_id_
     virtual bool NotPartCheckExist(RowID doc_id) = 0;
 
+    // Block-at-a-time evaluation: scores whole decoded blocks of the docs in [begin_doc_id, end_doc_id)
+    // and adds the docs accepted by filter to result_heap.
+    // Returns false if the iterator has no such path, the caller then iterates doc by doc.
+    virtual bool BulkScore(RowID begin_doc_id,
+                           RowID end_doc_id,
+                           FullTextScoreResultHeap &result_heap,
+                           const std::function<bool(RowID)> &filter,
+                           u32 &candidate_cnt) {
+        return false;
+    }
+
     // print the query tree, for debugging
     virtual void PrintTree(std::ostream &os, const String &prefix = "", bool is_final = true) const = 0;
 };
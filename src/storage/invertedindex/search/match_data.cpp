@@ -69,18 +69,17 @@ float Scorer::Score(RowID doc_id) {
     float score = 0.0F;
     for (u32 i = 0; i < column_counter_; i++) {
         BM25Ranker ranker(total_df_);
-        float avg_column_length = avg_column_length_[i];
-        u32 column_len = column_length_reader_.GetColumnLength(i, doc_id);
         Vector<DocIterator *> &column_iters = iterators_[i];
         if (column_iters.empty()) {
             continue;
         }
+        float bm25_norm = column_length_reader_.GetBM25Norm(i, doc_id);
         if (column_iters[0]->GetType() == DocIteratorType::kTermIterator) {
             TermColumnMatchData column_match_data;
             for (u32 j = 0; j < column_iters.size(); j++) {
                 TermDocIterator* term_iter = dynamic_cast<TermDocIterator*>(column_iters[j]);
                 if (term_iter->GetTermMatchData(column_match_data, doc_id)) {
-                    ranker.AddTermParam(column_match_data.tf_, term_iter->GetDF(), avg_column_length, column_len, term_iter->GetWeight());
+                    ranker.AddTermParam(column_match_data.tf_, term_iter->GetDF(), bm25_norm, term_iter->GetWeight());
                 }
             }
         } else if (column_iters[0]->GetType() == DocIteratorType::kPhraseIterator) {
@@ -88,11 +87,7 @@ float Scorer::Score(RowID doc_id) {
                 PhraseColumnMatchData column_match_data;
                 PhraseDocIterator* phrase_iter = dynamic_cast<PhraseDocIterator*>(column_iters[j]);
                 if (phrase_iter->GetPhraseMatchData(column_match_data, doc_id)) {
-                    ranker.AddPhraseParam(column_match_data.tf_,
-                                          phrase_iter->GetEstimateDF(),
-                                          avg_column_length,
-                                          column_len,
-                                          phrase_iter->GetWeight());
+                    ranker.AddPhraseParam(column_match_data.tf_, phrase_iter->GetEstimateDF(), bm25_norm, phrase_iter->GetWeight());
                 }
             }
         }
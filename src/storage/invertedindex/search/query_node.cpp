@@ -24,6 +24,7 @@ import index_defines;
 import third_party;
 import phrase_doc_iterator;
 import blockmax_phrase_doc_iterator;
+import fst;
 
 namespace infinity {
 
@@ -64,7 +65,12 @@ std::unique_ptr<QueryNode> QueryNode::GetOptimizedQueryTree(std::unique_ptr<Quer
             optimized_root = std::move(root);
             break;
         }
-        case QueryNodeType::PHRASE: {
+        case QueryNodeType::PHRASE:
+        case QueryNodeType::PREFIX_TERM:
+        case QueryNodeType::SUFFIX_TERM:
+        case QueryNodeType::SUBSTRING_TERM:
+        case QueryNodeType::WILDCARD_TERM:
+        case QueryNodeType::FUZZY_TERM: {
             // no need to optimize
             optimized_root = std::move(root);
             break;
@@ -123,7 +129,12 @@ std::unique_ptr<QueryNode> MultiQueryNode::GetNewOptimizedQueryTree() {
                 // no need to optimize
                 break;
             }
-            case QueryNodeType::PHRASE: {
+            case QueryNodeType::PHRASE:
+            case QueryNodeType::PREFIX_TERM:
+            case QueryNodeType::SUFFIX_TERM:
+            case QueryNodeType::SUBSTRING_TERM:
+            case QueryNodeType::WILDCARD_TERM:
+            case QueryNodeType::FUZZY_TERM: {
                 break;
             }
             case QueryNodeType::AND_NOT: {
@@ -182,6 +193,11 @@ std::unique_ptr<QueryNode> NotQueryNode::InnerGetNewOptimizedQueryTree() {
             }
             case QueryNodeType::TERM:
             case QueryNodeType::PHRASE:
+            case QueryNodeType::PREFIX_TERM:
+            case QueryNodeType::SUFFIX_TERM:
+            case QueryNodeType::SUBSTRING_TERM:
+            case QueryNodeType::WILDCARD_TERM:
+            case QueryNodeType::FUZZY_TERM:
             case QueryNodeType::AND:
             case QueryNodeType::AND_NOT: {
                 new_not_list.emplace_back(std::move(child));
@@ -238,6 +254,11 @@ std::unique_ptr<QueryNode> AndQueryNode::InnerGetNewOptimizedQueryTree() {
             }
             case QueryNodeType::TERM:
             case QueryNodeType::PHRASE:
+            case QueryNodeType::PREFIX_TERM:
+            case QueryNodeType::SUFFIX_TERM:
+            case QueryNodeType::SUBSTRING_TERM:
+            case QueryNodeType::WILDCARD_TERM:
+            case QueryNodeType::FUZZY_TERM:
             case QueryNodeType::OR: {
                 and_list.emplace_back(std::move(child));
                 break;
@@ -331,6 +352,11 @@ std::unique_ptr<QueryNode> OrQueryNode::InnerGetNewOptimizedQueryTree() {
             }
             case QueryNodeType::TERM:
             case QueryNodeType::PHRASE:
+            case QueryNodeType::PREFIX_TERM:
+            case QueryNodeType::SUFFIX_TERM:
+            case QueryNodeType::SUBSTRING_TERM:
+            case QueryNodeType::WILDCARD_TERM:
+            case QueryNodeType::FUZZY_TERM:
             case QueryNodeType::AND:
             case QueryNodeType::AND_NOT: {
                 or_list.emplace_back(std::move(child));
@@ -479,6 +505,116 @@ std::unique_ptr<EarlyTerminateIterator> TermQueryNode::CreateEarlyTerminateSearc
     return search;
 }
 
+TermAutomaton MakeTermAutomaton(const TermExpansionQueryNode &node) {
+    switch (node.GetType()) {
+        case QueryNodeType::PREFIX_TERM: {
+            return PrefixAutomaton(node.term_);
+        }
+        case QueryNodeType::SUFFIX_TERM: {
+            return WildcardAutomaton("*" + node.term_);
+        }
+        case QueryNodeType::SUBSTRING_TERM: {
+            return WildcardAutomaton("*" + node.term_ + "*");
+        }
+        case QueryNodeType::WILDCARD_TERM: {
+            return WildcardAutomaton(node.term_);
+        }
+        case QueryNodeType::FUZZY_TERM: {
+            return LevenshteinAutomaton(node.term_, std::min(node.max_edits_, TermExpansionQueryNode::MAX_FUZZY_EDITS));
+        }
+        default: {
+            String error_message = "MakeTermAutomaton: Unexpected case!";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+            return PrefixAutomaton(node.term_);
+        }
+    }
+}
+
+// the returned terms are owned by the node, the iterators refer to them
+Vector<const String *> ExpandTerms(const TermExpansionQueryNode &node, ColumnIndexReader *column_index_reader) {
+    Vector<String> terms = column_index_reader->ExpandTerms(MakeTermAutomaton(node), node.max_expansions_);
+    Vector<const String *> result;
+    result.reserve(terms.size());
+    for (auto &term : terms) {
+        result.push_back(&node.expanded_terms_.emplace_back(std::move(term)));
+    }
+    return result;
+}
+
+std::unique_ptr<DocIterator> TermExpansionQueryNode::CreateSearch(const TableEntry *table_entry, IndexReader &index_reader, Scorer *scorer) const {
+    ColumnID column_id = table_entry->GetColumnIdByName(column_);
+    ColumnIndexReader *column_index_reader = index_reader.GetColumnIndexReader(column_id);
+    if (!column_index_reader) {
+        return nullptr;
+    }
+    bool fetch_position = false;
+    auto option_flag = column_index_reader->GetOptionFlag();
+    if (option_flag & OptionFlag::of_position_list) {
+        fetch_position = true;
+    }
+    Vector<std::unique_ptr<DocIterator>> sub_doc_iters;
+    for (const String *term : ExpandTerms(*this, column_index_reader)) {
+        auto posting_iterator = column_index_reader->Lookup(*term, fetch_position);
+        if (!posting_iterator) {
+            continue;
+        }
+        auto search = MakeUnique<TermDocIterator>(std::move(posting_iterator), column_id, GetWeight());
+        search->term_ptr_ = term;
+        search->column_name_ptr_ = &column_;
+        if (scorer) {
+            // nodes under "not" will not be added to scorer
+            scorer->AddDocIterator(search.get(), column_id);
+        }
+        sub_doc_iters.emplace_back(std::move(search));
+    }
+    if (sub_doc_iters.empty()) {
+        return nullptr;
+    } else if (sub_doc_iters.size() == 1) {
+        return std::move(sub_doc_iters[0]);
+    } else {
+        return MakeUnique<OrIterator>(std::move(sub_doc_iters));
+    }
+}
+
+std::unique_ptr<EarlyTerminateIterator> TermExpansionQueryNode::CreateEarlyTerminateSearch(const TableEntry *table_entry,
+                                                                                           IndexReader &index_reader,
+                                                                                           Scorer *scorer,
+                                                                                           EarlyTermAlgo /*early_term_algo*/) const {
+    ColumnID column_id = table_entry->GetColumnIdByName(column_);
+    ColumnIndexReader *column_index_reader = index_reader.GetColumnIndexReader(column_id);
+    if (!column_index_reader) {
+        return nullptr;
+    }
+    bool fetch_position = false;
+    auto option_flag = column_index_reader->GetOptionFlag();
+    if (option_flag & OptionFlag::of_position_list) {
+        fetch_position = true;
+    }
+    Vector<std::unique_ptr<EarlyTerminateIterator>> sub_doc_iters;
+    for (const String *term : ExpandTerms(*this, column_index_reader)) {
+        auto search = column_index_reader->LookupBlockMax(*term, GetWeight(), fetch_position);
+        if (!search) {
+            continue;
+        }
+        search->term_ptr_ = term;
+        search->column_name_ptr_ = &column_;
+        if (scorer) {
+            // nodes under "not" will not be added to scorer
+            scorer->AddBlockMaxDocIterator(search.get(), column_id);
+        }
+        sub_doc_iters.emplace_back(std::move(search));
+    }
+    if (sub_doc_iters.empty()) {
+        return nullptr;
+    } else if (sub_doc_iters.size() == 1) {
+        return std::move(sub_doc_iters[0]);
+    } else {
+        // the expanded terms are many and mostly rare, maxscore skips the non-essential ones cheaply
+        return MakeUnique<BlockMaxMaxscoreIterator>(std::move(sub_doc_iters));
+    }
+}
+
 std::unique_ptr<DocIterator> PhraseQueryNode::CreateSearch(const TableEntry *table_entry, IndexReader &index_reader, Scorer *scorer) const {
     ColumnID column_id = table_entry->GetColumnIdByName(column_);
     ColumnIndexReader *column_index_reader = index_reader.GetColumnIndexReader(column_id);
@@ -724,6 +860,10 @@ std::string QueryNodeTypeToString(QueryNodeType type) {
             return "SUFFIX_TERM";
         case QueryNodeType::SUBSTRING_TERM:
             return "SUBSTRING_TERM";
+        case QueryNodeType::WILDCARD_TERM:
+            return "WILDCARD_TERM";
+        case QueryNodeType::FUZZY_TERM:
+            return "FUZZY_TERM";
     }
 }
 
@@ -737,6 +877,20 @@ void TermQueryNode::PrintTree(std::ostream &os, const std::string &prefix, bool
     os << '\n';
 }
 
+void TermExpansionQueryNode::PrintTree(std::ostream &os, const std::string &prefix, bool is_final) const {
+    os << prefix;
+    os << (is_final ? "└──" : "├──");
+    os << QueryNodeTypeToString(type_);
+    os << " (weight: " << weight_ << ")";
+    os << " (column: " << column_ << ")";
+    os << " (term: " << term_ << ")";
+    if (type_ == QueryNodeType::FUZZY_TERM) {
+        os << " (max_edits: " << max_edits_ << ")";
+    }
+    os << " (max_expansions: " << max_expansions_ << ")";
+    os << '\n';
+}
+
 void PhraseQueryNode::PrintTree(std::ostream &os, const std::string &prefix, bool is_final) const {
     os << prefix;
     os << (is_final ? "└──" : "├──");
@@ -15,6 +15,7 @@
 #ifndef QUERY_NODE_H
 #define QUERY_NODE_H
 
+#include <deque>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -37,11 +38,14 @@ enum class QueryNodeType : char {
     AND,
     AND_NOT,
     OR,
-    // unimplemented:
-    WAND,
+    // expanded to the matching terms of the dictionary:
     PREFIX_TERM,
     SUFFIX_TERM,
     SUBSTRING_TERM,
+    WILDCARD_TERM,
+    FUZZY_TERM,
+    // unimplemented:
+    WAND,
 };
 
 std::string QueryNodeTypeToString(QueryNodeType type);
@@ -103,6 +107,33 @@ struct TermQueryNode final : public QueryNode {
     void PrintTree(std::ostream &os, const std::string &prefix, bool is_final) const override;
 };
 
+// matches the dictionary terms of each segment against the pattern in term_:
+// PREFIX_TERM: terms starting with term_
+// SUFFIX_TERM: terms ending with term_
+// SUBSTRING_TERM: terms containing term_
+// WILDCARD_TERM: term_ with '*' for any sequence and '?' for one character
+// FUZZY_TERM: terms within max_edits_ edits of term_
+// at most max_expansions_ terms are searched, as a disjunction, fuzzy terms closest to term_ first
+struct TermExpansionQueryNode final : public QueryNode {
+    static constexpr uint32_t DEFAULT_MAX_EXPANSIONS = 50;
+    static constexpr uint32_t MAX_FUZZY_EDITS = 2;
+
+    std::string term_;
+    std::string column_;
+    uint32_t max_edits_{MAX_FUZZY_EDITS};
+    uint32_t max_expansions_{DEFAULT_MAX_EXPANSIONS};
+    // keeps the expanded terms alive for the iterators that refer to them
+    mutable std::deque<std::string> expanded_terms_;
+
+    explicit TermExpansionQueryNode(QueryNodeType type) : QueryNode(type) {}
+
+    void PushDownWeight(float factor) override { MultiplyWeight(factor); }
+    std::unique_ptr<DocIterator> CreateSearch(const TableEntry *table_entry, IndexReader &index_reader, Scorer *scorer) const override;
+    std::unique_ptr<EarlyTerminateIterator>
+    CreateEarlyTerminateSearch(const TableEntry *table_entry, IndexReader &index_reader, Scorer *scorer, EarlyTermAlgo early_term_algo) const override;
+    void PrintTree(std::ostream &os, const std::string &prefix, bool is_final) const override;
+};
+
 struct PhraseQueryNode final : public QueryNode {
     std::vector<std::string> terms_;
     std::string column_;
@@ -172,10 +203,6 @@ struct OrQueryNode final : public MultiQueryNode {
 
 // unimplemented
 struct WandQueryNode;
-// struct PhraseQueryNode;
-struct PrefixTermQueryNode;
-struct SuffixTermQueryNode;
-struct SubstringTermQueryNode;
 
 } // namespace infinity
 
@@ -31,6 +31,7 @@ export using infinity::AndNotQueryNode;
 export using infinity::OrQueryNode;
 export using infinity::NotQueryNode;
 export using infinity::PhraseQueryNode;
+export using infinity::TermExpansionQueryNode;
 
 // unimplemented
 // export using infinity::WandQueryNode;
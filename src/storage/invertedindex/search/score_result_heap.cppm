@@ -14,6 +14,8 @@
 
 module;
 
+#include <cmath>
+
 export module fulltext_score_result_heap;
 import stl;
 import internal_types;
@@ -26,6 +28,22 @@ struct HeapCompare {
     static constexpr ScoreType MinValue() { return std::numeric_limits<ScoreType>::lowest(); }
 };
 
+// The best k-th score published by the tasks searching disjoint segments of a table. A task keeps top k results
+// no worse than its k-th score, so results of any task below the published threshold can't be in the merged top k.
+export class FullTextScoreThreshold {
+public:
+    float Get() const { return threshold_.load(std::memory_order_relaxed); }
+
+    void Raise(float threshold) {
+        float old_threshold = threshold_.load(std::memory_order_relaxed);
+        while (threshold > old_threshold && !threshold_.compare_exchange_weak(old_threshold, threshold, std::memory_order_relaxed)) {
+        }
+    }
+
+private:
+    Atomic<float> threshold_{0.0F};
+};
+
 export class FullTextScoreResultHeap {
     using ScoreType = float;
     using ID = RowID;
@@ -34,6 +52,7 @@ export class FullTextScoreResultHeap {
     ID *id_ = nullptr;
     const u32 top_k_ = 0;
     u32 size_ = 0;
+    FullTextScoreThreshold *shared_threshold_ = nullptr;
 
     inline void HeapifyDown(const u32 size, u32 index) {
         if (index == 0 || (index << 1) > size) {
@@ -55,6 +74,12 @@ export class FullTextScoreResultHeap {
         id_[index] = tmp_i;
     }
 
+    inline void PublishThreshold() {
+        if (shared_threshold_ != nullptr) {
+            shared_threshold_->Raise(score_[1]);
+        }
+    }
+
 public:
     FullTextScoreResultHeap(u32 top_k, ScoreType *score, ID *id) : score_(score), id_(id), top_k_(top_k) {
         score_ -= 1;
@@ -63,7 +88,17 @@ public:
 
     [[nodiscard]] u32 GetResultSize() const { return size_; }
 
-    [[nodiscard]] ScoreType GetScoreThreshold() const { return size_ < top_k_ ? 0 : score_[1]; }
+    // Share the k-th score with the heaps of the other tasks of the same query.
+    void SetSharedThreshold(FullTextScoreThreshold *shared_threshold) { shared_threshold_ = shared_threshold; }
+
+    [[nodiscard]] ScoreType GetScoreThreshold() const {
+        const ScoreType threshold = size_ < top_k_ ? 0 : score_[1];
+        if (shared_threshold_ == nullptr) {
+            return threshold;
+        }
+        // keep the ties with the results of other tasks, the merge breaks them by row id
+        return std::max(threshold, std::nextafter(shared_threshold_->Get(), ScoreType{0}));
+    }
 
     // return true if the threshold is updated
     bool AddResult(ScoreType d, ID i) {
@@ -75,12 +110,14 @@ public:
                 for (u32 index = size_ / 2; index > 0; --index) {
                     HeapifyDown(size_, index);
                 }
+                PublishThreshold();
                 return true;
             }
         } else if (Compare::Less(score_[1], d, id_[1], i)) {
             score_[1] = d;
             id_[1] = i;
             HeapifyDown(size_, 1);
+            PublishThreshold();
             return true;
         }
         return false;
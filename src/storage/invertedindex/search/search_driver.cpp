@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <iostream>
 #include <sstream>
 #include <utility>
@@ -66,6 +68,22 @@ void ParseFields(const std::string &fields_str, std::vector<std::pair<std::strin
     }
 }
 
+QueryNodeType TermExpansionType(const std::string &term_expansion) {
+    if (term_expansion == "prefix") {
+        return QueryNodeType::PREFIX_TERM;
+    } else if (term_expansion == "suffix") {
+        return QueryNodeType::SUFFIX_TERM;
+    } else if (term_expansion == "substring") {
+        return QueryNodeType::SUBSTRING_TERM;
+    } else if (term_expansion == "wildcard") {
+        return QueryNodeType::WILDCARD_TERM;
+    }
+    Status status = Status::SyntaxError("term_expansion option must be prefix, suffix, substring or wildcard");
+    LOG_ERROR(status.message());
+    RecoverableError(status);
+    return QueryNodeType::INVALID;
+}
+
 std::unique_ptr<QueryNode> SearchDriver::ParseSingleWithFields(const std::string &fields_str, const std::string &query) const {
     std::unique_ptr<QueryNode> parsed_query_tree;
     std::vector<std::pair<std::string, float>> fields;
@@ -141,6 +159,14 @@ SearchDriver::AnalyzeAndBuildQueryNode(const std::string &field, std::string &&t
         RecoverableError(status);
         return nullptr;
     }
+    if (!from_quoted && !term_expansion_.empty()) {
+        // the pattern is matched against the terms as they are, only the case is folded like the analyzers do
+        auto result = std::make_unique<TermExpansionQueryNode>(TermExpansionType(term_expansion_));
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+        result->term_ = std::move(text);
+        result->column_ = field;
+        return result;
+    }
     Term input_term;
     input_term.text_ = std::move(text);
     TermList terms;
@@ -152,7 +178,7 @@ SearchDriver::AnalyzeAndBuildQueryNode(const std::string &field, std::string &&t
             analyzer_name = it->second;
         }
     }
-    auto [analyzer, status] = AnalyzerPool::instance().GetAnalyzer(analyzer_name);
+    auto [analyzer, status] = AnalyzerPool::instance().GetThreadLocalAnalyzer(analyzer_name);
     if (!status.ok()) {
         LOG_ERROR(status.message());
         RecoverableError(status);
@@ -189,16 +215,24 @@ SearchDriver::AnalyzeAndBuildQueryNode(const std::string &field, std::string &&t
     }
 
     // 2. build query node
-    if (terms.empty()) {
+    // as in Lucene, "~N" after an unquoted term asks for the terms within N edits, after a quoted phrase it is the slop
+    auto build_term_node = [&](std::string &&term) -> std::unique_ptr<QueryNode> {
+        if (!from_quoted && slop > 0) {
+            auto result = std::make_unique<TermExpansionQueryNode>(QueryNodeType::FUZZY_TERM);
+            result->term_ = std::move(term);
+            result->column_ = field;
+            result->max_edits_ = std::min<unsigned long>(slop, TermExpansionQueryNode::MAX_FUZZY_EDITS);
+            return result;
+        }
         auto result = std::make_unique<TermQueryNode>();
-        result->term_ = std::move(input_term.text_);
+        result->term_ = std::move(term);
         result->column_ = field;
         return result;
+    };
+    if (terms.empty()) {
+        return build_term_node(std::move(input_term.text_));
     } else if (terms.size() == 1) {
-        auto result = std::make_unique<TermQueryNode>();
-        result->term_ = std::move(terms.front().text_);
-        result->column_ = field;
-        return result;
+        return build_term_node(std::move(terms.front().text_));
     } else {
         if (from_quoted) {
             auto result = std::make_unique<PhraseQueryNode>();
@@ -211,10 +245,7 @@ SearchDriver::AnalyzeAndBuildQueryNode(const std::string &field, std::string &&t
         } else {
             auto result = std::make_unique<OrQueryNode>();
             for (auto &term : terms) {
-                auto subquery = std::make_unique<TermQueryNode>();
-                subquery->term_ = std::move(term.text_);
-                subquery->column_ = field;
-                result->Add(std::move(subquery));
+                result->Add(build_term_node(std::move(term.text_)));
             }
             return result;
         }
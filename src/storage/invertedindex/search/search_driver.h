@@ -28,8 +28,10 @@ struct QueryNode;
  */
 class SearchDriver {
 public:
-    SearchDriver(const std::map<std::string, std::string> &field2analyzer, const std::string &default_field)
-        : field2analyzer_{field2analyzer}, default_field_{SearchDriver::Unescape(default_field)} {}
+    SearchDriver(const std::map<std::string, std::string> &field2analyzer,
+                 const std::string &default_field,
+                 const std::string &term_expansion = std::string())
+        : field2analyzer_{field2analyzer}, default_field_{SearchDriver::Unescape(default_field)}, term_expansion_{term_expansion} {}
 
     // used in PhysicalMatch
     [[nodiscard]] std::unique_ptr<QueryNode> ParseSingleWithFields(const std::string &fields_str, const std::string &query) const;
@@ -38,6 +40,7 @@ public:
     [[nodiscard]] std::unique_ptr<QueryNode> ParseSingle(const std::string &query, const std::string *default_field_ptr = nullptr) const;
 
     // used in SearchParser in ParseSingle. Assumes field and text are both unescaped.
+    // slop is the slop of a quoted phrase, or the max edits of fuzzy terms if text is not quoted.
     [[nodiscard]] std::unique_ptr<QueryNode>
     AnalyzeAndBuildQueryNode(const std::string &field, std::string &&text, bool from_quoted, unsigned long slop = 0) const;
 
@@ -48,6 +51,9 @@ public:
      */
     const std::map<std::string, std::string> &field2analyzer_;
     const std::string default_field_;
+    // "prefix", "suffix", "substring" or "wildcard": each unquoted word is lowercased and matched as a pattern against the terms of
+    // the index instead of being analyzed. Empty for the analyzed terms.
+    const std::string term_expansion_;
 };
 
 } // namespace infinity
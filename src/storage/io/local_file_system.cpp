@@ -183,6 +183,18 @@ i64 LocalFileSystem::ReadAt(FileHandler &file_handler, i64 file_offset, void *da
     return readen;
 }
 
+void LocalFileSystem::ReadAhead(FileHandler &file_handler, const Vector<Pair<i64, u64>> &ranges) {
+    i32 fd = ((LocalFileHandler &)file_handler).fd_;
+    for (const auto &[file_offset, nbytes] : ranges) {
+        // Only an advice, ReadAt still reads the range if it is not cached.
+        int rc = posix_fadvise(fd, file_offset, nbytes, POSIX_FADV_WILLNEED);
+        if (rc != 0) {
+            LOG_WARN(fmt::format("Can't read ahead file: {}: {}", file_handler.path_.string(), strerror(rc)));
+            return;
+        }
+    }
+}
+
 i64 LocalFileSystem::WriteAt(FileHandler &file_handler, i64 file_offset, const void *data, u64 nbytes) {
     i32 fd = ((LocalFileHandler &)file_handler).fd_;
     i64 written = 0;
@@ -240,6 +252,20 @@ void LocalFileSystem::SyncFile(FileHandler &file_handler) {
     }
 }
 
+void LocalFileSystem::SyncFileData(FileHandler &file_handler) {
+    i32 fd = ((LocalFileHandler &)file_handler).fd_;
+#if defined(__linux__)
+    i32 ret = fdatasync(fd);
+#else
+    i32 ret = fsync(fd);
+#endif
+    if (ret != 0) {
+        String error_message = fmt::format("fdatasync failed: {}, {}", file_handler.path_.string(), strerror(errno));
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+}
+
 void LocalFileSystem::AppendFile(const String &dst_path, const String &src_path) {
     Path dst{dst_path};
     Path src{src_path};
@@ -55,6 +55,10 @@ public:
 
     i64 WriteAt(FileHandler &file_handler, i64 file_offset, const void *data, u64 nbytes) final;
 
+    // Start reading the ranges (offset, size) into the page cache without waiting for them. The reads are submitted together, so a
+    // following ReadAt of each range waits for its own read only.
+    void ReadAhead(FileHandler &file_handler, const Vector<Pair<i64, u64>> &ranges);
+
     void Rename(const String &old_path, const String &new_path) final;
 
     void Seek(FileHandler &file_handler, i64 pos) final;
@@ -65,6 +69,9 @@ public:
 
     void SyncFile(FileHandler &file_handler) final;
 
+    // Like SyncFile, but skip the metadata that is not needed to read the data back.
+    void SyncFileData(FileHandler &file_handler);
+
     void Close(FileHandler &file_handler) final;
 
     void AppendFile(const String &dst_path, const String &src_path) final;
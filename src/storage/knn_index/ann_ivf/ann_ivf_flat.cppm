@@ -30,15 +30,39 @@ import bitmask;
 import knn_expr;
 import internal_types;
 import logger;
+import float16;
+import bfloat16;
+import scalar_quantization;
 
 namespace infinity {
 
-template <typename Compare, MetricType metric, KnnDistanceAlgoType algo>
+template <typename Compare, MetricType metric, KnnDistanceAlgoType algo, typename VectorDataType = typename Compare::DistanceType>
 class AnnIVFFlat final : public KnnDistance<typename Compare::DistanceType> {
     using DistType = typename Compare::DistanceType;
     using ResultHandler = ReservoirResultHandler<Compare>;
-    static inline DistType Distance(const DistType *x, const DistType *y, u32 dimension) {
-        if constexpr (metric == MetricType::kMetricCosine) {
+    using IndexData = AnnIVFFlatIndexData<DistType, VectorDataType>;
+    static inline DistType Distance(const DistType *x, const VectorDataType *y, u32 dimension, const IndexData *base_ivf) {
+        if constexpr (std::is_same_v<VectorDataType, u8>) {
+            if constexpr (metric == MetricType::kMetricL2) {
+                return L2DistanceSQ8(x, y, base_ivf->sq_, dimension);
+            } else if constexpr (metric == MetricType::kMetricInnerProduct) {
+                return IPDistanceSQ8(x, y, base_ivf->sq_, dimension);
+            } else {
+                String error_message = "Metric type is invalid";
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+        } else if constexpr (IndexData::kQuantized) {
+            if constexpr (metric == MetricType::kMetricL2) {
+                return L2DistanceSQ(x, y, dimension);
+            } else if constexpr (metric == MetricType::kMetricInnerProduct) {
+                return IPDistanceSQ(x, y, dimension);
+            } else {
+                String error_message = "Metric type is invalid";
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+        } else if constexpr (metric == MetricType::kMetricCosine) {
             return CosineDistance<DistType>(x, y, dimension);
         } else if constexpr (metric == MetricType::kMetricL2) {
             return L2Distance<DistType>(x, y, dimension);
@@ -59,13 +83,13 @@ public:
         result_handler_ = MakeUnique<ResultHandler>(query_count, top_k, distance_array_.get(), id_array_.get());
     }
 
-    static UniquePtr<AnnIVFFlatIndexData<DistType>> CreateIndex(u32 dimension, u32 vector_count, const DistType *vectors_ptr, u32 partition_num) {
-        return AnnIVFFlat<Compare, metric, algo>::CreateIndex(dimension, vector_count, vectors_ptr, vector_count, vectors_ptr, partition_num);
+    static UniquePtr<IndexData> CreateIndex(u32 dimension, u32 vector_count, const DistType *vectors_ptr, u32 partition_num) {
+        return CreateIndex(dimension, vector_count, vectors_ptr, vector_count, vectors_ptr, partition_num);
     }
 
-    static UniquePtr<AnnIVFFlatIndexData<DistType>>
+    static UniquePtr<IndexData>
     CreateIndex(u32 dimension, u32 train_count, const DistType *train_ptr, u32 vector_count, const DistType *vectors_ptr, u32 partition_num) {
-        auto index_data = MakeUnique<AnnIVFFlatIndexData<DistType>>(metric, dimension, partition_num);
+        auto index_data = MakeUnique<IndexData>(metric, dimension, partition_num);
         index_data->BuildIndex(dimension, train_count, train_ptr, vector_count, vectors_ptr);
         return index_data;
     }
@@ -98,7 +122,7 @@ public:
         UnrecoverableError(error_message);
     }
 
-    void Search(const AnnIVFFlatIndexData<DistType> *base_ivf, u32 segment_id, u32 n_probes) {
+    void Search(const IndexData *base_ivf, u32 segment_id, u32 n_probes) {
         // check metric type
         if (base_ivf->metric_ != metric) {
             String error_message = "Metric type is invalid";
@@ -127,9 +151,9 @@ public:
                 u32 selected_centroid = assign_centroid_ids[i];
                 u32 contain_nums = base_ivf->ids_[selected_centroid].size();
                 const DistType *x_i = this->queries_ + i * this->dimension_;
-                const DistType *y_j = base_ivf->vectors_[selected_centroid].data();
+                const VectorDataType *y_j = base_ivf->vectors_[selected_centroid].data();
                 for (u32 j = 0; j < contain_nums; j++, y_j += this->dimension_) {
-                    DistType distance = Distance(x_i, y_j, this->dimension_);
+                    DistType distance = Distance(x_i, y_j, this->dimension_, base_ivf);
                     result_handler_->AddResult(i, distance, RowID(segment_id, base_ivf->ids_[selected_centroid][j]));
                 }
             }
@@ -150,9 +174,9 @@ public:
                 for (u32 k = 0; k < n_probes && centroid_dists[k + i * n_probes] != InvalidValue(); ++k) {
                     const u32 selected_centroid = centroid_ids[k + i * n_probes];
                     const u32 contain_nums = base_ivf->ids_[selected_centroid].size();
-                    const DistType *y_j = base_ivf->vectors_[selected_centroid].data();
+                    const VectorDataType *y_j = base_ivf->vectors_[selected_centroid].data();
                     for (u32 j = 0; j < contain_nums; j++, y_j += this->dimension_) {
-                        DistType distance = Distance(x_i, y_j, this->dimension_);
+                        DistType distance = Distance(x_i, y_j, this->dimension_, base_ivf);
                         result_handler_->AddResult(i, distance, RowID(segment_id, base_ivf->ids_[selected_centroid][j]));
                     }
                 }
@@ -161,7 +185,7 @@ public:
     }
 
     template <typename Filter>
-    void Search(const AnnIVFFlatIndexData<DistType> *base_ivf, u32 segment_id, u32 n_probes, Filter &filter) {
+    void Search(const IndexData *base_ivf, u32 segment_id, u32 n_probes, Filter &filter) {
         // check metric type
         if (base_ivf->metric_ != metric) {
             String error_message = "Metric type is invalid";
@@ -190,11 +214,11 @@ public:
                 u32 selected_centroid = assign_centroid_ids[i];
                 u32 contain_nums = base_ivf->ids_[selected_centroid].size();
                 const DistType *x_i = this->queries_ + i * this->dimension_;
-                const DistType *y_j = base_ivf->vectors_[selected_centroid].data();
+                const VectorDataType *y_j = base_ivf->vectors_[selected_centroid].data();
                 for (u32 j = 0; j < contain_nums; j++, y_j += this->dimension_) {
                     auto segment_offset = base_ivf->ids_[selected_centroid][j];
                     if (filter(segment_offset)) {
-                        DistType distance = Distance(x_i, y_j, this->dimension_);
+                        DistType distance = Distance(x_i, y_j, this->dimension_, base_ivf);
                         result_handler_->AddResult(i, distance, RowID(segment_id, segment_offset));
                     }
                 }
@@ -216,11 +240,11 @@ public:
                 for (u32 k = 0; k < n_probes && centroid_dists[k + i * n_probes] != InvalidValue(); ++k) {
                     const u32 selected_centroid = centroid_ids[k + i * n_probes];
                     const u32 contain_nums = base_ivf->ids_[selected_centroid].size();
-                    const DistType *y_j = base_ivf->vectors_[selected_centroid].data();
+                    const VectorDataType *y_j = base_ivf->vectors_[selected_centroid].data();
                     for (u32 j = 0; j < contain_nums; j++, y_j += this->dimension_) {
                         auto segment_offset = base_ivf->ids_[selected_centroid][j];
                         if (filter(segment_offset)) {
-                            DistType distance = Distance(x_i, y_j, this->dimension_);
+                            DistType distance = Distance(x_i, y_j, this->dimension_, base_ivf);
                             result_handler_->AddResult(i, distance, RowID(segment_id, segment_offset));
                         }
                     }
@@ -245,6 +269,9 @@ public:
         begin_ = false;
     }
 
+    // Skip the candidates not better than `bound`, e.g. the k-th distance already found in other segments.
+    void TightenThreshold(u64 query_idx, DistType bound) { result_handler_->TightenThreshold(query_idx, bound); }
+
     [[nodiscard]] inline DistType *GetDistances() const final { return distance_array_.get(); }
 
     [[nodiscard]] inline RowID *GetIDs() const final { return id_array_.get(); }
@@ -281,11 +308,11 @@ private:
     bool begin_{false};
 };
 
-export template <typename DistType>
-using AnnIVFFlatL2 = AnnIVFFlat<CompareMax<DistType, RowID>, MetricType::kMetricL2, KnnDistanceAlgoType::kKnnFlatL2>;
+export template <typename DistType, typename VectorDataType = DistType>
+using AnnIVFFlatL2 = AnnIVFFlat<CompareMax<DistType, RowID>, MetricType::kMetricL2, KnnDistanceAlgoType::kKnnFlatL2, VectorDataType>;
 
-export template <typename DistType>
-using AnnIVFFlatIP = AnnIVFFlat<CompareMin<DistType, RowID>, MetricType::kMetricInnerProduct, KnnDistanceAlgoType::kKnnFlatIp>;
+export template <typename DistType, typename VectorDataType = DistType>
+using AnnIVFFlatIP = AnnIVFFlat<CompareMin<DistType, RowID>, MetricType::kMetricInnerProduct, KnnDistanceAlgoType::kKnnFlatIp, VectorDataType>;
 
 export template <typename DistType>
 using AnnIVFFlatCOS = AnnIVFFlat<CompareMin<DistType, RowID>, MetricType::kMetricCosine, KnnDistanceAlgoType::kKnnFlatCosine>;
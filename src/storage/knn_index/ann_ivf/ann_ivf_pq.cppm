@@ -0,0 +1,204 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+export module ann_ivf_pq;
+
+import stl;
+import knn_distance;
+
+import infinity_exception;
+import index_base;
+import annivfpq_index_data;
+import vector_distance;
+import search_top_k;
+import knn_result_handler;
+import bitmask;
+import knn_expr;
+import internal_types;
+import logger;
+
+namespace infinity {
+
+template <typename Compare, MetricType metric, KnnDistanceAlgoType algo>
+class AnnIVFPQ final : public KnnDistance<typename Compare::DistanceType> {
+    using DistType = typename Compare::DistanceType;
+    using ResultHandler = ReservoirResultHandler<Compare>;
+
+public:
+    explicit AnnIVFPQ(const DistType *queries, u64 query_count, u32 top_k, u32 dimension, EmbeddingDataType elem_data_type)
+        : KnnDistance<DistType>(algo, elem_data_type, query_count, dimension, top_k), queries_(queries) {
+        id_array_ = MakeUniqueForOverwrite<RowID[]>(top_k * query_count);
+        distance_array_ = MakeUniqueForOverwrite<DistType[]>(top_k * query_count);
+        result_handler_ = MakeUnique<ResultHandler>(query_count, top_k, distance_array_.get(), id_array_.get());
+    }
+
+    static UniquePtr<AnnIVFPQIndexData<DistType>>
+    CreateIndex(u32 dimension, u32 vector_count, const DistType *vectors_ptr, u32 partition_num, u32 subspace_num, u32 subspace_bits) {
+        auto index_data = MakeUnique<AnnIVFPQIndexData<DistType>>(metric, dimension, partition_num, subspace_num, subspace_bits);
+        index_data->BuildIndex(dimension, vector_count, vectors_ptr, vector_count, vectors_ptr);
+        return index_data;
+    }
+
+    void Begin() final {
+        if (begin_ || this->query_count_ == 0) {
+            return;
+        }
+        result_handler_->Begin();
+        begin_ = true;
+    }
+
+    void Search(const DistType *, u16, u32, u16) final {
+        String error_message = "Unsupported search function";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+
+    void Search(const DistType *, u16, u32, u16, Bitmask &) final {
+        String error_message = "Unsupported search function";
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+
+    void Search(const AnnIVFPQIndexData<DistType> *base_ivf, u32 segment_id, u32 n_probes) {
+        SearchInner(base_ivf, segment_id, n_probes, [](SegmentOffset) { return true; });
+    }
+
+    template <typename Filter>
+    void Search(const AnnIVFPQIndexData<DistType> *base_ivf, u32 segment_id, u32 n_probes, Filter &filter) {
+        SearchInner(base_ivf, segment_id, n_probes, [&](SegmentOffset segment_offset) { return filter(segment_offset); });
+    }
+
+    void End() final {
+        if (!begin_) {
+            return;
+        }
+        result_handler_->End();
+        begin_ = false;
+    }
+
+    void EndWithoutSort() {
+        if (!begin_) {
+            return;
+        }
+        result_handler_->EndWithoutSort();
+        begin_ = false;
+    }
+
+    // Skip the candidates not better than `bound`, e.g. the k-th distance already found in other segments.
+    void TightenThreshold(u64 query_idx, DistType bound) { result_handler_->TightenThreshold(query_idx, bound); }
+
+    [[nodiscard]] inline DistType *GetDistances() const final { return distance_array_.get(); }
+
+    [[nodiscard]] inline RowID *GetIDs() const final { return id_array_.get(); }
+
+    [[nodiscard]] inline DistType *GetDistanceByIdx(u64 idx) const final {
+        if (idx >= this->query_count_) {
+            String error_message = "Query index exceeds the limit";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        return distance_array_.get() + idx * this->top_k_;
+    }
+
+    [[nodiscard]] inline RowID *GetIDByIdx(u64 idx) const final {
+        if (idx >= this->query_count_) {
+            String error_message = "Query index exceeds the limit";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        return id_array_.get() + idx * this->top_k_;
+    }
+
+    [[nodiscard]] static constexpr DistType InvalidValue() { return Compare::InitialValue(); }
+
+    [[nodiscard]] static bool CompareDist(const DistType &a, const DistType &b) { return Compare::Compare(b, a); }
+
+private:
+    void SearchInner(const AnnIVFPQIndexData<DistType> *base_ivf, u32 segment_id, u32 n_probes, auto &&filter) {
+        // check metric type
+        if (base_ivf->metric_ != metric) {
+            String error_message = "Metric type is invalid";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        if (!begin_) {
+            String error_message = "IVFPQ isn't begin";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        n_probes = std::min(n_probes, base_ivf->partition_num_);
+        if ((n_probes == 0) || (base_ivf->data_num_ == 0)) {
+            return;
+        }
+        this->total_base_count_ += base_ivf->data_num_;
+        const u32 dimension = this->dimension_;
+        auto centroid_dists = MakeUniqueForOverwrite<DistType[]>(n_probes * this->query_count_);
+        auto centroid_ids = MakeUniqueForOverwrite<u32[]>(n_probes * this->query_count_);
+        search_top_k_with_dis(n_probes,
+                              dimension,
+                              this->query_count_,
+                              queries_,
+                              base_ivf->partition_num_,
+                              base_ivf->centroids_.data(),
+                              centroid_ids.get(),
+                              centroid_dists.get(),
+                              false);
+        auto table = MakeUniqueForOverwrite<DistType[]>(base_ivf->subspace_num_ * base_ivf->SubspaceCentroidNum());
+        auto residual = MakeUniqueForOverwrite<DistType[]>(dimension);
+        for (u64 i = 0; i < this->query_count_; i++) {
+            const DistType *x_i = queries_ + i * dimension;
+            if constexpr (metric == MetricType::kMetricInnerProduct) {
+                // <x, c + r> = <x, c> + <x, r>, the table of <x, r> is shared by all lists
+                base_ivf->ComputeDistanceTable(x_i, table.get());
+            }
+            auto add_result = [&](DistType distance, SegmentOffset segment_offset) {
+                if (filter(segment_offset)) {
+                    result_handler_->AddResult(i, distance, RowID(segment_id, segment_offset));
+                }
+            };
+            for (u32 k = 0; k < n_probes; ++k) {
+                const u32 selected_centroid = centroid_ids[k + i * n_probes];
+                const DistType *centroid = base_ivf->centroids_.data() + selected_centroid * dimension;
+                DistType bias = 0;
+                if constexpr (metric == MetricType::kMetricL2) {
+                    for (u32 d = 0; d < dimension; ++d) {
+                        residual[d] = x_i[d] - centroid[d];
+                    }
+                    base_ivf->ComputeDistanceTable(residual.get(), table.get());
+                } else {
+                    bias = IPDistance<DistType>(x_i, centroid, dimension);
+                }
+                base_ivf->ScanList(selected_centroid, table.get(), bias, add_result);
+            }
+        }
+    }
+
+    UniquePtr<RowID[]> id_array_{};
+    UniquePtr<DistType[]> distance_array_{};
+
+    UniquePtr<ResultHandler> result_handler_{};
+
+    const DistType *queries_{};
+    bool begin_{false};
+};
+
+export template <typename DistType>
+using AnnIVFPQL2 = AnnIVFPQ<CompareMax<DistType, RowID>, MetricType::kMetricL2, KnnDistanceAlgoType::kKnnFlatL2>;
+
+export template <typename DistType>
+using AnnIVFPQIP = AnnIVFPQ<CompareMin<DistType, RowID>, MetricType::kMetricInnerProduct, KnnDistanceAlgoType::kKnnFlatIp>;
+
+} // namespace infinity
@@ -26,12 +26,19 @@ import infinity_exception;
 import logger;
 import third_party;
 import status;
+import float16;
+import bfloat16;
+import scalar_quantization;
 
 namespace infinity {
 
 export template <typename CentroidsDataType, typename VectorDataType = CentroidsDataType>
 struct AnnIVFFlatIndexData {
-    using CommonType = std::common_type_t<VectorDataType, CentroidsDataType>;
+    // fp16, bf16 and int8 lists are encoded from input vectors of CentroidsDataType
+    static constexpr bool kQuantized =
+        std::is_same_v<VectorDataType, float16_t> || std::is_same_v<VectorDataType, bfloat16_t> || std::is_same_v<VectorDataType, u8>;
+    using InputType = std::conditional_t<kQuantized, CentroidsDataType, VectorDataType>;
+    using CommonType = std::common_type_t<InputType, CentroidsDataType>;
     bool loaded_{false};
     MetricType metric_{MetricType::kInvalid};
     u32 dimension_{};
@@ -40,6 +47,8 @@ struct AnnIVFFlatIndexData {
     Vector<CentroidsDataType> centroids_;
     Vector<Vector<u32>> ids_;
     Vector<Vector<VectorDataType>> vectors_;
+    // only used when VectorDataType is u8
+    SQ8Quantizer sq_;
 
     AnnIVFFlatIndexData() = default;
     AnnIVFFlatIndexData(MetricType metric, u32 dimension, u32 partition_num)
@@ -49,9 +58,9 @@ struct AnnIVFFlatIndexData {
     // used in benchmark because there is no deleted rows
     void BuildIndex(const u32 dimension,
                     const u32 train_count,
-                    const VectorDataType *train_ptr,
+                    const InputType *train_ptr,
                     const u32 vector_count,
-                    const VectorDataType *vectors_ptr,
+                    const InputType *vectors_ptr,
                     const u32 min_points_per_centroid = 32,
                     const u32 max_points_per_centroid = 256) {
         if (loaded_) {
@@ -127,7 +136,7 @@ struct AnnIVFFlatIndexData {
         // step 1. load input data
 
         // reserve space for vectors and ids
-        Vector<VectorDataType> segment_column_data;
+        Vector<InputType> segment_column_data;
         segment_column_data.reserve(full_row_count * dimension);
         // offset without deleted rows
         Vector<SegmentOffset> segment_offset;
@@ -145,7 +154,7 @@ struct AnnIVFFlatIndexData {
                 LOG_CRITICAL(error_message);
                 UnrecoverableError(error_message);
             }
-            auto &[val_ptr, offset] = pair_opt.value(); // val_ptr is const VectorDataType * type, offset is SegmentOffset type
+            auto &[val_ptr, offset] = pair_opt.value(); // val_ptr is const InputType * type, offset is SegmentOffset type
             // copy data of single embedding
             segment_column_data.insert(segment_column_data.end(), val_ptr, val_ptr + dimension);
             // copy offset of single embedding
@@ -171,7 +180,7 @@ struct AnnIVFFlatIndexData {
     }
 
     inline void TrainCentroids(const u32 vector_count,
-                               const VectorDataType *vector_data_ptr,
+                               const InputType *vector_data_ptr,
                                const u32 min_points_per_centroid,
                                const u32 max_points_per_centroid) {
         u32 iteration_max = 0;
@@ -198,9 +207,12 @@ struct AnnIVFFlatIndexData {
             LOG_TRACE(fmt::format("AnnIVFFlatIndexData::BuildIndex(): Update partition_num_ to %u", real_partition_num));
             partition_num_ = real_partition_num;
         }
+        if constexpr (std::is_same_v<VectorDataType, u8>) {
+            sq_.Train(dimension_, vector_count, vector_data_ptr);
+        }
     }
 
-    inline void InsertData(u32 vector_count, const VectorDataType *vector_data_ptr, auto &&get_offset) {
+    inline void InsertData(u32 vector_count, const InputType *vector_data_ptr, auto &&get_offset) {
         // step 1. Classify vectors
         // search_top_1
         auto assigned_partition_id = MakeUniqueForOverwrite<u32[]>(vector_count);
@@ -227,7 +239,18 @@ struct AnnIVFFlatIndexData {
         for (u32 i = 0; i < vector_count; ++i) {
             auto vector_pos_i = vector_data_ptr + i * dimension_;
             auto partition_of_i = assigned_partition_id[i];
-            vectors_[partition_of_i].insert(vectors_[partition_of_i].end(), vector_pos_i, vector_pos_i + dimension_);
+            auto &partition_vectors = vectors_[partition_of_i];
+            if constexpr (std::is_same_v<VectorDataType, u8>) {
+                const SizeT code_pos = partition_vectors.size();
+                partition_vectors.resize(code_pos + dimension_);
+                sq_.Encode(vector_pos_i, partition_vectors.data() + code_pos);
+            } else if constexpr (kQuantized) {
+                for (u32 d = 0; d < dimension_; ++d) {
+                    partition_vectors.push_back(VectorDataType(vector_pos_i[d]));
+                }
+            } else {
+                partition_vectors.insert(partition_vectors.end(), vector_pos_i, vector_pos_i + dimension_);
+            }
             ids_[partition_of_i].push_back(get_offset[i]);
         }
 
@@ -247,6 +270,10 @@ struct AnnIVFFlatIndexData {
         file_handler.Write(&data_num_, sizeof(data_num_));
         if (!centroids_.empty()) {
             file_handler.Write(centroids_.data(), sizeof(CentroidsDataType) * dimension_ * partition_num_);
+            if constexpr (std::is_same_v<VectorDataType, u8>) {
+                file_handler.Write(sq_.min_.data(), sizeof(f32) * dimension_);
+                file_handler.Write(sq_.step_.data(), sizeof(f32) * dimension_);
+            }
             u32 vector_element_num;
             for (u32 i = 0; i < partition_num_; ++i) {
                 vector_element_num = ids_[i].size();
@@ -277,6 +304,12 @@ struct AnnIVFFlatIndexData {
         ids_.resize(partition_num_);
         vectors_.resize(partition_num_);
         file_handler.Read(centroids_.data(), sizeof(CentroidsDataType) * dimension_ * partition_num_);
+        if constexpr (std::is_same_v<VectorDataType, u8>) {
+            sq_.min_.resize(dimension_);
+            sq_.step_.resize(dimension_);
+            file_handler.Read(sq_.min_.data(), sizeof(f32) * dimension_);
+            file_handler.Read(sq_.step_.data(), sizeof(f32) * dimension_);
+        }
         u32 vector_element_num;
         for (u32 i = 0; i < partition_num_; ++i) {
             file_handler.Read(&vector_element_num, sizeof(vector_element_num));
@@ -0,0 +1,499 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+#include <algorithm>
+#include <cmath>
+#include <simde/x86/ssse3.h>
+
+export module annivfpq_index_data;
+
+import stl;
+import index_base;
+import file_system;
+import file_system_type;
+import search_top_k;
+import kmeans_partition;
+import vector_distance;
+import infinity_exception;
+import logger;
+import third_party;
+import status;
+
+namespace infinity {
+
+// 4-bit codes are stored in blocks of IVFPQ_FAST_SCAN_BLOCK_SIZE vectors. In a block every subspace takes 16 bytes,
+// byte j keeps the code of vector j in the low nibble and the code of vector j + 16 in the high nibble.
+export constexpr u32 IVFPQ_FAST_SCAN_BLOCK_SIZE = 32;
+
+// Accumulate the u8 lookup table values of one 4-bit block, out[j] is the quantized distance of vector j in the block.
+export inline void IVFPQFastScanBlock(const u8 *codes, const u8 *lut, const u32 subspace_num, u16 *out) {
+    const __m128i low_mask = _mm_set1_epi8(0x0f);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    __m128i acc2 = _mm_setzero_si128();
+    __m128i acc3 = _mm_setzero_si128();
+    for (u32 m = 0; m < subspace_num; ++m, codes += 16, lut += 16) {
+        const __m128i code = _mm_loadu_si128(reinterpret_cast<const __m128i *>(codes));
+        const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lut));
+        const __m128i dist_lo = _mm_shuffle_epi8(table, _mm_and_si128(code, low_mask));
+        const __m128i dist_hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(code, 4), low_mask));
+        // saturate instead of wrap, an overflowed vector is just far away
+        acc0 = _mm_adds_epu16(acc0, _mm_unpacklo_epi8(dist_lo, zero));
+        acc1 = _mm_adds_epu16(acc1, _mm_unpackhi_epi8(dist_lo, zero));
+        acc2 = _mm_adds_epu16(acc2, _mm_unpacklo_epi8(dist_hi, zero));
+        acc3 = _mm_adds_epu16(acc3, _mm_unpackhi_epi8(dist_hi, zero));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), acc0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), acc1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), acc2);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 24), acc3);
+}
+
+// IVF index whose lists keep product quantized residuals (vector - centroid) instead of the raw vectors.
+// Each vector costs subspace_num_ * subspace_bits_ / 8 bytes of codes and a u32 id.
+export template <typename DataType>
+struct AnnIVFPQIndexData {
+    bool loaded_{false};
+    MetricType metric_{MetricType::kInvalid};
+    u32 dimension_{};
+    u32 partition_num_{};
+    u32 subspace_num_{};
+    u32 subspace_bits_{};
+    u32 data_num_{};
+    Vector<DataType> centroids_;
+    // subspace m, code k: subspace_centroids_[(m * SubspaceCentroidNum() + k) * SubspaceDimension()]
+    Vector<DataType> subspace_centroids_;
+    Vector<Vector<u32>> ids_;
+    Vector<Vector<u8>> codes_;
+
+    AnnIVFPQIndexData() = default;
+    AnnIVFPQIndexData(MetricType metric, u32 dimension, u32 partition_num, u32 subspace_num, u32 subspace_bits)
+        : metric_(metric), dimension_(dimension), partition_num_(partition_num), subspace_num_(subspace_num), subspace_bits_(subspace_bits) {}
+
+    [[nodiscard]] inline u32 SubspaceDimension() const { return dimension_ / subspace_num_; }
+
+    [[nodiscard]] inline u32 SubspaceCentroidNum() const { return 1u << subspace_bits_; }
+
+    [[nodiscard]] inline SizeT ListCodeSize(SizeT vector_count) const {
+        if (subspace_bits_ == 4) {
+            SizeT block_count = (vector_count + IVFPQ_FAST_SCAN_BLOCK_SIZE - 1) / IVFPQ_FAST_SCAN_BLOCK_SIZE;
+            return block_count * subspace_num_ * 16;
+        }
+        return vector_count * subspace_num_;
+    }
+
+    // use existing vectors for training and insert
+    // used in benchmark because there is no deleted rows
+    void BuildIndex(const u32 dimension,
+                    const u32 train_count,
+                    const DataType *train_ptr,
+                    const u32 vector_count,
+                    const DataType *vectors_ptr,
+                    const u32 min_points_per_centroid = 32,
+                    const u32 max_points_per_centroid = 256) {
+        if (!CheckBuild(dimension)) {
+            return;
+        }
+        if (vector_count == 0 or train_count == 0) {
+            LOG_TRACE("AnnIVFPQIndexData::BuildIndex(): Empty data, no need to build index");
+            loaded_ = true;
+            return;
+        }
+
+        // step 1. train centroids and subspace codebooks
+        TrainCentroids(train_count, train_ptr, min_points_per_centroid, max_points_per_centroid);
+        TrainSubspaceCentroids(train_count, train_ptr);
+
+        // step 2. encode and insert data to partitions
+        struct {
+            u32 operator[](u32 i) { return i; }
+        } get_id;
+        InsertData(vector_count, vectors_ptr, get_id);
+
+        loaded_ = true;
+    }
+
+    // use iter for both training and insert
+    // used when create index for a segment
+    void BuildIndex(auto &&iter,
+                    const u32 dimension,
+                    const u32 full_row_count,
+                    const u32 min_points_per_centroid = 32,
+                    const u32 max_points_per_centroid = 256) {
+        if (!CheckBuild(dimension)) {
+            return;
+        }
+
+        // step 1. load input data
+        Vector<DataType> segment_column_data;
+        segment_column_data.reserve(full_row_count * dimension);
+        Vector<SegmentOffset> segment_offset;
+        segment_offset.reserve(full_row_count);
+        u32 cnt = 0;
+        while (true) {
+            auto pair_opt = iter.Next();
+            if (!pair_opt) {
+                break;
+            }
+            if (cnt >= full_row_count) {
+                String error_message = "AnnIVFPQIndexData::BuildIndex(): segment row count more than expected.";
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+            auto &[val_ptr, offset] = pair_opt.value();
+            segment_column_data.insert(segment_column_data.end(), val_ptr, val_ptr + dimension);
+            segment_offset.push_back(offset);
+            ++cnt;
+        }
+        if (cnt < full_row_count) {
+            LOG_TRACE("AnnIVFPQIndexData::BuildIndex(): segment has deleted rows");
+        }
+        if (cnt == 0) {
+            loaded_ = true;
+            return;
+        }
+
+        // step 2. train centroids and subspace codebooks
+        TrainCentroids(cnt, segment_column_data.data(), min_points_per_centroid, max_points_per_centroid);
+        TrainSubspaceCentroids(cnt, segment_column_data.data());
+
+        // step 3. encode and insert data to partitions, will update data_num_
+        InsertData(cnt, segment_column_data.data(), segment_offset.data());
+
+        loaded_ = true;
+    }
+
+    inline void TrainCentroids(const u32 vector_count,
+                               const DataType *vector_data_ptr,
+                               const u32 min_points_per_centroid,
+                               const u32 max_points_per_centroid) {
+        if (partition_num_ != 0 and partition_num_ > vector_count) {
+            LOG_TRACE(fmt::format("AnnIVFPQIndexData::TrainCentroids(): partition_num_ = {} is more than vector_count = {}",
+                                  partition_num_,
+                                  vector_count));
+            partition_num_ = vector_count;
+        }
+        partition_num_ = GetKMeansCentroids<DataType>(metric_,
+                                                      dimension_,
+                                                      vector_count,
+                                                      vector_data_ptr,
+                                                      centroids_,
+                                                      partition_num_,
+                                                      0,
+                                                      min_points_per_centroid,
+                                                      max_points_per_centroid);
+    }
+
+    // Train one L2 codebook per subspace on the residuals of the training vectors.
+    inline void TrainSubspaceCentroids(const u32 vector_count, const DataType *vector_data_ptr) {
+        const u32 subspace_dimension = SubspaceDimension();
+        const u32 subspace_centroid_num = SubspaceCentroidNum();
+        auto residuals = ComputeResiduals(vector_count, vector_data_ptr);
+        subspace_centroids_.resize(subspace_num_ * subspace_centroid_num * subspace_dimension);
+        Vector<DataType> subspace_data(vector_count * subspace_dimension);
+        Vector<DataType> subspace_centroids;
+        for (u32 m = 0; m < subspace_num_; ++m) {
+            GatherSubspace(vector_count, residuals.get(), m, subspace_data.data());
+            const u32 train_centroid_num = std::min(subspace_centroid_num, vector_count);
+            const u32 real_centroid_num = GetKMeansCentroids<DataType>(MetricType::kMetricL2,
+                                                                       subspace_dimension,
+                                                                       vector_count,
+                                                                       subspace_data.data(),
+                                                                       subspace_centroids,
+                                                                       train_centroid_num,
+                                                                       0,
+                                                                       1,
+                                                                       256);
+            // too few training vectors, unused codes repeat the first centroid and are never assigned
+            DataType *output = subspace_centroids_.data() + m * subspace_centroid_num * subspace_dimension;
+            std::copy_n(subspace_centroids.data(), real_centroid_num * subspace_dimension, output);
+            for (u32 k = real_centroid_num; k < subspace_centroid_num; ++k) {
+                std::copy_n(subspace_centroids.data(), subspace_dimension, output + k * subspace_dimension);
+            }
+        }
+    }
+
+    inline void InsertData(u32 vector_count, const DataType *vector_data_ptr, auto &&get_offset) {
+        // step 1. Classify vectors
+        auto assigned_partition_id = MakeUniqueForOverwrite<u32[]>(vector_count);
+        search_top_1_without_dis<DataType>(dimension_, vector_count, vector_data_ptr, partition_num_, centroids_.data(), assigned_partition_id.get());
+
+        // step 2. Encode residuals, codes[i * subspace_num_ + m] is the code of vector i in subspace m
+        auto residuals = ComputeResiduals(vector_count, vector_data_ptr, assigned_partition_id.get());
+        const u32 subspace_dimension = SubspaceDimension();
+        const u32 subspace_centroid_num = SubspaceCentroidNum();
+        Vector<u8> codes(vector_count * subspace_num_);
+        {
+            Vector<DataType> subspace_data(vector_count * subspace_dimension);
+            auto labels = MakeUniqueForOverwrite<u32[]>(vector_count);
+            for (u32 m = 0; m < subspace_num_; ++m) {
+                GatherSubspace(vector_count, residuals.get(), m, subspace_data.data());
+                search_top_1_without_dis<DataType>(subspace_dimension,
+                                                   vector_count,
+                                                   subspace_data.data(),
+                                                   subspace_centroid_num,
+                                                   subspace_centroids_.data() + m * subspace_centroid_num * subspace_dimension,
+                                                   labels.get());
+                for (u32 i = 0; i < vector_count; ++i) {
+                    codes[i * subspace_num_ + m] = static_cast<u8>(labels[i]);
+                }
+            }
+        }
+
+        // step 3. Group vectors by partition
+        Vector<Vector<u32>> partition_members(partition_num_);
+        for (u32 i = 0; i < vector_count; ++i) {
+            partition_members[assigned_partition_id[i]].push_back(i);
+        }
+        ids_.resize(partition_num_);
+        codes_.resize(partition_num_);
+        for (u32 p = 0; p < partition_num_; ++p) {
+            const auto &members = partition_members[p];
+            ids_[p].reserve(members.size());
+            for (u32 i : members) {
+                ids_[p].push_back(get_offset[i]);
+            }
+            auto &list_codes = codes_[p];
+            list_codes.assign(ListCodeSize(members.size()), 0);
+            if (subspace_bits_ == 4) {
+                for (SizeT j = 0; j < members.size(); ++j) {
+                    const u8 *code = codes.data() + members[j] * subspace_num_;
+                    const SizeT block_id = j / IVFPQ_FAST_SCAN_BLOCK_SIZE;
+                    const SizeT in_block = j % IVFPQ_FAST_SCAN_BLOCK_SIZE;
+                    const u32 shift = in_block < 16 ? 0 : 4;
+                    u8 *block = list_codes.data() + block_id * subspace_num_ * 16;
+                    for (u32 m = 0; m < subspace_num_; ++m) {
+                        block[m * 16 + in_block % 16] |= code[m] << shift;
+                    }
+                }
+            } else {
+                for (SizeT j = 0; j < members.size(); ++j) {
+                    std::copy_n(codes.data() + members[j] * subspace_num_, subspace_num_, list_codes.data() + j * subspace_num_);
+                }
+            }
+        }
+
+        // step 4. Update data_num_
+        data_num_ += vector_count;
+    }
+
+    // Asymmetric distance table of a query against the codebooks: table[m * SubspaceCentroidNum() + k].
+    // For L2 query_ptr is the query minus the centroid of the scanned list, for inner product it is the query itself.
+    void ComputeDistanceTable(const DataType *query_ptr, DataType *table) const {
+        const u32 subspace_dimension = SubspaceDimension();
+        const u32 subspace_centroid_num = SubspaceCentroidNum();
+        const DataType *subspace_centroid = subspace_centroids_.data();
+        for (u32 m = 0; m < subspace_num_; ++m) {
+            const DataType *query_sub = query_ptr + m * subspace_dimension;
+            for (u32 k = 0; k < subspace_centroid_num; ++k, subspace_centroid += subspace_dimension) {
+                if (metric_ == MetricType::kMetricL2) {
+                    table[m * subspace_centroid_num + k] = L2Distance<DataType>(query_sub, subspace_centroid, subspace_dimension);
+                } else {
+                    table[m * subspace_centroid_num + k] = IPDistance<DataType>(query_sub, subspace_centroid, subspace_dimension);
+                }
+            }
+        }
+    }
+
+    // Scan all vectors of a list with the distance table, add_result(distance, segment_offset) is called for each of them.
+    // bias is added to every distance, it is the query-centroid inner product for the inner product metric.
+    void ScanList(u32 partition_id, const DataType *table, DataType bias, auto &&add_result) const {
+        const auto &ids = ids_[partition_id];
+        const u8 *codes = codes_[partition_id].data();
+        const SizeT vector_count = ids.size();
+        if (subspace_bits_ == 4) {
+            // quantize the table to u8 so that 16 entries of a subspace fit in one shuffle register
+            DataType table_min_sum = 0;
+            DataType max_span = 0;
+            for (u32 m = 0; m < subspace_num_; ++m) {
+                const auto [min_it, max_it] = std::minmax_element(table + m * 16, table + m * 16 + 16);
+                table_min_sum += *min_it;
+                max_span = std::max(max_span, *max_it - *min_it);
+            }
+            const DataType scale = max_span > 0 ? DataType(255) / max_span : DataType(0);
+            const DataType inv_scale = max_span > 0 ? max_span / DataType(255) : DataType(0);
+            auto lut = MakeUniqueForOverwrite<u8[]>(subspace_num_ * 16);
+            for (u32 m = 0; m < subspace_num_; ++m) {
+                const DataType table_min = *std::min_element(table + m * 16, table + m * 16 + 16);
+                for (u32 k = 0; k < 16; ++k) {
+                    lut[m * 16 + k] = static_cast<u8>(std::lround((table[m * 16 + k] - table_min) * scale));
+                }
+            }
+            u16 block_dists[IVFPQ_FAST_SCAN_BLOCK_SIZE];
+            for (SizeT block_begin = 0; block_begin < vector_count; block_begin += IVFPQ_FAST_SCAN_BLOCK_SIZE) {
+                IVFPQFastScanBlock(codes, lut.get(), subspace_num_, block_dists);
+                codes += subspace_num_ * 16;
+                const SizeT block_end = std::min(block_begin + IVFPQ_FAST_SCAN_BLOCK_SIZE, vector_count);
+                for (SizeT j = block_begin; j < block_end; ++j) {
+                    add_result(bias + table_min_sum + block_dists[j - block_begin] * inv_scale, ids[j]);
+                }
+            }
+        } else {
+            const u32 subspace_centroid_num = SubspaceCentroidNum();
+            for (SizeT j = 0; j < vector_count; ++j, codes += subspace_num_) {
+                DataType distance = bias;
+                for (u32 m = 0; m < subspace_num_; ++m) {
+                    distance += table[m * subspace_centroid_num + codes[m]];
+                }
+                add_result(distance, ids[j]);
+            }
+        }
+    }
+
+    void SaveIndexInner(FileHandler &file_handler) {
+        if (!loaded_) {
+            String error_message = "AnnIVFPQIndexData::SaveIndexInner(): Index data not loaded.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        file_handler.Write(&metric_, sizeof(metric_));
+        file_handler.Write(&dimension_, sizeof(dimension_));
+        file_handler.Write(&partition_num_, sizeof(partition_num_));
+        file_handler.Write(&subspace_num_, sizeof(subspace_num_));
+        file_handler.Write(&subspace_bits_, sizeof(subspace_bits_));
+        file_handler.Write(&data_num_, sizeof(data_num_));
+        if (!centroids_.empty()) {
+            file_handler.Write(centroids_.data(), sizeof(DataType) * dimension_ * partition_num_);
+            file_handler.Write(subspace_centroids_.data(), sizeof(DataType) * subspace_centroids_.size());
+            u32 vector_element_num;
+            for (u32 i = 0; i < partition_num_; ++i) {
+                vector_element_num = ids_[i].size();
+                file_handler.Write(&vector_element_num, sizeof(vector_element_num));
+                file_handler.Write(ids_[i].data(), sizeof(u32) * vector_element_num);
+                file_handler.Write(codes_[i].data(), codes_[i].size());
+            }
+        }
+    }
+
+    void SaveIndex(const String &file_path, UniquePtr<FileSystem> fs) {
+        u8 file_flags = FileFlags::WRITE_FLAG | FileFlags::CREATE_FLAG;
+        auto [file_handler, status] = fs->OpenFile(file_path, file_flags, FileLockType::kWriteLock);
+        if (!status.ok()) {
+            LOG_CRITICAL(status.message());
+            UnrecoverableError(status.message());
+        }
+        SaveIndexInner(*file_handler);
+        file_handler->Close();
+    }
+
+    void ReadIndexInner(FileHandler &file_handler) {
+        file_handler.Read(&metric_, sizeof(metric_));
+        file_handler.Read(&dimension_, sizeof(dimension_));
+        file_handler.Read(&partition_num_, sizeof(partition_num_));
+        file_handler.Read(&subspace_num_, sizeof(subspace_num_));
+        file_handler.Read(&subspace_bits_, sizeof(subspace_bits_));
+        file_handler.Read(&data_num_, sizeof(data_num_));
+        if (data_num_ != 0) {
+            centroids_.resize(dimension_ * partition_num_);
+            file_handler.Read(centroids_.data(), sizeof(DataType) * dimension_ * partition_num_);
+            subspace_centroids_.resize(subspace_num_ * SubspaceCentroidNum() * SubspaceDimension());
+            file_handler.Read(subspace_centroids_.data(), sizeof(DataType) * subspace_centroids_.size());
+            ids_.resize(partition_num_);
+            codes_.resize(partition_num_);
+            u32 vector_element_num;
+            for (u32 i = 0; i < partition_num_; ++i) {
+                file_handler.Read(&vector_element_num, sizeof(vector_element_num));
+                ids_[i].resize(vector_element_num);
+                file_handler.Read(ids_[i].data(), sizeof(u32) * vector_element_num);
+                codes_[i].resize(ListCodeSize(vector_element_num));
+                file_handler.Read(codes_[i].data(), codes_[i].size());
+            }
+        }
+        loaded_ = true;
+    }
+
+    static UniquePtr<AnnIVFPQIndexData<DataType>> LoadIndexInner(FileHandler &file_handler) {
+        auto index_data = MakeUnique<AnnIVFPQIndexData<DataType>>();
+        index_data->ReadIndexInner(file_handler);
+        return index_data;
+    }
+
+    static UniquePtr<AnnIVFPQIndexData<DataType>> LoadIndex(const String &file_path, UniquePtr<FileSystem> fs) {
+        u8 file_flags = FileFlags::READ_FLAG;
+        auto [file_handler, status] = fs->OpenFile(file_path, file_flags, FileLockType::kReadLock);
+        if (!status.ok()) {
+            LOG_CRITICAL(status.message());
+            UnrecoverableError(status.message());
+        }
+        auto index_data = LoadIndexInner(*file_handler);
+        file_handler->Close();
+        return index_data;
+    }
+
+private:
+    bool CheckBuild(const u32 dimension) {
+        if (loaded_) {
+            String error_message = "AnnIVFPQIndexData::BuildIndex(): Index data already exists.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        if (dimension != dimension_) {
+            String error_message = "Dimension not match";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        if (metric_ != MetricType::kMetricL2 && metric_ != MetricType::kMetricInnerProduct) {
+            Status status = Status::NotSupport("Metric type not supported");
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+            return false;
+        }
+        if (subspace_num_ == 0 || dimension_ % subspace_num_ != 0) {
+            Status status = Status::InvalidIndexParam("pq_subspace_num");
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+            return false;
+        }
+        if (subspace_bits_ != 4 && subspace_bits_ != 8) {
+            Status status = Status::InvalidIndexParam("pq_subspace_bits");
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+            return false;
+        }
+        return true;
+    }
+
+    // Residuals to the nearest centroid, or to the given assigned centroids.
+    UniquePtr<DataType[]>
+    ComputeResiduals(const u32 vector_count, const DataType *vector_data_ptr, const u32 *assigned_partition_id = nullptr) const {
+        UniquePtr<u32[]> assigned_holder;
+        if (assigned_partition_id == nullptr) {
+            assigned_holder = MakeUniqueForOverwrite<u32[]>(vector_count);
+            search_top_1_without_dis<DataType>(dimension_, vector_count, vector_data_ptr, partition_num_, centroids_.data(), assigned_holder.get());
+            assigned_partition_id = assigned_holder.get();
+        }
+        auto residuals = MakeUniqueForOverwrite<DataType[]>(static_cast<SizeT>(vector_count) * dimension_);
+        for (u32 i = 0; i < vector_count; ++i) {
+            const DataType *x = vector_data_ptr + static_cast<SizeT>(i) * dimension_;
+            const DataType *c = centroids_.data() + static_cast<SizeT>(assigned_partition_id[i]) * dimension_;
+            DataType *r = residuals.get() + static_cast<SizeT>(i) * dimension_;
+            for (u32 d = 0; d < dimension_; ++d) {
+                r[d] = x[d] - c[d];
+            }
+        }
+        return residuals;
+    }
+
+    void GatherSubspace(const u32 vector_count, const DataType *vectors, const u32 m, DataType *output) const {
+        const u32 subspace_dimension = SubspaceDimension();
+        for (u32 i = 0; i < vector_count; ++i) {
+            std::copy_n(vectors + static_cast<SizeT>(i) * dimension_ + m * subspace_dimension, subspace_dimension, output + i * subspace_dimension);
+        }
+    }
+};
+
+} // namespace infinity
@@ -0,0 +1,170 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+export module scalar_quantization;
+
+import stl;
+import float16;
+import bfloat16;
+
+// Distances between a f32 query and scalar quantized vectors. The stored vectors are widened to f32 in registers,
+// so a scan reads 2 (fp16, bf16) or 4 (int8) times fewer bytes than the f32 vectors.
+
+namespace infinity {
+
+// Per-dimension affine quantizer of the int8 storage: x[d] ~= min_[d] + step_[d] * code[d], code in [0, 255].
+export struct SQ8Quantizer {
+    Vector<f32> min_;
+    Vector<f32> step_;
+
+    void Train(const u32 dimension, const SizeT vector_count, const f32 *vectors) {
+        min_.assign(dimension, std::numeric_limits<f32>::max());
+        Vector<f32> max(dimension, std::numeric_limits<f32>::lowest());
+        for (SizeT i = 0; i < vector_count; ++i) {
+            const f32 *v = vectors + i * dimension;
+            for (u32 d = 0; d < dimension; ++d) {
+                min_[d] = std::min(min_[d], v[d]);
+                max[d] = std::max(max[d], v[d]);
+            }
+        }
+        step_.resize(dimension);
+        for (u32 d = 0; d < dimension; ++d) {
+            if (vector_count == 0) {
+                min_[d] = 0;
+                max[d] = 0;
+            }
+            step_[d] = (max[d] - min_[d]) / 255.0f;
+        }
+    }
+
+    void Encode(const f32 *vector, u8 *code) const {
+        const SizeT dimension = min_.size();
+        for (SizeT d = 0; d < dimension; ++d) {
+            const f32 c = step_[d] > 0 ? std::round((vector[d] - min_[d]) / step_[d]) : 0.0f;
+            code[d] = static_cast<u8>(std::clamp(c, 0.0f, 255.0f));
+        }
+    }
+};
+
+#if defined(__AVX2__) && defined(__F16C__) && defined(__FMA__)
+
+inline f32 HorizontalSum256(__m256 x) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+inline __m256 Load8(const float16_t *y) { return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y))); }
+
+inline __m256 Load8(const bfloat16_t *y) {
+    const __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16));
+}
+
+inline __m256 Load8(const u8 *code, const f32 *min, const f32 *step) {
+    const __m256 c = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(code))));
+    return _mm256_fmadd_ps(c, _mm256_loadu_ps(step), _mm256_loadu_ps(min));
+}
+
+#endif
+
+export template <typename HalfType>
+    requires std::is_same_v<HalfType, float16_t> || std::is_same_v<HalfType, bfloat16_t>
+f32 L2DistanceSQ(const f32 *x, const HalfType *y, const SizeT dimension) {
+    SizeT i = 0;
+    f32 distance = 0;
+#if defined(__AVX2__) && defined(__F16C__) && defined(__FMA__)
+    __m256 sum = _mm256_setzero_ps();
+    for (; i + 8 <= dimension; i += 8) {
+        const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x + i), Load8(y + i));
+        sum = _mm256_fmadd_ps(diff, diff, sum);
+    }
+    distance = HorizontalSum256(sum);
+#endif
+    for (; i < dimension; ++i) {
+        const f32 diff = x[i] - f32(y[i]);
+        distance += diff * diff;
+    }
+    return distance;
+}
+
+export template <typename HalfType>
+    requires std::is_same_v<HalfType, float16_t> || std::is_same_v<HalfType, bfloat16_t>
+f32 IPDistanceSQ(const f32 *x, const HalfType *y, const SizeT dimension) {
+    SizeT i = 0;
+    f32 distance = 0;
+#if defined(__AVX2__) && defined(__F16C__) && defined(__FMA__)
+    __m256 sum = _mm256_setzero_ps();
+    for (; i + 8 <= dimension; i += 8) {
+        sum = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), Load8(y + i), sum);
+    }
+    distance = HorizontalSum256(sum);
+#endif
+    for (; i < dimension; ++i) {
+        distance += x[i] * f32(y[i]);
+    }
+    return distance;
+}
+
+export f32 L2DistanceSQ8(const f32 *x, const u8 *code, const SQ8Quantizer &quantizer, const SizeT dimension) {
+    const f32 *min = quantizer.min_.data();
+    const f32 *step = quantizer.step_.data();
+    SizeT i = 0;
+    f32 distance = 0;
+#if defined(__AVX2__) && defined(__F16C__) && defined(__FMA__)
+    __m256 sum = _mm256_setzero_ps();
+    for (; i + 8 <= dimension; i += 8) {
+        const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x + i), Load8(code + i, min + i, step + i));
+        sum = _mm256_fmadd_ps(diff, diff, sum);
+    }
+    distance = HorizontalSum256(sum);
+#endif
+    for (; i < dimension; ++i) {
+        const f32 diff = x[i] - (min[i] + step[i] * code[i]);
+        distance += diff * diff;
+    }
+    return distance;
+}
+
+export f32 IPDistanceSQ8(const f32 *x, const u8 *code, const SQ8Quantizer &quantizer, const SizeT dimension) {
+    const f32 *min = quantizer.min_.data();
+    const f32 *step = quantizer.step_.data();
+    SizeT i = 0;
+    f32 distance = 0;
+#if defined(__AVX2__) && defined(__F16C__) && defined(__FMA__)
+    __m256 sum = _mm256_setzero_ps();
+    for (; i + 8 <= dimension; i += 8) {
+        sum = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), Load8(code + i, min + i, step + i), sum);
+    }
+    distance = HorizontalSum256(sum);
+#endif
+    for (; i < dimension; ++i) {
+        distance += x[i] * (min[i] + step[i] * code[i]);
+    }
+    return distance;
+}
+
+} // namespace infinity
@@ -35,6 +35,20 @@ DiffType L2Distance(const ElemType1 *vector1, const ElemType2 *vector2, const Di
     }
 }
 
+// L2Distance abandoned once the partial sum reaches `bound`, the result is exact if it is less than `bound`.
+export template <typename DiffType, typename ElemType1, typename ElemType2, typename DimType = u32>
+DiffType L2DistanceBounded(const ElemType1 *vector1, const ElemType2 *vector2, const DimType dimension, const DiffType bound) {
+    constexpr DimType step = 64;
+    DiffType distance{};
+    for (DimType i = 0; i < dimension; i += step) {
+        distance += L2Distance<DiffType, ElemType1, ElemType2, DimType>(vector1 + i, vector2 + i, std::min(step, dimension - i));
+        if (distance >= bound) {
+            break;
+        }
+    }
+    return distance;
+}
+
 export template <typename DiffType, typename ElemType1, typename ElemType2, typename DimType = u32>
 DiffType CosineDistance(const ElemType1 *vector1, const ElemType2 *vector2, const DimType dimension) {
     if constexpr (std::is_same_v<ElemType1, f32> && std::is_same_v<ElemType2, f32>) {
@@ -0,0 +1,645 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+module;
+
+#include <algorithm>
+#include <random>
+
+export module diskann_index_data;
+
+import stl;
+import index_base;
+import file_system;
+import file_system_type;
+import local_file_system;
+import search_top_k;
+import kmeans_partition;
+import vector_distance;
+import infinity_exception;
+import logger;
+import third_party;
+import status;
+import utility;
+
+namespace infinity {
+
+// Node records are packed into sectors and only straddle a sector boundary when one record is larger than a sector,
+// so every node is fetched with one sector aligned read.
+export constexpr SizeT DISKANN_SECTOR_SIZE = 4096;
+
+// The vectors kept in memory are product quantized with 8-bit codes.
+export constexpr u32 DISKANN_PQ_CENTROID_NUM = 256;
+
+// Most nodes inserted into the graph together by a parallel build.
+export constexpr SizeT DISKANN_BUILD_MAX_BATCH = 1024;
+
+// Sorted candidate list of a greedy graph search, keeps at most capacity_ closest nodes.
+class DiskAnnCandidatePool {
+public:
+    explicit DiskAnnCandidatePool(SizeT capacity) : capacity_(capacity) { candidates_.reserve(capacity + 1); }
+
+    void Insert(f32 distance, u32 id) {
+        if (candidates_.size() == capacity_ && distance >= candidates_.back().distance_) {
+            return;
+        }
+        auto pos = std::upper_bound(candidates_.begin(), candidates_.end(), distance, [](f32 d, const Candidate &c) { return d < c.distance_; });
+        SizeT idx = pos - candidates_.begin();
+        candidates_.insert(pos, Candidate{distance, id, false});
+        if (candidates_.size() > capacity_) {
+            candidates_.pop_back();
+        }
+        next_ = std::min(next_, idx);
+    }
+
+    // Mark at most count closest unexpanded candidates as expanded and append their ids to ids.
+    void PopUnexpanded(SizeT count, Vector<u32> &ids) {
+        for (SizeT i = next_; i < candidates_.size() && ids.size() < count; ++i) {
+            if (!candidates_[i].expanded_) {
+                candidates_[i].expanded_ = true;
+                ids.push_back(candidates_[i].id_);
+            }
+        }
+        while (next_ < candidates_.size() && candidates_[next_].expanded_) {
+            ++next_;
+        }
+    }
+
+private:
+    struct Candidate {
+        f32 distance_;
+        u32 id_;
+        bool expanded_;
+    };
+
+    const SizeT capacity_;
+    Vector<Candidate> candidates_;
+    // no candidate before next_ is unexpanded
+    SizeT next_{0};
+};
+
+// Single layer Vamana graph of a segment. The graph and the full precision vectors are kept in sector aligned node records
+// which are read from the index file on demand, only the PQ codes and the labels stay in memory.
+export template <typename DataType>
+struct DiskAnnIndexData {
+    bool loaded_{false};
+    MetricType metric_{MetricType::kInvalid};
+    u32 dimension_{};
+    // R, the maximum out degree of a node
+    u32 max_degree_{};
+    // L, the candidate list size of the searches run while building
+    u32 build_list_size_{};
+    f32 alpha_{};
+    u32 subspace_num_{};
+    u32 data_num_{};
+    // entry node of every search
+    u32 medoid_{};
+    Vector<SegmentOffset> ids_;
+    // pq_centroids_[(m * DISKANN_PQ_CENTROID_NUM + k) * SubspaceDimension() + d]
+    Vector<DataType> pq_centroids_;
+    // pq_codes_[i * subspace_num_ + m] is the code of node i in subspace m
+    Vector<u8> pq_codes_;
+    // Node record i is [DataType vector[dimension_]][u32 degree][u32 neighbors[max_degree_]] at NodeOffset(i).
+    // The records are resident after a build or a full read, and empty when the index is read in place from the file.
+    Vector<char> nodes_;
+    UniquePtr<LocalFileSystem> node_fs_;
+    UniquePtr<FileHandler> node_file_;
+    i64 node_file_offset_{};
+
+    DiskAnnIndexData() = default;
+    DiskAnnIndexData(MetricType metric, u32 dimension, u32 max_degree, u32 build_list_size, f32 alpha, u32 subspace_num)
+        : metric_(metric), dimension_(dimension), max_degree_(max_degree), build_list_size_(build_list_size), alpha_(alpha),
+          subspace_num_(subspace_num) {}
+
+    [[nodiscard]] inline u32 SubspaceDimension() const { return dimension_ / subspace_num_; }
+
+    [[nodiscard]] inline SizeT NodeSize() const { return sizeof(DataType) * dimension_ + sizeof(u32) * (1 + max_degree_); }
+
+    // 0 if a node record is larger than a sector
+    [[nodiscard]] inline SizeT NodesPerSector() const { return DISKANN_SECTOR_SIZE / NodeSize(); }
+
+    // bytes read to fetch one node record
+    [[nodiscard]] inline SizeT NodeReadSize() const {
+        if (NodesPerSector() > 0) {
+            return DISKANN_SECTOR_SIZE;
+        }
+        return (NodeSize() + DISKANN_SECTOR_SIZE - 1) / DISKANN_SECTOR_SIZE * DISKANN_SECTOR_SIZE;
+    }
+
+    [[nodiscard]] inline SizeT NodeOffset(u32 node_id) const {
+        const SizeT nodes_per_sector = NodesPerSector();
+        if (nodes_per_sector > 0) {
+            return node_id / nodes_per_sector * DISKANN_SECTOR_SIZE + node_id % nodes_per_sector * NodeSize();
+        }
+        return node_id * NodeReadSize();
+    }
+
+    [[nodiscard]] inline SizeT NodesByteSize() const {
+        const SizeT nodes_per_sector = NodesPerSector();
+        if (nodes_per_sector > 0) {
+            return (data_num_ + nodes_per_sector - 1) / nodes_per_sector * DISKANN_SECTOR_SIZE;
+        }
+        return data_num_ * NodeReadSize();
+    }
+
+    // use existing vectors, the labels are the positions of the vectors. The graph is built on worker_count threads, the calling thread
+    // and worker_count - 1 scheduler workers the caller has reserved with TaskScheduler::ReserveExtraWorkers for the build.
+    void BuildIndex(const u32 dimension, const u32 vector_count, const DataType *vectors_ptr, SizeT worker_count = 1) {
+        if (!CheckBuild(dimension)) {
+            return;
+        }
+        Vector<SegmentOffset> segment_offset(vector_count);
+        std::iota(segment_offset.begin(), segment_offset.end(), 0);
+        BuildInner(vector_count, vectors_ptr, std::move(segment_offset), worker_count);
+    }
+
+    // used when create index for a segment, worker_count as above
+    void BuildIndex(auto &&iter, const u32 dimension, const u32 full_row_count, SizeT worker_count = 1) {
+        if (!CheckBuild(dimension)) {
+            return;
+        }
+        Vector<DataType> segment_column_data;
+        segment_column_data.reserve(full_row_count * dimension);
+        Vector<SegmentOffset> segment_offset;
+        segment_offset.reserve(full_row_count);
+        u32 cnt = 0;
+        while (true) {
+            auto pair_opt = iter.Next();
+            if (!pair_opt) {
+                break;
+            }
+            if (cnt >= full_row_count) {
+                String error_message = "DiskAnnIndexData::BuildIndex(): segment row count more than expected.";
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+            auto &[val_ptr, offset] = pair_opt.value();
+            segment_column_data.insert(segment_column_data.end(), val_ptr, val_ptr + dimension);
+            segment_offset.push_back(offset);
+            ++cnt;
+        }
+        if (cnt < full_row_count) {
+            LOG_TRACE("DiskAnnIndexData::BuildIndex(): segment has deleted rows");
+        }
+        BuildInner(cnt, segment_column_data.data(), std::move(segment_offset), worker_count);
+    }
+
+    // Beam search guided by the PQ distances. Each round reads the records of the beam_width closest unexpanded candidates,
+    // add_result(distance, segment_offset) is called with the full precision distance of every read node.
+    void Search(const DataType *query, u32 search_list_size, u32 beam_width, auto &&add_result) const {
+        if (data_num_ == 0) {
+            return;
+        }
+        search_list_size = std::max(search_list_size, 1u);
+        beam_width = std::max(beam_width, 1u);
+        auto table = MakeUniqueForOverwrite<DataType[]>(subspace_num_ * DISKANN_PQ_CENTROID_NUM);
+        ComputeDistanceTable(query, table.get());
+        auto approx_distance = [&](u32 node_id) {
+            const u8 *code = pq_codes_.data() + static_cast<SizeT>(node_id) * subspace_num_;
+            DataType distance = 0;
+            for (u32 m = 0; m < subspace_num_; ++m) {
+                distance += table[m * DISKANN_PQ_CENTROID_NUM + code[m]];
+            }
+            // the pool keeps the smallest distances
+            return metric_ == MetricType::kMetricL2 ? distance : -distance;
+        };
+
+        DiskAnnCandidatePool pool(search_list_size);
+        HashSet<u32> seen;
+        pool.Insert(approx_distance(medoid_), medoid_);
+        seen.insert(medoid_);
+        Vector<u32> beam;
+        beam.reserve(beam_width);
+        Vector<const char *> records(beam_width);
+        auto read_buffer = MakeUniqueForOverwrite<char[]>(beam_width * NodeReadSize());
+        while (true) {
+            beam.clear();
+            pool.PopUnexpanded(beam_width, beam);
+            if (beam.empty()) {
+                break;
+            }
+            ReadNodes(beam, read_buffer.get(), records);
+            for (SizeT k = 0; k < beam.size(); ++k) {
+                const auto *vector = reinterpret_cast<const DataType *>(records[k]);
+                if (metric_ == MetricType::kMetricL2) {
+                    add_result(L2Distance<DataType>(query, vector, dimension_), ids_[beam[k]]);
+                } else {
+                    add_result(IPDistance<DataType>(query, vector, dimension_), ids_[beam[k]]);
+                }
+                const auto *degree = reinterpret_cast<const u32 *>(vector + dimension_);
+                const u32 *neighbors = degree + 1;
+                for (u32 j = 0; j < *degree; ++j) {
+                    if (seen.insert(neighbors[j]).second) {
+                        pool.Insert(approx_distance(neighbors[j]), neighbors[j]);
+                    }
+                }
+            }
+        }
+    }
+
+    void SaveIndexInner(FileHandler &file_handler) {
+        if (!loaded_) {
+            String error_message = "DiskAnnIndexData::SaveIndexInner(): Index data not loaded.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        file_handler.Write(&metric_, sizeof(metric_));
+        file_handler.Write(&dimension_, sizeof(dimension_));
+        file_handler.Write(&max_degree_, sizeof(max_degree_));
+        file_handler.Write(&build_list_size_, sizeof(build_list_size_));
+        file_handler.Write(&alpha_, sizeof(alpha_));
+        file_handler.Write(&subspace_num_, sizeof(subspace_num_));
+        file_handler.Write(&data_num_, sizeof(data_num_));
+        file_handler.Write(&medoid_, sizeof(medoid_));
+        if (data_num_ == 0) {
+            return;
+        }
+        file_handler.Write(ids_.data(), sizeof(SegmentOffset) * data_num_);
+        file_handler.Write(pq_centroids_.data(), sizeof(DataType) * pq_centroids_.size());
+        file_handler.Write(pq_codes_.data(), pq_codes_.size());
+        // the node records start at a sector boundary
+        Vector<char> padding(NodeFileOffset() - MemoryPartSize(), 0);
+        file_handler.Write(padding.data(), padding.size());
+        if (!nodes_.empty()) {
+            file_handler.Write(nodes_.data(), nodes_.size());
+            return;
+        }
+        // read in place, copy the records from the index file
+        Vector<char> buffer(DISKANN_SECTOR_SIZE * 256);
+        const SizeT nodes_byte_size = NodesByteSize();
+        for (SizeT offset = 0; offset < nodes_byte_size; offset += buffer.size()) {
+            const SizeT size = std::min(buffer.size(), nodes_byte_size - offset);
+            node_fs_->ReadAt(*node_file_, node_file_offset_ + offset, buffer.data(), size);
+            file_handler.Write(buffer.data(), size);
+        }
+    }
+
+    void SaveIndex(const String &file_path, UniquePtr<FileSystem> fs) {
+        u8 file_flags = FileFlags::WRITE_FLAG | FileFlags::CREATE_FLAG;
+        auto [file_handler, status] = fs->OpenFile(file_path, file_flags, FileLockType::kWriteLock);
+        if (!status.ok()) {
+            LOG_CRITICAL(status.message());
+            UnrecoverableError(status.message());
+        }
+        SaveIndexInner(*file_handler);
+        file_handler->Close();
+    }
+
+    // Read the whole index, the node records become resident.
+    void ReadIndexInner(FileHandler &file_handler) {
+        ReadMemoryPart(file_handler);
+        if (data_num_ != 0) {
+            Vector<char> padding(NodeFileOffset() - MemoryPartSize());
+            file_handler.Read(padding.data(), padding.size());
+            nodes_.resize(NodesByteSize());
+            file_handler.Read(nodes_.data(), nodes_.size());
+        }
+        loaded_ = true;
+    }
+
+    // Read the PQ codes and the labels only, the node records are read from the file when searched.
+    void ReadIndexInPlace(const String &file_path) {
+        node_fs_ = MakeUnique<LocalFileSystem>();
+        auto [file_handler, status] = node_fs_->OpenFile(file_path, FileFlags::READ_FLAG, FileLockType::kReadLock);
+        if (!status.ok()) {
+            LOG_CRITICAL(status.message());
+            UnrecoverableError(status.message());
+        }
+        node_file_ = std::move(file_handler);
+        ReadMemoryPart(*node_file_);
+        node_file_offset_ = NodeFileOffset();
+        loaded_ = true;
+    }
+
+    static UniquePtr<DiskAnnIndexData<DataType>> LoadIndexInner(FileHandler &file_handler) {
+        auto index_data = MakeUnique<DiskAnnIndexData<DataType>>();
+        index_data->ReadIndexInner(file_handler);
+        return index_data;
+    }
+
+    static UniquePtr<DiskAnnIndexData<DataType>> LoadIndex(const String &file_path, UniquePtr<FileSystem> fs) {
+        u8 file_flags = FileFlags::READ_FLAG;
+        auto [file_handler, status] = fs->OpenFile(file_path, file_flags, FileLockType::kReadLock);
+        if (!status.ok()) {
+            LOG_CRITICAL(status.message());
+            UnrecoverableError(status.message());
+        }
+        auto index_data = LoadIndexInner(*file_handler);
+        file_handler->Close();
+        return index_data;
+    }
+
+private:
+    bool CheckBuild(const u32 dimension) {
+        if (loaded_) {
+            String error_message = "DiskAnnIndexData::BuildIndex(): Index data already exists.";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        if (dimension != dimension_) {
+            String error_message = "Dimension not match";
+            LOG_CRITICAL(error_message);
+            UnrecoverableError(error_message);
+        }
+        if (metric_ != MetricType::kMetricL2 && metric_ != MetricType::kMetricInnerProduct) {
+            Status status = Status::NotSupport("Metric type not supported");
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+            return false;
+        }
+        if (subspace_num_ == 0 || dimension_ % subspace_num_ != 0) {
+            Status status = Status::InvalidIndexParam("pq_subspace_num");
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+            return false;
+        }
+        if (max_degree_ == 0 || build_list_size_ == 0 || alpha_ < 1.0f) {
+            Status status = Status::InvalidIndexParam("R, L or alpha");
+            LOG_ERROR(status.message());
+            RecoverableError(status);
+            return false;
+        }
+        return true;
+    }
+
+    void BuildInner(const u32 vector_count, const DataType *vectors, Vector<SegmentOffset> segment_offset, SizeT worker_count) {
+        data_num_ = vector_count;
+        ids_ = std::move(segment_offset);
+        if (vector_count == 0) {
+            LOG_TRACE("DiskAnnIndexData::BuildIndex(): Empty data, no need to build index");
+            loaded_ = true;
+            return;
+        }
+        TrainAndEncodePQ(vectors);
+        Vector<Vector<u32>> graph = BuildGraph(vectors, worker_count);
+        nodes_.assign(NodesByteSize(), 0);
+        for (u32 i = 0; i < data_num_; ++i) {
+            char *record = nodes_.data() + NodeOffset(i);
+            std::copy_n(vectors + static_cast<SizeT>(i) * dimension_, dimension_, reinterpret_cast<DataType *>(record));
+            auto *degree = reinterpret_cast<u32 *>(record + sizeof(DataType) * dimension_);
+            *degree = graph[i].size();
+            std::copy(graph[i].begin(), graph[i].end(), degree + 1);
+        }
+        loaded_ = true;
+    }
+
+    void TrainAndEncodePQ(const DataType *vectors) {
+        const u32 subspace_dimension = SubspaceDimension();
+        pq_centroids_.assign(static_cast<SizeT>(subspace_num_) * DISKANN_PQ_CENTROID_NUM * subspace_dimension, 0);
+        pq_codes_.resize(static_cast<SizeT>(data_num_) * subspace_num_);
+        Vector<DataType> subspace_data(static_cast<SizeT>(data_num_) * subspace_dimension);
+        Vector<DataType> subspace_centroids;
+        auto labels = MakeUniqueForOverwrite<u32[]>(data_num_);
+        for (u32 m = 0; m < subspace_num_; ++m) {
+            for (u32 i = 0; i < data_num_; ++i) {
+                std::copy_n(vectors + static_cast<SizeT>(i) * dimension_ + m * subspace_dimension,
+                            subspace_dimension,
+                            subspace_data.data() + static_cast<SizeT>(i) * subspace_dimension);
+            }
+            const u32 train_centroid_num = std::min(DISKANN_PQ_CENTROID_NUM, data_num_);
+            const u32 real_centroid_num = GetKMeansCentroids<DataType>(MetricType::kMetricL2,
+                                                                       subspace_dimension,
+                                                                       data_num_,
+                                                                       subspace_data.data(),
+                                                                       subspace_centroids,
+                                                                       train_centroid_num,
+                                                                       0,
+                                                                       1,
+                                                                       256);
+            // too few vectors, unused codes repeat the first centroid and are never assigned
+            DataType *output = pq_centroids_.data() + static_cast<SizeT>(m) * DISKANN_PQ_CENTROID_NUM * subspace_dimension;
+            std::copy_n(subspace_centroids.data(), real_centroid_num * subspace_dimension, output);
+            for (u32 k = real_centroid_num; k < DISKANN_PQ_CENTROID_NUM; ++k) {
+                std::copy_n(subspace_centroids.data(), subspace_dimension, output + k * subspace_dimension);
+            }
+            search_top_1_without_dis<DataType>(subspace_dimension, data_num_, subspace_data.data(), DISKANN_PQ_CENTROID_NUM, output, labels.get());
+            for (u32 i = 0; i < data_num_; ++i) {
+                pq_codes_[static_cast<SizeT>(i) * subspace_num_ + m] = static_cast<u8>(labels[i]);
+            }
+        }
+    }
+
+    void ComputeDistanceTable(const DataType *query, DataType *table) const {
+        const u32 subspace_dimension = SubspaceDimension();
+        const DataType *centroid = pq_centroids_.data();
+        for (u32 m = 0; m < subspace_num_; ++m) {
+            const DataType *query_sub = query + m * subspace_dimension;
+            for (u32 k = 0; k < DISKANN_PQ_CENTROID_NUM; ++k, centroid += subspace_dimension) {
+                if (metric_ == MetricType::kMetricL2) {
+                    table[m * DISKANN_PQ_CENTROID_NUM + k] = L2Distance<DataType>(query_sub, centroid, subspace_dimension);
+                } else {
+                    table[m * DISKANN_PQ_CENTROID_NUM + k] = IPDistance<DataType>(query_sub, centroid, subspace_dimension);
+                }
+            }
+        }
+    }
+
+    // The graph is built with L2 distances for both metrics. The nodes are inserted in batches: the searches and prunes of a batch run
+    // in parallel on the graph as it was before the batch, then the edges of the batch and their reverse edges are added. The batches
+    // double in size up to DISKANN_BUILD_MAX_BATCH so that the first nodes still link to each other, and the graph doesn't depend on
+    // worker_count.
+    Vector<Vector<u32>> BuildGraph(const DataType *vectors, SizeT worker_count) {
+        auto distance = [&](u32 a, u32 b) {
+            return L2Distance<DataType>(vectors + static_cast<SizeT>(a) * dimension_, vectors + static_cast<SizeT>(b) * dimension_, dimension_);
+        };
+        medoid_ = FindMedoid(vectors);
+        Vector<Vector<u32>> graph(data_num_);
+        Vector<u32> order(data_num_);
+        std::iota(order.begin(), order.end(), 0);
+        std::mt19937 rng(data_num_);
+        std::shuffle(order.begin(), order.end(), rng);
+        Vector<Vector<u32>> batch_edges;
+        Vector<Pair<u32, Vector<u32>>> reverse_edges;
+        // the first pass links the graph with alpha = 1, the second one adds the long range edges
+        for (f32 alpha : {1.0f, alpha_}) {
+            for (SizeT batch_begin = 0; batch_begin < data_num_;) {
+                const SizeT batch_end = std::min<SizeT>(data_num_, batch_begin + std::clamp<SizeT>(batch_begin, 1, DISKANN_BUILD_MAX_BATCH));
+                batch_edges.assign(batch_end - batch_begin, {});
+                Utility::RunParallel(batch_end - batch_begin, worker_count, [&](SizeT k) {
+                    const u32 p = order[batch_begin + k];
+                    Vector<Pair<f32, u32>> candidates = GreedySearch(graph, vectors, p);
+                    for (u32 neighbor : graph[p]) {
+                        candidates.emplace_back(distance(p, neighbor), neighbor);
+                    }
+                    batch_edges[k] = RobustPrune(vectors, p, std::move(candidates), alpha);
+                });
+
+                // every node whose reverse edges change is updated by one task
+                HashMap<u32, SizeT> reverse_idx;
+                reverse_edges.clear();
+                for (SizeT k = 0; k < batch_edges.size(); ++k) {
+                    const u32 p = order[batch_begin + k];
+                    graph[p] = std::move(batch_edges[k]);
+                    for (u32 neighbor : graph[p]) {
+                        auto [iter, inserted] = reverse_idx.emplace(neighbor, reverse_edges.size());
+                        if (inserted) {
+                            reverse_edges.emplace_back(neighbor, Vector<u32>());
+                        }
+                        reverse_edges[iter->second].second.push_back(p);
+                    }
+                }
+                Utility::RunParallel(reverse_edges.size(), worker_count, [&](SizeT i) {
+                    const auto &[neighbor, sources] = reverse_edges[i];
+                    auto &reverse = graph[neighbor];
+                    for (u32 p : sources) {
+                        if (std::find(reverse.begin(), reverse.end(), p) == reverse.end()) {
+                            reverse.push_back(p);
+                        }
+                    }
+                    if (reverse.size() <= max_degree_) {
+                        return;
+                    }
+                    Vector<Pair<f32, u32>> reverse_candidates;
+                    reverse_candidates.reserve(reverse.size());
+                    for (u32 id : reverse) {
+                        reverse_candidates.emplace_back(distance(neighbor, id), id);
+                    }
+                    reverse = RobustPrune(vectors, neighbor, std::move(reverse_candidates), alpha);
+                });
+                batch_begin = batch_end;
+            }
+        }
+        return graph;
+    }
+
+    u32 FindMedoid(const DataType *vectors) const {
+        Vector<DataType> mean(dimension_, 0);
+        for (u32 i = 0; i < data_num_; ++i) {
+            for (u32 d = 0; d < dimension_; ++d) {
+                mean[d] += vectors[static_cast<SizeT>(i) * dimension_ + d];
+            }
+        }
+        for (u32 d = 0; d < dimension_; ++d) {
+            mean[d] /= data_num_;
+        }
+        u32 medoid = 0;
+        search_top_1_without_dis<DataType>(dimension_, 1, mean.data(), data_num_, vectors, &medoid);
+        return medoid;
+    }
+
+    // Greedy search for node p on the graph being built, returns every expanded node with its distance to p.
+    Vector<Pair<f32, u32>> GreedySearch(const Vector<Vector<u32>> &graph, const DataType *vectors, u32 p) const {
+        const DataType *query = vectors + static_cast<SizeT>(p) * dimension_;
+        auto distance = [&](u32 id) { return L2Distance<DataType>(query, vectors + static_cast<SizeT>(id) * dimension_, dimension_); };
+        DiskAnnCandidatePool pool(build_list_size_);
+        HashSet<u32> seen;
+        pool.Insert(distance(medoid_), medoid_);
+        seen.insert(medoid_);
+        Vector<Pair<f32, u32>> expanded;
+        Vector<u32> next;
+        while (true) {
+            next.clear();
+            pool.PopUnexpanded(1, next);
+            if (next.empty()) {
+                break;
+            }
+            const u32 id = next[0];
+            expanded.emplace_back(distance(id), id);
+            for (u32 neighbor : graph[id]) {
+                if (seen.insert(neighbor).second) {
+                    pool.Insert(distance(neighbor), neighbor);
+                }
+            }
+        }
+        return expanded;
+    }
+
+    // Keep the closest candidates of p, dropping a candidate c when a kept node k has alpha * d(k, c) <= d(p, c).
+    Vector<u32> RobustPrune(const DataType *vectors, u32 p, Vector<Pair<f32, u32>> candidates, f32 alpha) const {
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(),
+                                     candidates.end(),
+                                     [](const Pair<f32, u32> &a, const Pair<f32, u32> &b) { return a.second == b.second; }),
+                         candidates.end());
+        Vector<u32> result;
+        Vector<bool> pruned(candidates.size(), false);
+        for (SizeT i = 0; i < candidates.size() && result.size() < max_degree_; ++i) {
+            const u32 id = candidates[i].second;
+            if (pruned[i] || id == p) {
+                continue;
+            }
+            result.push_back(id);
+            const DataType *kept = vectors + static_cast<SizeT>(id) * dimension_;
+            for (SizeT j = i + 1; j < candidates.size(); ++j) {
+                if (!pruned[j] &&
+                    alpha * L2Distance<DataType>(kept, vectors + static_cast<SizeT>(candidates[j].second) * dimension_, dimension_) <=
+                        candidates[j].first) {
+                    pruned[j] = true;
+                }
+            }
+        }
+        return result;
+    }
+
+    void ReadNodes(const Vector<u32> &node_ids, char *buffer, Vector<const char *> &records) const {
+        if (!nodes_.empty()) {
+            for (SizeT k = 0; k < node_ids.size(); ++k) {
+                records[k] = nodes_.data() + NodeOffset(node_ids[k]);
+            }
+            return;
+        }
+        // The reads of the beam are submitted together and then waited for one by one. Nodes sharing a sector are read once.
+        // There is no io_uring (liburing is not a dependency), the kernel read ahead of the sectors gives the same overlap of the reads.
+        const SizeT read_size = NodeReadSize();
+        Vector<Pair<i64, u64>> ranges;
+        Vector<SizeT> range_idx(node_ids.size());
+        for (SizeT k = 0; k < node_ids.size(); ++k) {
+            const i64 read_offset = node_file_offset_ + NodeOffset(node_ids[k]) / DISKANN_SECTOR_SIZE * DISKANN_SECTOR_SIZE;
+            auto iter = std::find_if(ranges.begin(), ranges.end(), [&](const Pair<i64, u64> &range) { return range.first == read_offset; });
+            range_idx[k] = iter - ranges.begin();
+            if (iter == ranges.end()) {
+                ranges.emplace_back(read_offset, read_size);
+            }
+        }
+        node_fs_->ReadAhead(*node_file_, ranges);
+        for (SizeT r = 0; r < ranges.size(); ++r) {
+            node_fs_->ReadAt(*node_file_, ranges[r].first, buffer + r * read_size, read_size);
+        }
+        for (SizeT k = 0; k < node_ids.size(); ++k) {
+            const SizeT offset = NodeOffset(node_ids[k]);
+            records[k] = buffer + range_idx[k] * read_size + offset % DISKANN_SECTOR_SIZE;
+        }
+    }
+
+    void ReadMemoryPart(FileHandler &file_handler) {
+        file_handler.Read(&metric_, sizeof(metric_));
+        file_handler.Read(&dimension_, sizeof(dimension_));
+        file_handler.Read(&max_degree_, sizeof(max_degree_));
+        file_handler.Read(&build_list_size_, sizeof(build_list_size_));
+        file_handler.Read(&alpha_, sizeof(alpha_));
+        file_handler.Read(&subspace_num_, sizeof(subspace_num_));
+        file_handler.Read(&data_num_, sizeof(data_num_));
+        file_handler.Read(&medoid_, sizeof(medoid_));
+        if (data_num_ != 0) {
+            ids_.resize(data_num_);
+            file_handler.Read(ids_.data(), sizeof(SegmentOffset) * data_num_);
+            pq_centroids_.resize(static_cast<SizeT>(subspace_num_) * DISKANN_PQ_CENTROID_NUM * SubspaceDimension());
+            file_handler.Read(pq_centroids_.data(), sizeof(DataType) * pq_centroids_.size());
+            pq_codes_.resize(static_cast<SizeT>(data_num_) * subspace_num_);
+            file_handler.Read(pq_codes_.data(), pq_codes_.size());
+        }
+    }
+
+    [[nodiscard]] SizeT MemoryPartSize() const {
+        SizeT size = sizeof(metric_) + sizeof(alpha_) + sizeof(u32) * 6;
+        size += sizeof(SegmentOffset) * data_num_;
+        size += sizeof(DataType) * pq_centroids_.size();
+        size += pq_codes_.size();
+        return size;
+    }
+
+    [[nodiscard]] SizeT NodeFileOffset() const { return (MemoryPartSize() + DISKANN_SECTOR_SIZE - 1) / DISKANN_SECTOR_SIZE * DISKANN_SECTOR_SIZE; }
+};
+
+} // namespace infinity
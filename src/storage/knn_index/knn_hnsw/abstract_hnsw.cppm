@@ -117,6 +117,15 @@ public:
             knn_hnsw_ptr_);
     }
 
+    void LoadFromPtr(char *ptr) {
+        std::visit(
+            [&ptr, this](auto &&arg) {
+                using T = std::decay_t<decltype(*arg)>;
+                knn_hnsw_ptr_ = new T(T::LoadFromPtr(ptr));
+            },
+            knn_hnsw_ptr_);
+    }
+
     void Save(FileHandler &file_handler) {
         std::visit([&file_handler](auto &&arg) { arg->Save(file_handler); }, knn_hnsw_ptr_);
     }
@@ -133,6 +142,35 @@ public:
         std::visit([idx](auto &&arg) { arg->Build(idx); }, knn_hnsw_ptr_);
     }
 
+    void BuildParallel(SizeT start_i, SizeT end_i, SizeT worker_count, HnswBuildProgress &progress) {
+        std::visit([&](auto &&arg) { arg->BuildParallel(start_i, end_i, worker_count, progress); }, knn_hnsw_ptr_);
+    }
+
+    void BuildBulk(SizeT start_i, SizeT end_i, SizeT worker_count, HnswBuildProgress &progress) {
+        std::visit([&](auto &&arg) { arg->BuildBulk(start_i, end_i, worker_count, progress); }, knn_hnsw_ptr_);
+    }
+
+    template <typename MapLabel>
+    HnswSubgraph CopyGraph(const AbstractHnsw &other, MapLabel &&map_label) {
+        return std::visit(
+            [&](auto &&arg, auto &&other_arg) -> HnswSubgraph {
+                if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, std::decay_t<decltype(other_arg)>>) {
+                    return arg->CopyGraph(*other_arg, map_label);
+                } else {
+                    String error_message = "Copy graph between different hnsw types";
+                    LOG_CRITICAL(error_message);
+                    UnrecoverableError(error_message);
+                    return {};
+                }
+            },
+            knn_hnsw_ptr_,
+            other.knn_hnsw_ptr_);
+    }
+
+    void MergeSubgraphs(const Vector<HnswSubgraph> &subgraphs, SizeT worker_count, HnswBuildProgress &progress) {
+        std::visit([&](auto &&arg) { arg->MergeSubgraphs(subgraphs, worker_count, progress); }, knn_hnsw_ptr_);
+    }
+
     void *RawPtr() const {
         return std::visit([](auto &&arg) { return reinterpret_cast<void *>(arg); }, knn_hnsw_ptr_);
     }
@@ -181,6 +219,47 @@ public:
             knn_hnsw_ptr_);
     }
 
+    template <FilterConcept<LabelType> Filter>
+    Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<LabelType[]>>>
+    KnnSearchBatch(const DataType *const *qs, SizeT query_n, SizeT k, const Filter &filter, bool with_lock = true) const {
+        return std::visit(
+            [qs, query_n, k, &filter, with_lock](auto &&arg) {
+                if (with_lock) {
+                    return arg->template KnnSearchBatch<Filter, true>(qs, query_n, k, filter);
+                } else {
+                    return arg->template KnnSearchBatch<Filter, false>(qs, query_n, k, filter);
+                }
+            },
+            knn_hnsw_ptr_);
+    }
+
+    Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<LabelType[]>>>
+    KnnSearchBatch(const DataType *const *qs, SizeT query_n, SizeT k, bool with_lock = true) const {
+        return std::visit(
+            [qs, query_n, k, with_lock](auto &&arg) {
+                if (with_lock) {
+                    return arg->template KnnSearchBatch<true>(qs, query_n, k);
+                } else {
+                    return arg->template KnnSearchBatch<false>(qs, query_n, k);
+                }
+            },
+            knn_hnsw_ptr_);
+    }
+
+    template <FilterConcept<LabelType> Filter>
+    Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<LabelType[]>>
+    KnnSearchExpanded(const DataType *q, SizeT k, const Filter &filter, bool with_lock = true) const {
+        return std::visit(
+            [q, k, &filter, with_lock](auto &&arg) {
+                if (with_lock) {
+                    return arg->template KnnSearchExpanded<Filter, true>(q, k, filter);
+                } else {
+                    return arg->template KnnSearchExpanded<Filter, false>(q, k, filter);
+                }
+            },
+            knn_hnsw_ptr_);
+    }
+
     bool RerankDist() const {
         return std::visit(
             [](auto &&arg) {
@@ -26,6 +26,7 @@ import file_system;
 import vec_store_type;
 import graph_store;
 import infinity_exception;
+import serialize;
 
 namespace infinity {
 
@@ -164,6 +165,25 @@ public:
         return ret;
     }
 
+    // Read only data store over the memory of a saved data store, e.g. a mmaped index file. The memory must outlive the returned store.
+    static This LoadFromPtr(char *&ptr) {
+        SizeT chunk_size = ReadBufAdv<SizeT>(ptr);
+        SizeT max_chunk_n = ReadBufAdv<SizeT>(ptr);
+        SizeT cur_vec_num = ReadBufAdv<SizeT>(ptr);
+        VecStoreMeta vec_store_meta = VecStoreMeta::LoadFromPtr(ptr);
+        GraphStoreMeta graph_store_meta = GraphStoreMeta::LoadFromPtr(ptr);
+
+        This ret = This(chunk_size, max_chunk_n, std::move(vec_store_meta), std::move(graph_store_meta));
+        ret.cur_vec_num_ = cur_vec_num;
+
+        auto [chunk_num, last_chunk_size] = ret.ChunkInfo(cur_vec_num);
+        for (SizeT i = 0; i < chunk_num; ++i) {
+            SizeT cur_chunk_size = (i < chunk_num - 1) ? chunk_size : last_chunk_size;
+            ret.inners_[i] = Inner::LoadFromPtr(ptr, cur_chunk_size, ret.vec_store_meta_, ret.graph_store_meta_);
+        }
+        return ret;
+    }
+
     template <DataIteratorConcept<QueryVecType, LabelType> Iterator>
     Pair<SizeT, SizeT> AddVec(Iterator &&query_iter) {
         SizeT cur_vec_num = this->cur_vec_num();
@@ -249,6 +269,16 @@ public:
         return inner.GetNeighborsMut(idx, layer_i, graph_store_meta_);
     }
 
+    i32 GetLayerN(VertexType vertex_i) const {
+        const auto &[inner, idx] = GetInner(vertex_i);
+        return inner.GetLayerN(idx, graph_store_meta_);
+    }
+
+    void PrefetchNeighbors(VertexType vertex_i) const {
+        const auto &[inner, idx] = GetInner(vertex_i);
+        inner.PrefetchNeighbors(idx, graph_store_meta_);
+    }
+
     Pair<i32, VertexType> GetEnterPoint() const { return graph_store_meta_.GetEnterPoint(); }
 
     Pair<i32, VertexType> TryUpdateEnterPoint(i32 layer, VertexType vertex_i) { return graph_store_meta_.TryUpdateEnterPoint(layer, vertex_i); }
@@ -356,7 +386,11 @@ public:
 private:
     DataStoreInner(SizeT chunk_size, VecStoreInner vec_store_inner, GraphStoreInner graph_store_inner)
         : vec_store_inner_(std::move(vec_store_inner)), graph_store_inner_(std::move(graph_store_inner)),
-          labels_(MakeUnique<LabelType[]>(chunk_size)), vertex_mutex_(MakeUnique<std::shared_mutex[]>(chunk_size)) {}
+          labels_(MakeUnique<LabelType[]>(chunk_size)), labels_p_(labels_.get()), vertex_mutex_(MakeUnique<std::shared_mutex[]>(chunk_size)) {}
+
+    // Loaded from memory, the inner is never modified so the vertex locks are not needed.
+    DataStoreInner(VecStoreInner vec_store_inner, GraphStoreInner graph_store_inner, LabelType *labels_p)
+        : vec_store_inner_(std::move(vec_store_inner)), graph_store_inner_(std::move(graph_store_inner)), labels_p_(labels_p) {}
 
 public:
     DataStoreInner() = default;
@@ -372,7 +406,7 @@ public:
     void Save(FileHandler &file_handler, SizeT cur_vec_num, const VecStoreMeta &vec_store_meta, const GraphStoreMeta &graph_store_meta) const {
         vec_store_inner_.Save(file_handler, cur_vec_num, vec_store_meta);
         graph_store_inner_.Save(file_handler, cur_vec_num, graph_store_meta);
-        file_handler.Write(labels_.get(), sizeof(LabelType) * cur_vec_num);
+        file_handler.Write(labels_p_, sizeof(LabelType) * cur_vec_num);
     }
 
     static This Load(FileHandler &file_handler, SizeT cur_vec_num, SizeT chunk_size, VecStoreMeta &vec_store_meta, GraphStoreMeta &graph_store_meta) {
@@ -383,6 +417,14 @@ public:
         return ret;
     }
 
+    static This LoadFromPtr(char *&ptr, SizeT cur_vec_num, const VecStoreMeta &vec_store_meta, const GraphStoreMeta &graph_store_meta) {
+        auto vec_store_inner = VecStoreInner::LoadFromPtr(ptr, cur_vec_num, vec_store_meta);
+        auto graph_store_inner = GraphStoreInner::LoadFromPtr(ptr, cur_vec_num, graph_store_meta);
+        auto *labels_p = reinterpret_cast<LabelType *>(ptr);
+        ptr += sizeof(LabelType) * cur_vec_num;
+        return This(std::move(vec_store_inner), std::move(graph_store_inner), labels_p);
+    }
+
     // vec store
     template <DataIteratorConcept<QueryVecType, LabelType> Iterator>
     Pair<SizeT, bool> AddVec(Iterator &&query_iter, VertexType start_idx, SizeT remain_num, const VecStoreMeta &meta) {
@@ -392,7 +434,7 @@ public:
             if (auto ret = query_iter.Next(); ret) {
                 auto &[vec, label] = *ret;
                 vec_store_inner_.SetVec(start_idx + insert_n, vec, meta);
-                labels_[start_idx + insert_n] = label;
+                labels_p_[start_idx + insert_n] = label;
                 ++insert_n;
             } else {
                 used_up = true;
@@ -416,11 +458,25 @@ public:
         return graph_store_inner_.GetNeighborsMut(vertex_i, layer_i, meta);
     }
 
-    LabelType GetLabel(VertexType vec_i) const { return labels_[vec_i]; }
+    i32 GetLayerN(VertexType vertex_i, const GraphStoreMeta &meta) const { return graph_store_inner_.GetLayerN(vertex_i, meta); }
 
-    std::shared_lock<std::shared_mutex> SharedLock(VertexType vec_i) const { return std::shared_lock<std::shared_mutex>(vertex_mutex_[vec_i]); }
+    void PrefetchNeighbors(VertexType vertex_i, const GraphStoreMeta &meta) const { graph_store_inner_.PrefetchNeighbors(vertex_i, meta); }
 
-    std::unique_lock<std::shared_mutex> UniqueLock(VertexType vec_i) { return std::unique_lock<std::shared_mutex>(vertex_mutex_[vec_i]); }
+    LabelType GetLabel(VertexType vec_i) const { return labels_p_[vec_i]; }
+
+    std::shared_lock<std::shared_mutex> SharedLock(VertexType vec_i) const {
+        if (!vertex_mutex_) {
+            return {};
+        }
+        return std::shared_lock<std::shared_mutex>(vertex_mutex_[vec_i]);
+    }
+
+    std::unique_lock<std::shared_mutex> UniqueLock(VertexType vec_i) {
+        if (!vertex_mutex_) {
+            return {};
+        }
+        return std::unique_lock<std::shared_mutex>(vertex_mutex_[vec_i]);
+    }
 
     VecStoreInner *vec_store_inner() { return &vec_store_inner_; }
 
@@ -431,6 +487,8 @@ protected:
     VecStoreInner vec_store_inner_;
     GraphStoreInner graph_store_inner_;
     UniquePtr<LabelType[]> labels_;
+    // `labels_` or the loaded memory
+    LabelType *labels_p_{};
 
 private:
     mutable UniquePtr<std::shared_mutex[]> vertex_mutex_;
@@ -444,7 +502,7 @@ public:
         vec_store_inner_.Dump(os, offset, chunk_size, meta);
         os << "labels: [";
         for (SizeT i = 0; i < chunk_size; ++i) {
-            os << labels_[i] << ", ";
+            os << labels_p_[i] << ", ";
         }
         os << "]" << std::endl;
     }
@@ -16,12 +16,18 @@ module;
 
 #include <cassert>
 #include <ostream>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <xmmintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#include <simde/x86/sse.h>
+#endif
 
 export module graph_store;
 
 import stl;
 import hnsw_common;
 import file_system;
+import serialize;
 
 namespace infinity {
 
@@ -89,6 +95,16 @@ public:
         return meta;
     }
 
+    static GraphStoreMeta LoadFromPtr(char *&ptr) {
+        SizeT Mmax0 = ReadBufAdv<SizeT>(ptr);
+        SizeT Mmax = ReadBufAdv<SizeT>(ptr);
+
+        GraphStoreMeta meta(Mmax0, Mmax);
+        meta.max_layer_ = ReadBufAdv<i32>(ptr);
+        meta.enterpoint_ = ReadBufAdv<VertexType>(ptr);
+        return meta;
+    }
+
     SizeT Mmax0() const { return Mmax0_; }
     SizeT Mmax() const { return Mmax_; }
     SizeT level0_size() const { return level0_size_; }
@@ -134,7 +150,7 @@ public:
 export class GraphStoreInner {
 private:
     GraphStoreInner(SizeT max_vertex, const GraphStoreMeta &meta, SizeT loaded_vertex_n)
-        : graph_(MakeUnique<char[]>(max_vertex * meta.level0_size())), loaded_vertex_n_(loaded_vertex_n) {}
+        : graph_(MakeUnique<char[]>(max_vertex * meta.level0_size())), graph_p_(graph_.get()), loaded_vertex_n_(loaded_vertex_n) {}
 
 public:
     GraphStoreInner() = default;
@@ -157,11 +173,11 @@ public:
             layer_sum += GetLevel0(vertex_i, meta)->layer_n_;
         }
         file_handler.Write(&layer_sum, sizeof(layer_sum));
-        file_handler.Write(graph_.get(), cur_vertex_n * meta.level0_size());
+        file_handler.Write(graph_p_, cur_vertex_n * meta.level0_size());
         for (VertexType vertex_i = 0; vertex_i < (VertexType)cur_vertex_n; ++vertex_i) {
             const VertexL0 *v = GetLevel0(vertex_i, meta);
             if (v->layer_n_) {
-                file_handler.Write(v->layers_p_, meta.levelx_size() * v->layer_n_);
+                file_handler.Write(GetLayers(vertex_i, v), meta.levelx_size() * v->layer_n_);
             }
         }
     }
@@ -191,6 +207,29 @@ public:
         return graph_store;
     }
 
+    // Use the graph in place, the memory must outlive the inner and is never written.
+    // The upper layer pointers saved in level 0 are stale, so the upper layers of each vertex are looked up in `mapped_layers_`.
+    static GraphStoreInner LoadFromPtr(char *&ptr, SizeT cur_vertex_n, const GraphStoreMeta &meta) {
+        [[maybe_unused]] SizeT layer_sum = ReadBufAdv<SizeT>(ptr);
+
+        GraphStoreInner graph_store;
+        graph_store.graph_p_ = ptr;
+        graph_store.loaded_vertex_n_ = cur_vertex_n;
+        ptr += cur_vertex_n * meta.level0_size();
+
+        [[maybe_unused]] char *layers_begin = ptr;
+        for (VertexType vertex_i = 0; vertex_i < (VertexType)cur_vertex_n; ++vertex_i) {
+            const VertexL0 *v = graph_store.GetLevel0(vertex_i, meta);
+            if (v->layer_n_) {
+                graph_store.mapped_layers_.emplace_back(vertex_i, ptr);
+                ptr += meta.levelx_size() * v->layer_n_;
+            }
+        }
+        assert(ptr == layers_begin + meta.levelx_size() * layer_sum);
+        graph_store.mapped_ = true;
+        return graph_store;
+    }
+
     void AddVertex(VertexType vertex_i, i32 layer_n, const GraphStoreMeta &meta) {
         VertexL0 *v = GetLevel0(vertex_i, meta);
         v->neighbor_n_ = 0;
@@ -210,9 +249,20 @@ public:
         if (layer_i == 0) {
             return {v->neighbors_, v->neighbor_n_};
         }
-        const VertexLX *vx = GetLevelX(v->layers_p_, layer_i, meta);
+        const VertexLX *vx = GetLevelX(GetLayers(vertex_i, v), layer_i, meta);
         return {vx->neighbors_, vx->neighbor_n_};
     }
+    // Prefetch the level 0 neighbor list, which also holds the pointer to the upper layers.
+    void PrefetchNeighbors(VertexType vertex_i, const GraphStoreMeta &meta) const {
+        const char *p = reinterpret_cast<const char *>(GetLevel0(vertex_i, meta));
+        for (SizeT offset = 0; offset < meta.level0_size(); offset += 64) {
+            _mm_prefetch(p + offset, _MM_HINT_T0);
+        }
+    }
+
+    // the top layer of the vertex, 0 if it is only in layer 0
+    i32 GetLayerN(VertexType vertex_i, const GraphStoreMeta &meta) const { return GetLevel0(vertex_i, meta)->layer_n_; }
+
     Pair<VertexType *, VertexListSize *> GetNeighborsMut(VertexType vertex_i, i32 layer_i, const GraphStoreMeta &meta) {
         VertexL0 *v = GetLevel0(vertex_i, meta);
         if (layer_i == 0) {
@@ -224,10 +274,20 @@ public:
 
 private:
     const VertexL0 *GetLevel0(VertexType vertex_i, const GraphStoreMeta &meta) const {
-        return reinterpret_cast<const VertexL0 *>(graph_.get() + vertex_i * meta.level0_size());
+        return reinterpret_cast<const VertexL0 *>(graph_p_ + vertex_i * meta.level0_size());
     }
     VertexL0 *GetLevel0(VertexType vertex_i, const GraphStoreMeta &meta) {
-        return reinterpret_cast<VertexL0 *>(graph_.get() + vertex_i * meta.level0_size());
+        return reinterpret_cast<VertexL0 *>(graph_p_ + vertex_i * meta.level0_size());
+    }
+
+    const char *GetLayers(VertexType vertex_i, const VertexL0 *v) const {
+        if (!mapped_) {
+            return v->layers_p_;
+        }
+        auto iter = std::lower_bound(mapped_layers_.begin(), mapped_layers_.end(), vertex_i, [](const auto &layers, VertexType vertex_i) {
+            return layers.first < vertex_i;
+        });
+        return iter->second;
     }
 
     const VertexLX *GetLevelX(const char *layer_p, i32 layer_i, const GraphStoreMeta &meta) const {
@@ -241,8 +301,13 @@ private:
 
 private:
     UniquePtr<char[]> graph_;
+    // `graph_` or the loaded memory
+    char *graph_p_{};
     SizeT loaded_vertex_n_;
     UniquePtr<char[]> loaded_layers_;
+    // Vertices with upper layers and their layers in the loaded memory, sorted by vertex
+    bool mapped_{false};
+    Vector<Pair<VertexType, const char *>> mapped_layers_{};
 
     //---------------------------------------------- Following is the tmp debug function. ----------------------------------------------
 
@@ -263,7 +328,7 @@ public:
                 assert(neighbor_idx != out_vertex_i);
             }
             for (int layer_i = 1; layer_i <= v->layer_n_; ++layer_i) {
-                const VertexLX *vx = GetLevelX(v->layers_p_, layer_i, meta);
+                const VertexLX *vx = GetLevelX(GetLayers(vertex_i, v), layer_i, meta);
                 for (int i = 0; i < vx->neighbor_n_; ++i) {
                     VertexType neighbor_idx = vx->neighbors_[i];
                     assert(neighbor_idx < (VertexType)cur_vec_num && neighbor_idx >= 0);
@@ -303,7 +368,7 @@ public:
                     neighbors = v->neighbors_;
                     neighbor_n = v->neighbor_n_;
                 } else {
-                    const VertexLX *vx = GetLevelX(v->layers_p_, layer, meta);
+                    const VertexLX *vx = GetLevelX(GetLayers(vertex_i, v), layer, meta);
                     neighbors = vx->neighbors_;
                     neighbor_n = vx->neighbor_n_;
                 }
@@ -28,6 +28,7 @@ export module lvq_vec_store;
 import stl;
 import file_system;
 import hnsw_common;
+import serialize;
 
 namespace infinity {
 
@@ -110,6 +111,16 @@ public:
         return meta;
     }
 
+    static This LoadFromPtr(char *&ptr) {
+        SizeT dim = ReadBufAdv<SizeT>(ptr);
+        This meta(dim);
+        std::memcpy(meta.mean_.get(), ptr, sizeof(MeanType) * dim);
+        ptr += sizeof(MeanType) * dim;
+        std::memcpy(&meta.global_cache_, ptr, sizeof(GlobalCacheType));
+        ptr += sizeof(GlobalCacheType);
+        return meta;
+    }
+
     LVQQuery MakeQuery(const DataType *vec) const {
         LVQQuery query(compress_data_size_);
         CompressTo(vec, query.inner_.get());
@@ -249,7 +260,7 @@ public:
     using LVQData = LVQData<DataType, LocalCacheType, CompressType>;
 
 private:
-    LVQVecStoreInner(SizeT max_vec_num, const Meta &meta) : ptr_(MakeUnique<char[]>(max_vec_num * meta.compress_data_size())) {}
+    LVQVecStoreInner(SizeT max_vec_num, const Meta &meta) : ptr_(MakeUnique<char[]>(max_vec_num * meta.compress_data_size())), data_(ptr_.get()) {}
 
 public:
     LVQVecStoreInner() = default;
@@ -257,7 +268,7 @@ public:
     static This Make(SizeT max_vec_num, const Meta &meta) { return This(max_vec_num, meta); }
 
     void Save(FileHandler &file_handler, SizeT cur_vec_num, const Meta &meta) const {
-        file_handler.Write(ptr_.get(), cur_vec_num * meta.compress_data_size());
+        file_handler.Write(data_, cur_vec_num * meta.compress_data_size());
     }
 
     static This Load(FileHandler &file_handler, SizeT cur_vec_num, SizeT max_vec_num, const Meta &meta) {
@@ -267,19 +278,29 @@ public:
         return ret;
     }
 
+    // Use the compressed vectors in place, the memory must outlive the inner and is never written.
+    static This LoadFromPtr(char *&ptr, SizeT cur_vec_num, const Meta &meta) {
+        This ret;
+        ret.data_ = ptr;
+        ptr += cur_vec_num * meta.compress_data_size();
+        return ret;
+    }
+
     void SetVec(SizeT idx, const DataType *vec, const Meta &meta) { meta.CompressTo(vec, GetVecMut(idx, meta)); }
 
     const LVQData *GetVec(SizeT idx, const Meta &meta) const {
-        return reinterpret_cast<const LVQData *>(ptr_.get() + idx * meta.compress_data_size());
+        return reinterpret_cast<const LVQData *>(data_ + idx * meta.compress_data_size());
     }
 
     void Prefetch(VertexType vec_i, const Meta &meta) const { _mm_prefetch(reinterpret_cast<const char *>(GetVec(vec_i, meta)), _MM_HINT_T0); }
 
 private:
-    LVQData *GetVecMut(SizeT idx, const Meta &meta) { return reinterpret_cast<LVQData *>(ptr_.get() + idx * meta.compress_data_size()); }
+    LVQData *GetVecMut(SizeT idx, const Meta &meta) { return reinterpret_cast<LVQData *>(data_ + idx * meta.compress_data_size()); }
 
 private:
     UniquePtr<char[]> ptr_;
+    // `ptr_` or the loaded memory
+    char *data_{};
 
 public:
     void Dump(std::ostream &os, SizeT offset, SizeT chunk_size, const Meta &meta) const {
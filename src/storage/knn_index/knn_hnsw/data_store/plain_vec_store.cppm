@@ -27,6 +27,7 @@ export module plain_vec_store;
 import stl;
 import file_system;
 import hnsw_common;
+import serialize;
 
 namespace infinity {
 
@@ -61,6 +62,11 @@ public:
         return This(dim);
     }
 
+    static This LoadFromPtr(char *&ptr) {
+        SizeT dim = ReadBufAdv<SizeT>(ptr);
+        return This(dim);
+    }
+
     QueryType MakeQuery(const DataType *vec) const { return vec; }
 
     SizeT dim() const { return dim_; }
@@ -79,7 +85,7 @@ public:
     using Meta = PlainVecStoreMeta<DataType>;
 
 private:
-    PlainVecStoreInner(SizeT max_vec_num, const Meta &meta) : ptr_(MakeUnique<DataType[]>(max_vec_num * meta.dim())) {}
+    PlainVecStoreInner(SizeT max_vec_num, const Meta &meta) : ptr_(MakeUnique<DataType[]>(max_vec_num * meta.dim())), data_(ptr_.get()) {}
 
 public:
     PlainVecStoreInner() = default;
@@ -87,7 +93,7 @@ public:
     static This Make(SizeT max_vec_num, const Meta &meta) { return This(max_vec_num, meta); }
 
     void Save(FileHandler &file_handler, SizeT cur_vec_num, const Meta &meta) const {
-        file_handler.Write(ptr_.get(), sizeof(DataType) * cur_vec_num * meta.dim());
+        file_handler.Write(data_, sizeof(DataType) * cur_vec_num * meta.dim());
     }
 
     static This Load(FileHandler &file_handler, SizeT cur_vec_num, SizeT max_vec_num, const Meta &meta) {
@@ -97,17 +103,27 @@ public:
         return ret;
     }
 
+    // Use the vectors in place, the memory must outlive the inner and is never written.
+    static This LoadFromPtr(char *&ptr, SizeT cur_vec_num, const Meta &meta) {
+        This ret;
+        ret.data_ = reinterpret_cast<DataType *>(ptr);
+        ptr += sizeof(DataType) * cur_vec_num * meta.dim();
+        return ret;
+    }
+
     void SetVec(SizeT idx, const DataType *vec, const Meta &meta) { Copy(vec, vec + meta.dim(), GetVecMut(idx, meta)); }
 
-    const DataType *GetVec(SizeT idx, const Meta &meta) const { return ptr_.get() + idx * meta.dim(); }
+    const DataType *GetVec(SizeT idx, const Meta &meta) const { return data_ + idx * meta.dim(); }
 
     void Prefetch(VertexType vec_i, const Meta &meta) const { _mm_prefetch(reinterpret_cast<const char *>(GetVec(vec_i, meta)), _MM_HINT_T0); }
 
 private:
-    DataType *GetVecMut(SizeT idx, const Meta &meta) { return ptr_.get() + idx * meta.dim(); }
+    DataType *GetVecMut(SizeT idx, const Meta &meta) { return data_ + idx * meta.dim(); }
 
 private:
     UniquePtr<DataType[]> ptr_;
+    // `ptr_` or the loaded memory
+    DataType *data_{};
 
 public:
     void Dump(std::ostream &os, SizeT offset, SizeT chunk_size, const Meta &meta) const {
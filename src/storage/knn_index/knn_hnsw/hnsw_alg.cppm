@@ -28,6 +28,8 @@ import bitmask;
 
 import hnsw_common;
 import data_store;
+import serialize;
+import utility;
 
 // Fixme: some variable has implicit type conversion.
 // Fixme: some variable has confusing name.
@@ -56,6 +58,8 @@ public:
 
     constexpr static int prefetch_offset_ = 0;
     constexpr static int prefetch_step_ = 2;
+    // Queries whose layer 0 searches are interleaved in KnnSearchBatch.
+    constexpr static SizeT search_batch_size_ = 8;
 
     using CompressVecStoreType = decltype(VecStoreType::template ToLVQ<i8>());
 
@@ -117,11 +121,27 @@ public:
         return This(M, ef_construction, std::move(data_store), std::move(distance), 0, 0);
     }
 
+    // The returned index is read only and refers to the memory of `ptr`.
+    static This LoadFromPtr(char *&ptr) {
+        SizeT M = ReadBufAdv<SizeT>(ptr);
+        SizeT ef_construction = ReadBufAdv<SizeT>(ptr);
+
+        auto data_store = DataStore::LoadFromPtr(ptr);
+        Distance distance(data_store.dim());
+
+        return This(M, ef_construction, std::move(data_store), std::move(distance), 0, 0);
+    }
+
 private:
     // >= 0
     i32 GenerateRandomLayer() {
         std::uniform_real_distribution<double> distribution(0.0, 1.0);
-        auto r1 = distribution(level_rng_);
+        double r1;
+        {
+            // concurrent builds share the generator
+            std::lock_guard<std::mutex> lock(level_rng_mutex_);
+            r1 = distribution(level_rng_);
+        }
         double r = -std::log(r1) * mult_;
         return static_cast<i32>(r);
     }
@@ -149,8 +169,9 @@ private:
         }
 
         SizeT cur_vec_num = data_store_.cur_vec_num();
-        Vector<bool> visited(cur_vec_num, false);
-        visited[enter_point] = true;
+        VisitedTable &visited = VisitedTable::ThreadLocal();
+        visited.Reset(cur_vec_num);
+        visited.TestAndSet(enter_point);
 
         while (!candidate.empty()) {
             const auto [minus_c_dist, c_idx] = candidate.top();
@@ -158,6 +179,10 @@ private:
             if (result_handler.GetSize(0) == result_n && -minus_c_dist > result_handler.GetDistance0(0)) {
                 break;
             }
+            if (!candidate.empty()) {
+                // The adjacency list of the next candidate is loaded while the neighbors of this one are computed.
+                data_store_.PrefetchNeighbors(candidate.top().second);
+            }
 
             std::shared_lock<std::shared_mutex> lock;
             if constexpr (WithLock) {
@@ -168,10 +193,9 @@ private:
             int prefetch_start = neighbor_size - 1 - prefetch_offset_;
             for (int i = neighbor_size - 1; i >= 0; --i) {
                 VertexType n_idx = neighbors_p[i];
-                if (n_idx >= (VertexType)cur_vec_num || visited[n_idx]) {
+                if (n_idx >= (VertexType)cur_vec_num || visited.TestAndSet(n_idx)) {
                     continue;
                 }
-                visited[n_idx] = true;
                 if (prefetch_start >= 0) {
                     int lower = std::max(0, prefetch_start - prefetch_step_);
                     for (int i = prefetch_start; i >= lower; --i) {
@@ -197,6 +221,186 @@ private:
         return {result_handler.GetSize(0), std::move(d_ptr), std::move(i_ptr)};
     }
 
+    // SearchLayer for a filter that few vertices pass, in the way of ACORN-1. Only the vertices passing the filter are scored and
+    // become candidates, and a neighbor failing the filter is replaced by its own neighbors, so the walk stays connected on the
+    // subgraph of passing vertices instead of spending ef on vertices that are discarded.
+    template <bool WithLock, FilterConcept<LabelType> Filter>
+    Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<VertexType[]>>
+    SearchLayerExpanded(VertexType enter_point, const StoreType &query, i32 layer_idx, SizeT result_n, const Filter &filter) const {
+        auto d_ptr = MakeUniqueForOverwrite<DataType[]>(result_n);
+        auto i_ptr = MakeUniqueForOverwrite<VertexType[]>(result_n);
+        HeapResultHandler<CompareMax<DataType, VertexType>> result_handler(1, result_n, d_ptr.get(), i_ptr.get());
+        result_handler.Begin();
+        DistHeap candidate;
+
+        data_store_.PrefetchVec(enter_point);
+        // enter_point is expanded even if it fails the filter
+        auto dist = distance_(query, data_store_.GetVec(enter_point), data_store_.vec_store_meta());
+        candidate.emplace(-dist, enter_point);
+        if (filter(GetLabel(enter_point))) {
+            result_handler.AddResult(0, dist, enter_point);
+        }
+
+        SizeT cur_vec_num = data_store_.cur_vec_num();
+        VisitedTable &visited = VisitedTable::ThreadLocal();
+        visited.Reset(cur_vec_num);
+        visited.TestAndSet(enter_point);
+
+        Vector<VertexType> passed;
+        Vector<VertexType> failed;
+        while (!candidate.empty()) {
+            const auto [minus_c_dist, c_idx] = candidate.top();
+            candidate.pop();
+            if (result_handler.GetSize(0) == result_n && -minus_c_dist > result_handler.GetDistance0(0)) {
+                break;
+            }
+            passed.clear();
+            failed.clear();
+            {
+                std::shared_lock<std::shared_mutex> lock;
+                if constexpr (WithLock) {
+                    lock = data_store_.SharedLock(c_idx);
+                }
+                const auto [neighbors_p, neighbor_size] = data_store_.GetNeighbors(c_idx, layer_idx);
+                for (int i = neighbor_size - 1; i >= 0; --i) {
+                    VertexType n_idx = neighbors_p[i];
+                    if (n_idx >= (VertexType)cur_vec_num || visited.TestAndSet(n_idx)) {
+                        continue;
+                    }
+                    if (filter(GetLabel(n_idx))) {
+                        passed.push_back(n_idx);
+                    } else {
+                        failed.push_back(n_idx);
+                    }
+                }
+            }
+            for (VertexType f_idx : failed) {
+                std::shared_lock<std::shared_mutex> lock;
+                if constexpr (WithLock) {
+                    lock = data_store_.SharedLock(f_idx);
+                }
+                const auto [neighbors_p, neighbor_size] = data_store_.GetNeighbors(f_idx, layer_idx);
+                for (int i = neighbor_size - 1; i >= 0; --i) {
+                    VertexType n_idx = neighbors_p[i];
+                    // a failing vertex two hops away is left unvisited, it may bridge to passing vertices from another candidate
+                    if (n_idx >= (VertexType)cur_vec_num || !filter(GetLabel(n_idx)) || visited.TestAndSet(n_idx)) {
+                        continue;
+                    }
+                    passed.push_back(n_idx);
+                }
+            }
+            for (VertexType n_idx : passed) {
+                data_store_.PrefetchVec(n_idx);
+            }
+            for (VertexType n_idx : passed) {
+                auto dist = distance_(query, data_store_.GetVec(n_idx), data_store_.vec_store_meta());
+                if (result_handler.GetSize(0) < result_n || dist < result_handler.GetDistance0(0)) {
+                    candidate.emplace(-dist, n_idx);
+                    result_handler.AddResult(0, dist, n_idx);
+                }
+            }
+        }
+        result_handler.EndWithoutSort();
+        return {result_handler.GetSize(0), std::move(d_ptr), std::move(i_ptr)};
+    }
+
+    // SearchLayer of several queries at once, each query gets the same result as SearchLayer.
+    // The searches advance in turn: a query expands a candidate and prefetches the vectors of its unvisited neighbors, and computes
+    // their distances on its next turn, so the memory loads of one query overlap the distance computations of the others.
+    template <bool WithLock, FilterConcept<LabelType> Filter = NoneType>
+    void SearchLayerBatch(const VertexType *enter_points,
+                          const QueryType *queries,
+                          SizeT query_n,
+                          i32 layer_idx,
+                          SizeT result_n,
+                          const Filter &filter,
+                          DataType *d_ptr,
+                          VertexType *i_ptr,
+                          SizeT *result_sizes) const {
+        HeapResultHandler<CompareMax<DataType, VertexType>> result_handler(query_n, result_n, d_ptr, i_ptr);
+        result_handler.Begin();
+        Vector<DistHeap> candidates(query_n);
+        // Neighbors waiting for their distance to be computed, in the order SearchLayer visits them.
+        Vector<Vector<VertexType>> pendings(query_n);
+        Vector<bool> finished(query_n, false);
+
+        auto add_result = [&](SizeT q, DataType dist, VertexType v_idx) {
+            if constexpr (!std::is_same_v<Filter, NoneType>) {
+                if (filter(GetLabel(v_idx))) {
+                    result_handler.AddResult(q, dist, v_idx);
+                }
+            } else {
+                result_handler.AddResult(q, dist, v_idx);
+            }
+        };
+
+        SizeT cur_vec_num = data_store_.cur_vec_num();
+        Vector<VisitedTable> &visiteds = VisitedTable::ThreadLocalBatch(query_n);
+        for (SizeT q = 0; q < query_n; ++q) {
+            data_store_.PrefetchVec(enter_points[q]);
+        }
+        for (SizeT q = 0; q < query_n; ++q) {
+            auto dist = distance_(queries[q], data_store_.GetVec(enter_points[q]), data_store_.vec_store_meta());
+            candidates[q].emplace(-dist, enter_points[q]);
+            add_result(q, dist, enter_points[q]);
+            visiteds[q].Reset(cur_vec_num);
+            visiteds[q].TestAndSet(enter_points[q]);
+        }
+
+        SizeT active_n = query_n;
+        while (active_n > 0) {
+            for (SizeT q = 0; q < query_n; ++q) {
+                if (finished[q]) {
+                    continue;
+                }
+                auto &candidate = candidates[q];
+                auto &pending = pendings[q];
+                for (VertexType n_idx : pending) {
+                    auto dist = distance_(queries[q], data_store_.GetVec(n_idx), data_store_.vec_store_meta());
+                    if (result_handler.GetSize(q) < result_n || dist < result_handler.GetDistance0(q)) {
+                        candidate.emplace(-dist, n_idx);
+                        add_result(q, dist, n_idx);
+                    }
+                }
+                pending.clear();
+
+                if (candidate.empty()) {
+                    finished[q] = true;
+                    --active_n;
+                    continue;
+                }
+                const auto [minus_c_dist, c_idx] = candidate.top();
+                candidate.pop();
+                if (result_handler.GetSize(q) == result_n && -minus_c_dist > result_handler.GetDistance0(q)) {
+                    finished[q] = true;
+                    --active_n;
+                    continue;
+                }
+                if (!candidate.empty()) {
+                    data_store_.PrefetchNeighbors(candidate.top().second);
+                }
+
+                std::shared_lock<std::shared_mutex> lock;
+                if constexpr (WithLock) {
+                    lock = data_store_.SharedLock(c_idx);
+                }
+                const auto [neighbors_p, neighbor_size] = data_store_.GetNeighbors(c_idx, layer_idx);
+                for (int i = neighbor_size - 1; i >= 0; --i) {
+                    VertexType n_idx = neighbors_p[i];
+                    if (n_idx >= (VertexType)cur_vec_num || visiteds[q].TestAndSet(n_idx)) {
+                        continue;
+                    }
+                    data_store_.PrefetchVec(n_idx);
+                    pending.push_back(n_idx);
+                }
+            }
+        }
+        result_handler.EndWithoutSort();
+        for (SizeT q = 0; q < query_n; ++q) {
+            result_sizes[q] = result_handler.GetSize(q);
+        }
+    }
+
     template <bool WithLock>
     VertexType SearchLayerNearest(VertexType enter_point, const StoreType &query, i32 layer_idx) const {
         VertexType cur_p = enter_point;
@@ -211,6 +415,9 @@ private:
             }
 
             const auto [neighbors_p, neighbor_size] = data_store_.GetNeighbors(cur_p, layer_idx);
+            for (int i = neighbor_size - 1; i >= 0; --i) {
+                data_store_.PrefetchVec(neighbors_p[i]);
+            }
             for (int i = neighbor_size - 1; i >= 0; --i) {
                 VertexType n_idx = neighbors_p[i];
                 DataType n_dist = distance_(query, data_store_.GetVec(n_idx), data_store_.vec_store_meta());
@@ -257,7 +464,12 @@ private:
         *result_size_p = result_size;
     }
 
-    void ConnectNeighbors(VertexType vertex_i, const VertexType *q_neighbors_p, VertexListSize q_neighbor_size, i32 layer_idx) {
+    // `skip_connected`: the neighbors may already link to vertex_i
+    void ConnectNeighbors(VertexType vertex_i,
+                          const VertexType *q_neighbors_p,
+                          VertexListSize q_neighbor_size,
+                          i32 layer_idx,
+                          bool skip_connected = false) {
         for (int i = 0; i < q_neighbor_size; ++i) {
             VertexType n_idx = q_neighbors_p[i];
 
@@ -265,6 +477,9 @@ private:
 
             auto [n_neighbors_p, n_neighbor_size_p] = data_store_.GetNeighborsMut(n_idx, layer_idx);
             VertexListSize n_neighbor_size = *n_neighbor_size_p;
+            if (skip_connected && std::find(n_neighbors_p, n_neighbors_p + n_neighbor_size, vertex_i) != n_neighbors_p + n_neighbor_size) {
+                continue;
+            }
             SizeT Mmax = layer_idx == 0 ? data_store_.Mmax0() : data_store_.Mmax();
             if (n_neighbor_size < VertexListSize(Mmax)) {
                 *(n_neighbors_p + n_neighbor_size) = vertex_i;
@@ -285,9 +500,79 @@ private:
         }
     }
 
+    // Link the added vertex_i, whose top layer is q_layer, into the graph entered at `ep` on layer `max_layer`.
+    template <bool WithLock>
+    void Connect(VertexType vertex_i, i32 q_layer, i32 max_layer, VertexType ep) {
+        StoreType query = data_store_.GetVec(vertex_i);
+
+        for (i32 cur_layer = max_layer; cur_layer > q_layer; --cur_layer) {
+            ep = SearchLayerNearest<WithLock>(ep, query, cur_layer);
+        }
+        for (i32 cur_layer = std::min(q_layer, max_layer); cur_layer >= 0; --cur_layer) {
+            auto [result_n, d_ptr, v_ptr] = SearchLayer<WithLock>(ep, query, cur_layer, ef_construction_, None);
+            auto search_result = Vector<PDV>(result_n);
+            for (SizeT i = 0; i < result_n; ++i) {
+                search_result[i] = {d_ptr[i], v_ptr[i]};
+            }
+
+            const auto [q_neighbors_p, q_neighbor_size_p] = data_store_.GetNeighborsMut(vertex_i, cur_layer);
+            SelectNeighborsHeuristic(std::move(search_result), M_, q_neighbors_p, q_neighbor_size_p);
+            ep = q_neighbors_p[0];
+            ConnectNeighbors(vertex_i, q_neighbors_p, *q_neighbor_size_p, cur_layer);
+        }
+    }
+
+    // Search the linked vertex_i in the graph with `ef` and merge the results into its neighbor lists.
+    void RepairVertex(VertexType vertex_i, SizeT ef) {
+        const i32 q_layer = data_store_.GetLayerN(vertex_i);
+        auto [max_layer, ep] = data_store_.GetEnterPoint();
+        StoreType query = data_store_.GetVec(vertex_i);
+
+        for (i32 cur_layer = max_layer; cur_layer > q_layer; --cur_layer) {
+            ep = SearchLayerNearest<true>(ep, query, cur_layer);
+        }
+        Vector<PDV> candidates;
+        Vector<VertexType> old_neighbors;
+        Vector<VertexType> new_neighbors;
+        for (i32 cur_layer = std::min(q_layer, max_layer); cur_layer >= 0; --cur_layer) {
+            // vertex_i is not locked while searching, the search may pass through it
+            auto [result_n, d_ptr, v_ptr] = SearchLayer<true>(ep, query, cur_layer, ef, None);
+            candidates.clear();
+            for (SizeT i = 0; i < result_n; ++i) {
+                if (v_ptr[i] != vertex_i) {
+                    candidates.emplace_back(d_ptr[i], v_ptr[i]);
+                }
+            }
+            new_neighbors.clear();
+            {
+                std::unique_lock<std::shared_mutex> lock = data_store_.UniqueLock(vertex_i);
+                const auto [neighbors_p, neighbor_size_p] = data_store_.GetNeighborsMut(vertex_i, cur_layer);
+                old_neighbors.assign(neighbors_p, neighbors_p + *neighbor_size_p);
+                for (VertexType n_idx : old_neighbors) {
+                    candidates.emplace_back(distance_(query, data_store_.GetVec(n_idx), data_store_.vec_store_meta()), n_idx);
+                }
+                std::sort(candidates.begin(), candidates.end(), [](const PDV &a, const PDV &b) { return a.second < b.second; });
+                auto last = std::unique(candidates.begin(), candidates.end(), [](const PDV &a, const PDV &b) { return a.second == b.second; });
+                candidates.erase(last, candidates.end());
+
+                SizeT Mmax = cur_layer == 0 ? data_store_.Mmax0() : data_store_.Mmax();
+                SelectNeighborsHeuristic(std::move(candidates), Mmax, neighbors_p, neighbor_size_p);
+                for (VertexListSize i = 0; i < *neighbor_size_p; ++i) {
+                    if (std::find(old_neighbors.begin(), old_neighbors.end(), neighbors_p[i]) == old_neighbors.end()) {
+                        new_neighbors.push_back(neighbors_p[i]);
+                    }
+                }
+                if (*neighbor_size_p > 0) {
+                    ep = neighbors_p[0];
+                }
+            }
+            ConnectNeighbors(vertex_i, new_neighbors.data(), new_neighbors.size(), cur_layer, true);
+        }
+    }
+
     LabelType GetLabel(VertexType vertex_i) const { return data_store_.GetLabel(vertex_i); }
 
-    template <bool WithLock, FilterConcept<LabelType> Filter = NoneType>
+    template <bool WithLock, FilterConcept<LabelType> Filter = NoneType, bool Expanded = false>
     Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<VertexType[]>> KnnSearchInner(const QueryVecType &q, SizeT k, const Filter &filter) const {
         QueryType query = data_store_.MakeQuery(q);
         auto [max_layer, ep] = data_store_.GetEnterPoint();
@@ -297,7 +582,60 @@ private:
         for (i32 cur_layer = max_layer; cur_layer > 0; --cur_layer) {
             ep = SearchLayerNearest<WithLock>(ep, query, cur_layer);
         }
-        return SearchLayer<WithLock, Filter>(ep, query, 0, std::max(k, ef_), filter);
+        if constexpr (Expanded) {
+            return SearchLayerExpanded<WithLock, Filter>(ep, query, 0, std::max(k, ef_), filter);
+        } else {
+            return SearchLayer<WithLock, Filter>(ep, query, 0, std::max(k, ef_), filter);
+        }
+    }
+
+    template <bool WithLock, FilterConcept<LabelType> Filter = NoneType>
+    Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<VertexType[]>>>
+    KnnSearchBatchInner(const QueryVecType *qs, SizeT query_n, SizeT k, const Filter &filter) const {
+        Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<VertexType[]>>> results(query_n);
+        auto [max_layer, ep] = data_store_.GetEnterPoint();
+        if (ep == -1) {
+            return results;
+        }
+        SizeT result_n = std::max(k, ef_);
+        auto d_ptr = MakeUniqueForOverwrite<DataType[]>(search_batch_size_ * result_n);
+        auto i_ptr = MakeUniqueForOverwrite<VertexType[]>(search_batch_size_ * result_n);
+        Vector<QueryType> queries;
+        Vector<VertexType> enter_points;
+        SizeT result_sizes[search_batch_size_];
+        for (SizeT batch_start = 0; batch_start < query_n; batch_start += search_batch_size_) {
+            SizeT batch_n = std::min(search_batch_size_, query_n - batch_start);
+            queries.clear();
+            enter_points.clear();
+            for (SizeT q = 0; q < batch_n; ++q) {
+                QueryType &query = queries.emplace_back(data_store_.MakeQuery(qs[batch_start + q]));
+                VertexType q_ep = ep;
+                for (i32 cur_layer = max_layer; cur_layer > 0; --cur_layer) {
+                    q_ep = SearchLayerNearest<WithLock>(q_ep, query, cur_layer);
+                }
+                enter_points.push_back(q_ep);
+            }
+            SearchLayerBatch<WithLock, Filter>(enter_points.data(),
+                                               queries.data(),
+                                               batch_n,
+                                               0,
+                                               result_n,
+                                               filter,
+                                               d_ptr.get(),
+                                               i_ptr.get(),
+                                               result_sizes);
+            for (SizeT q = 0; q < batch_n; ++q) {
+                SizeT result_size = result_sizes[q];
+                auto q_d_ptr = MakeUniqueForOverwrite<DataType[]>(result_size);
+                auto q_i_ptr = MakeUniqueForOverwrite<VertexType[]>(result_size);
+                std::copy(d_ptr.get() + q * result_n, d_ptr.get() + q * result_n + result_size, q_d_ptr.get());
+                std::copy(i_ptr.get() + q * result_n, i_ptr.get() + q * result_n + result_size, q_i_ptr.get());
+                results[batch_start + q] = {result_size, std::move(q_d_ptr), std::move(q_i_ptr)};
+            }
+        }
+        // The tables are reused by all batches of the search, free them once all queries are done.
+        VisitedTable::ShrinkThreadLocalBatch();
+        return results;
     }
 
 public:
@@ -326,25 +664,139 @@ public:
         i32 q_layer = GenerateRandomLayer();
         auto [max_layer, ep] = data_store_.TryUpdateEnterPoint(q_layer, vertex_i);
 
-        StoreType query = data_store_.GetVec(vertex_i);
+        data_store_.AddVertex(vertex_i, q_layer);
+
+        Connect<true>(vertex_i, q_layer, max_layer, ep);
+    }
 
+    // Build vertex_i into `subgraph`. No other thread builds or searches the subgraph, so it is built without locks.
+    void Build(VertexType vertex_i, HnswSubgraph &subgraph) {
+        i32 q_layer = GenerateRandomLayer();
         data_store_.AddVertex(vertex_i, q_layer);
 
-        for (i32 cur_layer = max_layer; cur_layer > q_layer; --cur_layer) {
-            ep = SearchLayerNearest<true>(ep, query, cur_layer);
+        Connect<false>(vertex_i, q_layer, subgraph.max_layer_, subgraph.enter_point_);
+        if (q_layer > subgraph.max_layer_) {
+            subgraph.max_layer_ = q_layer;
+            subgraph.enter_point_ = vertex_i;
         }
-        for (i32 cur_layer = std::min(q_layer, max_layer); cur_layer >= 0; --cur_layer) {
-            auto [result_n, d_ptr, v_ptr] = SearchLayer<true>(ep, query, cur_layer, ef_construction_, None);
-            auto search_result = Vector<PDV>(result_n);
-            for (SizeT i = 0; i < result_n; ++i) {
-                search_result[i] = {d_ptr[i], v_ptr[i]};
+    }
+
+    // Build the stored vertices [start_i, end_i) on `worker_count` threads with the concurrent Build.
+    void BuildParallel(VertexType start_i, VertexType end_i, SizeT worker_count, HnswBuildProgress &progress) {
+        progress.total_ += end_i - start_i;
+        Utility::RunParallel(end_i - start_i, worker_count, [&](SizeT i) {
+            Build(start_i + static_cast<VertexType>(i));
+            ++progress.done_;
+        });
+    }
+
+    // Build the stored vertices [start_i, end_i) as `worker_count` subgraphs of consecutive vertices, one per worker, so the workers
+    // never wait for each other's locks or the enter point. The subgraphs are merged at the end.
+    void BuildBulk(VertexType start_i, VertexType end_i, SizeT worker_count, HnswBuildProgress &progress) {
+        const SizeT vertex_n = end_i - start_i;
+        worker_count = std::max<SizeT>(1, std::min(worker_count, vertex_n));
+        progress.total_ += vertex_n;
+
+        Vector<HnswSubgraph> subgraphs;
+        auto [max_layer, ep] = data_store_.GetEnterPoint();
+        if (ep != -1) {
+            // the vertices built before are a subgraph
+            subgraphs.push_back({0, start_i, max_layer, ep});
+        }
+        const SizeT first_new = subgraphs.size();
+        for (SizeT i = 0; i < worker_count; ++i) {
+            auto sub_start = static_cast<VertexType>(start_i + vertex_n * i / worker_count);
+            auto sub_end = static_cast<VertexType>(start_i + vertex_n * (i + 1) / worker_count);
+            subgraphs.push_back({sub_start, sub_end, -1, -1});
+        }
+        Utility::RunParallel(worker_count, worker_count, [&](SizeT i) {
+            HnswSubgraph &subgraph = subgraphs[first_new + i];
+            for (VertexType vertex_i = subgraph.start_; vertex_i < subgraph.end_; ++vertex_i) {
+                Build(vertex_i, subgraph);
+                ++progress.done_;
             }
+        });
+        MergeSubgraphs(subgraphs, worker_count, progress);
+    }
 
-            const auto [q_neighbors_p, q_neighbor_size_p] = data_store_.GetNeighborsMut(vertex_i, cur_layer);
-            SelectNeighborsHeuristic(std::move(search_result), M_, q_neighbors_p, q_neighbor_size_p);
-            ep = q_neighbors_p[0];
-            ConnectNeighbors(vertex_i, q_neighbors_p, *q_neighbor_size_p, cur_layer);
+    // Copy the graph of `other` into the stored vertices, so it can be merged as a subgraph. The vertex of `other` labeled `label`
+    // becomes the vertex `map_label(label)`, or is dropped with its edges if that is -1. The kept vertices must be mapped to a range.
+    template <typename MapLabel>
+    HnswSubgraph CopyGraph(const This &other, MapLabel &&map_label) {
+        const SizeT other_n = other.GetVertexNum();
+        Vector<VertexType> vertex_map(other_n);
+        HnswSubgraph subgraph{std::numeric_limits<VertexType>::max(), 0, -1, -1};
+        for (SizeT vertex_i = 0; vertex_i < other_n; ++vertex_i) {
+            VertexType new_vertex_i = map_label(other.GetLabel(vertex_i));
+            vertex_map[vertex_i] = new_vertex_i;
+            if (new_vertex_i != -1) {
+                subgraph.start_ = std::min(subgraph.start_, new_vertex_i);
+                subgraph.end_ = std::max(subgraph.end_, new_vertex_i + 1);
+            }
+        }
+        if (subgraph.start_ >= subgraph.end_) {
+            return {};
+        }
+        for (SizeT vertex_i = 0; vertex_i < other_n; ++vertex_i) {
+            VertexType new_vertex_i = vertex_map[vertex_i];
+            if (new_vertex_i == -1) {
+                continue;
+            }
+            i32 layer_n = other.data_store_.GetLayerN(vertex_i);
+            data_store_.AddVertex(new_vertex_i, layer_n);
+            for (i32 layer_i = 0; layer_i <= layer_n; ++layer_i) {
+                auto [neighbors_p, neighbor_size] = other.data_store_.GetNeighbors(vertex_i, layer_i);
+                auto [new_neighbors_p, new_neighbor_size_p] = data_store_.GetNeighborsMut(new_vertex_i, layer_i);
+                VertexListSize new_neighbor_size = 0;
+                for (VertexListSize i = 0; i < neighbor_size; ++i) {
+                    if (VertexType n_idx = vertex_map[neighbors_p[i]]; n_idx != -1) {
+                        new_neighbors_p[new_neighbor_size++] = n_idx;
+                    }
+                }
+                *new_neighbor_size_p = new_neighbor_size;
+            }
+            // the enter point of `other` may be dropped
+            if (layer_n > subgraph.max_layer_) {
+                subgraph.max_layer_ = layer_n;
+                subgraph.enter_point_ = new_vertex_i;
+            }
         }
+        return subgraph;
+    }
+
+    // Merge subgraphs over disjoint vertex ranges into one graph. The subgraph reaching the highest layer keeps its edges and
+    // provides the enter point. Each vertex of the other subgraphs is searched in the merged graph and the results are merged into its
+    // neighbor lists, so the edges inside the subgraphs are reused and only the edges across their boundaries are added.
+    void MergeSubgraphs(const Vector<HnswSubgraph> &subgraphs, SizeT worker_count, HnswBuildProgress &progress) {
+        if (subgraphs.empty()) {
+            return;
+        }
+        SizeT base = 0;
+        for (SizeT i = 1; i < subgraphs.size(); ++i) {
+            if (subgraphs[i].max_layer_ > subgraphs[base].max_layer_) {
+                base = i;
+            }
+        }
+        data_store_.TryUpdateEnterPoint(subgraphs[base].max_layer_, subgraphs[base].enter_point_);
+
+        // vertex k of the merged subgraphs is the vertex k - offsets[i] of subgraph i, where offsets[i] <= k < offsets[i + 1]
+        Vector<SizeT> subgraph_ids;
+        Vector<SizeT> offsets{0};
+        for (SizeT i = 0; i < subgraphs.size(); ++i) {
+            if (i != base && subgraphs[i].start_ < subgraphs[i].end_) {
+                subgraph_ids.push_back(i);
+                offsets.push_back(offsets.back() + (subgraphs[i].end_ - subgraphs[i].start_));
+            }
+        }
+        const SizeT repair_n = offsets.back();
+        progress.total_ += repair_n;
+        // the subgraphs are good approximations already, their vertices are searched with a smaller ef than a build
+        const SizeT ef = std::max(data_store_.Mmax0(), ef_construction_ / 2);
+        Utility::RunParallel(repair_n, worker_count, [&](SizeT k) {
+            SizeT i = std::upper_bound(offsets.begin(), offsets.end(), k) - offsets.begin() - 1;
+            RepairVertex(subgraphs[subgraph_ids[i]].start_ + static_cast<VertexType>(k - offsets[i]), ef);
+            ++progress.done_;
+        });
     }
 
     KnnHnsw<CompressVecStoreType, LabelType> CompressToLVQ() && {
@@ -375,6 +827,39 @@ public:
         return KnnSearch<NoneType, WithLock>(q, k, None);
     }
 
+    // KnnSearch for a filter that few vertices pass, see SearchLayerExpanded.
+    template <FilterConcept<LabelType> Filter, bool WithLock = true>
+    Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<LabelType[]>> KnnSearchExpanded(const QueryVecType &q, SizeT k, const Filter &filter) const {
+        auto [result_n, d_ptr, v_ptr] = KnnSearchInner<WithLock, Filter, true>(q, k, filter);
+        auto labels = MakeUniqueForOverwrite<LabelType[]>(result_n);
+        for (SizeT i = 0; i < result_n; ++i) {
+            labels[i] = GetLabel(v_ptr[i]);
+        }
+        return {result_n, std::move(d_ptr), std::move(labels)};
+    }
+
+    // Search `query_n` queries, the result of each query is the same as KnnSearch.
+    template <FilterConcept<LabelType> Filter = NoneType, bool WithLock = true>
+    Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<LabelType[]>>>
+    KnnSearchBatch(const QueryVecType *qs, SizeT query_n, SizeT k, const Filter &filter) const {
+        auto inner_results = KnnSearchBatchInner<WithLock, Filter>(qs, query_n, k, filter);
+        Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<LabelType[]>>> results;
+        results.reserve(query_n);
+        for (auto &[result_n, d_ptr, v_ptr] : inner_results) {
+            auto labels = MakeUniqueForOverwrite<LabelType[]>(result_n);
+            for (SizeT i = 0; i < result_n; ++i) {
+                labels[i] = GetLabel(v_ptr[i]);
+            }
+            results.emplace_back(result_n, std::move(d_ptr), std::move(labels));
+        }
+        return results;
+    }
+
+    template <bool WithLock = true>
+    Vector<Tuple<SizeT, UniquePtr<DataType[]>, UniquePtr<LabelType[]>>> KnnSearchBatch(const QueryVecType *qs, SizeT query_n, SizeT k) const {
+        return KnnSearchBatch<NoneType, WithLock>(qs, query_n, k, None);
+    }
+
     // function for test, add sort for convenience
     template <FilterConcept<LabelType> Filter = NoneType, bool WithLock = true>
     Vector<Pair<DataType, LabelType>> KnnSearchSorted(const QueryVecType &q, SizeT k, const Filter &filter) const {
@@ -402,6 +887,7 @@ private:
     // 1 / log(1.0 * M_)
     double mult_;
     std::default_random_engine level_rng_{};
+    std::mutex level_rng_mutex_;
 
     DataStore data_store_;
     Distance distance_;
@@ -96,6 +96,93 @@ public:
 export template <typename Filter, typename LabelType>
 concept FilterConcept = requires(LabelType label) { std::is_same_v<Filter, NoneType> || std::is_base_of_v<FilterBase<LabelType>, Filter>; };
 
+// Visited marks of the vertices in one search. A vertex is visited only if its mark equals the current epoch, so starting a new
+// search bumps the epoch instead of allocating and zeroing a table of the whole graph. The table is cleared once the epoch wraps.
+export class VisitedTable {
+public:
+    void Reset(SizeT vertex_n) {
+        if (marks_.size() < vertex_n) {
+            marks_.resize(vertex_n, 0);
+        }
+        if (++epoch_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    // Mark the vertex and return whether it was visited before.
+    inline bool TestAndSet(VertexType vertex_i) {
+        if (marks_[vertex_i] == epoch_) {
+            return true;
+        }
+        marks_[vertex_i] = epoch_;
+        return false;
+    }
+
+    // One table per thread, reused by all searches of the thread.
+    static VisitedTable &ThreadLocal() {
+        thread_local VisitedTable visited_table;
+        return visited_table;
+    }
+
+    // Tables of a batch of searches running together in the thread, at least `n` of them.
+    static Vector<VisitedTable> &ThreadLocalBatch(SizeT n) {
+        Vector<VisitedTable> &visited_tables = ThreadLocalBatchTables();
+        if (visited_tables.size() < n) {
+            visited_tables.resize(n);
+        }
+        return visited_tables;
+    }
+
+    // Free the batch tables of the thread beyond the first BATCH_CACHE_BYTES of marks, called when a batched search of all its queries
+    // is done. A search over a large graph would otherwise pin one table of the whole graph per query in every thread.
+    static void ShrinkThreadLocalBatch() {
+        Vector<VisitedTable> &visited_tables = ThreadLocalBatchTables();
+        SizeT kept_bytes = 0;
+        SizeT keep_n = 0;
+        for (; keep_n < visited_tables.size(); ++keep_n) {
+            kept_bytes += visited_tables[keep_n].marks_.size() * sizeof(u16);
+            if (kept_bytes > BATCH_CACHE_BYTES) {
+                break;
+            }
+        }
+        visited_tables.resize(keep_n);
+    }
+
+    static constexpr SizeT BATCH_CACHE_BYTES = 16 * 1024 * 1024;
+
+private:
+    static Vector<VisitedTable> &ThreadLocalBatchTables() {
+        thread_local Vector<VisitedTable> visited_tables;
+        return visited_tables;
+    }
+
+    Vector<u16> marks_{};
+    u16 epoch_{0};
+};
+
+// Steps of an index build, one per vertex linked or repaired by a merge, readable while the build runs.
+export struct HnswBuildProgress {
+    Atomic<SizeT> total_{0};
+    Atomic<SizeT> done_{0};
+};
+
+// Part of a graph over the vertices [start_, end_) whose edges stay inside the part, built apart from the rest of the graph and
+// merged into it afterwards.
+export struct HnswSubgraph {
+    VertexType start_{};
+    VertexType end_{};
+    i32 max_layer_{-1};
+    VertexType enter_point_{-1};
+};
+
+// Whole-segment builds of at least this many vertices run on all workers.
+export constexpr SizeT HNSW_PARALLEL_BUILD_MIN_VERTICES = 8192;
+// From this many vertices, each worker builds the subgraph of a range of the vertices, and the subgraphs are merged at the end.
+export constexpr SizeT HNSW_BULK_BUILD_MIN_VERTICES = 1 << 20;
+// A concurrent build logs its progress this many times.
+export constexpr SizeT HNSW_PROGRESS_LOG_STEPS = 16;
+
 export struct HnswInsertConfig {
     bool optimize_;
 };
@@ -32,10 +32,35 @@ public:
     virtual ~MergeKnnBase() = default;
 };
 
+// The best threshold published by the tasks of a knn scan for each query. A task has top k results better than its threshold, so
+// results of any task that are not better than the published threshold can't be in the merged top k. The distances are stored so
+// that smaller is better, negated for the metrics where larger is better.
+export class MergeKnnBound {
+public:
+    explicit MergeKnnBound(SizeT query_count) : bounds_(query_count) {
+        for (auto &bound : bounds_) {
+            bound.store(std::numeric_limits<f64>::max(), std::memory_order_relaxed);
+        }
+    }
+
+    f64 Get(SizeT query_id) const { return bounds_[query_id].load(std::memory_order_relaxed); }
+
+    void Tighten(SizeT query_id, f64 bound) {
+        f64 old_bound = bounds_[query_id].load(std::memory_order_relaxed);
+        while (bound < old_bound && !bounds_[query_id].compare_exchange_weak(old_bound, bound, std::memory_order_relaxed)) {
+        }
+    }
+
+private:
+    Vector<Atomic<f64>> bounds_;
+};
+
 export template <typename DataType, template <typename, typename> typename C>
 class MergeKnn final : public MergeKnnBase {
     using ResultHandler = ReservoirResultHandler<C<DataType, RowID>>;
     using DistFunc = DataType (*)(const DataType *, const DataType *, SizeT);
+    // Computes the distance until it is known to be no better than the last argument, see L2DistanceBounded.
+    using BoundedDistFunc = DataType (*)(const DataType *, const DataType *, SizeT, DataType);
 
 public:
     explicit MergeKnn(u64 query_count, u64 topk)
@@ -53,6 +78,15 @@ public:
 
     void Search(const DataType *query, const DataType *data, u32 dim, DistFunc dist_f, u16 row_cnt, u32 segment_id, u16 block_id, Bitmask &bitmask);
 
+    void Search(const DataType *query,
+                const DataType *data,
+                u32 dim,
+                BoundedDistFunc dist_f,
+                u16 row_cnt,
+                u32 segment_id,
+                u16 block_id,
+                Bitmask &bitmask);
+
     void Search(const DataType *dist, const RowID *row_ids, u16 count);
 
     void Search(SizeT query_id, const DataType *dist, const RowID *row_ids, u16 count);
@@ -73,6 +107,12 @@ public:
 
     i64 total_count() const { return total_count_; }
 
+    // Publish the thresholds of this task to `bound` and drop the later results not better than the published ones.
+    void SyncBound(MergeKnnBound &bound);
+
+    // The current threshold of a query, results not better than it are dropped.
+    DataType GetThreshold(SizeT query_id) const { return result_handler_->GetThreshold(query_id); }
+
 private:
     i64 total_count_{};
     bool begin_{false};
@@ -138,6 +178,33 @@ void MergeKnn<DataType, C>::Search(const DataType *query,
     }
 }
 
+template <typename DataType, template <typename, typename> typename C>
+void MergeKnn<DataType, C>::Search(const DataType *query,
+                                   const DataType *data,
+                                   u32 dim,
+                                   BoundedDistFunc dist_f,
+                                   u16 row_cnt,
+                                   u32 segment_id,
+                                   u16 block_id,
+                                   Bitmask &bitmask) {
+    const bool all_true = bitmask.IsAllTrue();
+    u32 segment_offset_start = block_id * DEFAULT_BLOCK_CAPACITY;
+    for (u64 i = 0; i < this->query_count_; ++i) {
+        const DataType *x_i = query + i * dim;
+        const DataType *y_j = data;
+        for (u16 j = 0; j < row_cnt; ++j, y_j += dim) {
+            if (all_true || bitmask.IsTrue(j)) {
+                if (i == 0) {
+                    ++this->total_count_;
+                }
+                // the threshold only tightens, an abandoned distance is rejected by AddResult
+                auto dist = dist_f(x_i, y_j, dim, result_handler_->GetThreshold(i));
+                result_handler_->AddResult(i, dist, RowID(segment_id, segment_offset_start + j));
+            }
+        }
+    }
+}
+
 template <typename DataType, template <typename, typename> typename C>
 void MergeKnn<DataType, C>::Search(const DataType *dist, const RowID *row_ids, u16 count) {
     this->total_count_ += count;
@@ -160,6 +227,22 @@ void MergeKnn<DataType, C>::Search(SizeT query_id, const DataType *dist, const R
     }
 }
 
+template <typename DataType, template <typename, typename> typename C>
+void MergeKnn<DataType, C>::SyncBound(MergeKnnBound &bound) {
+    using Compare = C<DataType, RowID>;
+    constexpr f64 sign = Compare::IsMax ? 1.0 : -1.0;
+    for (u64 i = 0; i < this->query_count_; ++i) {
+        DataType threshold = result_handler_->GetThreshold(i);
+        if (threshold != Compare::InitialValue()) {
+            bound.Tighten(i, sign * threshold);
+        }
+        f64 global_bound = bound.Get(i);
+        if (global_bound != std::numeric_limits<f64>::max()) {
+            result_handler_->TightenThreshold(i, static_cast<DataType>(sign * global_bound));
+        }
+    }
+}
+
 template <typename DataType, template <typename, typename> typename C>
 void MergeKnn<DataType, C>::Begin() {
     if (this->begin_ || this->query_count_ == 0) {
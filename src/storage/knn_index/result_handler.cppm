@@ -453,6 +453,13 @@ public:
 
     [[nodiscard]] SizeT GetSize(SizeT q_id) const { return sizes[q_id]; }
 
+    // Drop the later results not better than `bound`, known to be beaten by top_k results elsewhere.
+    void TightenThreshold(SizeT q_id, DistType bound) {
+        if (Compare::Compare(thresholds[q_id], bound)) {
+            thresholds[q_id] = bound;
+        }
+    }
+
     void AddResult(SizeT q_id, DistType distance, ID id) {
         auto q_id_distance = reservoir_distance_ptr.get() + q_id * capacity;
         auto q_id_id = reservoir_id_ptr.get() + q_id * capacity;
@@ -244,6 +244,21 @@ u64 ChunkIndexEntry::GetColumnLengthSum() const {
     return column_length_sum;
 }
 
+SharedPtr<Vector<u8>> ChunkIndexEntry::GetColumnNorms() {
+    std::lock_guard lock(column_norms_mutex_);
+    if (column_norms_.get() == nullptr) {
+        assert(segment_index_entry_->table_index_entry()->index_base()->index_type_ == IndexType::kFullText);
+        BufferHandle buffer_handle = buffer_obj_->Load();
+        const u32 *column_lengths = (const u32 *)buffer_handle.GetData();
+        auto column_norms = MakeShared<Vector<u8>>(row_count_);
+        for (SizeT i = 0; i < row_count_; i++) {
+            (*column_norms)[i] = ColumnLengthToNorm(column_lengths[i]);
+        }
+        column_norms_ = std::move(column_norms);
+    }
+    return column_norms_;
+}
+
 BufferHandle ChunkIndexEntry::GetIndex() { return buffer_obj_->Load(); }
 
 nlohmann::json ChunkIndexEntry::Serialize() {
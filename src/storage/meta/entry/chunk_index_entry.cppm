@@ -100,6 +100,9 @@ public:
     // Only for fulltext
     u64 GetColumnLengthSum() const;
 
+    // Only for fulltext. The column lengths quantized by ColumnLengthToNorm, loaded on first use and shared by all queries.
+    SharedPtr<Vector<u8>> GetColumnNorms();
+
     inline u32 GetPartNum() const { return (row_count_ + 8191) / 8192; }
 
     inline u32 GetPartRowCount(const u32 part_id) const { return std::min<u32>(8192, row_count_ - part_id * 8192); }
@@ -154,6 +157,9 @@ public:
 private:
     BufferObj *buffer_obj_{};
     Vector<BufferObj *> part_buffer_objs_;
+
+    std::mutex column_norms_mutex_;
+    SharedPtr<Vector<u8>> column_norms_;
 };
 
 } // namespace infinity
@@ -37,6 +37,11 @@ import hnsw_alg;
 import catalog_delta_entry;
 import column_vector;
 import annivfflat_index_data;
+import annivfpq_index_data;
+import diskann_index_data;
+import index_ivfflat;
+import float16;
+import bfloat16;
 import secondary_index_data;
 import type_info;
 import embedding_info;
@@ -46,6 +51,8 @@ import block_column_entry;
 import default_values;
 import segment_iter;
 import annivfflat_index_file_worker;
+import annivfpq_index_file_worker;
+import diskann_index_file_worker;
 import hnsw_file_worker;
 import secondary_index_file_worker;
 import bmp_index_file_worker;
@@ -63,9 +70,31 @@ import secondary_index_in_mem;
 import emvb_index;
 import emvb_index_in_mem;
 import bmp_util;
+import infinity_context;
+import config;
+import utility;
+import task_scheduler;
+import defer_op;
 
 namespace infinity {
 
+namespace {
+
+// An index build runs on the calling thread and on the extra threads given by the scheduler workers idle at the moment, the
+// reserved workers are released with ReleaseExtraWorkers once the build is done. One idle worker is left so that queries
+// aren't stalled by a long build.
+u64 ReserveIndexBuildWorkers() {
+    const i64 cpu_limit = InfinityContext::instance().config()->CPULimit();
+    if (cpu_limit <= 1) {
+        return 0;
+    }
+    return InfinityContext::instance().task_scheduler()->ReserveExtraWorkers(cpu_limit - 1, 1);
+}
+
+void ReleaseIndexBuildWorkers(u64 extra_worker_count) { InfinityContext::instance().task_scheduler()->ReleaseExtraWorkers(extra_worker_count); }
+
+} // namespace
+
 Vector<std::string_view> SegmentIndexEntry::DecodeIndex(std::string_view encode) {
     SizeT delimiter_i = encode.rfind('#');
     if (delimiter_i == String::npos) {
@@ -212,6 +241,38 @@ Vector<UniquePtr<IndexFileWorker>> SegmentIndexEntry::CreateFileWorkers(SharedPt
             }
             break;
         }
+        case IndexType::kIVFPQ: {
+            auto create_annivfpq_param = static_cast<CreateAnnIVFFlatParam *>(param);
+            auto elem_type = ((EmbeddingInfo *)(column_def->type()->type_info().get()))->Type();
+            switch (elem_type) {
+                case kElemFloat: {
+                    file_worker =
+                        MakeUnique<AnnIVFPQIndexFileWorker<f32>>(index_dir, file_name, index_base, column_def, create_annivfpq_param->row_count_);
+                    break;
+                }
+                default: {
+                    String error_message = "Create IVF PQ index: Unsupported element type.";
+                    LOG_CRITICAL(error_message);
+                    UnrecoverableError(error_message);
+                }
+            }
+            break;
+        }
+        case IndexType::kDiskAnn: {
+            auto elem_type = ((EmbeddingInfo *)(column_def->type()->type_info().get()))->Type();
+            switch (elem_type) {
+                case kElemFloat: {
+                    file_worker = MakeUnique<DiskAnnIndexFileWorker<f32>>(index_dir, file_name, index_base, column_def);
+                    break;
+                }
+                default: {
+                    String error_message = "Create DiskAnn index: Unsupported element type.";
+                    LOG_CRITICAL(error_message);
+                    UnrecoverableError(error_message);
+                }
+            }
+            break;
+        }
         default: {
             UniquePtr<String> err_msg =
                 MakeUnique<String>(fmt::format("File worker isn't implemented: {}", IndexInfo::IndexTypeToString(index_base->index_type_)));
@@ -331,7 +392,9 @@ void SegmentIndexEntry::MemIndexInsert(SharedPtr<BlockEntry> block_entry,
             memory_secondary_index_->Insert(block_id, block_column_entry, buffer_manager, row_offset, row_count);
             break;
         }
-        case IndexType::kIVFFlat: {
+        case IndexType::kIVFFlat:
+        case IndexType::kIVFPQ:
+        case IndexType::kDiskAnn: {
             UniquePtr<String> err_msg =
                 MakeUnique<String>(fmt::format("{} realtime index is not supported yet", IndexInfo::IndexTypeToString(index_base->index_type_)));
             LOG_WARN(*err_msg);
@@ -542,8 +605,28 @@ void SegmentIndexEntry::PopulateEntirely(const SegmentEntry *segment_entry, Txn
                         insert_config.optimize_ = true;
                         SegmentOffset start_i, end_i;
                         if (!config.prepare_) {
-                            // Single thread insert
-                            std::tie(start_i, end_i) = abstract_hnsw.InsertVecs(std::move(iter), insert_config);
+                            // Store the data, then link the vertices on all workers
+                            std::tie(start_i, end_i) = abstract_hnsw.StoreData(std::move(iter), insert_config);
+                            const SizeT vertex_n = end_i - start_i;
+                            const u64 extra_worker_count = vertex_n < HNSW_PARALLEL_BUILD_MIN_VERTICES ? 0 : ReserveIndexBuildWorkers();
+                            DeferFn release_workers([&] { ReleaseIndexBuildWorkers(extra_worker_count); });
+                            const SizeT worker_count = 1 + extra_worker_count;
+                            HnswBuildProgress &progress = build_progress_;
+                            progress.total_ = 0;
+                            progress.done_ = 0;
+                            LOG_INFO(fmt::format("Build hnsw index of {} vectors with {} workers", vertex_n, worker_count));
+                            if (vertex_n < HNSW_PARALLEL_BUILD_MIN_VERTICES || worker_count == 1) {
+                                progress.total_ += vertex_n;
+                                for (SegmentOffset i = start_i; i < end_i; ++i) {
+                                    abstract_hnsw.Build(i);
+                                    ++progress.done_;
+                                }
+                            } else if (vertex_n < HNSW_BULK_BUILD_MIN_VERTICES) {
+                                abstract_hnsw.BuildParallel(start_i, end_i, worker_count, progress);
+                            } else {
+                                abstract_hnsw.BuildBulk(start_i, end_i, worker_count, progress);
+                            }
+                            LOG_INFO(fmt::format("Built hnsw index, {} of {} build steps done", progress.done_.load(), progress.total_.load()));
                         } else {
                             // Multi thread insert data, write file in the physical create index finish stage.
                             std::tie(start_i, end_i) = abstract_hnsw.StoreData(std::move(iter), insert_config);
@@ -596,7 +679,9 @@ void SegmentIndexEntry::PopulateEntirely(const SegmentEntry *segment_entry, Txn
             data_ptr->BuildEMVBIndex(base_row_id, row_count, segment_entry, column_def, buffer_mgr);
             break;
         }
-        case IndexType::kIVFFlat: { // TODO
+        case IndexType::kIVFFlat:
+        case IndexType::kIVFPQ:
+        case IndexType::kDiskAnn: { // TODO
             UniquePtr<String> err_msg =
                 MakeUnique<String>(fmt::format("{} PopulateEntirely is not supported yet", IndexInfo::IndexTypeToString(index_base->index_type_)));
             LOG_WARN(*err_msg);
@@ -666,15 +751,71 @@ Status SegmentIndexEntry::CreateIndexPrepare(const SegmentEntry *segment_entry,
             BufferHandle buffer_handle = GetIndex();
             switch (embedding_info->Type()) {
                 case kElemFloat: {
-                    auto annivfflat_index = reinterpret_cast<AnnIVFFlatIndexData<f32> *>(buffer_handle.GetDataMut());
-                    // TODO: How to select training data?
+                    auto build_index = [&]<typename IndexData>() {
+                        auto annivfflat_index = reinterpret_cast<IndexData *>(buffer_handle.GetDataMut());
+                        // TODO: How to select training data?
+                        if (check_ts) {
+                            OneColumnIterator<float> iter(segment_entry, buffer_mgr, column_def->id(), begin_ts);
+                            annivfflat_index->BuildIndex(iter, dimension, full_row_count);
+                        } else {
+                            // Not check ts in uncommitted segment when compact segment
+                            OneColumnIterator<float, false> iter(segment_entry, buffer_mgr, column_def->id(), begin_ts);
+                            annivfflat_index->BuildIndex(iter, dimension, full_row_count);
+                        }
+                    };
+                    switch (static_cast<const IndexIVFFlat *>(index_base)->encode_type_) {
+                        case IVFFlatEncodeType::kPlain: {
+                            build_index.template operator()<AnnIVFFlatIndexData<f32>>();
+                            break;
+                        }
+                        case IVFFlatEncodeType::kFloat16: {
+                            build_index.template operator()<AnnIVFFlatIndexData<f32, float16_t>>();
+                            break;
+                        }
+                        case IVFFlatEncodeType::kBFloat16: {
+                            build_index.template operator()<AnnIVFFlatIndexData<f32, bfloat16_t>>();
+                            break;
+                        }
+                        case IVFFlatEncodeType::kInt8: {
+                            build_index.template operator()<AnnIVFFlatIndexData<f32, u8>>();
+                            break;
+                        }
+                        default: {
+                            String error_message = "Invalid IVFFlat encode type";
+                            LOG_CRITICAL(error_message);
+                            UnrecoverableError(error_message);
+                        }
+                    }
+                    break;
+                }
+                default: {
+                    Status status = Status::NotSupport("Not support data type for index ivf.");
+                    LOG_ERROR(status.message());
+                    RecoverableError(status);
+                }
+            }
+            break;
+        }
+        case IndexType::kIVFPQ: {
+            if (column_def->type()->type() != LogicalType::kEmbedding) {
+                String error_message = "AnnIVFPQ only supports embedding type.";
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+            auto embedding_info = static_cast<EmbeddingInfo *>(column_def->type()->type_info().get());
+            u32 dimension = embedding_info->Dimension();
+            u32 full_row_count = segment_entry->row_count();
+            BufferHandle buffer_handle = GetIndex();
+            switch (embedding_info->Type()) {
+                case kElemFloat: {
+                    auto annivfpq_index = reinterpret_cast<AnnIVFPQIndexData<f32> *>(buffer_handle.GetDataMut());
                     if (check_ts) {
                         OneColumnIterator<float> iter(segment_entry, buffer_mgr, column_def->id(), begin_ts);
-                        annivfflat_index->BuildIndex(iter, dimension, full_row_count);
+                        annivfpq_index->BuildIndex(iter, dimension, full_row_count);
                     } else {
                         // Not check ts in uncommitted segment when compact segment
                         OneColumnIterator<float, false> iter(segment_entry, buffer_mgr, column_def->id(), begin_ts);
-                        annivfflat_index->BuildIndex(iter, dimension, full_row_count);
+                        annivfpq_index->BuildIndex(iter, dimension, full_row_count);
                     }
                     break;
                 }
@@ -686,6 +827,40 @@ Status SegmentIndexEntry::CreateIndexPrepare(const SegmentEntry *segment_entry,
             }
             break;
         }
+        case IndexType::kDiskAnn: {
+            if (column_def->type()->type() != LogicalType::kEmbedding) {
+                String error_message = "DiskAnn only supports embedding type.";
+                LOG_CRITICAL(error_message);
+                UnrecoverableError(error_message);
+            }
+            auto embedding_info = static_cast<EmbeddingInfo *>(column_def->type()->type_info().get());
+            u32 dimension = embedding_info->Dimension();
+            u32 full_row_count = segment_entry->row_count();
+            const u64 extra_worker_count = ReserveIndexBuildWorkers();
+            DeferFn release_workers([&] { ReleaseIndexBuildWorkers(extra_worker_count); });
+            const SizeT worker_count = 1 + extra_worker_count;
+            BufferHandle buffer_handle = GetIndex();
+            switch (embedding_info->Type()) {
+                case kElemFloat: {
+                    auto diskann_index = reinterpret_cast<DiskAnnIndexData<f32> *>(buffer_handle.GetDataMut());
+                    if (check_ts) {
+                        OneColumnIterator<float> iter(segment_entry, buffer_mgr, column_def->id(), begin_ts);
+                        diskann_index->BuildIndex(iter, dimension, full_row_count, worker_count);
+                    } else {
+                        // Not check ts in uncommitted segment when compact segment
+                        OneColumnIterator<float, false> iter(segment_entry, buffer_mgr, column_def->id(), begin_ts);
+                        diskann_index->BuildIndex(iter, dimension, full_row_count, worker_count);
+                    }
+                    break;
+                }
+                default: {
+                    Status status = Status::NotSupport("Not support data type for index diskann.");
+                    LOG_ERROR(status.message());
+                    RecoverableError(status);
+                }
+            }
+            break;
+        }
         case IndexType::kHnsw: {
             PopulateEntirely(segment_entry, txn, populate_entire_config);
             break;
@@ -747,6 +922,9 @@ Status SegmentIndexEntry::CreateIndexDo(atomic_u64 &create_index_idx) {
                                 break;
                             }
                             abstract_hnsw.Build(offset + idx);
+                            if (row_count >= HNSW_PROGRESS_LOG_STEPS && (idx + 1) % (row_count / HNSW_PROGRESS_LOG_STEPS) == 0) {
+                                LOG_INFO(fmt::format("Build hnsw index: {} of {} vectors claimed", idx + 1, row_count));
+                            }
                         }
                         break;
                     }
@@ -766,6 +944,80 @@ Status SegmentIndexEntry::CreateIndexDo(atomic_u64 &create_index_idx) {
     return Status::OK();
 }
 
+bool SegmentIndexEntry::CreateIndexByMerge(const Vector<SegmentIndexEntry *> &old_index_entries,
+                                           const std::function<Optional<SegmentOffset>(SegmentID, SegmentOffset)> &remap,
+                                           TxnTimeStamp begin_ts) {
+    const IndexBase *index_base = table_index_entry_->index_base();
+    const ColumnDef *column_def = table_index_entry_->column_def().get();
+    if (index_base->index_type_ != IndexType::kHnsw) {
+        return false;
+    }
+    auto embedding_info = static_cast<EmbeddingInfo *>(column_def->type()->type_info().get());
+    if (embedding_info->Type() != kElemFloat) {
+        return false;
+    }
+    auto *index_hnsw = static_cast<const IndexHnsw *>(index_base);
+
+    Vector<SharedPtr<ChunkIndexEntry>> chunk_index_entries;
+    GetChunkIndexEntries(chunk_index_entries);
+    if (chunk_index_entries.size() != 1 || chunk_index_entries[0]->base_rowid_.segment_offset_ != 0) {
+        return false;
+    }
+    const SegmentOffset row_count = chunk_index_entries[0]->row_count_;
+    BufferHandle buffer_handle = chunk_index_entries[0]->GetIndex();
+    AbstractHnsw<f32, SegmentOffset> abstract_hnsw(buffer_handle.GetDataMut(), index_hnsw);
+
+    // The graph of each chunk of the compacted segments is copied as a subgraph, the moved rows keep their neighbors.
+    Vector<HnswSubgraph> subgraphs;
+    Vector<bool> linked(row_count, false);
+    for (SegmentIndexEntry *old_index_entry : old_index_entries) {
+        const SegmentID old_segment_id = old_index_entry->segment_id();
+        Vector<SharedPtr<ChunkIndexEntry>> old_chunk_index_entries;
+        old_index_entry->GetChunkIndexEntries(old_chunk_index_entries, begin_ts);
+        for (const auto &old_chunk_index_entry : old_chunk_index_entries) {
+            BufferHandle old_buffer_handle = old_chunk_index_entry->GetIndex();
+            AbstractHnsw<f32, SegmentOffset> old_abstract_hnsw(const_cast<void *>(old_buffer_handle.GetData()), index_hnsw);
+            HnswSubgraph subgraph = abstract_hnsw.CopyGraph(old_abstract_hnsw, [&](SegmentOffset old_offset) -> VertexType {
+                Optional<SegmentOffset> new_offset = remap(old_segment_id, old_offset);
+                if (!new_offset.has_value() || *new_offset >= row_count || linked[*new_offset]) {
+                    return -1;
+                }
+                linked[*new_offset] = true;
+                return *new_offset;
+            });
+            if (subgraph.start_ < subgraph.end_) {
+                subgraphs.push_back(subgraph);
+            }
+        }
+    }
+
+    const u64 extra_worker_count = ReserveIndexBuildWorkers();
+    DeferFn release_workers([&] { ReleaseIndexBuildWorkers(extra_worker_count); });
+    const SizeT worker_count = 1 + extra_worker_count;
+    HnswBuildProgress &progress = build_progress_;
+    progress.total_ = 0;
+    progress.done_ = 0;
+    abstract_hnsw.MergeSubgraphs(subgraphs, worker_count, progress);
+    // The rows that were not in a graph, such as the rows of a compacted segment without a dumped index, are inserted.
+    Vector<SegmentOffset> unlinked_offsets;
+    for (SegmentOffset offset = 0; offset < row_count; ++offset) {
+        if (!linked[offset]) {
+            unlinked_offsets.push_back(offset);
+        }
+    }
+    progress.total_ += unlinked_offsets.size();
+    Utility::RunParallel(unlinked_offsets.size(), worker_count, [&](SizeT i) {
+        abstract_hnsw.Build(unlinked_offsets[i]);
+        ++progress.done_;
+    });
+    LOG_INFO(fmt::format("Merged hnsw index of segment {} from {} subgraphs, {} of {} rows inserted",
+                         segment_id_,
+                         subgraphs.size(),
+                         unlinked_offsets.size(),
+                         row_count));
+    return true;
+}
+
 void SegmentIndexEntry::CommitSegmentIndex(TransactionID txn_id, TxnTimeStamp commit_ts) {
     std::unique_lock lock(rw_locker_);
 
@@ -907,7 +1159,9 @@ void SegmentIndexEntry::PickCleanup(CleanupScanner *scanner) {
 UniquePtr<CreateIndexParam>
 SegmentIndexEntry::GetCreateIndexParam(SharedPtr<IndexBase> index_base, SizeT seg_row_count, SharedPtr<ColumnDef> column_def) {
     switch (index_base->index_type_) {
-        case IndexType::kIVFFlat: {
+        case IndexType::kIVFFlat:
+        case IndexType::kIVFPQ: {
+            // IVF-PQ only needs the segment row count for the default centroids count as well
             return MakeUnique<CreateAnnIVFFlatParam>(index_base, column_def, seg_row_count);
         }
         case IndexType::kHnsw: {
@@ -927,6 +1181,9 @@ SegmentIndexEntry::GetCreateIndexParam(SharedPtr<IndexBase> index_base, SizeT se
         case IndexType::kBMP: {
             return MakeUnique<CreateIndexParam>(index_base, column_def);
         }
+        case IndexType::kDiskAnn: {
+            return MakeUnique<CreateIndexParam>(index_base, column_def);
+        }
         default: {
             UniquePtr<String> err_msg =
                 MakeUnique<String>(fmt::format("Invalid index type: {}", IndexInfo::IndexTypeToString(index_base->index_type_)));
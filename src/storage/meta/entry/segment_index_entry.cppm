@@ -34,6 +34,7 @@ import chunk_index_entry;
 import memory_indexer;
 import default_values;
 import statement_common;
+import hnsw_common;
 
 namespace infinity {
 
@@ -115,6 +116,8 @@ public:
     inline TxnTimeStamp max_ts() const { return max_ts_; }
     inline ChunkID next_chunk_id() const { return next_chunk_id_; }
     SharedPtr<String> index_dir() const { return index_dir_; }
+    // Progress of the running or the last HNSW build of the segment.
+    const HnswBuildProgress &build_progress() const { return build_progress_; }
 
     // MemIndexInsert is non-blocking. Caller must ensure there's no RowID gap between each call.
     void MemIndexInsert(SharedPtr<BlockEntry> block_entry, u32 row_offset, u32 row_count, TxnTimeStamp commit_ts, BufferManager *buffer_manager);
@@ -137,6 +140,13 @@ public:
 
     Status CreateIndexDo(atomic_u64 &create_index_idx);
 
+    // Link the prepared hnsw index of a segment made by compaction from the graphs of the compacted segments. `remap` gives the offset
+    // in this segment of a row of a compacted segment, None if the row is not moved. Only the chunks of the compacted segments visible
+    // at `begin_ts` of the compacting txn are merged. Return false if the index is not merged.
+    bool CreateIndexByMerge(const Vector<SegmentIndexEntry *> &old_index_entries,
+                            const std::function<Optional<SegmentOffset>(SegmentID, SegmentOffset)> &remap,
+                            TxnTimeStamp begin_ts);
+
     static UniquePtr<CreateIndexParam> GetCreateIndexParam(SharedPtr<IndexBase> index_base, SizeT seg_row_count, SharedPtr<ColumnDef> column_def);
 
     void GetChunkIndexEntries(Vector<SharedPtr<ChunkIndexEntry>> &chunk_index_entries, TxnTimeStamp begin_ts = MAX_TIMESTAMP) {
@@ -256,6 +266,7 @@ private:
     TxnTimeStamp max_ts_{0}; // Indicate the max commit_ts which update data inside this SegmentIndexEntry
     TxnTimeStamp checkpoint_ts_{0};
     ChunkID next_chunk_id_{0};
+    HnswBuildProgress build_progress_{};
 
     Vector<SharedPtr<ChunkIndexEntry>> chunk_index_entries_{};
     SharedPtr<ChunkIndexEntry> memory_hnsw_indexer_{};
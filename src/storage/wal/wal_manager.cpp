@@ -55,11 +55,74 @@ import default_values;
 import defer_op;
 import index_base;
 import base_table_ref;
+import file_system;
+import file_system_type;
+import utility;
 
 module wal_manager;
 
 namespace infinity {
 
+namespace {
+
+enum class ReplayScope {
+    kNone,    // nothing to replay
+    kTable,   // all commands change the same table
+    kCatalog, // changes databases or tables, or more than one table, or builds an index
+};
+
+ReplayScope GetReplayScope(const WalEntry &entry, String &table_key) {
+    table_key.clear();
+    for (const auto &cmd : entry.cmds_) {
+        String cmd_table_key;
+        switch (cmd->GetType()) {
+            case WalCommandType::CHECKPOINT: {
+                continue;
+            }
+            case WalCommandType::DROP_INDEX: {
+                const auto *drop_index_cmd = static_cast<const WalCmdDropIndex *>(cmd.get());
+                cmd_table_key = fmt::format("{}.{}", drop_index_cmd->db_name_, drop_index_cmd->table_name_);
+                break;
+            }
+            case WalCommandType::IMPORT: {
+                const auto *import_cmd = static_cast<const WalCmdImport *>(cmd.get());
+                cmd_table_key = fmt::format("{}.{}", import_cmd->db_name_, import_cmd->table_name_);
+                break;
+            }
+            case WalCommandType::APPEND: {
+                const auto *append_cmd = static_cast<const WalCmdAppend *>(cmd.get());
+                cmd_table_key = fmt::format("{}.{}", append_cmd->db_name_, append_cmd->table_name_);
+                break;
+            }
+            case WalCommandType::DELETE: {
+                const auto *delete_cmd = static_cast<const WalCmdDelete *>(cmd.get());
+                cmd_table_key = fmt::format("{}.{}", delete_cmd->db_name_, delete_cmd->table_name_);
+                break;
+            }
+            case WalCommandType::COMPACT: {
+                const auto *compact_cmd = static_cast<const WalCmdCompact *>(cmd.get());
+                cmd_table_key = fmt::format("{}.{}", compact_cmd->db_name_, compact_cmd->table_name_);
+                break;
+            }
+            case WalCommandType::CREATE_INDEX:
+            case WalCommandType::OPTIMIZE: {
+                // Index builds run on threads of their own, they are replayed alone so the threads don't multiply with the partitions.
+                return ReplayScope::kCatalog;
+            }
+            default: {
+                return ReplayScope::kCatalog;
+            }
+        }
+        if (!table_key.empty() && table_key != cmd_table_key) {
+            return ReplayScope::kCatalog;
+        }
+        table_key = std::move(cmd_table_key);
+    }
+    return table_key.empty() ? ReplayScope::kNone : ReplayScope::kTable;
+}
+
+} // namespace
+
 WalManager::WalManager(Storage *storage,
                        String wal_dir,
                        u64 wal_size_threshold,
@@ -96,16 +159,14 @@ void WalManager::Start() {
         fs.CreateDirectory(wal_dir_);
     }
     // TODO: recovery from wal checkpoint
-    ofs_ = std::ofstream(wal_path_, std::ios::app | std::ios::binary);
-    if (!ofs_.is_open()) {
-        String error_message = fmt::format("Failed to open wal file: {}", wal_path_);
-        LOG_CRITICAL(error_message);
-        UnrecoverableError(error_message);
-    }
+    OpenWalFile();
     LOG_INFO(fmt::format("Open wal file: {}", wal_path_));
 
     wal_size_ = 0;
     flush_thread_ = Thread([this] { Flush(); });
+    if (flush_option_ == FlushOptionType::kFlushPerSecond) {
+        flush_timer_thread_ = Thread([this] { FlushTimer(); });
+    }
     // checkpoint_thread_ = Thread([this] { CheckpointTimer(); });
     LOG_INFO("WAL manager is started.");
 }
@@ -132,7 +193,22 @@ void WalManager::Stop() {
     LOG_TRACE("WalManager::Stop flush thread join");
     flush_thread_.join();
 
-    ofs_.close();
+    if (flush_timer_thread_.joinable()) {
+        {
+            std::lock_guard guard(flush_timer_mutex_);
+            flush_timer_cv_.notify_one();
+        }
+        flush_timer_thread_.join();
+    }
+
+    if (flush_option_ != FlushOptionType::kOnlyWrite) {
+        SyncWalFile();
+    }
+    {
+        std::lock_guard guard(wal_file_mutex_);
+        wal_file_handler_->Close();
+        wal_file_handler_.reset();
+    }
     LOG_INFO("WAL manager is stopped.");
 }
 
@@ -166,10 +242,13 @@ TxnTimeStamp WalManager::GetCheckpointedTS() { return last_ckp_ts_ == UNCOMMIT_T
 // wal and do parallel committing. Each sync cost ~1s. Each checkpoint cost
 // ~10s. So it's necessary to sync for a batch of transactions, and to
 // checkpoint for a batch of sync.
+// All entries queued while the previous batch is written and synced form the next batch (group commit):
+// they are written with one write, synced at most once, and committed together.
 void WalManager::Flush() {
     LOG_TRACE("WalManager::Flush log mainloop begin");
 
     Deque<WalEntry *> log_batch{};
+    Vector<char> batch_buffer{};
     TxnManager *txn_mgr = storage_->txn_manager();
     while (running_.load()) {
         wait_flush_.DequeueBulk(log_batch);
@@ -178,7 +257,9 @@ void WalManager::Flush() {
             continue;
         }
         // auto [max_commit_ts, wal_size] = GetWalState();
+        auto flush_begin = std::chrono::steady_clock::now();
 
+        batch_buffer.clear();
         for (const auto &entry : log_batch) {
             // Empty WalEntry (read-only transactions) shouldn't go into WalManager.
             if (entry == nullptr) {
@@ -193,22 +274,23 @@ void WalManager::Flush() {
             }
 
             i32 exp_size = entry->GetSizeInBytes();
-            Vector<char> buf(exp_size);
-            char *ptr = buf.data();
+            SizeT offset = batch_buffer.size();
+            batch_buffer.resize(offset + exp_size);
+            char *ptr = batch_buffer.data() + offset;
             entry->WriteAdv(ptr);
-            i32 act_size = ptr - buf.data();
+            i32 act_size = ptr - (batch_buffer.data() + offset);
             if (exp_size != act_size) {
                 String error_message = fmt::format("WalManager::Flush WalEntry estimated size {} differ with the actual one {}", exp_size, act_size);
                 LOG_CRITICAL(error_message);
                 UnrecoverableError(error_message);
             }
-            ofs_.write(buf.data(), ptr - buf.data());
             LOG_TRACE(fmt::format("WalManager::Flush done writing wal for txn_id {}, commit_ts {}", entry->txn_id_, entry->commit_ts_));
 
             // update
             max_commit_ts_ = entry->commit_ts_;
             wal_size_ += act_size;
         }
+        WriteWalFile(batch_buffer);
 
         if (!running_.load()) {
             break;
@@ -216,18 +298,18 @@ void WalManager::Flush() {
 
         switch (flush_option_) {
             case FlushOptionType::kFlushAtOnce: {
-                ofs_.flush();
-                break;
-            }
-            case FlushOptionType::kOnlyWrite: {
-                ofs_.flush(); // FIXME: not flush, only write
+                SyncWalFile();
                 break;
             }
+            case FlushOptionType::kOnlyWrite:
             case FlushOptionType::kFlushPerSecond: {
-                ofs_.flush(); // FIXME: not flush, flush per second
+                // The OS or FlushTimer syncs the written entries.
                 break;
             }
         }
+        auto flush_end = std::chrono::steady_clock::now();
+        flush_latency_histogram_.Record(std::chrono::duration_cast<std::chrono::microseconds>(flush_end - flush_begin).count());
+        flush_batch_size_histogram_.Record(log_batch.size());
 
         for (const auto &entry : log_batch) {
             Txn *txn = txn_mgr->GetTxn(entry->txn_id_);
@@ -265,6 +347,47 @@ void WalManager::Flush() {
     LOG_TRACE("WalManager::Flush mainloop end");
 }
 
+void WalManager::FlushTimer() {
+    LOG_TRACE("WalManager::FlushTimer mainloop begin");
+    std::unique_lock lock(flush_timer_mutex_);
+    while (running_.load()) {
+        flush_timer_cv_.wait_for(lock, std::chrono::seconds(1), [this] { return !running_.load(); });
+        SyncWalFile();
+    }
+    LOG_TRACE("WalManager::FlushTimer mainloop end");
+}
+
+void WalManager::OpenWalFile() {
+    u8 file_flags = FileFlags::WRITE_FLAG | FileFlags::CREATE_FLAG | FileFlags::APPEND_FLAG;
+    auto [wal_file_handler, status] = wal_fs_.OpenFile(wal_path_, file_flags, FileLockType::kNoLock);
+    if (!status.ok()) {
+        String error_message = fmt::format("Failed to open wal file: {}, {}", wal_path_, status.message());
+        LOG_CRITICAL(error_message);
+        UnrecoverableError(error_message);
+    }
+    std::lock_guard guard(wal_file_mutex_);
+    wal_file_handler_ = std::move(wal_file_handler);
+    wal_file_synced_ = true;
+}
+
+void WalManager::WriteWalFile(const Vector<char> &buffer) {
+    if (buffer.empty()) {
+        return;
+    }
+    std::lock_guard guard(wal_file_mutex_);
+    wal_fs_.Write(*wal_file_handler_, buffer.data(), buffer.size());
+    wal_file_synced_ = false;
+}
+
+void WalManager::SyncWalFile() {
+    std::lock_guard guard(wal_file_mutex_);
+    if (wal_file_synced_ || wal_file_handler_.get() == nullptr) {
+        return;
+    }
+    wal_fs_.SyncFileData(*wal_file_handler_);
+    wal_file_synced_ = true;
+}
+
 bool WalManager::TrySubmitCheckpointTask(SharedPtr<CheckpointTaskBase> ckp_task) {
     bool expect = false;
     if (checkpoint_in_progress_.compare_exchange_strong(expect, true)) {
@@ -364,8 +487,12 @@ void WalManager::CheckpointInner(bool is_full_checkpoint, Txn *txn, TxnTimeStamp
  * current wal file.
  */
 void WalManager::SwapWalFile(const TxnTimeStamp max_commit_ts) {
-    if (ofs_.is_open()) {
-        ofs_.close();
+    // The renamed file is not written any more, sync it before it is closed.
+    SyncWalFile();
+    {
+        std::lock_guard guard(wal_file_mutex_);
+        wal_file_handler_->Close();
+        wal_file_handler_.reset();
     }
 
     String new_file_path = fmt::format("{}/{}", wal_dir_, WalFile::WalFilename(max_commit_ts));
@@ -376,12 +503,7 @@ void WalManager::SwapWalFile(const TxnTimeStamp max_commit_ts) {
     fs.Rename(wal_path_, new_file_path);
 
     // Create a new wal file with the original name.
-    ofs_ = std::ofstream(wal_path_, std::ios::app | std::ios::binary);
-    if (!ofs_.is_open()) {
-        String error_message = fmt::format("Failed to open wal file: {}", wal_path_);
-        LOG_CRITICAL(error_message);
-        UnrecoverableError(error_message);
-    }
+    OpenWalFile();
     LOG_INFO(fmt::format("Open new wal file {}", wal_path_));
 }
 
@@ -539,10 +661,8 @@ i64 WalManager::ReplayWalFile() {
         }
         system_start_ts = replay_entries[replay_count]->commit_ts_;
         last_txn_id = replay_entries[replay_count]->txn_id_;
-
-        LOG_TRACE(replay_entries[replay_count]->ToString());
-        ReplayWalEntry(*replay_entries[replay_count]);
     }
+    ReplayWalEntries(replay_entries);
 
     LOG_INFO(fmt::format("System start ts: {}, latest txn id: {}", system_start_ts, last_txn_id));
     storage_->catalog()->next_txn_id_ = last_txn_id;
@@ -555,6 +675,80 @@ i64 WalManager::ReplayWalFile() {
     return system_start_ts;
 }
 
+void WalManager::ReplayWalEntries(const Vector<SharedPtr<WalEntry>> &replay_entries) {
+    SizeT entry_count = replay_entries.size();
+    if (entry_count == 0) {
+        return;
+    }
+    SizeT worker_count = std::max<SizeT>(1, Thread::hardware_concurrency());
+    SizeT progress_interval = std::max<SizeT>(1, entry_count / 10);
+    auto replay_begin = std::chrono::steady_clock::now();
+    Atomic<SizeT> replayed_count{0};
+    auto report_progress = [&](SizeT count) {
+        if (count % progress_interval != 0 && count != entry_count) {
+            return;
+        }
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - replay_begin).count();
+        LOG_INFO(fmt::format("Replay phase 3: replayed {}/{} entries in {} ms, {:.1f} entries/s",
+                             count,
+                             entry_count,
+                             elapsed_ms,
+                             count * 1000.0 / std::max<i64>(1, elapsed_ms)));
+    };
+
+    // Entries of each table in commit order, replayed concurrently with the other tables.
+    HashMap<String, SizeT> table_partition_map;
+    Vector<Vector<const WalEntry *>> table_partitions;
+    auto replay_table_partitions = [&] {
+        Utility::RunParallel(table_partitions.size(), worker_count, [&](SizeT partition_idx) {
+            for (const WalEntry *entry : table_partitions[partition_idx]) {
+                LOG_TRACE(entry->ToString());
+                ReplayWalEntry(*entry);
+                report_progress(++replayed_count);
+            }
+        });
+        table_partition_map.clear();
+        table_partitions.clear();
+    };
+
+    i64 replay_bytes = 0;
+    String table_key;
+    for (const auto &entry : replay_entries) {
+        replay_bytes += entry->size_;
+        switch (GetReplayScope(*entry, table_key)) {
+            case ReplayScope::kNone: {
+                report_progress(++replayed_count);
+                break;
+            }
+            case ReplayScope::kTable: {
+                auto [iter, inserted] = table_partition_map.emplace(table_key, table_partitions.size());
+                if (inserted) {
+                    table_partitions.emplace_back();
+                }
+                table_partitions[iter->second].emplace_back(entry.get());
+                break;
+            }
+            case ReplayScope::kCatalog: {
+                // Catalog changes and index builds are barriers, the entries before them are replayed first.
+                replay_table_partitions();
+                LOG_TRACE(entry->ToString());
+                ReplayWalEntry(*entry);
+                report_progress(++replayed_count);
+                break;
+            }
+        }
+    }
+    replay_table_partitions();
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - replay_begin).count();
+    LOG_INFO(fmt::format("Replay phase 3: {} entries, {} bytes replayed in {} ms with {} threads, {:.2f} MB/s",
+                         entry_count,
+                         replay_bytes,
+                         elapsed_ms,
+                         worker_count,
+                         replay_bytes / 1000.0 / std::max<i64>(1, elapsed_ms)));
+}
+
 void WalManager::ReplayWalEntry(const WalEntry &entry) {
     for (const auto &cmd : entry.cmds_) {
         LOG_TRACE(fmt::format("Replay wal cmd: {}, commit ts: {}", WalCmd::WalCommandTypeToString(cmd->GetType()).c_str(), entry.commit_ts_));
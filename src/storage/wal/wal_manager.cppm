@@ -22,6 +22,9 @@ import wal_entry;
 import options;
 import catalog_delta_entry;
 import blocking_queue;
+import file_system;
+import local_file_system;
+import histogram;
 
 namespace infinity {
 
@@ -52,6 +55,9 @@ public:
     // checkpoint for a batch of sync.
     void Flush();
 
+    // Sync the written entries once per second in kFlushPerSecond mode.
+    void FlushTimer();
+
     bool TrySubmitCheckpointTask(SharedPtr<CheckpointTaskBase> ckp_task);
 
     void Checkpoint(bool is_full_checkpoint, TxnTimeStamp max_commit_ts, i64 wal_size);
@@ -66,6 +72,9 @@ public:
 
     void ReplayWalEntry(const WalEntry &entry);
 
+    // Replay entries in commit order. Entries of different tables are replayed concurrently between two catalog changes.
+    void ReplayWalEntries(const Vector<SharedPtr<WalEntry>> &replay_entries);
+
     void RecycleWalFile(TxnTimeStamp full_ckp_ts);
 
     // Should only call in `Flush` thread
@@ -75,7 +84,19 @@ public:
 
     TxnTimeStamp GetCheckpointedTS();
 
+    // Committed transactions of each flush batch.
+    const Log2Histogram &flush_batch_size_histogram() const { return flush_batch_size_histogram_; }
+
+    // Microseconds to write and sync each flush batch.
+    const Log2Histogram &flush_latency_histogram() const { return flush_latency_histogram_; }
+
 private:
+    void OpenWalFile();
+
+    void WriteWalFile(const Vector<char> &buffer);
+
+    void SyncWalFile();
+
     // Checkpoint Helper
     void CheckpointInner(bool is_full_checkpoint, Txn *txn, TxnTimeStamp max_commit_ts, i64 wal_size);
 
@@ -115,12 +136,23 @@ private:
     // WalManager state
     Atomic<bool> running_{};
     Thread flush_thread_{};
+    Thread flush_timer_thread_{};
+    std::mutex flush_timer_mutex_{};
+    std::condition_variable flush_timer_cv_{};
 
     // TxnManager and Flush thread access following members
     BlockingQueue<WalEntry *> wait_flush_{};
 
+    // Flush and FlushTimer threads access following members
+    std::mutex wal_file_mutex_{};
+    LocalFileSystem wal_fs_{};
+    UniquePtr<FileHandler> wal_file_handler_{};
+    bool wal_file_synced_{true};
+
+    Log2Histogram flush_batch_size_histogram_{};
+    Log2Histogram flush_latency_histogram_{};
+
     // Only Flush thread access following members
-    std::ofstream ofs_{};
     TxnTimeStamp max_commit_ts_{};
     i64 wal_size_{};
     FlushOptionType flush_option_{FlushOptionType::kOnlyWrite};
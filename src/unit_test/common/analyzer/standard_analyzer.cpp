@@ -17,6 +17,9 @@
 import stl;
 import term;
 import standard_analyzer;
+import analyzer;
+import analyzer_pool;
+import status;
 using namespace infinity;
 
 namespace fs = std::filesystem;
@@ -138,3 +141,30 @@ TEST_F(StandardAnalyzerTest, test6) {
         std::cout << std::endl;
     }
 }
+
+TEST_F(StandardAnalyzerTest, test_thread_local_analyzer) {
+    auto [analyzer, status] = AnalyzerPool::instance().GetThreadLocalAnalyzer("standard");
+    ASSERT_TRUE(status.ok());
+    // reused by the later calls of the same thread
+    auto [analyzer_again, status_again] = AnalyzerPool::instance().GetThreadLocalAnalyzer("standard");
+    ASSERT_TRUE(status_again.ok());
+    EXPECT_EQ(analyzer, analyzer_again);
+
+    Analyzer *other_thread_analyzer = nullptr;
+    std::thread([&other_thread_analyzer] {
+        auto [thread_analyzer, thread_status] = AnalyzerPool::instance().GetThreadLocalAnalyzer("standard");
+        EXPECT_TRUE(thread_status.ok());
+        other_thread_analyzer = thread_analyzer;
+    }).join();
+    EXPECT_NE(other_thread_analyzer, nullptr);
+    EXPECT_NE(other_thread_analyzer, analyzer);
+
+    TermList term_list;
+    analyzer->Analyze(String("Boost unit tests."), term_list);
+    ASSERT_FALSE(term_list.empty());
+    ASSERT_EQ(term_list[0].text_, String("boost"));
+
+    auto [invalid_analyzer, invalid_status] = AnalyzerPool::instance().GetThreadLocalAnalyzer("unknown");
+    EXPECT_FALSE(invalid_status.ok());
+    EXPECT_EQ(invalid_analyzer, nullptr);
+}
@@ -0,0 +1,45 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import histogram;
+
+using namespace infinity;
+
+class HistogramTest : public BaseTest {};
+
+TEST_F(HistogramTest, log2_buckets) {
+    EXPECT_EQ(Log2Histogram::BucketIndex(0), 0u);
+    EXPECT_EQ(Log2Histogram::BucketIndex(1), 1u);
+    EXPECT_EQ(Log2Histogram::BucketIndex(3), 2u);
+    EXPECT_EQ(Log2Histogram::BucketIndex(4), 3u);
+    EXPECT_EQ(Log2Histogram::BucketIndex(std::numeric_limits<u64>::max()), 64u);
+    EXPECT_EQ(Log2Histogram::BucketUpperBound(3), 7u);
+
+    Log2Histogram histogram;
+    EXPECT_EQ(histogram.Percentile(0.5), 0u);
+    for (u64 value = 1; value <= 100; ++value) {
+        histogram.Record(value);
+    }
+    EXPECT_EQ(histogram.Count(), 100u);
+    EXPECT_EQ(histogram.Sum(), 5050u);
+    EXPECT_EQ(histogram.Max(), 100u);
+    // The 50th value is 50 in bucket [32, 63].
+    EXPECT_EQ(histogram.Percentile(0.5), 63u);
+    // The 99th value is 99 in bucket [64, 127], capped by max.
+    EXPECT_EQ(histogram.Percentile(0.99), 100u);
+    EXPECT_EQ(histogram.ToString(), "count: 100, avg: 50.50, p50: 63, p90: 100, p99: 100, max: 100");
+}
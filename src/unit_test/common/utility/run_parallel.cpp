@@ -0,0 +1,51 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import utility;
+import infinity_exception;
+
+using namespace infinity;
+
+class RunParallelTest : public BaseTest {};
+
+TEST_F(RunParallelTest, all_tasks) {
+    SizeT task_count = 100;
+    Vector<Atomic<SizeT>> runs(task_count);
+    Utility::RunParallel(task_count, 4, [&](SizeT task_idx) { ++runs[task_idx]; });
+    for (SizeT task_idx = 0; task_idx < task_count; ++task_idx) {
+        EXPECT_EQ(runs[task_idx].load(), 1u);
+    }
+}
+
+TEST_F(RunParallelTest, rethrow_on_caller) {
+    for (SizeT worker_count : {1, 4}) {
+        Atomic<SizeT> finished{0};
+        try {
+            Utility::RunParallel(100, worker_count, [&](SizeT task_idx) {
+                if (task_idx == 10) {
+                    UnrecoverableError("task failed");
+                }
+                ++finished;
+            });
+            FAIL() << "RunParallel didn't rethrow the task exception";
+        } catch (const UnrecoverableException &e) {
+            EXPECT_EQ(GetErrorMsg(e.what()), "task failed");
+        }
+        // Tasks not started when the exception is thrown are skipped.
+        EXPECT_LT(finished.load(), 100u);
+    }
+}
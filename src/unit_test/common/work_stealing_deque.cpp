@@ -0,0 +1,86 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import work_stealing_deque;
+
+using namespace infinity;
+
+class WorkStealingDequeTest : public BaseTest {};
+
+TEST_F(WorkStealingDequeTest, push_pop_steal) {
+    WorkStealingDeque<i64> deque(2);
+    Vector<i64> values{0, 1, 2, 3, 4};
+    EXPECT_EQ(deque.Pop(), nullptr);
+    EXPECT_EQ(deque.Steal(), nullptr);
+    // Grow the ring twice.
+    for (auto &value : values) {
+        deque.Push(&value);
+    }
+    EXPECT_EQ(deque.Size(), 5u);
+    // The owner pops the newest task, thieves steal the oldest.
+    EXPECT_EQ(deque.Pop(), &values[4]);
+    EXPECT_EQ(deque.Steal(), &values[0]);
+    EXPECT_EQ(deque.Steal(), &values[1]);
+    EXPECT_EQ(deque.Pop(), &values[3]);
+    EXPECT_EQ(deque.Pop(), &values[2]);
+    EXPECT_EQ(deque.Pop(), nullptr);
+    EXPECT_TRUE(deque.Empty());
+}
+
+TEST_F(WorkStealingDequeTest, concurrent_steal) {
+    constexpr SizeT value_count = 100000;
+    constexpr SizeT thief_count = 4;
+    Vector<i64> values(value_count);
+    Vector<Atomic<u32>> taken_counts(value_count);
+    WorkStealingDeque<i64> deque(64);
+    Atomic<bool> done{false};
+
+    auto take = [&](i64 *value) { ++taken_counts[value - values.data()]; };
+    Vector<Thread> thieves;
+    for (SizeT thief_id = 0; thief_id < thief_count; ++thief_id) {
+        thieves.emplace_back([&] {
+            while (true) {
+                bool finished = done.load();
+                i64 *value = deque.Steal();
+                if (value != nullptr) {
+                    take(value);
+                } else if (finished) {
+                    break;
+                }
+            }
+        });
+    }
+    for (SizeT value_idx = 0; value_idx < value_count; ++value_idx) {
+        deque.Push(&values[value_idx]);
+        if (value_idx % 3 == 0) {
+            if (i64 *value = deque.Pop(); value != nullptr) {
+                take(value);
+            }
+        }
+    }
+    while (i64 *value = deque.Pop()) {
+        take(value);
+    }
+    done = true;
+    for (auto &thief : thieves) {
+        thief.join();
+    }
+    // Every value is taken exactly once, either by the owner or by a thief.
+    for (SizeT value_idx = 0; value_idx < value_count; ++value_idx) {
+        EXPECT_EQ(taken_counts[value_idx].load(), 1u);
+    }
+}
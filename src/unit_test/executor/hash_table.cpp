@@ -0,0 +1,235 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import third_party;
+import value;
+import column_vector;
+import logical_type;
+import internal_types;
+import data_type;
+import hash_table;
+import default_values;
+
+using namespace infinity;
+
+class AggregateHashTableTest : public BaseTest {
+protected:
+    static SharedPtr<ColumnVector> MakeBigIntColumn(SizeT row_count, SizeT key_mod, SizeT null_every = 0) {
+        auto column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kBigInt));
+        column->Initialize();
+        for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+            column->AppendValue(Value::MakeBigInt(row_idx % key_mod));
+            if (null_every != 0 && row_idx % null_every == 0) {
+                column->nulls_ptr_->SetFalse(row_idx);
+            }
+        }
+        return column;
+    }
+
+    static SharedPtr<ColumnVector> MakeVarcharColumn(SizeT row_count, SizeT key_mod) {
+        auto column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kVarchar));
+        column->Initialize();
+        for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+            // Long enough to be stored outside of the varchar.
+            column->AppendValue(Value::MakeVarchar(fmt::format("a_long_varchar_group_key_{}", row_idx % key_mod)));
+        }
+        return column;
+    }
+};
+
+TEST_F(AggregateHashTableTest, bigint_key) {
+    AggregateHashTable hash_table({MakeShared<DataType>(LogicalType::kBigInt)}, {sizeof(i64)});
+    Vector<ptr_t> group_ptrs;
+    Vector<ptr_t> new_groups;
+    // Insert the same keys twice, the second round must not create groups.
+    for (SizeT round = 0; round < 2; ++round) {
+        auto column = MakeBigIntColumn(DEFAULT_VECTOR_SIZE, 1000);
+        new_groups.clear();
+        hash_table.FindOrCreateGroups({column}, DEFAULT_VECTOR_SIZE, group_ptrs, new_groups);
+        EXPECT_EQ(new_groups.size(), round == 0 ? 1000u : 0u);
+        for (ptr_t group : new_groups) {
+            *reinterpret_cast<i64 *>(hash_table.GetState(group, 0)) = 0;
+        }
+        for (SizeT row_idx = 0; row_idx < DEFAULT_VECTOR_SIZE; ++row_idx) {
+            ++*reinterpret_cast<i64 *>(hash_table.GetState(group_ptrs[row_idx], 0));
+        }
+    }
+    EXPECT_EQ(hash_table.GroupCount(), 1000u);
+
+    auto output = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kBigInt));
+    output->Initialize();
+    Vector<ptr_t> groups;
+    for (SizeT group_idx = 0; group_idx < hash_table.GroupCount(); ++group_idx) {
+        groups.emplace_back(hash_table.GetGroup(group_idx));
+    }
+    hash_table.AppendKeys(groups, {output});
+    EXPECT_EQ(output->Size(), 1000u);
+    for (SizeT group_idx = 0; group_idx < hash_table.GroupCount(); ++group_idx) {
+        // Groups are created in the order of first appearance.
+        EXPECT_EQ(output->GetValue(group_idx).GetValue<BigIntT>(), static_cast<BigIntT>(group_idx));
+        i64 count = *reinterpret_cast<i64 *>(hash_table.GetState(groups[group_idx], 0));
+        EXPECT_EQ(count, static_cast<i64>(2 * (DEFAULT_VECTOR_SIZE / 1000) + (group_idx < DEFAULT_VECTOR_SIZE % 1000 ? 2 : 0)));
+    }
+}
+
+TEST_F(AggregateHashTableTest, grow) {
+    AggregateHashTable hash_table({MakeShared<DataType>(LogicalType::kBigInt)}, {});
+    SizeT initial_slot_count = hash_table.SlotCount();
+    Vector<ptr_t> group_ptrs;
+    Vector<ptr_t> new_groups;
+    auto column = MakeBigIntColumn(DEFAULT_VECTOR_SIZE, DEFAULT_VECTOR_SIZE);
+    hash_table.FindOrCreateGroups({column}, DEFAULT_VECTOR_SIZE, group_ptrs, new_groups);
+    EXPECT_EQ(hash_table.GroupCount(), static_cast<SizeT>(DEFAULT_VECTOR_SIZE));
+    EXPECT_GE(hash_table.SlotCount(), static_cast<SizeT>(2 * DEFAULT_VECTOR_SIZE));
+    EXPECT_GT(hash_table.SlotCount(), initial_slot_count);
+    // Lookup after grow finds the same groups.
+    Vector<ptr_t> group_ptrs2;
+    new_groups.clear();
+    hash_table.FindOrCreateGroups({column}, DEFAULT_VECTOR_SIZE, group_ptrs2, new_groups);
+    EXPECT_TRUE(new_groups.empty());
+    EXPECT_EQ(group_ptrs, group_ptrs2);
+}
+
+TEST_F(AggregateHashTableTest, null_key) {
+    AggregateHashTable hash_table({MakeShared<DataType>(LogicalType::kBigInt)}, {});
+    Vector<ptr_t> group_ptrs;
+    Vector<ptr_t> new_groups;
+    // Keys 0..9, every even row is NULL, NULL keys belong to one group.
+    auto column = MakeBigIntColumn(100, 10, 2);
+    hash_table.FindOrCreateGroups({column}, 100, group_ptrs, new_groups);
+    EXPECT_EQ(hash_table.GroupCount(), 6u);
+    EXPECT_EQ(group_ptrs[0], group_ptrs[2]);
+
+    auto output = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kBigInt));
+    output->Initialize();
+    hash_table.AppendKeys({group_ptrs[0], group_ptrs[1]}, {output});
+    EXPECT_FALSE(output->nulls_ptr_->IsTrue(0));
+    EXPECT_TRUE(output->nulls_ptr_->IsTrue(1));
+    EXPECT_EQ(output->GetValue(1).GetValue<BigIntT>(), 1);
+}
+
+TEST_F(AggregateHashTableTest, multi_key_with_varchar) {
+    AggregateHashTable hash_table({MakeShared<DataType>(LogicalType::kVarchar), MakeShared<DataType>(LogicalType::kBigInt)}, {sizeof(i64)});
+    Vector<ptr_t> group_ptrs;
+    Vector<ptr_t> new_groups;
+    auto varchar_column = MakeVarcharColumn(1000, 10);
+    auto bigint_column = MakeBigIntColumn(1000, 20);
+    hash_table.FindOrCreateGroups({varchar_column, bigint_column}, 1000, group_ptrs, new_groups);
+    // (i % 10, i % 20) has 20 distinct values.
+    EXPECT_EQ(hash_table.GroupCount(), 20u);
+
+    // The keys are copied into the table, the input column can be released.
+    varchar_column.reset();
+    auto varchar_output = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kVarchar));
+    varchar_output->Initialize();
+    auto bigint_output = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kBigInt));
+    bigint_output->Initialize();
+    hash_table.AppendKeys(new_groups, {varchar_output, bigint_output});
+    for (SizeT group_idx = 0; group_idx < 20; ++group_idx) {
+        EXPECT_EQ(varchar_output->GetValue(group_idx).GetVarchar(), fmt::format("a_long_varchar_group_key_{}", group_idx % 10));
+        EXPECT_EQ(bigint_output->GetValue(group_idx).GetValue<BigIntT>(), static_cast<BigIntT>(group_idx));
+    }
+}
+
+TEST_F(AggregateHashTableTest, merge_partial_groups) {
+    // Two tables aggregate count per key on overlapping inputs, then their groups are merged by partition.
+    Vector<UniquePtr<AggregateHashTable>> partial_tables;
+    for (SizeT key_mod : {100ul, 150ul}) {
+        auto hash_table = MakeUnique<AggregateHashTable>(Vector<SharedPtr<DataType>>{MakeShared<DataType>(LogicalType::kBigInt)}, Vector<SizeT>{sizeof(i64)});
+        Vector<ptr_t> group_ptrs;
+        Vector<ptr_t> new_groups;
+        auto column = MakeBigIntColumn(3000, key_mod);
+        hash_table->FindOrCreateGroups({column}, 3000, group_ptrs, new_groups);
+        for (ptr_t group : new_groups) {
+            *reinterpret_cast<i64 *>(hash_table->GetState(group, 0)) = 0;
+        }
+        for (ptr_t group : group_ptrs) {
+            ++*reinterpret_cast<i64 *>(hash_table->GetState(group, 0));
+        }
+        partial_tables.emplace_back(std::move(hash_table));
+    }
+
+    constexpr SizeT partition_bits = 2;
+    SizeT merged_group_count = 0;
+    for (SizeT partition_idx = 0; partition_idx < (1ul << partition_bits); ++partition_idx) {
+        AggregateHashTable merged_table({MakeShared<DataType>(LogicalType::kBigInt)}, {sizeof(i64)});
+        for (const auto &partial_table : partial_tables) {
+            Vector<ptr_t> groups;
+            Vector<u64> hashes;
+            for (SizeT group_idx = 0; group_idx < partial_table->GroupCount(); ++group_idx) {
+                groups.emplace_back(partial_table->GetGroup(group_idx));
+                hashes.emplace_back(AggregateHashTable::GetHash(groups.back()));
+            }
+            auto key_column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kBigInt));
+            key_column->Initialize();
+            partial_table->AppendKeys(groups, {key_column});
+
+            Vector<u32> rows;
+            for (SizeT row_idx = 0; row_idx < groups.size(); ++row_idx) {
+                if (AggregateHashTable::PartitionOf(hashes[row_idx], partition_bits) == partition_idx) {
+                    rows.emplace_back(row_idx);
+                }
+            }
+            Vector<ptr_t> group_ptrs;
+            Vector<ptr_t> new_groups;
+            merged_table.FindOrCreateGroups({key_column}, hashes.data(), rows, group_ptrs, new_groups);
+            for (ptr_t group : new_groups) {
+                *reinterpret_cast<i64 *>(merged_table.GetState(group, 0)) = 0;
+            }
+            for (SizeT idx = 0; idx < rows.size(); ++idx) {
+                *reinterpret_cast<i64 *>(merged_table.GetState(group_ptrs[idx], 0)) +=
+                    *reinterpret_cast<i64 *>(partial_table->GetState(groups[rows[idx]], 0));
+            }
+        }
+
+        auto output = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kBigInt));
+        output->Initialize();
+        Vector<ptr_t> groups;
+        for (SizeT group_idx = 0; group_idx < merged_table.GroupCount(); ++group_idx) {
+            groups.emplace_back(merged_table.GetGroup(group_idx));
+        }
+        merged_table.AppendKeys(groups, {output});
+        for (SizeT group_idx = 0; group_idx < groups.size(); ++group_idx) {
+            BigIntT key = output->GetValue(group_idx).GetValue<BigIntT>();
+            i64 expected = 3000 / 150 + (key < 100 ? 3000 / 100 : 0);
+            EXPECT_EQ(*reinterpret_cast<i64 *>(merged_table.GetState(groups[group_idx], 0)), expected);
+        }
+        merged_group_count += merged_table.GroupCount();
+    }
+    // Every key is merged in exactly one partition.
+    EXPECT_EQ(merged_group_count, 150u);
+}
+
+TEST_F(AggregateHashTableTest, float_key) {
+    auto column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kDouble));
+    column->Initialize();
+    // 0.0 and -0.0 are one group, all NaNs are another one.
+    const DoubleT nan = std::numeric_limits<DoubleT>::quiet_NaN();
+    Vector<DoubleT> keys{0.0, -0.0, nan, -nan, std::numeric_limits<DoubleT>::signaling_NaN(), 1.5};
+    for (DoubleT key : keys) {
+        column->AppendValue(Value::MakeDouble(key));
+    }
+    AggregateHashTable hash_table({MakeShared<DataType>(LogicalType::kDouble)}, {});
+    Vector<ptr_t> group_ptrs;
+    Vector<ptr_t> new_groups;
+    hash_table.FindOrCreateGroups({column}, keys.size(), group_ptrs, new_groups);
+    EXPECT_EQ(hash_table.GroupCount(), 3u);
+    EXPECT_EQ(group_ptrs[0], group_ptrs[1]);
+    EXPECT_EQ(group_ptrs[2], group_ptrs[3]);
+    EXPECT_EQ(group_ptrs[2], group_ptrs[4]);
+    EXPECT_NE(group_ptrs[0], group_ptrs[5]);
+}
@@ -0,0 +1,153 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import third_party;
+import value;
+import data_block;
+import column_vector;
+import logical_type;
+import internal_types;
+import data_type;
+import join_hash_table;
+
+using namespace infinity;
+
+class JoinHashTableTest : public BaseTest {
+protected:
+    // Blocks of (BigInt key, Varchar payload), key of row i is i % key_mod, every null_every rows has NULL key.
+    static Vector<UniquePtr<DataBlock>> MakeBlocks(SizeT row_count, SizeT key_mod, SizeT null_every) {
+        Vector<SharedPtr<DataType>> types{MakeShared<DataType>(LogicalType::kBigInt), MakeShared<DataType>(LogicalType::kVarchar)};
+        Vector<UniquePtr<DataBlock>> blocks;
+        for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+            if (blocks.empty() || blocks.back()->column_vectors[0]->Size() == blocks.back()->capacity()) {
+                if (!blocks.empty()) {
+                    blocks.back()->Finalize();
+                }
+                blocks.emplace_back(DataBlock::MakeUniquePtr());
+                blocks.back()->Init(types);
+            }
+            DataBlock *block = blocks.back().get();
+            SizeT block_row = block->column_vectors[0]->Size();
+            block->column_vectors[0]->AppendValue(Value::MakeBigInt(row_idx % key_mod));
+            block->column_vectors[1]->AppendValue(Value::MakeVarchar(fmt::format("payload_{}", row_idx % key_mod)));
+            if (null_every != 0 && row_idx % null_every == 0) {
+                block->column_vectors[0]->nulls_ptr_->SetFalse(block_row);
+            }
+        }
+        if (!blocks.empty()) {
+            blocks.back()->Finalize();
+        }
+        return blocks;
+    }
+
+    static SizeT CountMatches(const JoinHashTable &hash_table,
+                              const Vector<UniquePtr<DataBlock>> &probe_blocks,
+                              const Vector<SizeT> &probe_key_ids,
+                              SizeT radix_bits) {
+        Vector<JoinHashEntry> null_key_rows;
+        auto partitions = JoinHashTable::PartitionRows(probe_blocks, probe_key_ids, radix_bits, 4, null_key_rows);
+        SizeT match_count = 0;
+        for (const auto &partition : partitions) {
+            for (const auto &probe_entry : partition) {
+                match_count += hash_table.ForEachMatch(probe_entry,
+                                                       probe_blocks[probe_entry.block_idx_].get(),
+                                                       probe_key_ids,
+                                                       [](const JoinHashEntry &) { return true; });
+            }
+        }
+        return match_count;
+    }
+};
+
+TEST_F(JoinHashTableTest, choose_radix_bits) {
+    EXPECT_EQ(JoinHashTable::ChooseRadixBits(0), 0u);
+    EXPECT_EQ(JoinHashTable::ChooseRadixBits(JOIN_PARTITION_TARGET_ROWS), 0u);
+    EXPECT_EQ(JoinHashTable::ChooseRadixBits(JOIN_PARTITION_TARGET_ROWS * 4), 2u);
+    EXPECT_EQ(JoinHashTable::ChooseRadixBits(std::numeric_limits<u32>::max()), JOIN_MAX_RADIX_BITS);
+}
+
+TEST_F(JoinHashTableTest, partition_rows) {
+    auto blocks = MakeBlocks(10000, 1000, 10);
+    Vector<JoinHashEntry> null_key_rows;
+    auto partitions = JoinHashTable::PartitionRows(blocks, {0}, 3, 4, null_key_rows);
+    EXPECT_EQ(partitions.size(), 8u);
+    EXPECT_EQ(null_key_rows.size(), 1000u);
+    SizeT row_count = 0;
+    for (SizeT partition_idx = 0; partition_idx < partitions.size(); ++partition_idx) {
+        for (const auto &entry : partitions[partition_idx]) {
+            EXPECT_EQ(JoinHashTable::PartitionOf(entry.hash_, 3), partition_idx);
+        }
+        row_count += partitions[partition_idx].size();
+    }
+    EXPECT_EQ(row_count, 9000u);
+}
+
+TEST_F(JoinHashTableTest, bigint_key) {
+    // Build keys 0..99, each appears 10 times except NULL rows.
+    auto build_blocks = MakeBlocks(1000, 100, 0);
+    // Probe keys 0..199, only half of them can match.
+    auto probe_blocks = MakeBlocks(400, 200, 0);
+    for (SizeT radix_bits : {0ul, 2ul, 5ul}) {
+        JoinHashTable hash_table(&build_blocks, {0}, radix_bits);
+        hash_table.Build(4);
+        EXPECT_EQ(hash_table.RowCount(), 1000u);
+        EXPECT_EQ(hash_table.PartitionCount(), 1ul << radix_bits);
+        // 200 probe rows have key < 100, each matches 10 build rows.
+        EXPECT_EQ(CountMatches(hash_table, probe_blocks, {0}, radix_bits), 2000u);
+    }
+}
+
+TEST_F(JoinHashTableTest, varchar_key) {
+    auto build_blocks = MakeBlocks(1000, 100, 0);
+    auto probe_blocks = MakeBlocks(400, 200, 0);
+    JoinHashTable hash_table(&build_blocks, {1}, 2);
+    hash_table.Build(2);
+    EXPECT_EQ(CountMatches(hash_table, probe_blocks, {1}, 2), 2000u);
+}
+
+TEST_F(JoinHashTableTest, null_key) {
+    // Every other build row has a NULL key.
+    auto build_blocks = MakeBlocks(1000, 100, 2);
+    auto probe_blocks = MakeBlocks(100, 100, 0);
+    JoinHashTable hash_table(&build_blocks, {0}, 0);
+    hash_table.Build(1);
+    EXPECT_EQ(hash_table.RowCount(), 500u);
+    // Even keys are always NULL on the build side.
+    EXPECT_EQ(CountMatches(hash_table, probe_blocks, {0}, 0), 500u);
+}
+
+TEST_F(JoinHashTableTest, float_key) {
+    auto make_blocks = [](const Vector<FloatT> &keys) {
+        Vector<UniquePtr<DataBlock>> blocks;
+        blocks.emplace_back(DataBlock::MakeUniquePtr());
+        blocks.back()->Init({MakeShared<DataType>(LogicalType::kFloat)});
+        for (FloatT key : keys) {
+            blocks.back()->column_vectors[0]->AppendValue(Value::MakeFloat(key));
+        }
+        blocks.back()->Finalize();
+        return blocks;
+    };
+    const FloatT nan = std::numeric_limits<FloatT>::quiet_NaN();
+    auto build_blocks = make_blocks({0.0f, nan, 2.0f});
+    // -0.0 joins 0.0, NaN joins NaN whatever its sign
+    auto probe_blocks = make_blocks({-0.0f, -nan, 3.0f});
+    for (SizeT radix_bits : {0ul, 2ul}) {
+        JoinHashTable hash_table(&build_blocks, {0}, radix_bits);
+        hash_table.Build(2);
+        EXPECT_EQ(CountMatches(hash_table, probe_blocks, {0}, radix_bits), 2u);
+    }
+}
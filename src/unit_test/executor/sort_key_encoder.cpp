@@ -0,0 +1,118 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import third_party;
+import value;
+import column_vector;
+import logical_type;
+import internal_types;
+import data_type;
+import select_statement;
+import sort_key_encoder;
+
+using namespace infinity;
+
+class SortKeyEncoderTest : public BaseTest {
+protected:
+    // Row order given by the encoded keys, ties keep the row order.
+    static Vector<SizeT> SortRows(const SortKeyEncoder &encoder, const Vector<SharedPtr<ColumnVector>> &columns, SizeT row_count) {
+        Vector<char> keys(row_count * encoder.key_size());
+        encoder.Encode(columns, row_count, keys.data());
+        Vector<SizeT> rows(row_count);
+        for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+            rows[row_idx] = row_idx;
+        }
+        std::stable_sort(rows.begin(), rows.end(), [&](SizeT left, SizeT right) {
+            SizeT key_size = encoder.key_size();
+            return encoder.Compare({keys.data() + left * key_size, &columns, left}, {keys.data() + right * key_size, &columns, right}) < 0;
+        });
+        return rows;
+    }
+};
+
+TEST_F(SortKeyEncoderTest, bigint_with_null) {
+    auto column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kBigInt));
+    column->Initialize();
+    for (BigIntT value : {3l, -5l, 0l, 100l, -1l, 7l}) {
+        column->AppendValue(Value::MakeBigInt(value));
+    }
+    column->nulls_ptr_->SetFalse(5);
+
+    SortKeyEncoder asc_encoder({MakeShared<DataType>(LogicalType::kBigInt)}, {OrderType::kAsc});
+    EXPECT_EQ(asc_encoder.key_size(), 1 + sizeof(BigIntT));
+    // NULL is the smallest value.
+    EXPECT_EQ(SortRows(asc_encoder, {column}, 6), (Vector<SizeT>{5, 1, 4, 2, 0, 3}));
+
+    SortKeyEncoder desc_encoder({MakeShared<DataType>(LogicalType::kBigInt)}, {OrderType::kDesc});
+    EXPECT_EQ(SortRows(desc_encoder, {column}, 6), (Vector<SizeT>{3, 0, 2, 4, 1, 5}));
+}
+
+TEST_F(SortKeyEncoderTest, double_and_multi_key) {
+    auto integer_column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kInteger));
+    integer_column->Initialize();
+    auto double_column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kDouble));
+    double_column->Initialize();
+    Vector<Pair<IntegerT, DoubleT>> rows{{1, 2.5}, {0, -0.0}, {1, -3.25}, {0, 0.0}, {1, 1e100}, {0, -1e-100}};
+    for (const auto &[integer_value, double_value] : rows) {
+        integer_column->AppendValue(Value::MakeInt(integer_value));
+        double_column->AppendValue(Value::MakeDouble(double_value));
+    }
+
+    SortKeyEncoder encoder({MakeShared<DataType>(LogicalType::kInteger), MakeShared<DataType>(LogicalType::kDouble)},
+                           {OrderType::kAsc, OrderType::kDesc});
+    // -0.0 and 0.0 are equal and keep the input order.
+    EXPECT_EQ(SortRows(encoder, {integer_column, double_column}, rows.size()), (Vector<SizeT>{1, 3, 5, 4, 0, 2}));
+}
+
+TEST_F(SortKeyEncoderTest, varchar_longer_than_prefix) {
+    auto column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kVarchar));
+    column->Initialize();
+    String common_prefix(SORT_KEY_VARCHAR_PREFIX_SIZE, 'x');
+    Vector<String> values{common_prefix + "b", "abc", common_prefix + "a", "", common_prefix, "ab"};
+    for (const auto &value : values) {
+        column->AppendValue(Value::MakeVarchar(value));
+    }
+
+    SortKeyEncoder asc_encoder({MakeShared<DataType>(LogicalType::kVarchar)}, {OrderType::kAsc});
+    EXPECT_EQ(SortRows(asc_encoder, {column}, values.size()), (Vector<SizeT>{3, 5, 1, 4, 2, 0}));
+
+    SortKeyEncoder desc_encoder({MakeShared<DataType>(LogicalType::kVarchar)}, {OrderType::kDesc});
+    EXPECT_EQ(SortRows(desc_encoder, {column}, values.size()), (Vector<SizeT>{0, 2, 4, 1, 5, 3}));
+}
+
+TEST_F(SortKeyEncoderTest, varchar_prefix_before_other_key) {
+    auto varchar_column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kVarchar));
+    varchar_column->Initialize();
+    auto integer_column = MakeShared<ColumnVector>(MakeShared<DataType>(LogicalType::kInteger));
+    integer_column->Initialize();
+    String common_prefix(SORT_KEY_VARCHAR_PREFIX_SIZE, 'x');
+    // The integer key must not decide the order of strings that only differ after the prefix.
+    Vector<Pair<String, IntegerT>> rows{{common_prefix + "a", 3}, {common_prefix + "c", 1}, {common_prefix + "b", 2}, {common_prefix, 0},
+                                        {common_prefix + "a", 0}};
+    for (const auto &[varchar_value, integer_value] : rows) {
+        varchar_column->AppendValue(Value::MakeVarchar(varchar_value));
+        integer_column->AppendValue(Value::MakeInt(integer_value));
+    }
+
+    SortKeyEncoder asc_encoder({MakeShared<DataType>(LogicalType::kVarchar), MakeShared<DataType>(LogicalType::kInteger)},
+                               {OrderType::kAsc, OrderType::kAsc});
+    EXPECT_EQ(SortRows(asc_encoder, {varchar_column, integer_column}, rows.size()), (Vector<SizeT>{3, 4, 0, 2, 1}));
+
+    SortKeyEncoder desc_encoder({MakeShared<DataType>(LogicalType::kVarchar), MakeShared<DataType>(LogicalType::kInteger)},
+                                {OrderType::kDesc, OrderType::kAsc});
+    EXPECT_EQ(SortRows(desc_encoder, {varchar_column, integer_column}, rows.size()), (Vector<SizeT>{1, 2, 4, 0, 3}));
+}
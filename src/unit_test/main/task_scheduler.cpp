@@ -0,0 +1,100 @@
+// Copyright(C) 2023 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import config;
+import task_scheduler;
+import infinity_context;
+import sql_runner;
+import data_table;
+import global_resource_usage;
+
+class TaskSchedulerTest : public BaseTest {
+    void SetUp() override {
+        BaseTest::SetUp();
+        BaseTest::RemoveDbDirs();
+#ifdef INFINITY_DEBUG
+        infinity::GlobalResourceUsage::Init();
+#endif
+        std::shared_ptr<std::string> config_path = nullptr;
+        infinity::InfinityContext::instance().Init(config_path);
+    }
+
+    void TearDown() override {
+        infinity::InfinityContext::instance().UnInit();
+#ifdef INFINITY_DEBUG
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetObjectCount(), 0);
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetRawMemoryCount(), 0);
+        infinity::GlobalResourceUsage::UnInit();
+#endif
+        BaseTest::TearDown();
+    }
+};
+
+TEST_F(TaskSchedulerTest, reserve_extra_workers) {
+    using namespace infinity;
+    SharedPtr<String> path = nullptr;
+    Config config;
+    config.Init(path, nullptr);
+    const u64 worker_count = std::min<u64>(Thread::hardware_concurrency(), config.CPULimit());
+
+    TaskScheduler task_scheduler(&config);
+    // No task is scheduled, so all workers are idle.
+    EXPECT_EQ(task_scheduler.ReserveExtraWorkers(worker_count + 1), worker_count);
+    EXPECT_EQ(task_scheduler.ReserveExtraWorkers(1), 0u);
+
+    task_scheduler.ReleaseExtraWorkers(1);
+    EXPECT_EQ(task_scheduler.ReserveExtraWorkers(worker_count), 1u);
+
+    task_scheduler.ReleaseExtraWorkers(worker_count);
+    EXPECT_EQ(task_scheduler.ReserveExtraWorkers(0), 0u);
+    EXPECT_EQ(task_scheduler.ReserveExtraWorkers(worker_count, 1), worker_count - 1);
+    task_scheduler.ReleaseExtraWorkers(worker_count - 1);
+    task_scheduler.UnInit();
+}
+
+TEST_F(TaskSchedulerTest, reserved_workers_hold_back_queries) {
+    using namespace infinity;
+    TaskScheduler *task_scheduler = InfinityContext::instance().task_scheduler();
+    const u64 worker_count = std::min<u64>(Thread::hardware_concurrency(), InfinityContext::instance().config()->CPULimit());
+
+    SQLRunner::Run("create table t1(a bigint)", false);
+    SQLRunner::Run("insert into t1 values(1);", false);
+    SQLRunner::Run("insert into t1 values(2);", false);
+    SQLRunner::Run("insert into t1 values(3);", false);
+
+    // An index build holds all workers, the query tasks wait instead of running next to the build threads.
+    EXPECT_EQ(task_scheduler->ReserveExtraWorkers(worker_count), worker_count);
+    Atomic<bool> query_done{false};
+    Thread query_thread([&] {
+        SharedPtr<DataTable> result = SQLRunner::Run("select a from t1", false);
+        EXPECT_EQ(result->row_count(), 3u);
+        query_done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_FALSE(query_done);
+    EXPECT_EQ(task_scheduler->busy_worker_count(), 0u);
+
+    // Half of the workers are given back, the query runs on them only.
+    const u64 release_count = (worker_count + 1) / 2;
+    task_scheduler->ReleaseExtraWorkers(release_count);
+    query_thread.join();
+    EXPECT_TRUE(query_done);
+    EXPECT_LE(task_scheduler->busy_worker_count(), release_count);
+
+    task_scheduler->ReleaseExtraWorkers(worker_count - release_count);
+    SQLRunner::Run("drop table t1", false);
+}
@@ -135,6 +135,10 @@ DS\-K3AJ303\/Dm140
 "a b"~1
 "a b"~2
 "a b c"~4
+
+#fuzzy term
+dune~1
+name:duna~2
     )##";
 
     Map<String, String> column2analyzer;
@@ -209,3 +213,28 @@ graphic cards
         std::cerr << long(e.ErrorCode()) << " " << e.what() << std::endl;
     }
 }
+
+TEST_F(SearchDriverTest, term_expansion_test) {
+    using namespace infinity;
+
+    Map<String, String> column2analyzer;
+    String default_field("body");
+    Vector<Pair<String, QueryNodeType>> expansions = {{"prefix", QueryNodeType::PREFIX_TERM},
+                                                      {"suffix", QueryNodeType::SUFFIX_TERM},
+                                                      {"substring", QueryNodeType::SUBSTRING_TERM},
+                                                      {"wildcard", QueryNodeType::WILDCARD_TERM}};
+    for (const auto &[term_expansion, node_type] : expansions) {
+        SearchDriver driver(column2analyzer, default_field, term_expansion);
+        auto query_tree = driver.ParseSingle(R"##(Ch\?p\*)##");
+        ASSERT_NE(query_tree, nullptr);
+        EXPECT_EQ(query_tree->GetType(), node_type);
+        // the pattern is unescaped and lowercased, not analyzed
+        EXPECT_EQ(static_cast<TermExpansionQueryNode *>(query_tree.get())->term_, "ch?p*");
+        EXPECT_EQ(static_cast<TermExpansionQueryNode *>(query_tree.get())->column_, "body");
+
+        // a quoted phrase is still analyzed
+        query_tree = driver.ParseSingle(R"##("chip card")##");
+        ASSERT_NE(query_tree, nullptr);
+        EXPECT_EQ(query_tree->GetType(), QueryNodeType::PHRASE);
+    }
+}
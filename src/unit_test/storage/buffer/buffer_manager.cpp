@@ -25,6 +25,8 @@ import infinity_context;
 import local_file_system;
 import logger;
 import config;
+import file_worker_type;
+import eviction_policy;
 
 using namespace infinity;
 
@@ -182,6 +184,57 @@ TEST_F(BufferManagerTest, cleanup_test) {
     }
 }
 
+TEST_F(BufferManagerTest, eviction_test) {
+    const SizeT file_size = 100;
+    BufferManager buffer_mgr(2 * file_size, data_dir_, temp_dir_);
+    EXPECT_EQ(buffer_mgr.GetEvictionPolicyType(FileWorkerType::kDataFile), EvictionPolicyType::kSegmentedLRU);
+
+    auto AllocateAndWrite = [&](SizeT idx) {
+        auto file_name = MakeShared<String>(fmt::format("file_{}", idx));
+        auto *buffer_obj = buffer_mgr.AllocateBufferObject(MakeUnique<DataFileWorker>(data_dir_, file_name, file_size));
+        auto buffer_handle = buffer_obj->Load();
+        auto *data = reinterpret_cast<char *>(buffer_handle.GetDataMut());
+        std::memset(data, 'a' + idx, file_size);
+        return buffer_obj;
+    };
+    BufferObj *buffer_obj0 = AllocateAndWrite(0);
+    BufferObj *buffer_obj1 = AllocateAndWrite(1);
+    // file_0 is reused before memory runs out, file_1 is freed instead of it.
+    buffer_obj0->Load();
+    BufferObj *buffer_obj2 = AllocateAndWrite(2);
+    EXPECT_EQ(buffer_obj0->status(), BufferStatus::kUnloaded);
+    EXPECT_EQ(buffer_obj1->status(), BufferStatus::kFreed);
+    EXPECT_EQ(buffer_obj0->hit_count(), 1u);
+    EXPECT_EQ(buffer_obj1->eviction_count(), 1u);
+    EXPECT_EQ(buffer_mgr.eviction_count(), 1u);
+
+    // Reading file_1 back is a miss, file_2 is scanned once and freed before file_0.
+    {
+        auto buffer_handle = buffer_obj1->Load();
+        const auto *data = reinterpret_cast<const char *>(buffer_handle.GetData());
+        EXPECT_EQ(data[0], 'b');
+    }
+    EXPECT_EQ(buffer_obj1->miss_count(), 1u);
+    EXPECT_EQ(buffer_obj0->status(), BufferStatus::kUnloaded);
+    EXPECT_EQ(buffer_obj2->status(), BufferStatus::kFreed);
+    EXPECT_EQ(buffer_mgr.hit_count(), 1u);
+    EXPECT_EQ(buffer_mgr.miss_count(), 1u);
+    EXPECT_EQ(buffer_mgr.WaitingGCObjectCount(), 2u);
+
+    // Switching the policy keeps the waiting buffers.
+    buffer_mgr.SetEvictionPolicy(FileWorkerType::kDataFile, EvictionPolicyType::kClock, 0);
+    EXPECT_EQ(buffer_mgr.GetEvictionPolicyType(FileWorkerType::kDataFile), EvictionPolicyType::kClock);
+    EXPECT_EQ(buffer_mgr.WaitingGCObjectCount(), 2u);
+
+    Vector<BufferObjectInfo> buffer_object_infos = buffer_mgr.GetBufferObjectsInfo();
+    EXPECT_EQ(buffer_object_infos.size(), 3u);
+    for (const auto &buffer_object_info : buffer_object_infos) {
+        if (buffer_object_info.object_path_ == buffer_obj2->GetFilename()) {
+            EXPECT_EQ(buffer_object_info.eviction_count_, 1u);
+        }
+    }
+}
+
 TEST_F(BufferManagerTest, parallel_test) {
     LocalFileSystem fs;
 
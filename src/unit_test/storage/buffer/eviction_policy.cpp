@@ -0,0 +1,78 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import buffer_obj;
+import eviction_policy;
+
+using namespace infinity;
+
+class EvictionPolicyTest : public BaseTest {
+protected:
+    // The policies never dereference the objects, any distinct addresses work.
+    BufferObj *Obj(SizeT idx) { return reinterpret_cast<BufferObj *>(&slots_[idx]); }
+
+    Array<u64, 8> slots_{};
+};
+
+TEST_F(EvictionPolicyTest, clock) {
+    ClockEvictionPolicy policy;
+    EXPECT_EQ(policy.Victim(), nullptr);
+    for (SizeT idx = 0; idx < 4; ++idx) {
+        policy.Insert(Obj(idx));
+    }
+    policy.Insert(Obj(0));
+    EXPECT_EQ(policy.Size(), 4u);
+    EXPECT_EQ(policy.Victim(), Obj(0));
+
+    // Obj 0 gets a second chance, obj 1 is locked by another thread.
+    policy.Promote(Obj(0));
+    EXPECT_EQ(policy.Victim(), Obj(1));
+    policy.Skip(Obj(1));
+    EXPECT_EQ(policy.Victim(), Obj(2));
+    EXPECT_TRUE(policy.Remove(Obj(2)));
+    EXPECT_FALSE(policy.Remove(Obj(2)));
+    EXPECT_EQ(policy.Victim(), Obj(3));
+    EXPECT_EQ(policy.Objects(), (Vector<BufferObj *>{Obj(3), Obj(0), Obj(1)}));
+
+    // New objects are the last ones the hand reaches.
+    policy.Insert(Obj(4));
+    EXPECT_EQ(policy.Objects(), (Vector<BufferObj *>{Obj(3), Obj(0), Obj(1), Obj(4)}));
+}
+
+TEST_F(EvictionPolicyTest, segmented_lru) {
+    SegmentedLRUEvictionPolicy policy(50);
+    EXPECT_EQ(policy.Victim(), nullptr);
+    for (SizeT idx = 0; idx < 4; ++idx) {
+        policy.Insert(Obj(idx));
+    }
+    // Promoted objects are freed after all probation objects.
+    policy.Promote(Obj(0));
+    EXPECT_EQ(policy.Victim(), Obj(1));
+    policy.Promote(Obj(1));
+    EXPECT_EQ(policy.Objects(), (Vector<BufferObj *>{Obj(2), Obj(3), Obj(0), Obj(1)}));
+
+    // The protected segment holds at most half of the objects, the least recently promoted is demoted.
+    policy.Promote(Obj(2));
+    EXPECT_EQ(policy.Objects(), (Vector<BufferObj *>{Obj(3), Obj(0), Obj(1), Obj(2)}));
+
+    policy.Skip(Obj(3));
+    EXPECT_EQ(policy.Victim(), Obj(0));
+    EXPECT_TRUE(policy.Remove(Obj(0)));
+    EXPECT_TRUE(policy.Remove(Obj(3)));
+    EXPECT_EQ(policy.Victim(), Obj(1));
+    EXPECT_EQ(policy.Size(), 2u);
+}
@@ -20,6 +20,8 @@ import index_base;
 import index_ivfflat;
 import index_hnsw;
 import index_full_text;
+import serialize;
+import create_index_info;
 
 import statement_common;
 
@@ -55,6 +57,67 @@ TEST_F(IndexBaseTest, ivfflat_readwrite) {
     EXPECT_EQ(*index_base, *index_base1);
 }
 
+TEST_F(IndexBaseTest, ivfflat_encode_readwrite) {
+    using namespace infinity;
+
+    Vector<String> columns{"col1"};
+    Vector<InitParameter *> parameters;
+    parameters.emplace_back(new InitParameter("centroids_count", "100"));
+    parameters.emplace_back(new InitParameter("metric", "ip"));
+    parameters.emplace_back(new InitParameter("encode", "int8"));
+
+    auto index_base = IndexIVFFlat::Make(MakeShared<String>("idx1"), "tbl1_idx1", columns, parameters);
+    for (auto parameter : parameters) {
+        delete parameter;
+    }
+
+    int32_t exp_size = index_base->GetSizeInBytes();
+    Vector<char> buf(exp_size, char(0));
+    char *buf_beg = buf.data();
+    char *ptr = buf_beg;
+    index_base->WriteAdv(ptr);
+    EXPECT_EQ(ptr - buf_beg, exp_size);
+
+    ptr = buf_beg;
+    SharedPtr<IndexBase> index_base1 = IndexBase::ReadAdv(ptr, exp_size);
+    EXPECT_EQ(ptr - buf_beg, exp_size);
+    EXPECT_EQ(*index_base, *index_base1);
+    auto *index_ivfflat = static_cast<IndexIVFFlat *>(index_base1.get());
+    EXPECT_EQ(index_ivfflat->metric_type_, MetricType::kMetricInnerProduct);
+    EXPECT_EQ(index_ivfflat->encode_type_, IVFFlatEncodeType::kInt8);
+}
+
+// An IVFFlat definition written before encode types existed, as found in old WAL files and catalog deltas, reads as a plain index
+// and leaves the bytes after it alone.
+TEST_F(IndexBaseTest, ivfflat_read_old_layout) {
+    using namespace infinity;
+
+    Vector<char> buf(256, char(0));
+    char *buf_beg = buf.data();
+    char *ptr = buf_beg;
+    WriteBufAdv(ptr, IndexType::kIVFFlat);
+    WriteBufAdv(ptr, String("idx1"));
+    WriteBufAdv(ptr, String("tbl1_idx1"));
+    WriteBufAdv(ptr, static_cast<int32_t>(1));
+    WriteBufAdv(ptr, String("col1"));
+    WriteBufAdv(ptr, static_cast<size_t>(100));
+    WriteBufAdv(ptr, MetricType::kMetricL2);
+    int32_t old_size = ptr - buf_beg;
+    // the next field of the enclosing entry
+    WriteBufAdv(ptr, static_cast<int32_t>(12345));
+
+    ptr = buf_beg;
+    SharedPtr<IndexBase> index_base = IndexBase::ReadAdv(ptr, buf.size());
+    EXPECT_EQ(ptr - buf_beg, old_size);
+    EXPECT_EQ(ReadBufAdv<int32_t>(ptr), 12345);
+
+    auto *index_ivfflat = static_cast<IndexIVFFlat *>(index_base.get());
+    EXPECT_EQ(index_ivfflat->centroids_count_, 100u);
+    EXPECT_EQ(index_ivfflat->metric_type_, MetricType::kMetricL2);
+    EXPECT_EQ(index_ivfflat->encode_type_, IVFFlatEncodeType::kPlain);
+    EXPECT_EQ(index_ivfflat->GetSizeInBytes(), old_size);
+}
+
 TEST_F(IndexBaseTest, hnsw_readwrite) {
     using namespace infinity;
 
@@ -120,3 +120,42 @@ TEST_F(FstTest, Iterate) {
     }
     EXPECT_EQ(i, b2_num);
 }
+
+TEST_F(FstTest, SearchAutomaton) {
+    Vector<u8> buffer;
+    BufferWriter wtr(buffer);
+    FstBuilder builder(wtr);
+    for (auto &month : months) {
+        builder.Insert((u8 *)month.first.c_str(), month.first.length(), month.second);
+    }
+    builder.Finish();
+
+    Fst f(buffer.data(), buffer.size());
+    auto search = [&](const auto &automaton, SizeT limit = std::numeric_limits<SizeT>::max()) {
+        Vector<String> keys;
+        f.Search(automaton, [&](const u8 *key_ptr, SizeT key_len, u64 val) {
+            String key((const char *)key_ptr, key_len);
+            u64 expect_val;
+            EXPECT_TRUE(f.Get((u8 *)key.c_str(), key.length(), expect_val));
+            EXPECT_EQ(val, expect_val);
+            keys.push_back(std::move(key));
+            return keys.size() < limit;
+        });
+        return keys;
+    };
+    EXPECT_EQ(search(PrefixAutomaton("Ju")), (Vector<String>{"July", "June"}));
+    EXPECT_EQ(search(PrefixAutomaton("Jx")), Vector<String>{});
+    EXPECT_EQ(search(WildcardAutomaton("*ber")), (Vector<String>{"December", "November", "October", "September"}));
+    EXPECT_EQ(search(WildcardAutomaton("*ber"), 2), (Vector<String>{"December", "November"}));
+    EXPECT_EQ(search(WildcardAutomaton("M?y")), Vector<String>{"May"});
+    EXPECT_EQ(search(WildcardAutomaton("*u*")), (Vector<String>{"August", "February", "January", "July", "June"}));
+    EXPECT_EQ(search(LevenshteinAutomaton("Juny", 1)), (Vector<String>{"July", "June"}));
+    EXPECT_EQ(search(LevenshteinAutomaton("Mach", 1)), Vector<String>{"March"});
+    EXPECT_EQ(search(LevenshteinAutomaton("Mach", 0)), Vector<String>{});
+
+    // the automata work on code points, one edit replaces a multi-byte character
+    EXPECT_TRUE(AutomatonMatches(LevenshteinAutomaton("邓肯", 1), "邓背"));
+    EXPECT_FALSE(AutomatonMatches(LevenshteinAutomaton("邓肯", 1), "背景"));
+    EXPECT_TRUE(AutomatonMatches(WildcardAutomaton("邓?"), "邓肯"));
+    EXPECT_FALSE(AutomatonMatches(WildcardAutomaton("邓?"), "邓"));
+}
@@ -96,3 +96,41 @@ TEST_F(PostingWriterTest, test1) {
         }
     }
 }
+
+TEST_F(PostingWriterTest, test_decode_block) {
+    Vector<docid_t> expected_docs;
+    Vector<tf_t> expected_tfs;
+    VectorWithLock<u32> column_length_array(1000, 10);
+    SharedPtr<PostingWriter> posting = MakeShared<PostingWriter>(posting_format_, column_length_array);
+    for (docid_t doc = 1; doc < 1000; doc += 3) {
+        const tf_t tf = doc % 5 + 1;
+        for (tf_t i = 0; i < tf; ++i) {
+            posting->AddPosition(i);
+        }
+        posting->EndDocument(doc, 0);
+        expected_docs.push_back(doc);
+        expected_tfs.push_back(tf);
+    }
+
+    SharedPtr<Vector<SegmentPosting>> seg_postings = MakeShared<Vector<SegmentPosting>>();
+    SegmentPosting seg_posting;
+    seg_posting.Init(RowID(0, 0), posting);
+    seg_postings->push_back(seg_posting);
+    PostingIterator iter(flag_);
+    iter.Init(seg_postings, 0);
+
+    Vector<RowID> doc_ids;
+    Vector<tf_t> tfs;
+    RowID block_doc_ids[MAX_DOC_PER_RECORD];
+    tf_t block_tfs[MAX_DOC_PER_RECORD];
+    for (RowID doc_id(0, 0); iter.SkipTo(doc_id); doc_id = iter.BlockLastDocID() + 1) {
+        const u32 count = iter.DecodeBlock(doc_id, iter.BlockLastDocID(), block_doc_ids, block_tfs);
+        doc_ids.insert(doc_ids.end(), block_doc_ids, block_doc_ids + count);
+        tfs.insert(tfs.end(), block_tfs, block_tfs + count);
+    }
+    ASSERT_EQ(doc_ids.size(), expected_docs.size());
+    for (SizeT i = 0; i < expected_docs.size(); ++i) {
+        ASSERT_EQ(doc_ids[i], RowID(0, expected_docs[i]));
+        ASSERT_EQ(tfs[i], expected_tfs[i]);
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import index_defines;
+
+using namespace infinity;
+
+class ColumnNormTest : public BaseTest {};
+
+TEST_F(ColumnNormTest, test_exact_short_columns) {
+    for (u32 column_len = 0; column_len < COLUMN_NORM_EXACT_NUM; ++column_len) {
+        EXPECT_EQ(NormToColumnLength(ColumnLengthToNorm(column_len)), column_len);
+    }
+}
+
+TEST_F(ColumnNormTest, test_round_up) {
+    u32 prev_len = 0;
+    for (u32 norm = 1; norm < 256; ++norm) {
+        u32 len = NormToColumnLength(norm);
+        EXPECT_GT(len, prev_len);
+        prev_len = len;
+    }
+    // the decoded length never underestimates the column length, block-max upper bounds rely on it
+    for (u32 column_len = 0; column_len < (1u << 20); column_len += 1 + column_len / 64) {
+        u8 norm = ColumnLengthToNorm(column_len);
+        u32 len = NormToColumnLength(norm);
+        EXPECT_GE(len, column_len);
+        if (norm > 0) {
+            EXPECT_LT(NormToColumnLength(norm - 1), column_len);
+        }
+    }
+}
@@ -78,6 +78,8 @@ protected:
                     const float &expected_matched_freq,
                     const DocIteratorType &query_type);
 
+    Vector<RowID> QueryMatchRowIDs(const String &db_name, const String &table_name, const String &fields, const String &match_text);
+
     void InitData();
 
 
@@ -163,6 +165,25 @@ TEST_F(QueryMatchTest, phrase) {
     }
 }
 
+TEST_F(QueryMatchTest, fuzzy_term) {
+    // 54 terms within one edit of "zebra" sort before it, the exact term is beyond the first 50 expanded terms
+    String near_terms;
+    for (char c = 'a'; c < 'z'; ++c) {
+        near_terms += fmt::format("{}ebra {}zebra ", c, c);
+    }
+    near_terms += "zabra zbbra zcbra zdbra";
+    datas_ = {{"1", "near", near_terms}, {"2", "exact", "zebra"}};
+    CreateDBAndTable(db_name_, table_name_);
+    CreateIndex(db_name_, table_name_, index_name_, "standard");
+    InsertData(db_name_, table_name_);
+
+    // the exact term is the closest one, it is expanded and matches the second row
+    Vector<RowID> row_ids = QueryMatchRowIDs(db_name_, table_name_, "text", "zebra~1");
+    EXPECT_EQ(row_ids.size(), 2u);
+    row_ids = QueryMatchRowIDs(db_name_, table_name_, "text", "zebra");
+    EXPECT_EQ(row_ids.size(), 1u);
+}
+
 void QueryMatchTest::CreateDBAndTable(const String& db_name, const String& table_name) {
     Vector<SharedPtr<ColumnDef>> column_defs;
     {
@@ -380,4 +401,38 @@ void QueryMatchTest::QueryMatch(const String &db_name,
 
     }
     last_commit_ts_ = txn_mgr->CommitTxn(txn);
-}
\ No newline at end of file
+}
+
+Vector<RowID> QueryMatchTest::QueryMatchRowIDs(const String &db_name, const String &table_name, const String &fields, const String &match_text) {
+    Storage *storage = InfinityContext::instance().storage();
+    TxnManager *txn_mgr = storage->txn_manager();
+
+    auto *txn = txn_mgr->BeginTxn(MakeUnique<String>("query match"));
+
+    auto [table_entry, status_table] = txn->GetTableByName(db_name, table_name);
+    EXPECT_TRUE(status_table.ok());
+
+    auto fake_table_ref = BaseTableRef::FakeTableRef(table_entry, txn);
+
+    QueryBuilder query_builder(fake_table_ref.get());
+    IndexReader index_reader = fake_table_ref->table_entry_ptr_->GetFullTextIndexReader(txn);
+    query_builder.Init(index_reader);
+    const Map<String, String> &column2analyzer = query_builder.GetColumn2Analyzer();
+
+    String default_field;
+    SearchDriver driver(column2analyzer, default_field);
+    FullTextQueryContext full_text_query_context;
+    full_text_query_context.query_tree_ = driver.ParseSingleWithFields(fields, match_text);
+    EXPECT_NE(full_text_query_context.query_tree_.get(), nullptr);
+    UniquePtr<DocIterator> doc_iterator = query_builder.CreateSearch(full_text_query_context);
+
+    Vector<RowID> row_ids;
+    if (doc_iterator.get() != nullptr) {
+        doc_iterator->PrepareFirstDoc();
+        for (RowID row_id = doc_iterator->Doc(); row_id != INVALID_ROWID; row_id = doc_iterator->Next()) {
+            row_ids.push_back(row_id);
+        }
+    }
+    last_commit_ts_ = txn_mgr->CommitTxn(txn);
+    return row_ids;
+}
@@ -0,0 +1,55 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import fulltext_score_result_heap;
+import internal_types;
+
+using namespace infinity;
+
+class ScoreResultHeapTest : public BaseTest {};
+
+TEST_F(ScoreResultHeapTest, test_shared_threshold) {
+    constexpr u32 top_k = 3;
+    FullTextScoreThreshold shared_threshold;
+    Vector<float> scores_0(top_k), scores_1(top_k);
+    Vector<RowID> row_ids_0(top_k), row_ids_1(top_k);
+    FullTextScoreResultHeap heap_0(top_k, scores_0.data(), row_ids_0.data());
+    FullTextScoreResultHeap heap_1(top_k, scores_1.data(), row_ids_1.data());
+    heap_0.SetSharedThreshold(&shared_threshold);
+    heap_1.SetSharedThreshold(&shared_threshold);
+
+    // the threshold is published once the heap is full
+    heap_0.AddResult(5.0f, RowID(0, 0));
+    heap_0.AddResult(6.0f, RowID(0, 1));
+    EXPECT_EQ(shared_threshold.Get(), 0.0f);
+    heap_0.AddResult(4.0f, RowID(0, 2));
+    EXPECT_EQ(shared_threshold.Get(), 4.0f);
+
+    // the other task prunes with it, but keeps the ties
+    EXPECT_LT(heap_1.GetScoreThreshold(), 4.0f);
+    EXPECT_GT(heap_1.GetScoreThreshold(), 3.99f);
+
+    heap_1.AddResult(7.0f, RowID(1, 0));
+    heap_1.AddResult(8.0f, RowID(1, 1));
+    heap_1.AddResult(9.0f, RowID(1, 2));
+    EXPECT_EQ(shared_threshold.Get(), 7.0f);
+    EXPECT_GT(heap_0.GetScoreThreshold(), 6.99f);
+
+    // a lower k-th score never lowers the shared threshold
+    shared_threshold.Raise(1.0f);
+    EXPECT_EQ(shared_threshold.Get(), 7.0f);
+}
@@ -0,0 +1,148 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import infinity_exception;
+import stl;
+import knn_filter;
+import ann_ivf_flat;
+import annivfflat_index_data;
+import scalar_quantization;
+import float16;
+import bfloat16;
+import bitmask;
+import knn_expr;
+import internal_types;
+import infinity_context;
+import global_resource_usage;
+
+using namespace infinity;
+
+class AnnIVFFlatSQTest : public BaseTest {
+    void SetUp() override {
+        BaseTest::SetUp();
+#ifdef INFINITY_DEBUG
+        infinity::GlobalResourceUsage::Init();
+#endif
+        std::shared_ptr<std::string> config_path = nullptr;
+        RemoveDbDirs();
+        infinity::InfinityContext::instance().Init(config_path);
+    }
+
+    void TearDown() override {
+        infinity::InfinityContext::instance().UnInit();
+#ifdef INFINITY_DEBUG
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetObjectCount(), 0);
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetRawMemoryCount(), 0);
+        infinity::GlobalResourceUsage::UnInit();
+#endif
+        BaseTest::TearDown();
+    }
+
+protected:
+    template <typename VectorDataType>
+    void TestL2(f32 abs_error) {
+        const f32 *query_embedding = base_embedding_;
+        const f32 expect_distances[] = {0, 0.02, 0.08, 0.2};
+        auto index = AnnIVFFlatL2<f32, VectorDataType>::CreateIndex(dimension_, base_embedding_count_, base_embedding_, 1);
+        EXPECT_EQ(index->data_num_, base_embedding_count_);
+        EXPECT_EQ(index->vectors_[0].size(), dimension_ * base_embedding_count_);
+
+        AnnIVFFlatL2<f32, VectorDataType> ann_distance(query_embedding, 1, 4, dimension_, EmbeddingDataType::kElemFloat);
+        ann_distance.Begin();
+        ann_distance.Search(index.get(), 0, 1);
+        ann_distance.End();
+        f32 *distance_array = ann_distance.GetDistanceByIdx(0);
+        RowID *id_array = ann_distance.GetIDByIdx(0);
+        for (u32 i = 0; i < base_embedding_count_; ++i) {
+            EXPECT_NEAR(distance_array[i], expect_distances[i], abs_error);
+            EXPECT_EQ(id_array[i].segment_offset_, i);
+        }
+
+        AnnIVFFlatL2<f32, VectorDataType> ann_distance_m(query_embedding, 1, 4, dimension_, EmbeddingDataType::kElemFloat);
+        auto p_bitmask = Bitmask::Make(64);
+        BitmaskFilter<SegmentOffset> filter(*p_bitmask);
+        p_bitmask->SetFalse(1);
+        ann_distance_m.Begin();
+        ann_distance_m.Search(index.get(), 0, 1, filter);
+        ann_distance_m.End();
+        RowID *id_array_m = ann_distance_m.GetIDByIdx(0);
+        EXPECT_EQ(id_array_m[0].segment_offset_, 0u);
+        EXPECT_EQ(id_array_m[1].segment_offset_, 2u);
+        EXPECT_EQ(id_array_m[2].segment_offset_, 3u);
+    }
+
+    static constexpr u32 dimension_ = 4;
+    static constexpr u32 base_embedding_count_ = 4;
+    const f32 base_embedding_[dimension_ * base_embedding_count_] = {0.1, 0.2, 0.3, 0.4, 0.2, 0.1, 0.3, 0.4, 0.3, 0.2, 0.1, 0.4, 0.4, 0.3, 0.2, 0.1};
+};
+
+TEST_F(AnnIVFFlatSQTest, test_kernels) {
+    // not a multiple of the SIMD width, so the scalar tail is covered too
+    constexpr u32 dimension = 19;
+    constexpr u32 vector_count = 8;
+    Vector<f32> vectors(dimension * vector_count);
+    for (u32 i = 0; i < vectors.size(); ++i) {
+        vectors[i] = f32((i * 37) % 101) / 50.0f - 1.0f;
+    }
+    SQ8Quantizer quantizer;
+    quantizer.Train(dimension, vector_count, vectors.data());
+    const f32 *query = vectors.data();
+    for (u32 i = 0; i < vector_count; ++i) {
+        const f32 *v = vectors.data() + i * dimension;
+        Vector<float16_t> fp16(v, v + dimension);
+        Vector<bfloat16_t> bf16(v, v + dimension);
+        Vector<u8> code(dimension);
+        quantizer.Encode(v, code.data());
+        // compare with the distances to the decoded vectors
+        f32 expect_l2[3] = {}, expect_ip[3] = {};
+        for (u32 d = 0; d < dimension; ++d) {
+            const f32 decoded[3] = {f32(fp16[d]), f32(bf16[d]), quantizer.min_[d] + quantizer.step_[d] * code[d]};
+            for (u32 k = 0; k < 3; ++k) {
+                expect_l2[k] += (query[d] - decoded[k]) * (query[d] - decoded[k]);
+                expect_ip[k] += query[d] * decoded[k];
+            }
+        }
+        EXPECT_NEAR(L2DistanceSQ(query, fp16.data(), dimension), expect_l2[0], 1e-4);
+        EXPECT_NEAR(IPDistanceSQ(query, fp16.data(), dimension), expect_ip[0], 1e-4);
+        EXPECT_NEAR(L2DistanceSQ(query, bf16.data(), dimension), expect_l2[1], 1e-4);
+        EXPECT_NEAR(IPDistanceSQ(query, bf16.data(), dimension), expect_ip[1], 1e-4);
+        EXPECT_NEAR(L2DistanceSQ8(query, code.data(), quantizer, dimension), expect_l2[2], 1e-4);
+        EXPECT_NEAR(IPDistanceSQ8(query, code.data(), quantizer, dimension), expect_ip[2], 1e-4);
+    }
+}
+
+TEST_F(AnnIVFFlatSQTest, test_l2) {
+    TestL2<float16_t>(1e-3);
+    TestL2<bfloat16_t>(1e-2);
+    TestL2<u8>(1e-3);
+}
+
+TEST_F(AnnIVFFlatSQTest, test_ip) {
+    const f32 *query_embedding = base_embedding_;
+    const f32 expect_distances[] = {0.3, 0.29, 0.26, 0.2};
+    auto index = AnnIVFFlatIP<f32, u8>::CreateIndex(dimension_, base_embedding_count_, base_embedding_, 1);
+
+    AnnIVFFlatIP<f32, u8> ann_distance(query_embedding, 1, 4, dimension_, EmbeddingDataType::kElemFloat);
+    ann_distance.Begin();
+    ann_distance.Search(index.get(), 0, 1);
+    ann_distance.End();
+    f32 *distance_array = ann_distance.GetDistanceByIdx(0);
+    RowID *id_array = ann_distance.GetIDByIdx(0);
+    for (u32 i = 0; i < base_embedding_count_; ++i) {
+        EXPECT_NEAR(distance_array[i], expect_distances[i], 1e-3);
+        EXPECT_EQ(id_array[i].segment_offset_, i);
+    }
+}
@@ -0,0 +1,138 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import infinity_exception;
+import stl;
+import knn_filter;
+import ann_ivf_pq;
+import annivfpq_index_data;
+import bitmask;
+import knn_expr;
+import internal_types;
+import infinity_context;
+import global_resource_usage;
+
+using namespace infinity;
+
+class AnnIVFPQTest : public BaseTest {
+    void SetUp() override {
+        BaseTest::SetUp();
+#ifdef INFINITY_DEBUG
+        infinity::GlobalResourceUsage::Init();
+#endif
+        std::shared_ptr<std::string> config_path = nullptr;
+        RemoveDbDirs();
+        infinity::InfinityContext::instance().Init(config_path);
+    }
+
+    void TearDown() override {
+        infinity::InfinityContext::instance().UnInit();
+#ifdef INFINITY_DEBUG
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetObjectCount(), 0);
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetRawMemoryCount(), 0);
+        infinity::GlobalResourceUsage::UnInit();
+#endif
+        BaseTest::TearDown();
+    }
+
+protected:
+    static constexpr u32 dimension_ = 4;
+    static constexpr u32 base_embedding_count_ = 4;
+    // the same data as AnnIVFFlatL2Test, each subspace has fewer vectors than codes so the residuals are encoded exactly
+    const f32 base_embedding_[dimension_ * base_embedding_count_] = {0.1, 0.2, 0.3, 0.4, 0.2, 0.1, 0.3, 0.4, 0.3, 0.2, 0.1, 0.4, 0.4, 0.3, 0.2, 0.1};
+};
+
+TEST_F(AnnIVFPQTest, test_l2) {
+    const f32 *query_embedding = base_embedding_;
+    const f32 expect_distances[] = {0, 0.02, 0.08, 0.2};
+    for (u32 subspace_bits : {8u, 4u}) {
+        // 4-bit codes are scanned with u8 quantized lookup tables, the distances are approximate
+        const f32 abs_error = subspace_bits == 8 ? 1e-5 : 1e-3;
+        auto index = AnnIVFPQL2<f32>::CreateIndex(dimension_, base_embedding_count_, base_embedding_, 1, 2, subspace_bits);
+        EXPECT_EQ(index->data_num_, base_embedding_count_);
+        EXPECT_EQ(index->codes_[0].size(), index->ListCodeSize(base_embedding_count_));
+
+        AnnIVFPQL2<f32> ann_distance(query_embedding, 1, 4, dimension_, EmbeddingDataType::kElemFloat);
+        ann_distance.Begin();
+        ann_distance.Search(index.get(), 0, 1);
+        ann_distance.End();
+        f32 *distance_array = ann_distance.GetDistanceByIdx(0);
+        RowID *id_array = ann_distance.GetIDByIdx(0);
+        for (u32 i = 0; i < base_embedding_count_; ++i) {
+            EXPECT_NEAR(distance_array[i], expect_distances[i], abs_error);
+            EXPECT_EQ(id_array[i].segment_id_, 0u);
+            EXPECT_EQ(id_array[i].segment_offset_, i);
+        }
+
+        AnnIVFPQL2<f32> ann_distance_m(query_embedding, 1, 4, dimension_, EmbeddingDataType::kElemFloat);
+        auto p_bitmask = Bitmask::Make(64);
+        BitmaskFilter<SegmentOffset> filter(*p_bitmask);
+        p_bitmask->SetFalse(1);
+        ann_distance_m.Begin();
+        ann_distance_m.Search(index.get(), 0, 1, filter);
+        ann_distance_m.End();
+        RowID *id_array_m = ann_distance_m.GetIDByIdx(0);
+        EXPECT_EQ(id_array_m[0].segment_offset_, 0u);
+        EXPECT_EQ(id_array_m[1].segment_offset_, 2u);
+        EXPECT_EQ(id_array_m[2].segment_offset_, 3u);
+    }
+}
+
+TEST_F(AnnIVFPQTest, test_ip) {
+    const f32 *query_embedding = base_embedding_;
+    const f32 expect_distances[] = {0.3, 0.29, 0.26, 0.2};
+    auto index = AnnIVFPQIP<f32>::CreateIndex(dimension_, base_embedding_count_, base_embedding_, 1, 2, 8);
+
+    AnnIVFPQIP<f32> ann_distance(query_embedding, 1, 4, dimension_, EmbeddingDataType::kElemFloat);
+    ann_distance.Begin();
+    ann_distance.Search(index.get(), 0, 1);
+    ann_distance.End();
+    f32 *distance_array = ann_distance.GetDistanceByIdx(0);
+    RowID *id_array = ann_distance.GetIDByIdx(0);
+    for (u32 i = 0; i < base_embedding_count_; ++i) {
+        EXPECT_NEAR(distance_array[i], expect_distances[i], 1e-5);
+        EXPECT_EQ(id_array[i].segment_offset_, i);
+    }
+}
+
+TEST_F(AnnIVFPQTest, test_fast_scan_block) {
+    constexpr u32 subspace_num = 3;
+    u8 codes[IVFPQ_FAST_SCAN_BLOCK_SIZE][subspace_num];
+    u8 lut[subspace_num * 16];
+    for (u32 j = 0; j < IVFPQ_FAST_SCAN_BLOCK_SIZE; ++j) {
+        for (u32 m = 0; m < subspace_num; ++m) {
+            codes[j][m] = (j * 7 + m * 5) % 16;
+        }
+    }
+    for (u32 i = 0; i < subspace_num * 16; ++i) {
+        lut[i] = (i * 37) % 256;
+    }
+    u8 packed[subspace_num * 16] = {};
+    for (u32 j = 0; j < IVFPQ_FAST_SCAN_BLOCK_SIZE; ++j) {
+        for (u32 m = 0; m < subspace_num; ++m) {
+            packed[m * 16 + j % 16] |= codes[j][m] << (j < 16 ? 0 : 4);
+        }
+    }
+    u16 out[IVFPQ_FAST_SCAN_BLOCK_SIZE];
+    IVFPQFastScanBlock(packed, lut, subspace_num, out);
+    for (u32 j = 0; j < IVFPQ_FAST_SCAN_BLOCK_SIZE; ++j) {
+        u16 expect = 0;
+        for (u32 m = 0; m < subspace_num; ++m) {
+            expect += lut[m * 16 + codes[j][m]];
+        }
+        EXPECT_EQ(out[j], expect);
+    }
+}
@@ -0,0 +1,218 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import infinity_exception;
+import stl;
+import diskann_index_data;
+import index_base;
+import internal_types;
+import local_file_system;
+import infinity_context;
+import global_resource_usage;
+import index_diskann;
+import diskann_index_file_worker;
+import column_def;
+import logical_type;
+import embedding_info;
+import data_type;
+
+using namespace infinity;
+
+class DiskAnnTest : public BaseTest {
+    void SetUp() override {
+        BaseTest::SetUp();
+#ifdef INFINITY_DEBUG
+        infinity::GlobalResourceUsage::Init();
+#endif
+        std::shared_ptr<std::string> config_path = nullptr;
+        RemoveDbDirs();
+        infinity::InfinityContext::instance().Init(config_path);
+    }
+
+    void TearDown() override {
+        infinity::InfinityContext::instance().UnInit();
+#ifdef INFINITY_DEBUG
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetObjectCount(), 0);
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetRawMemoryCount(), 0);
+        infinity::GlobalResourceUsage::UnInit();
+#endif
+        BaseTest::TearDown();
+    }
+
+protected:
+    static constexpr u32 dimension_ = 8;
+    static constexpr u32 base_embedding_count_ = 500;
+
+    const std::string save_dir_ = GetTmpDir();
+
+    Vector<f32> MakeData() const {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<f32> distrib_real;
+        Vector<f32> data(dimension_ * base_embedding_count_);
+        for (auto &x : data) {
+            x = distrib_real(rng);
+        }
+        return data;
+    }
+
+    static Vector<Pair<f32, SegmentOffset>> Search(const DiskAnnIndexData<f32> &index, const f32 *query, u32 search_list_size) {
+        Vector<Pair<f32, SegmentOffset>> result;
+        index.Search(query, search_list_size, 4, [&](f32 distance, SegmentOffset segment_offset) { result.emplace_back(distance, segment_offset); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+TEST_F(DiskAnnTest, test_node_layout) {
+    // 8 * 4 + 4 * (1 + 16) = 100 bytes, 40 records per sector
+    DiskAnnIndexData<f32> small(MetricType::kMetricL2, dimension_, 16, 32, 1.2f, 4);
+    EXPECT_EQ(small.NodeSize(), 100u);
+    EXPECT_EQ(small.NodesPerSector(), 40u);
+    EXPECT_EQ(small.NodeOffset(39), 39u * 100u);
+    EXPECT_EQ(small.NodeOffset(40), DISKANN_SECTOR_SIZE);
+    EXPECT_EQ(small.NodeOffset(81), 2 * DISKANN_SECTOR_SIZE + 100u);
+
+    // a record larger than a sector starts at its own sector boundary
+    DiskAnnIndexData<f32> large(MetricType::kMetricL2, 1024, 16, 32, 1.2f, 4);
+    EXPECT_EQ(large.NodesPerSector(), 0u);
+    EXPECT_EQ(large.NodeReadSize(), 2 * DISKANN_SECTOR_SIZE);
+    EXPECT_EQ(large.NodeOffset(3), 6 * DISKANN_SECTOR_SIZE);
+}
+
+TEST_F(DiskAnnTest, test_l2) {
+    const Vector<f32> data = MakeData();
+    DiskAnnIndexData<f32> index(MetricType::kMetricL2, dimension_, 16, 32, 1.2f, 4);
+    index.BuildIndex(dimension_, base_embedding_count_, data.data());
+    EXPECT_EQ(index.data_num_, base_embedding_count_);
+    EXPECT_EQ(index.pq_codes_.size(), base_embedding_count_ * 4);
+
+    for (u32 i = 0; i < base_embedding_count_; i += 50) {
+        const auto result = Search(index, data.data() + i * dimension_, 32);
+        ASSERT_FALSE(result.empty());
+        EXPECT_NEAR(result[0].first, 0.0f, 1e-5);
+        EXPECT_EQ(result[0].second, i);
+    }
+}
+
+TEST_F(DiskAnnTest, test_ip) {
+    const Vector<f32> data = MakeData();
+    DiskAnnIndexData<f32> index(MetricType::kMetricInnerProduct, dimension_, 16, 32, 1.2f, 4);
+    index.BuildIndex(dimension_, base_embedding_count_, data.data());
+
+    const f32 *query = data.data();
+    f32 expect_max = std::numeric_limits<f32>::lowest();
+    for (u32 i = 0; i < base_embedding_count_; ++i) {
+        f32 ip = 0;
+        for (u32 d = 0; d < dimension_; ++d) {
+            ip += query[d] * data[i * dimension_ + d];
+        }
+        expect_max = std::max(expect_max, ip);
+    }
+    const auto result = Search(index, query, 64);
+    ASSERT_FALSE(result.empty());
+    EXPECT_NEAR(result.back().first, expect_max, 1e-3);
+}
+
+TEST_F(DiskAnnTest, test_save_and_read_in_place) {
+    const Vector<f32> data = MakeData();
+    const String file_path = save_dir_ + "/test_diskann.bin";
+    Vector<Vector<Pair<f32, SegmentOffset>>> expect_results;
+    {
+        DiskAnnIndexData<f32> index(MetricType::kMetricL2, dimension_, 16, 32, 1.2f, 4);
+        index.BuildIndex(dimension_, base_embedding_count_, data.data());
+        for (u32 i = 0; i < base_embedding_count_; i += 50) {
+            expect_results.push_back(Search(index, data.data() + i * dimension_, 32));
+        }
+        index.SaveIndex(file_path, MakeUnique<LocalFileSystem>());
+    }
+    auto check = [&](const DiskAnnIndexData<f32> &index) {
+        EXPECT_EQ(index.data_num_, base_embedding_count_);
+        for (u32 i = 0, k = 0; i < base_embedding_count_; i += 50, ++k) {
+            const auto result = Search(index, data.data() + i * dimension_, 32);
+            ASSERT_EQ(result.size(), expect_results[k].size());
+            for (SizeT j = 0; j < result.size(); ++j) {
+                EXPECT_EQ(result[j].first, expect_results[k][j].first);
+                EXPECT_EQ(result[j].second, expect_results[k][j].second);
+            }
+        }
+    };
+    {
+        auto index = DiskAnnIndexData<f32>::LoadIndex(file_path, MakeUnique<LocalFileSystem>());
+        check(*index);
+    }
+    {
+        // only the PQ data and the labels are read, the node records are read from the file by the search
+        DiskAnnIndexData<f32> index;
+        index.ReadIndexInPlace(file_path);
+        EXPECT_TRUE(index.nodes_.empty());
+        check(index);
+    }
+}
+
+TEST_F(DiskAnnTest, test_parallel_build) {
+    const Vector<f32> data = MakeData();
+    DiskAnnIndexData<f32> serial_index(MetricType::kMetricL2, dimension_, 16, 32, 1.2f, 4);
+    serial_index.BuildIndex(dimension_, base_embedding_count_, data.data());
+    DiskAnnIndexData<f32> parallel_index(MetricType::kMetricL2, dimension_, 16, 32, 1.2f, 4);
+    parallel_index.BuildIndex(dimension_, base_embedding_count_, data.data(), 4);
+
+    // the batches don't depend on the worker count, so neither does the graph
+    EXPECT_EQ(parallel_index.medoid_, serial_index.medoid_);
+    EXPECT_EQ(parallel_index.nodes_, serial_index.nodes_);
+    for (u32 i = 0; i < base_embedding_count_; i += 50) {
+        const auto result = Search(parallel_index, data.data() + i * dimension_, 32);
+        ASSERT_FALSE(result.empty());
+        EXPECT_EQ(result[0].second, i);
+    }
+}
+
+// A persisted index is loaded by its file worker with only the PQ data and the labels in memory.
+TEST_F(DiskAnnTest, test_file_worker_read_in_place) {
+    const Vector<f32> data = MakeData();
+    auto index_diskann = MakeShared<IndexDiskAnn>(MakeShared<String>("idx1"), "tbl1_idx1", Vector<String>{"col1"}, MetricType::kMetricL2, 16, 32, 1.2f, 4);
+    auto column_def = MakeShared<ColumnDef>(0,
+                                            MakeShared<DataType>(LogicalType::kEmbedding, EmbeddingInfo::Make(EmbeddingDataType::kElemFloat, dimension_)),
+                                            "col1",
+                                            std::set<ConstraintType>());
+    DiskAnnIndexFileWorker<f32> file_worker(MakeShared<String>(save_dir_),
+                                            MakeShared<String>("test_diskann_worker.bin"),
+                                            index_diskann,
+                                            column_def);
+
+    Vector<Vector<Pair<f32, SegmentOffset>>> expect_results;
+    file_worker.AllocateInMemory();
+    {
+        auto *index = static_cast<DiskAnnIndexData<f32> *>(file_worker.GetData());
+        index->BuildIndex(dimension_, base_embedding_count_, data.data(), 4);
+        for (u32 i = 0; i < base_embedding_count_; i += 50) {
+            expect_results.push_back(Search(*index, data.data() + i * dimension_, 32));
+        }
+    }
+    file_worker.WriteToFile(false);
+    file_worker.FreeInMemory();
+
+    file_worker.ReadFromFile(false);
+    {
+        auto *index = static_cast<DiskAnnIndexData<f32> *>(file_worker.GetData());
+        EXPECT_TRUE(index->nodes_.empty());
+        for (u32 i = 0, k = 0; i < base_embedding_count_; i += 50, ++k) {
+            const auto result = Search(*index, data.data() + i * dimension_, 32);
+            EXPECT_EQ(result, expect_results[k]);
+        }
+    }
+    file_worker.FreeInMemory();
+    file_worker.CleanupFile();
+}
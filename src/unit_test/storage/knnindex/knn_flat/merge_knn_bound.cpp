@@ -0,0 +1,96 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import merge_knn;
+import knn_result_handler;
+import vector_distance;
+import bitmask;
+import internal_types;
+
+using namespace infinity;
+
+class MergeKnnBoundTest : public BaseTest {};
+
+TEST_F(MergeKnnBoundTest, test_shared_bound) {
+    constexpr u32 dimension = 128;
+    constexpr u16 row_count = 1000;
+    constexpr u64 query_count = 2;
+    constexpr u64 top_k = 10;
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<f32> distrib_real;
+    Vector<f32> queries(dimension * query_count);
+    Vector<Vector<f32>> segments(2, Vector<f32>(dimension * row_count));
+    for (auto &x : queries) {
+        x = distrib_real(rng);
+    }
+    for (auto &segment : segments) {
+        for (auto &x : segment) {
+            x = distrib_real(rng);
+        }
+    }
+
+    // each segment is scanned by its own task, the second one starts from the threshold published by the first
+    MergeKnnBound bound(query_count);
+    Vector<UniquePtr<MergeKnn<f32, CompareMax>>> tasks;
+    for (u32 segment_id = 0; segment_id < segments.size(); ++segment_id) {
+        auto task = MakeUnique<MergeKnn<f32, CompareMax>>(query_count, top_k);
+        task->Begin();
+        task->SyncBound(bound);
+        Bitmask bitmask;
+        bitmask.Initialize(row_count);
+        task->Search(queries.data(),
+                     segments[segment_id].data(),
+                     dimension,
+                     L2DistanceBounded<f32, f32, f32, SizeT>,
+                     row_count,
+                     segment_id,
+                     0,
+                     bitmask);
+        task->SyncBound(bound);
+        task->End();
+        tasks.push_back(std::move(task));
+    }
+    for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+        EXPECT_LT(bound.Get(query_idx), std::numeric_limits<f64>::max());
+    }
+
+    MergeKnn<f32, CompareMax> merge_knn(query_count, top_k);
+    merge_knn.Begin();
+    for (const auto &task : tasks) {
+        merge_knn.Search(task->GetDistances(), task->GetIDs(), top_k);
+    }
+    merge_knn.End();
+
+    for (u64 query_idx = 0; query_idx < query_count; ++query_idx) {
+        const f32 *query = queries.data() + query_idx * dimension;
+        Vector<Pair<f32, RowID>> expect;
+        for (u32 segment_id = 0; segment_id < segments.size(); ++segment_id) {
+            for (u32 i = 0; i < row_count; ++i) {
+                f32 distance = L2Distance<f32, f32, f32, SizeT>(query, segments[segment_id].data() + i * dimension, dimension);
+                expect.emplace_back(distance, RowID(segment_id, i));
+            }
+        }
+        std::sort(expect.begin(), expect.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        const f32 *distances = merge_knn.GetDistancesByIdx(query_idx);
+        const RowID *row_ids = merge_knn.GetIDsByIdx(query_idx);
+        for (u64 i = 0; i < top_k; ++i) {
+            EXPECT_FLOAT_EQ(distances[i], expect[i].first);
+            EXPECT_EQ(row_ids[i], expect[i].second);
+        }
+    }
+}
@@ -81,6 +81,23 @@ public:
             float correct_rate = float(correct) / element_size;
             // std::printf("correct rage: %f\n", correct_rate);
             EXPECT_GE(correct_rate, 0.95);
+
+            // The batched search gives the same result as searching the queries one by one.
+            Vector<const float *> queries(element_size);
+            for (int i = 0; i < element_size; ++i) {
+                queries[i] = data.get() + i * dim;
+            }
+            auto batch_results = hnsw_index.KnnSearchBatch(queries.data(), element_size, 1);
+            ASSERT_EQ(batch_results.size(), SizeT(element_size));
+            for (int i = 0; i < element_size; ++i) {
+                auto [result_n, d_ptr, l_ptr] = hnsw_index.KnnSearch(queries[i], 1);
+                const auto &[batch_result_n, batch_d_ptr, batch_l_ptr] = batch_results[i];
+                ASSERT_EQ(batch_result_n, result_n);
+                for (SizeT j = 0; j < result_n; ++j) {
+                    EXPECT_EQ(batch_d_ptr[j], d_ptr[j]);
+                    EXPECT_EQ(batch_l_ptr[j], l_ptr[j]);
+                }
+            }
         };
 
         LocalFileSystem fs;
@@ -110,6 +127,22 @@ public:
 
             test_func(hnsw_index);
         }
+        {
+            u8 *data_ptr = nullptr;
+            SizeT data_len = 0;
+            int ret = fs.MmapFile(save_dir_ + "/test_hnsw.bin", data_ptr, data_len);
+            EXPECT_EQ(ret, 0);
+
+            // Searched in place, without lock.
+            char *ptr = reinterpret_cast<char *>(data_ptr);
+            {
+                auto hnsw_index = Hnsw::LoadFromPtr(ptr);
+                EXPECT_EQ(ptr, reinterpret_cast<char *>(data_ptr) + data_len);
+
+                test_func(hnsw_index);
+            }
+            fs.MunmapFile(save_dir_ + "/test_hnsw.bin");
+        }
     }
 
     template <typename Hnsw, typename CompressedHnsw>
@@ -182,6 +215,22 @@ public:
 
             test_func(compress_hnsw);
         }
+        {
+            u8 *data_ptr = nullptr;
+            SizeT data_len = 0;
+            int ret = fs.MmapFile(save_dir_ + "/test_hnsw.bin", data_ptr, data_len);
+            EXPECT_EQ(ret, 0);
+
+            // Searched in place, without lock.
+            char *ptr = reinterpret_cast<char *>(data_ptr);
+            {
+                auto compress_hnsw = CompressedHnsw::LoadFromPtr(ptr);
+                EXPECT_EQ(ptr, reinterpret_cast<char *>(data_ptr) + data_len);
+
+                test_func(compress_hnsw);
+            }
+            fs.MunmapFile(save_dir_ + "/test_hnsw.bin");
+        }
     }
 
     template <typename Hnsw>
@@ -294,6 +343,120 @@ public:
             t.join();
         }
     }
+
+    template <typename Hnsw>
+    void TestBuildParallel() {
+        int dim = 16;
+        int M = 8;
+        int ef_construction = 200;
+        int chunk_size = 128;
+        int max_chunk_n = 10;
+        int element_size = max_chunk_n * chunk_size;
+
+        std::mt19937 rng;
+        rng.seed(0);
+        std::uniform_real_distribution<float> distrib_real;
+
+        auto data = MakeUnique<float[]>(dim * element_size);
+        for (int i = 0; i < dim * element_size; ++i) {
+            data[i] = distrib_real(rng);
+        }
+
+        auto hnsw_index = Hnsw::Make(chunk_size, max_chunk_n, dim, M, ef_construction);
+        HnswBuildProgress progress;
+        {
+            auto iter = DenseVectorIter<float, LabelT>(data.get(), dim, element_size / 2);
+            auto [start_i, end_i] = hnsw_index.StoreData(std::move(iter));
+            hnsw_index.BuildParallel(start_i, end_i, 4, progress);
+            EXPECT_EQ(progress.done_.load(), SizeT(element_size / 2));
+        }
+        {
+            // the bulk build merges its subgraphs with the graph built above
+            auto iter = DenseVectorIter<float, LabelT>(data.get() + element_size / 2 * dim, dim, element_size - element_size / 2, element_size / 2);
+            auto [start_i, end_i] = hnsw_index.StoreData(std::move(iter));
+            hnsw_index.BuildBulk(start_i, end_i, 4, progress);
+        }
+        EXPECT_EQ(progress.done_.load(), progress.total_.load());
+        hnsw_index.Check();
+
+        hnsw_index.SetEf(10);
+        int correct = 0;
+        for (int i = 0; i < element_size; ++i) {
+            const float *query = data.get() + i * dim;
+            auto result = hnsw_index.KnnSearchSorted(query, 1);
+            if (result[0].second == (LabelT)i) {
+                ++correct;
+            }
+        }
+        float correct_rate = float(correct) / element_size;
+        EXPECT_GE(correct_rate, 0.95);
+    }
+
+    template <typename Hnsw>
+    void TestMergeGraphs() {
+        int dim = 16;
+        int M = 8;
+        int ef_construction = 200;
+        int chunk_size = 128;
+        int max_chunk_n = 10;
+        int element_size = max_chunk_n * chunk_size;
+
+        std::mt19937 rng;
+        rng.seed(0);
+        std::uniform_real_distribution<float> distrib_real;
+
+        auto data = MakeUnique<float[]>(dim * element_size);
+        for (int i = 0; i < dim * element_size; ++i) {
+            data[i] = distrib_real(rng);
+        }
+
+        // two source graphs of the halves, as the indexes of two compacted segments
+        int half_size = element_size / 2;
+        auto hnsw_index1 = Hnsw::Make(chunk_size, max_chunk_n, dim, M, ef_construction);
+        auto hnsw_index2 = Hnsw::Make(chunk_size, max_chunk_n, dim, M, ef_construction);
+        {
+            auto iter = DenseVectorIter<float, LabelT>(data.get(), dim, half_size);
+            hnsw_index1.InsertVecs(std::move(iter));
+        }
+        {
+            auto iter = DenseVectorIter<float, LabelT>(data.get() + half_size * dim, dim, element_size - half_size, half_size);
+            hnsw_index2.InsertVecs(std::move(iter));
+        }
+
+        auto hnsw_index = Hnsw::Make(chunk_size, max_chunk_n, dim, M, ef_construction);
+        {
+            auto iter = DenseVectorIter<float, LabelT>(data.get(), dim, element_size);
+            hnsw_index.StoreData(std::move(iter));
+        }
+        // every 10th vertex of the first graph is dropped and inserted after the merge, as a row without a source graph
+        auto map_label = [&](LabelT label) -> VertexType { return label < LabelT(half_size) && label % 10 == 0 ? -1 : VertexType(label); };
+        Vector<HnswSubgraph> subgraphs;
+        subgraphs.push_back(hnsw_index.CopyGraph(hnsw_index1, map_label));
+        subgraphs.push_back(hnsw_index.CopyGraph(hnsw_index2, map_label));
+        EXPECT_EQ(subgraphs[0].start_, 1);
+        EXPECT_EQ(subgraphs[0].end_, half_size);
+        EXPECT_EQ(subgraphs[1].start_, half_size);
+        EXPECT_EQ(subgraphs[1].end_, element_size);
+
+        HnswBuildProgress progress;
+        hnsw_index.MergeSubgraphs(subgraphs, 4, progress);
+        for (int i = 0; i < half_size; i += 10) {
+            hnsw_index.Build(i);
+        }
+        hnsw_index.Check();
+
+        hnsw_index.SetEf(10);
+        int correct = 0;
+        for (int i = 0; i < element_size; ++i) {
+            const float *query = data.get() + i * dim;
+            auto result = hnsw_index.KnnSearchSorted(query, 1);
+            if (result[0].second == (LabelT)i) {
+                ++correct;
+            }
+        }
+        float correct_rate = float(correct) / element_size;
+        EXPECT_GE(correct_rate, 0.95);
+    }
 };
 
 TEST_F(HnswAlgTest, test1) {
@@ -327,3 +490,13 @@ TEST_F(HnswAlgTest, test6) {
     using CompressedHnsw = KnnHnsw<LVQL2VecStoreType<float, int8_t>, LabelT>;
     TestCompress<Hnsw, CompressedHnsw>();
 }
+
+TEST_F(HnswAlgTest, test_build_parallel) {
+    using Hnsw = KnnHnsw<PlainL2VecStoreType<float>, LabelT>;
+    TestBuildParallel<Hnsw>();
+}
+
+TEST_F(HnswAlgTest, test_merge_graphs) {
+    using Hnsw = KnnHnsw<PlainL2VecStoreType<float>, LabelT>;
+    TestMergeGraphs<Hnsw>();
+}
@@ -140,4 +140,61 @@ TEST_F(HnswAlgBitmaskTest, test1) {
         EXPECT_NEAR(result[0].first, 0.2, error);
         EXPECT_NEAR(result[0].second, 3, error);
     }
-}
\ No newline at end of file
+}
+
+TEST_F(HnswAlgBitmaskTest, test_expanded) {
+    SizeT dimension = 16;
+    SizeT base_embedding_count = 2000;
+    SizeT top_k = 10;
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<f32> distrib_real;
+    auto base_embedding = MakeUnique<f32[]>(dimension * base_embedding_count);
+    for (SizeT i = 0; i < dimension * base_embedding_count; ++i) {
+        base_embedding[i] = distrib_real(rng);
+    }
+
+    using LabelT = u64;
+    using Hnsw = KnnHnsw<PlainL2VecStoreType<f32>, LabelT>;
+    Hnsw hnsw_index = Hnsw::Make(base_embedding_count, 1, dimension, 8, 100);
+    auto iter = DenseVectorIter<f32, LabelT>(base_embedding.get(), dimension, base_embedding_count);
+    hnsw_index.InsertVecs(std::move(iter));
+    hnsw_index.SetEf(2 * top_k);
+
+    // 2% of the vectors pass the filter
+    auto p_bitmask = Bitmask::Make(base_embedding_count);
+    p_bitmask->SetAllFalse();
+    for (SizeT i = 0; i < base_embedding_count; i += 50) {
+        p_bitmask->SetTrue(i);
+    }
+    BitmaskFilter<LabelT> filter(*p_bitmask);
+
+    SizeT hit_n = 0;
+    SizeT query_n = 20;
+    for (SizeT q = 0; q < query_n; ++q) {
+        const f32 *query = base_embedding.get() + (q * 97 + 13) * dimension;
+        Vector<Pair<f32, LabelT>> expect;
+        for (SizeT i = 0; i < base_embedding_count; i += 50) {
+            f32 dist = 0;
+            for (SizeT d = 0; d < dimension; ++d) {
+                f32 diff = query[d] - base_embedding[i * dimension + d];
+                dist += diff * diff;
+            }
+            expect.emplace_back(dist, i);
+        }
+        std::sort(expect.begin(), expect.end());
+        expect.resize(top_k);
+
+        auto [result_n, d_ptr, l_ptr] = hnsw_index.KnnSearchExpanded(query, top_k, filter);
+        for (SizeT i = 0; i < result_n; ++i) {
+            EXPECT_TRUE(p_bitmask->IsTrue(l_ptr[i]));
+            for (const auto &[dist, label] : expect) {
+                if (label == l_ptr[i]) {
+                    EXPECT_NEAR(dist, d_ptr[i], error);
+                    ++hit_n;
+                }
+            }
+        }
+    }
+    // the expanded traversal only scores passing vertices, so a small ef still finds most of the filtered neighbors
+    EXPECT_GE(hit_n, query_n * top_k * 8 / 10);
+}
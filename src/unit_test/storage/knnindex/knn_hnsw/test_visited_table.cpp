@@ -0,0 +1,70 @@
+// Copyright(C) 2024 InfiniFlow, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "unit_test/base_test.h"
+
+import stl;
+import hnsw_common;
+
+using namespace infinity;
+
+class VisitedTableTest : public BaseTest {};
+
+TEST_F(VisitedTableTest, reuse_across_searches) {
+    VisitedTable visited;
+    visited.Reset(10);
+    EXPECT_FALSE(visited.TestAndSet(3));
+    EXPECT_TRUE(visited.TestAndSet(3));
+
+    // A new search sees no visited vertex, and the table grows for a larger graph.
+    visited.Reset(100);
+    EXPECT_FALSE(visited.TestAndSet(3));
+    EXPECT_FALSE(visited.TestAndSet(99));
+    EXPECT_TRUE(visited.TestAndSet(99));
+
+    // Marks left from old epochs must not leak through the epoch wrap.
+    for (SizeT i = 0; i < 70000; ++i) {
+        visited.Reset(100);
+        if (i == 0) {
+            visited.TestAndSet(5);
+        }
+    }
+    EXPECT_FALSE(visited.TestAndSet(5));
+}
+
+TEST_F(VisitedTableTest, shrink_batch) {
+    // Tables of small graphs are all kept for the next batch.
+    Vector<VisitedTable> &small_tables = VisitedTable::ThreadLocalBatch(8);
+    for (auto &visited : small_tables) {
+        visited.Reset(100);
+    }
+    VisitedTable::ShrinkThreadLocalBatch();
+    EXPECT_EQ(VisitedTable::ThreadLocalBatch(0).size(), 8u);
+
+    // Only the tables within the cache budget are kept after a batch over a large graph.
+    SizeT large_vertex_n = VisitedTable::BATCH_CACHE_BYTES / sizeof(u16) / 2 + 1;
+    Vector<VisitedTable> &large_tables = VisitedTable::ThreadLocalBatch(8);
+    for (auto &visited : large_tables) {
+        visited.Reset(large_vertex_n);
+    }
+    VisitedTable::ShrinkThreadLocalBatch();
+    EXPECT_EQ(VisitedTable::ThreadLocalBatch(0).size(), 1u);
+
+    // The pool grows again for the next batch.
+    Vector<VisitedTable> &next_tables = VisitedTable::ThreadLocalBatch(4);
+    EXPECT_EQ(next_tables.size(), 4u);
+    next_tables[3].Reset(10);
+    EXPECT_FALSE(next_tables[3].TestAndSet(3));
+    EXPECT_TRUE(next_tables[3].TestAndSet(3));
+}
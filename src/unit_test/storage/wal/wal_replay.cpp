@@ -466,6 +466,104 @@ TEST_F(WalReplayTest, wal_replay_append) {
     }
 }
 
+// Appends to several tables are replayed in parallel, one task per table, the rows of each table keep the commit order.
+TEST_F(WalReplayTest, wal_replay_append_tables) {
+    SizeT table_count = 4;
+    SizeT round_count = 3;
+    SizeT row_count = 2;
+    auto table_name = [](SizeT table_idx) { return "tbl" + std::to_string(table_idx); };
+    auto row_value = [&](SizeT table_idx, SizeT round_idx, SizeT row_idx) {
+        return static_cast<i64>((table_idx * round_count + round_idx) * row_count + row_idx);
+    };
+    {
+#ifdef INFINITY_DEBUG
+        infinity::GlobalResourceUsage::Init();
+#endif
+        std::shared_ptr<std::string> config_path = WalReplayTest::config_path();
+        infinity::InfinityContext::instance().Init(config_path);
+
+        Storage *storage = infinity::InfinityContext::instance().storage();
+        TxnManager *txn_mgr = storage->txn_manager();
+
+        Vector<SharedPtr<ColumnDef>> columns;
+        {
+            std::set<ConstraintType> constraints;
+            auto column_def_ptr = MakeShared<ColumnDef>(0, MakeShared<DataType>(DataType(LogicalType::kBigInt)), "big_int_col", constraints);
+            columns.emplace_back(column_def_ptr);
+        }
+        for (SizeT table_idx = 0; table_idx < table_count; ++table_idx) {
+            auto tbl_def = MakeUnique<TableDef>(MakeShared<String>("default_db"), MakeShared<String>(table_name(table_idx)), columns);
+            auto *txn = txn_mgr->BeginTxn(MakeUnique<String>("create table"));
+            Status status = txn->CreateTable("default_db", std::move(tbl_def), ConflictType::kIgnore);
+            EXPECT_TRUE(status.ok());
+            txn_mgr->CommitTxn(txn);
+        }
+        // Appends of the tables interleave in the WAL.
+        for (SizeT round_idx = 0; round_idx < round_count; ++round_idx) {
+            for (SizeT table_idx = 0; table_idx < table_count; ++table_idx) {
+                auto *txn = txn_mgr->BeginTxn(MakeUnique<String>("insert table"));
+                SharedPtr<DataBlock> input_block = MakeShared<DataBlock>();
+                input_block->Init({MakeShared<DataType>(LogicalType::kBigInt)}, row_count);
+                for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+                    input_block->AppendValue(0, Value::MakeBigInt(row_value(table_idx, round_idx, row_idx)));
+                }
+                input_block->Finalize();
+                auto [table_entry, status] = txn->GetTableByName("default_db", table_name(table_idx));
+                EXPECT_TRUE(status.ok());
+                txn->Append(table_entry, input_block);
+                txn_mgr->CommitTxn(txn);
+            }
+        }
+        infinity::InfinityContext::instance().UnInit();
+#ifdef INFINITY_DEBUG
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetObjectCount(), 0);
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetRawMemoryCount(), 0);
+        infinity::GlobalResourceUsage::UnInit();
+#endif
+    }
+    // Restart the db instance
+    {
+#ifdef INFINITY_DEBUG
+        infinity::GlobalResourceUsage::Init();
+#endif
+        std::shared_ptr<std::string> config_path = WalReplayTest::config_path();
+        infinity::InfinityContext::instance().Init(config_path);
+
+        Storage *storage = infinity::InfinityContext::instance().storage();
+        TxnManager *txn_mgr = storage->txn_manager();
+        {
+            auto *txn = txn_mgr->BeginTxn(MakeUnique<String>("check table"));
+            TxnTimeStamp begin_ts = txn->BeginTS();
+            for (SizeT table_idx = 0; table_idx < table_count; ++table_idx) {
+                auto [table_entry, status] = txn->GetTableByName("default_db", table_name(table_idx));
+                EXPECT_NE(table_entry, nullptr);
+
+                auto segment_entry = table_entry->GetSegmentByID(0, begin_ts);
+                EXPECT_NE(segment_entry, nullptr);
+                EXPECT_EQ(segment_entry->row_count(), round_count * row_count);
+
+                auto *block_entry = segment_entry->GetBlockEntryByID(0).get();
+                EXPECT_EQ(block_entry->row_count(), round_count * row_count);
+
+                ColumnVector col0 = block_entry->GetColumnBlockEntry(0)->GetColumnVector(storage->buffer_manager());
+                for (SizeT round_idx = 0; round_idx < round_count; ++round_idx) {
+                    for (SizeT row_idx = 0; row_idx < row_count; ++row_idx) {
+                        Value v0 = col0.GetValue(round_idx * row_count + row_idx);
+                        EXPECT_EQ(v0.GetValue<BigIntT>(), row_value(table_idx, round_idx, row_idx));
+                    }
+                }
+            }
+            txn_mgr->CommitTxn(txn);
+        }
+        infinity::InfinityContext::instance().UnInit();
+#ifdef INFINITY_DEBUG
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetObjectCount(), 0);
+        EXPECT_EQ(infinity::GlobalResourceUsage::GetRawMemoryCount(), 0);
+        infinity::GlobalResourceUsage::UnInit();
+#endif
+    }
+}
+
 TEST_F(WalReplayTest, wal_replay_import) {
     {
 #ifdef INFINITY_DEBUG
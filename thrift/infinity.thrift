@@ -389,6 +389,8 @@ FullText,
 BMP,
 Secondary,
 EMVB,
+IVFPQ,
+DiskAnn,
 }
 
 struct IndexInfo {